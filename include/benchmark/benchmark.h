@@ -3,6 +3,9 @@
 
 #include "indexes/base_index.h"
 #include "benchmark/workload_generator.h"
+#include "benchmark/result_validator.h"
+#include "utils/perf_counters.h"
+#include "utils/cache_flusher.h"
 #include <string>
 #include <vector>
 #include <memory>
@@ -22,15 +25,89 @@ struct BenchmarkResult {
     double median_query_time_ms;
     double p95_query_time_ms;
     double p99_query_time_ms;
-    double scan_overhead;
+    double scan_overhead;      // Points scanned / points returned (1.0 if not instrumented)
+    double avg_scanned_runs;   // Contiguous runs scanned per query (0 if not instrumented)
     
     size_t total_queries;
     size_t total_results;
     
+    std::vector<double> query_times_ms;  // Per-query latency, in workload order
+    
+    // Cold-cache pass (only with Benchmark::setColdCache): each query timed
+    // right after the caches were flushed
+    bool cold_measured = false;
+    double cold_avg_query_time_ms = 0.0;
+    double cold_median_query_time_ms = 0.0;
+    double cold_p95_query_time_ms = 0.0;
+    double cold_p99_query_time_ms = 0.0;
+    std::vector<double> cold_query_times_ms;
+    
+    // Hardware counters (only with Benchmark::setPerfCounters; events the
+    // kernel refused are invalid): the build, all queries, and each query
+    // in workload order
+    PerfSample build_counters;
+    PerfSample query_counters;
+    std::vector<PerfSample> per_query_counters;
+    
+    // Result validation (only with Benchmark::setValidation): queries
+    // checked against the reference, and the ones that were wrong
+    size_t validated_queries = 0;
+    size_t failed_queries = 0;
+    std::vector<QueryValidation> mismatches;
+    
     std::string toCSV() const;
     void print() const;
 };
 
+/**
+ * Results from running a read/write stream (Benchmark::runMixedBenchmark)
+ */
+struct MixedResult {
+    std::string index_name;
+    std::string workload_name;
+    std::string mix;                 // Query/insert/delete percentages
+    size_t rebuild_every = 0;        // Rebuild policy (0 = never rebuild)
+    bool native_inserts = false;     // Inserts went into the index itself
+    
+    double build_time_ms = 0.0;      // Initial build
+    size_t rebuilds = 0;
+    double rebuild_time_ms = 0.0;    // Also counted in the latency of the operation that triggered it
+    
+    // Latency of each operation of a type, in stream order
+    std::vector<double> query_times_ms;
+    std::vector<double> insert_times_ms;
+    std::vector<double> delete_times_ms;
+    
+    /**
+     * One of Benchmark::AGING_WINDOWS equal slices of the stream, to show
+     * how latency changes as updates accumulate
+     */
+    struct Window {
+        size_t end_operation = 0;    // One past the window's last operation
+        size_t queries = 0;
+        double mean_query_ms = 0.0;
+        double p99_query_ms = 0.0;
+        size_t inserts = 0;
+        double mean_insert_ms = 0.0;
+        size_t deletes = 0;
+        double mean_delete_ms = 0.0;
+        size_t rebuilds = 0;
+        size_t pending_updates = 0;  // Updates not yet in the index at the window's end
+    };
+    std::vector<Window> windows;
+    
+    // Result validation (only with Benchmark::setValidation)
+    size_t validated_queries = 0;
+    size_t failed_queries = 0;
+    
+    /**
+     * Mean query latency of the last window over that of the first
+     */
+    double degradation() const;
+    
+    void print() const;
+};
+
 /**
  * Benchmark: Runs performance evaluation on indexes
  */
@@ -40,7 +117,9 @@ public:
     
     /**
      * Run a complete benchmark suite
-     * Tests all indexes against all workloads
+     * Builds each index once on the data, then runs every workload against
+     * the built indexes; each result carries its index's build time, size
+     * and build counters
      */
     std::vector<BenchmarkResult> runSuite(
         const std::vector<std::shared_ptr<BaseIndex>>& indexes,
@@ -48,7 +127,7 @@ public:
         const std::vector<std::pair<std::string, std::vector<QueryRange>>>& workloads);
     
     /**
-     * Run benchmark for a single index and workload
+     * Run benchmark for a single index and workload (build, then queries)
      */
     BenchmarkResult runBenchmark(
         BaseIndex* index,
@@ -56,6 +135,24 @@ public:
         const std::vector<QueryRange>& queries,
         const std::string& workload_name);
     
+    static constexpr size_t AGING_WINDOWS = 10;
+    
+    /**
+     * Build the index on workload.initial, then run its operations in
+     * order, timing each one. Indexes that support inserts take them
+     * directly; otherwise inserted points wait in a delta buffer that
+     * queries scan alongside the index. Deletes are tombstones filtered
+     * out of every result. Once the index lags by rebuild_every updates
+     * (see setRebuildPolicy) it is rebuilt on the live data, synchronously,
+     * so the rebuild shows up in the latency of the operation that
+     * triggered it: the cost of keeping results fresh on an index that
+     * cannot update.
+     */
+    MixedResult runMixedBenchmark(
+        BaseIndex* index,
+        const MixedWorkload& workload,
+        const std::string& workload_name);
+    
     /**
      * Save benchmark results to CSV file
      */
@@ -63,18 +160,87 @@ public:
                     const std::string& filepath);
     
     /**
-     * Set warmup queries (run before actual benchmark)
+     * Save one row per query: warm latency, cold latency if measured, and
+     * counters if collected
+     */
+    void saveQueryTrace(const std::vector<BenchmarkResult>& results,
+                        const std::string& filepath);
+    
+    /**
+     * Save one row per stream window of each read/write run
+     */
+    void saveMixedResults(const std::vector<MixedResult>& results,
+                          const std::string& filepath);
+    
+    /**
+     * Set warmup queries: the first num queries of the workload (all of
+     * them if num is at least its size) run untimed before the warm pass
      */
     void setWarmupQueries(size_t num) { warmup_queries_ = num; }
     
+    /**
+     * Also time every query with cold caches: a separate pass before the
+     * warm one that empties the index's own caches (BaseIndex::dropCaches)
+     * and flushes the CPU caches (CacheFlusher of flush_bytes, 0 = sized
+     * from the last-level cache) before each query. Both are outside
+     * the timed section; hardware counters and validation cover the warm
+     * pass only.
+     */
+    void setColdCache(bool enabled, size_t flush_bytes = 0);
+    const CacheFlusher* getCacheFlusher() const { return flusher_.get(); }
+    
     /**
      * Enable/disable verbose output
      */
     void setVerbose(bool v) { verbose_ = v; }
+    
+    /**
+     * Rebuild an index that cannot apply updates itself after this many
+     * inserts and deletes (0 = never; queries then scan a growing delta)
+     */
+    void setRebuildPolicy(size_t every_updates) { rebuild_every_ = every_updates; }
+    
+    /**
+     * Collect hardware counters around each build and each query. Returns
+     * false (and leaves them off) if the kernel grants no counters.
+     */
+    bool setPerfCounters(bool enabled);
+    const PerfCounters* getPerfCounters() const { return perf_.get(); }
+    
+    /**
+     * Check query results against a brute-force scan (ResultValidator),
+     * outside the timed section. At most sample_queries evenly spaced
+     * queries per run are checked (0 = all of them).
+     */
+    void setValidation(bool enabled, size_t sample_queries = 0);
 
 private:
     size_t warmup_queries_;
     bool verbose_;
+    size_t rebuild_every_;
+    std::unique_ptr<PerfCounters> perf_;
+    std::unique_ptr<CacheFlusher> flusher_;  // Set for cold-cache passes
+    
+    bool validate_;
+    size_t validation_sample_;
+    std::unique_ptr<ResultValidator> validator_;  // Shared by the runs of one suite
+    
+    /**
+     * Build the index on data, recording build time, size and counters
+     */
+    void buildIndex(BaseIndex* index, const std::vector<DataPoint>& data, BenchmarkResult& result);
+    
+    /**
+     * Query passes against an already built index
+     */
+    void runQueries(BaseIndex* index, const std::vector<DataPoint>& data,
+                    const std::vector<QueryRange>& queries, BenchmarkResult& result);
+    void runColdQueries(BaseIndex* index, const std::vector<QueryRange>& queries, BenchmarkResult& result);
+    
+    void validateResults(const std::vector<DataPoint>& data,
+                         const std::vector<QueryRange>& queries,
+                         const std::vector<std::pair<size_t, std::vector<DataPoint>>>& sampled,
+                         BenchmarkResult& result);
     
     // Helper functions
     double calculateScanOverhead(
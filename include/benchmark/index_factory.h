@@ -0,0 +1,25 @@
+#ifndef INDEX_FACTORY_H
+#define INDEX_FACTORY_H
+
+#include "indexes/base_index.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace flood {
+
+/**
+ * Comma-separated names accepted by createIndex(), for usage messages
+ */
+extern const char* const INDEX_NAMES;
+
+/**
+ * Create an index by its command-line name (nullptr if unknown).
+ * Workload-aware indexes are trained on training_queries.
+ */
+std::shared_ptr<BaseIndex> createIndex(const std::string& name,
+                                       const std::vector<QueryRange>& training_queries);
+
+} // namespace flood
+
+#endif // INDEX_FACTORY_H
@@ -0,0 +1,105 @@
+#ifndef LOAD_GENERATOR_H
+#define LOAD_GENERATOR_H
+
+#include "indexes/base_index.h"
+#include "utils/latency_histogram.h"
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace flood {
+
+/**
+ * When an open-loop generator sends its requests
+ */
+enum class ArrivalProcess {
+    CONSTANT,   // Evenly spaced
+    POISSON     // Exponential inter-arrival times (independent arrivals)
+};
+
+ArrivalProcess parseArrivalProcess(const std::string& name);
+const char* arrivalProcessName(ArrivalProcess arrivals);
+
+/**
+ * Settings for LoadGenerator
+ */
+struct LoadConfig {
+    ArrivalProcess arrivals = ArrivalProcess::POISSON;
+    double duration_s = 2.0;        // Sending time per rate step
+    size_t generator_threads = 1;   // Each sends rate / generator_threads
+    size_t worker_threads = 4;      // Threads executing queries on the shared index
+    uint32_t seed = 42;
+    
+    // Stop a rate sweep at the first step whose achieved throughput falls
+    // below this fraction of the offered rate (0 = run every step)
+    double saturation_cutoff = 0.9;
+};
+
+/**
+ * Outcome of one open-loop run at a fixed offered rate
+ */
+struct LoadPoint {
+    double offered_qps = 0.0;
+    double achieved_qps = 0.0;      // Completed / (sending time, or until the last completion)
+    uint64_t issued = 0;
+    uint64_t completed = 0;
+    size_t max_queue_depth = 0;     // Most requests ever waiting for a worker
+    bool serialized = false;        // Index could not be queried concurrently
+    
+    // Latency from the intended send time to completion (includes any
+    // time spent queued, or waiting on a generator that fell behind)
+    LatencyHistogram latency;
+    // Time a worker spent executing the query
+    LatencyHistogram service;
+};
+
+/**
+ * LoadGenerator: open-loop driver for a shared index
+ *
+ * Generator threads issue queries at a target rate on a fixed schedule,
+ * independent of how fast queries complete, into a queue served by a
+ * worker pool that queries one shared (already built) index. Latency is
+ * measured from each request's intended send time, not from when it was
+ * actually sent or picked up, so a stall shows up in the latency of every
+ * request scheduled behind it instead of silently delaying the schedule
+ * (coordinated omission). Latencies go into HDR-style histograms.
+ *
+ * Indexes that do not support concurrent queries are queried by one
+ * worker at a time; the run still shows their queueing behavior.
+ */
+class LoadGenerator {
+public:
+    explicit LoadGenerator(LoadConfig config = LoadConfig());
+    
+    /**
+     * Run at one offered rate; requests cycle through queries
+     * (throws std::invalid_argument for a non-positive rate or no queries)
+     */
+    LoadPoint run(BaseIndex& index, const std::vector<QueryRange>& queries, double rate_qps) const;
+    
+    /**
+     * Latency-versus-throughput curve: one run per rate, in order, stopping
+     * after the first saturated step (see LoadConfig::saturation_cutoff)
+     */
+    std::vector<LoadPoint> sweep(BaseIndex& index, const std::vector<QueryRange>& queries,
+                                 const std::vector<double>& rates_qps) const;
+    
+    static const char* const CSV_HEADER;
+    
+    /**
+     * One CSV row (latencies in microseconds)
+     */
+    static std::string toCSV(const std::string& index_name, ArrivalProcess arrivals, const LoadPoint& point);
+    
+    static void printCurve(const std::string& index_name, const std::vector<LoadPoint>& curve);
+    
+    const LoadConfig& getConfig() const { return config_; }
+
+private:
+    LoadConfig config_;
+};
+
+} // namespace flood
+
+#endif // LOAD_GENERATOR_H
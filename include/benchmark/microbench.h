@@ -0,0 +1,155 @@
+#ifndef MICROBENCH_H
+#define MICROBENCH_H
+
+#include <string>
+#include <vector>
+#include <functional>
+#include <cstdint>
+#include <cstddef>
+
+namespace flood {
+
+/**
+ * Keep value (and every store that produced it) alive without emitting
+ * any code, so the compiler cannot drop a kernel whose result is unused.
+ * Meant for scalars: pass each kernel result, not an aggregate.
+ */
+template <typename T>
+inline void doNotOptimize(const T& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+/**
+ * Settings for MicroBenchmark::run()
+ */
+struct MicroConfig {
+    size_t samples = 20;          // Timed samples per kernel
+    double min_sample_ms = 10.0;  // Each sample repeats the kernel until it takes this long
+    double confidence = 0.95;     // 0.90, 0.95 or 0.99
+    std::string filter;           // Only kernels whose name contains this
+    bool verbose = true;          // Print each result as it completes
+};
+
+/**
+ * Timing of one kernel; all times are per operation (one kernel
+ * application to one input)
+ */
+struct MicroResult {
+    std::string name;
+    size_t samples = 0;
+    uint64_t ops_per_sample = 0;
+    double median_ns = 0.0;
+    double min_ns = 0.0;
+    double mean_ns = 0.0;
+    double ci_low_ns = 0.0;   // Confidence interval of the mean
+    double ci_high_ns = 0.0;
+    
+    /**
+     * Throughput at the median time
+     */
+    double opsPerSecond() const { return median_ns > 0.0 ? 1e9 / median_ns : 0.0; }
+};
+
+/**
+ * One kernel measured against a baseline
+ */
+struct MicroComparison {
+    std::string name;
+    double baseline_ns = 0.0;   // Median per op (0 if the baseline lacks it)
+    double current_ns = 0.0;
+    double change = 0.0;        // current / baseline - 1
+    bool regression = false;
+    bool improvement = false;
+};
+
+/**
+ * MicroBenchmark: repeatable timing of small hot-path kernels
+ *
+ * A kernel is registered with the number of operations one call performs
+ * (typically a loop over a batch of prepared inputs) and is called with a
+ * repeat count. Before measuring, the repeat count is grown until one
+ * call takes min_sample_ms; that calibration doubles as warm-up (caches,
+ * branch predictors, frequency scaling). Then `samples` calls are timed
+ * separately and reported as median, minimum, and mean with a Student's t
+ * confidence interval, all in ns per operation.
+ *
+ * A change only counts as a regression (or improvement) against a baseline
+ * when the medians differ by more than the threshold and the confidence
+ * intervals do not overlap, so noise alone does not fail a comparison.
+ */
+class MicroBenchmark {
+public:
+    using Kernel = std::function<void(size_t repeats)>;
+    
+    explicit MicroBenchmark(MicroConfig config = MicroConfig());
+    
+    /**
+     * Register a kernel performing ops_per_call operations per repeat
+     * (throws std::invalid_argument for a duplicate name or zero ops)
+     */
+    void add(const std::string& name, size_t ops_per_call, Kernel kernel);
+    
+    /**
+     * Names of the registered kernels that pass the filter, in order
+     */
+    std::vector<std::string> names() const;
+    
+    /**
+     * Calibrate and time every kernel that passes the filter
+     */
+    std::vector<MicroResult> run() const;
+    
+    static const char* const CSV_HEADER;
+    
+    /**
+     * Write results as CSV (throws std::runtime_error if it cannot be written)
+     */
+    static void saveResults(const std::vector<MicroResult>& results, const std::string& filepath);
+    
+    /**
+     * Read results written by saveResults() (throws std::runtime_error)
+     */
+    static std::vector<MicroResult> loadResults(const std::string& filepath);
+    
+    /**
+     * Compare each current result with the baseline entry of the same name
+     * @param threshold Relative change of the median below which kernels
+     *                  count as unchanged (0.05 = 5%)
+     */
+    static std::vector<MicroComparison> compare(const std::vector<MicroResult>& baseline,
+                                                const std::vector<MicroResult>& current,
+                                                double threshold);
+    
+    static void printResults(const std::vector<MicroResult>& results);
+    static void printComparison(const std::vector<MicroComparison>& comparison);
+
+private:
+    struct Entry {
+        std::string name;
+        size_t ops_per_call;
+        Kernel kernel;
+    };
+    
+    MicroResult measure(const Entry& entry) const;
+    
+    MicroConfig config_;
+    std::vector<Entry> entries_;
+};
+
+/**
+ * Register the index hot paths over synthetic 3-D inputs drawn from
+ * uniform, clustered (Gaussian hot spots) and skewed (mass near the
+ * origin) distributions, batch_size inputs per call:
+ *
+ *   flattened_key/<dist>      FloodIndex::flattenedKey
+ *   normalize/<dist>          CurveIndex::normalizeToCell, all dimensions
+ *   morton3d/<dist>           sfc::mortonEncode3D (BMI2 when available)
+ *   morton3d_magic/<dist>     sfc::mortonEncode3DMagic
+ *   hilbert3d/<dist>          sfc::hilbertEncode, 21 bits per dimension
+ *   contains/<dist>           QueryRange::contains, central box of 10% volume
+ */
+void addIndexKernels(MicroBenchmark& bench, size_t batch_size, uint32_t seed);
+
+} // namespace flood
+
+#endif // MICROBENCH_H
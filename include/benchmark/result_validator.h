@@ -0,0 +1,76 @@
+#ifndef RESULT_VALIDATOR_H
+#define RESULT_VALIDATOR_H
+
+#include "data/data_point.h"
+#include "utils/thread_pool.h"
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace flood {
+
+/**
+ * Outcome of checking one query's results against the reference
+ */
+struct QueryValidation {
+    size_t query = 0;           // Position in the workload
+    size_t expected = 0;        // Points the reference scan matched
+    size_t returned = 0;        // Points the index returned
+    size_t missing = 0;         // Expected points the index did not return
+    size_t extra = 0;           // Returned points the reference did not match (incl. duplicates)
+    std::vector<uint64_t> missing_ids;   // First few of each, for the report
+    std::vector<uint64_t> extra_ids;
+    
+    bool ok() const { return missing == 0 && extra == 0; }
+};
+
+/**
+ * ResultValidator: brute-force correctness oracle for range queries
+ *
+ * Keeps its own column-wise copy of the data and answers a query by
+ * scanning every point: each chunk of rows is filtered one dimension at a
+ * time into a byte mask with branch-free comparisons the compiler turns
+ * into SIMD, and chunks run in parallel on a thread pool. Containment is
+ * the same as QueryRange::contains (inclusive bounds over the dimensions
+ * the range and the data share).
+ *
+ * Results are compared by point id as multisets, so a lost point, a point
+ * outside the range and a point returned twice are all reported. Memory
+ * is one double per coordinate plus one id per point.
+ */
+class ResultValidator {
+public:
+    /**
+     * @param num_threads Scan threads besides the caller (0 = hardware
+     *                    concurrency - 1)
+     */
+    explicit ResultValidator(const std::vector<DataPoint>& data, size_t num_threads = 0);
+    
+    ResultValidator(const ResultValidator&) = delete;
+    ResultValidator& operator=(const ResultValidator&) = delete;
+    
+    /**
+     * Ids of the points inside range, sorted
+     */
+    std::vector<uint64_t> expectedIds(const QueryRange& range);
+    
+    /**
+     * Compare an index's results for range with the reference
+     * @param query Position of the query, copied into the report
+     */
+    QueryValidation check(const QueryRange& range, const std::vector<DataPoint>& results, size_t query = 0);
+    
+    size_t size() const { return ids_.size(); }
+    
+    // Ids kept per kind of mismatch in a QueryValidation
+    static constexpr size_t MAX_REPORTED_IDS = 5;
+
+private:
+    std::vector<std::vector<double>> columns_;   // columns_[d][row]
+    std::vector<uint64_t> ids_;
+    ThreadPool pool_;
+};
+
+} // namespace flood
+
+#endif // RESULT_VALIDATOR_H
@@ -0,0 +1,125 @@
+#ifndef SWEEP_H
+#define SWEEP_H
+
+#include "data/data_point.h"
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace flood {
+
+/**
+ * Parameter ranges for a ParameterSweep; the sweep runs their full
+ * cross-product
+ *
+ * Every list is set from a string (set(), command line or config file):
+ * comma-separated values ("1K,10K,1M"; K/M/G suffixes multiply by 10^3,
+ * 10^6, 10^9), or a geometric range "start:end:xfactor" ("1K:100M:x10"
+ * is 1K, 10K, ..., 100M).
+ */
+struct SweepConfig {
+    std::vector<size_t> data_sizes = {10000, 100000};
+    std::vector<size_t> dimensions = {3};
+    std::vector<double> selectivities = {0.001, 0.01};
+    std::vector<size_t> query_counts = {100};
+    std::vector<std::string> workloads = {"mixed"};    // See parseWorkloadType (not trace)
+    bool calibrate = false;     // Calibrate queries to return the selectivity on the data
+    std::string distribution = "uniform";  // Synthetic data, see parseDistribution
+    
+    // Index configurations: every index x shard count x coordinate encoding
+    std::vector<std::string> indexes = {"kdtree", "grid", "flood"};
+    std::vector<size_t> shards = {1};
+    std::vector<std::string> coords = {"double"};
+    bool recheck = false;       // Keep exact doubles to recheck compact coords
+    
+    size_t trials = 5;          // Independent builds and query sets per point
+    double confidence = 0.95;   // 0.90, 0.95 or 0.99
+    uint32_t seed = 42;
+    std::string output = "sweep_results.csv";
+    
+    /**
+     * Set one parameter by name: sizes, dims, selectivities, queries,
+     * workloads, calibrate, distribution, indexes, shards, coords, recheck,
+     * trials, confidence, seed, output
+     * (throws std::invalid_argument for unknown keys or bad values)
+     */
+    void set(const std::string& key, const std::string& value);
+    
+    /**
+     * Read "key = value" lines ('#' starts a comment) with the keys of set()
+     */
+    void loadFile(const std::string& path);
+    
+    /**
+     * Sweep points times index configurations
+     */
+    size_t numConfigurations() const;
+};
+
+/**
+ * Mean and confidence interval of repeated measurements (Student's t;
+ * a single trial gives a zero-width interval)
+ */
+struct SweepStat {
+    size_t trials = 0;
+    double mean = 0.0;
+    double stddev = 0.0;
+    double ci_low = 0.0;
+    double ci_high = 0.0;
+    
+    static SweepStat of(const std::vector<double>& samples, double confidence);
+};
+
+/**
+ * Two-sided Student's t critical value (throws std::invalid_argument for
+ * confidence levels other than 0.90, 0.95 and 0.99)
+ */
+double studentT(size_t degrees_of_freedom, double confidence);
+
+/**
+ * Parse a value list or geometric range (see SweepConfig)
+ */
+std::vector<size_t> parseSizeList(const std::string& text);
+std::vector<double> parseValueList(const std::string& text);
+
+/**
+ * ParameterSweep: scaling benchmark over a SweepConfig
+ *
+ * For each data size and dimensionality a synthetic dataset of the
+ * configured distribution is generated once; for each workload, selectivity and query count, every
+ * trial draws a fresh query set (and training sample) and builds every
+ * index configuration from scratch, with the index configurations
+ * interleaved within a trial so slow drift in the machine affects them
+ * alike. Results go to a tidy CSV, one row per (configuration, metric):
+ *
+ *   Index,Config,Shards,Coords,Workload,DataSize,Dimensions,Selectivity,
+ *   NumQueries,Metric,Trials,Mean,StdDev,CI_Low,CI_High,Confidence
+ *
+ * with Metric one of BuildTime_ms, IndexSize_MB, AvgQueryTime_ms,
+ * P95QueryTime_ms, P99QueryTime_ms, Throughput_qps, ScanOverhead,
+ * AchievedSelectivity (mean fraction of the data a query returned), and
+ * Coords suffixed "+recheck" for rechecked compact encodings. Rows
+ * are flushed as each sweep point completes, so a long sweep that is
+ * interrupted keeps what it measured.
+ */
+class ParameterSweep {
+public:
+    explicit ParameterSweep(SweepConfig config);
+    
+    /**
+     * Run the sweep and write config.output (throws std::runtime_error if
+     * it cannot be written, std::invalid_argument for unknown indexes);
+     * returns the number of rows written
+     */
+    size_t run();
+    
+    static const char* const CSV_HEADER;
+
+private:
+    SweepConfig config_;
+};
+
+} // namespace flood
+
+#endif // SWEEP_H
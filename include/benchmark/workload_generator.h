@@ -14,9 +14,22 @@ namespace flood {
 enum class WorkloadType {
     SPATIAL,      // Workload A: Pure spatial queries (lon, lat)
     TEMPORAL,     // Workload B: Spatio-temporal queries (lon, lat, time)
-    MIXED         // Workload C: Mixed queries with all dimensions
+    MIXED,        // Workload C: Mixed queries with all dimensions
+    CENTERED,     // Mixed-shape queries centered on sampled data points
+    HOTSPOT,      // Spatial queries around a few Zipf-popular data points
+    RUSH_HOUR,    // Spatio-temporal queries at data points during weekday peak hours
+    ZONE,         // Spatial boxes of equal-count zones (small where data is dense)
+    TRACE         // Queries replayed from a saved workload (WorkloadConfig::trace_file)
 };
 
+/**
+ * Workload names as used on the command line: spatial, temporal, mixed,
+ * centered, hotspot, rush-hour, zone, trace
+ * (parseWorkloadType throws std::invalid_argument for an unknown name)
+ */
+WorkloadType parseWorkloadType(const std::string& name);
+const char* workloadTypeName(WorkloadType type);
+
 /**
  * Configuration for workload generation
  */
@@ -31,6 +44,21 @@ struct WorkloadConfig {
     // For temporal workloads
     double temporal_range_hours;  // Time range in hours
     
+    // For hotspot workloads: number of hotspots, and the Zipf exponent of
+    // their popularity (rank k is queried in proportion to 1 / k^s)
+    size_t num_hotspots = 16;
+    double zipf_exponent = 1.0;
+    
+    // For trace workloads: file written by saveWorkload
+    std::string trace_file;
+    
+    // Rescale each generated query so that it returns selectivity of the
+    // data to within a relative tolerance, instead of only sizing it as
+    // that fraction of the domain (see WorkloadGenerator::calibrateWorkload)
+    bool calibrate = false;
+    double selectivity_tolerance = 0.1;
+    size_t calibration_sample = 100000;
+    
     // Random seed
     uint32_t seed = 42;
     
@@ -39,6 +67,70 @@ struct WorkloadConfig {
           spatial_range_ratio(0.01), temporal_range_hours(24.0) {}
 };
 
+/**
+ * Kinds of operation in a read/write stream
+ */
+enum class OperationType {
+    QUERY,
+    INSERT,
+    DELETE
+};
+
+/**
+ * Shares of each operation type in a stream, normalized to sum to 1
+ */
+struct OperationMix {
+    double query = 1.0;
+    double insert = 0.0;
+    double remove = 0.0;
+    
+    std::string toString() const;  // e.g. "90/10/0"
+};
+
+/**
+ * Parse a mix given as query/insert[/delete] percentages or weights,
+ * e.g. "90/10" or "50/25/25" (throws std::invalid_argument)
+ */
+OperationMix parseOperationMix(const std::string& text);
+
+/**
+ * One step of a read/write stream; arg is the position in
+ * MixedWorkload::queries for a query, in MixedWorkload::inserts for an
+ * insert, and the id of the point to remove for a delete
+ */
+struct Operation {
+    OperationType type;
+    size_t arg;
+};
+
+/**
+ * A read/write stream over a dataset: the index is built on initial, then
+ * the operations run in order
+ */
+struct MixedWorkload {
+    std::vector<DataPoint> initial;
+    std::vector<DataPoint> inserts;     // In insertion (time) order
+    std::vector<QueryRange> queries;
+    std::vector<Operation> operations;
+    OperationMix mix;
+};
+
+/**
+ * Configuration for read/write streams
+ */
+struct MixedWorkloadConfig {
+    OperationMix mix;
+    size_t num_operations = 10000;
+    
+    // Oldest fraction of the data (by time_dim) the index is built on;
+    // inserts then arrive in time order from the rest
+    double initial_fraction = 0.5;
+    size_t time_dim = 2;
+    
+    // Queries of the stream (num_queries is ignored: one per query operation)
+    WorkloadConfig queries = WorkloadConfig(WorkloadType::SPATIAL, 0, 0.001);
+};
+
 /**
  * WorkloadGenerator: Creates synthetic query workloads for benchmarking
  */
@@ -78,6 +170,112 @@ public:
         size_t num_queries,
         double selectivity);
     
+    /**
+     * Queries of the same shape as Workload C, centered on uniformly sampled
+     * data points (shifted to stay inside the domain), so they land where
+     * the data is instead of on empty regions of the bounding box
+     */
+    std::vector<QueryRange> generateCenteredWorkload(
+        const std::vector<DataPoint>& data,
+        size_t num_queries,
+        double selectivity);
+    
+    /**
+     * Spatial queries clustered around num_hotspots sampled data points
+     * whose popularity follows a Zipf distribution, jittered by a fraction
+     * of the query size
+     */
+    std::vector<QueryRange> generateHotspotWorkload(
+        const std::vector<DataPoint>& data,
+        size_t num_queries,
+        double selectivity,
+        size_t num_hotspots,
+        double zipf_exponent);
+    
+    /**
+     * Spatio-temporal queries centered on data points picked up during the
+     * weekday morning (7-10) or evening (16-19) peak, with a time window of
+     * at most time_range_hours inside that peak. Times are Unix seconds of
+     * local wall-clock time, as parsed from the trip records; data without
+     * peak-hour points falls back to windows around any data point.
+     */
+    std::vector<QueryRange> generateRushHourWorkload(
+        const std::vector<DataPoint>& data,
+        size_t num_queries,
+        double selectivity,
+        double time_range_hours);
+    
+    /**
+     * Spatial queries covering whole zones: the (lon, lat) plane is cut into
+     * about 1 / selectivity equal-count cells (quantile slabs in lon, each
+     * cut by quantiles in lat), so like real taxi zones they are small where
+     * the data is dense and large where it is sparse, and each query returns
+     * about selectivity of the data
+     */
+    std::vector<QueryRange> generateZoneWorkload(
+        const std::vector<DataPoint>& data,
+        size_t num_queries,
+        double selectivity);
+    
+    /**
+     * Replay a workload saved with saveWorkload: its first num_queries
+     * queries, or all of them if num_queries is 0 or larger than the trace
+     * (throws std::runtime_error if the trace is missing or empty)
+     */
+    std::vector<QueryRange> replayWorkload(
+        const std::string& filepath,
+        size_t num_queries);
+    
+    /**
+     * Rescale each query about its center, keeping its shape, so that it
+     * returns target_selectivity of the data. The scale is the exact
+     * quantile of the points' (scaled Chebyshev) distance from the center
+     * on a sample of at least sample_size points (more for very selective
+     * targets); queries whose exact selectivity is then off by more than
+     * tolerance x target are recalibrated against all the data. Dimensions
+     * a query leaves unrestricted stay unrestricted; ties (duplicate
+     * points) can still keep a query outside the tolerance. Measuring
+     * takes two batched passes over the data (see measureSelectivity):
+     * one for the whole workload, one for the recalibrated queries.
+     *
+     * @return Exact selectivity of each calibrated query
+     */
+    std::vector<double> calibrateWorkload(
+        const std::vector<DataPoint>& data,
+        std::vector<QueryRange>& workload,
+        double target_selectivity,
+        double tolerance,
+        size_t sample_size);
+    
+    /**
+     * Interleave queries, inserts and deletes in the proportions of
+     * config.mix. The data is split by time: the oldest initial_fraction
+     * is the initial index, the rest is inserted in time order (points
+     * without a time dimension keep their order). Each delete removes a
+     * uniformly chosen live point. Once the data to insert runs out, or
+     * nothing is left to delete, those operations become queries. Queries
+     * are generated over all the data, so they also cover points inserted
+     * later. (Throws std::invalid_argument if the stream has query
+     * operations but no queries can be generated, e.g. on empty data.)
+     */
+    MixedWorkload generateOperationStream(
+        const std::vector<DataPoint>& data,
+        const MixedWorkloadConfig& config);
+    
+    /**
+     * Exact fraction of the data each query returns (one parallel pass
+     * over the data for the whole workload)
+     */
+    static std::vector<double> measureSelectivity(
+        const std::vector<DataPoint>& data,
+        const std::vector<QueryRange>& workload);
+    
+    /**
+     * Exact selectivity of each query of the last workload generated with
+     * WorkloadConfig::calibrate (empty otherwise)
+     */
+    const std::vector<double>& getAchievedSelectivities() const { return achieved_selectivities_; }
+    
     /**
      * Save workload to file for reproducibility
      */
@@ -91,6 +289,7 @@ public:
 
 private:
     std::mt19937 rng_;
+    std::vector<double> achieved_selectivities_;
     
     // Helper functions
     QueryRange generateRandomQuery(
@@ -99,6 +298,8 @@ private:
         size_t dimensions,
         double selectivity);
     
+    const DataPoint& samplePoint(const std::vector<DataPoint>& data);
+    
     void computeDataBounds(
         const std::vector<DataPoint>& data,
         std::vector<double>& min_bounds,
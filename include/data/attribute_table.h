@@ -0,0 +1,74 @@
+#ifndef ATTRIBUTE_TABLE_H
+#define ATTRIBUTE_TABLE_H
+
+#include "data/data_point.h"
+#include <vector>
+#include <string>
+#include <unordered_map>
+#include <cstdint>
+#include <cstddef>
+
+namespace flood {
+
+/**
+ * Result of a projected query: the hits plus the requested attribute
+ * columns, stored columnar (columns[c][k] is column c of points[k])
+ */
+struct ProjectedResult {
+    std::vector<DataPoint> points;
+    std::vector<std::string> column_names;
+    std::vector<std::vector<double>> columns;
+};
+
+/**
+ * AttributeTable: named non-indexed columns (fare, tip, passenger count...)
+ * describing a point set row by row
+ *
+ * Row i describes the i-th point the table was created from, so a table
+ * handed to BaseIndex::setAttributes() lines up with the vector passed to
+ * build(). Each column is one contiguous array. The table also keeps an
+ * id -> row map for joining hits back by id when an index cannot gather
+ * attributes by position.
+ */
+class AttributeTable {
+public:
+    AttributeTable() = default;
+    explicit AttributeTable(const std::vector<DataPoint>& data);
+    
+    /**
+     * Add a column with one value per row (throws std::invalid_argument on
+     * a size mismatch or a duplicate name)
+     */
+    void addColumn(const std::string& name, std::vector<double> values);
+    
+    size_t numRows() const { return ids_.size(); }
+    size_t numColumns() const { return columns_.size(); }
+    const std::string& getName(size_t column) const { return names_[column]; }
+    const std::vector<double>& getColumn(size_t column) const { return columns_[column]; }
+    uint64_t getId(size_t row) const { return ids_[row]; }
+    
+    /**
+     * Position of a named column (throws std::invalid_argument if absent)
+     */
+    size_t findColumn(const std::string& name) const;
+    
+    /**
+     * Row of the point with the given id (throws std::out_of_range if absent)
+     */
+    size_t rowOf(uint64_t id) const;
+    
+    /**
+     * Fill result's columns for result.points, joining on the point ids
+     */
+    void project(const std::vector<std::string>& columns, ProjectedResult& result) const;
+
+private:
+    std::vector<uint64_t> ids_;
+    std::unordered_map<uint64_t, size_t> rows_;
+    std::vector<std::string> names_;
+    std::vector<std::vector<double>> columns_;
+};
+
+} // namespace flood
+
+#endif // ATTRIBUTE_TABLE_H
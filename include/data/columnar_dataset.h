@@ -0,0 +1,152 @@
+#ifndef COLUMNAR_DATASET_H
+#define COLUMNAR_DATASET_H
+
+#include "data/data_point.h"
+#include <vector>
+#include <string>
+#include <mutex>
+#include <cstdint>
+#include <cstddef>
+
+namespace flood {
+
+/**
+ * ColumnarDataset: read-only, memory-mapped columnar dataset file
+ *
+ * File layout (version 1, native little-endian):
+ * - Header: magic "FLOODCOL", version, header size, point count,
+ *   dimensions, column stride, endianness marker, then the per-dimension
+ *   min and max bounds; padded to a 4 KiB page
+ * - Id column: uint64_t[num_points]
+ * - One double[num_points] column per dimension
+ * Every column starts on a page boundary, so the file is mapped as is
+ * and columns are read in place without parsing or copying. The mapping
+ * is shared, so processes opening the same file share its page cache.
+ *
+ * Indexes still copy points into their own layouts; toDataPoints()
+ * materializes the DataPoint vector that BaseIndex::build() takes.
+ */
+class ColumnarDataset {
+public:
+    static constexpr uint32_t FORMAT_VERSION = 1;
+    static constexpr size_t PAGE_ALIGNMENT = 4096;
+    
+    /**
+     * Write data in the columnar format (throws std::runtime_error on I/O errors)
+     */
+    static void write(const std::vector<DataPoint>& data, const std::string& filepath);
+    
+    /**
+     * True if the file starts with the columnar format's magic
+     */
+    static bool isColumnarFile(const std::string& filepath);
+    
+    /**
+     * Map a columnar file (throws std::runtime_error if it cannot be opened
+     * or its header is invalid)
+     */
+    explicit ColumnarDataset(const std::string& filepath);
+    ~ColumnarDataset();
+    
+    ColumnarDataset(ColumnarDataset&& other) noexcept;
+    ColumnarDataset& operator=(ColumnarDataset&& other) noexcept;
+    ColumnarDataset(const ColumnarDataset&) = delete;
+    ColumnarDataset& operator=(const ColumnarDataset&) = delete;
+    
+    size_t size() const { return num_points_; }
+    size_t getDimensions() const { return dimensions_; }
+    
+    /**
+     * Zero-copy column access (size() values each)
+     */
+    const uint64_t* ids() const { return ids_; }
+    const double* column(size_t dim) const { return columns_[dim]; }
+    
+    double getMinBound(size_t dim) const { return min_bounds_[dim]; }
+    double getMaxBound(size_t dim) const { return max_bounds_[dim]; }
+    
+    /**
+     * Materialize one point / all points
+     */
+    DataPoint getPoint(size_t i) const;
+    std::vector<DataPoint> toDataPoints() const;
+    
+    /**
+     * Ask the kernel to read the whole file ahead (MADV_WILLNEED)
+     */
+    void prefetch() const;
+    
+    /**
+     * Drop the resident pages of rows [begin, end) (MADV_DONTNEED); they
+     * are read back from the file on next access. Lets streaming readers
+     * keep their footprint bounded on datasets larger than memory.
+     */
+    void release(size_t begin, size_t end) const;
+
+private:
+    void* mapping_;
+    size_t mapping_size_;
+    size_t num_points_;
+    size_t dimensions_;
+    const uint64_t* ids_;
+    std::vector<const double*> columns_;
+    const double* min_bounds_;
+    const double* max_bounds_;
+    
+    void unmap();
+};
+
+/**
+ * ColumnarWriter: writes a columnar dataset of known size piece by piece
+ *
+ * Rows go straight to their place in the file (pwrite), in any order and
+ * from any number of threads at once, so datasets far larger than memory
+ * can be produced without materializing them. The header, with the bounds
+ * of everything written, is written last by finish(); until then the file
+ * is not recognized as a columnar dataset.
+ */
+class ColumnarWriter {
+public:
+    /**
+     * Create (or truncate) the file at its final size (throws
+     * std::runtime_error on I/O errors)
+     */
+    ColumnarWriter(const std::string& filepath, size_t num_points, size_t dimensions);
+    ~ColumnarWriter();
+    
+    ColumnarWriter(const ColumnarWriter&) = delete;
+    ColumnarWriter& operator=(const ColumnarWriter&) = delete;
+    
+    /**
+     * Write rows [begin, begin + count): ids[count] and one double[count]
+     * per dimension (thread-safe; throws std::out_of_range past the end
+     * and std::runtime_error on I/O errors)
+     */
+    void writeRows(size_t begin, size_t count, const uint64_t* ids, const std::vector<const double*>& columns);
+    
+    /**
+     * Write the header and close the file; every row must have been written
+     */
+    void finish();
+    
+    size_t size() const { return num_points_; }
+    size_t getDimensions() const { return dimensions_; }
+
+private:
+    std::string filepath_;
+    int fd_;
+    size_t num_points_;
+    size_t dimensions_;
+    size_t header_bytes_;
+    size_t column_stride_;
+    
+    std::mutex bounds_mutex_;
+    std::vector<double> min_bounds_;
+    std::vector<double> max_bounds_;
+    
+    void writeAt(const void* data, size_t bytes, size_t offset);
+};
+
+} // namespace flood
+
+#endif // COLUMNAR_DATASET_H
@@ -0,0 +1,89 @@
+#ifndef CSV_PARSER_H
+#define CSV_PARSER_H
+
+#include "data/data_point.h"
+#include <vector>
+#include <string>
+#include <utility>
+
+namespace flood {
+
+/**
+ * Options for CSVParser
+ */
+struct CSVParseOptions {
+    char delimiter = ',';
+    bool has_header = true;
+    
+    // Columns to keep, in output dimension order. Either header names
+    // (case-insensitive, alternatives separated by '|') or, if names are
+    // empty, zero-based column positions; both empty keeps every column.
+    std::vector<std::string> column_names;
+    std::vector<size_t> columns;
+    
+    // Cleaning, fused into parsing: non-finite values are always dropped;
+    // if bounds is non-empty, output dimension i must lie in bounds[i]
+    std::vector<std::pair<double, double>> bounds;
+    
+    size_t num_threads = 0;           // 0 = all cores
+    size_t min_chunk_bytes = 1 << 20;  // Smallest chunk worth a parallel task
+};
+
+/**
+ * Row counts from the last parse
+ */
+struct CSVParseStats {
+    size_t rows_read = 0;
+    size_t rows_kept = 0;
+    size_t rows_malformed = 0;  // Missing or unparsable fields
+    size_t rows_filtered = 0;   // Parsed but outside the cleaning bounds
+    double elapsed_ms = 0.0;
+    
+    void print() const;
+};
+
+/**
+ * CSVParser: parallel CSV ingestion
+ * 
+ * The file is memory-mapped and cut into newline-aligned chunks that are
+ * parsed concurrently. Fields are converted in place with std::from_chars
+ * (no per-field strings); fields of the form "YYYY-MM-DD HH:MM:SS[.fff]"
+ * are converted to Unix seconds (UTC). Cleaning happens in the same pass,
+ * and ids are assigned to kept rows in file order. Quoted fields with
+ * embedded delimiters or newlines are not supported.
+ */
+class CSVParser {
+public:
+    explicit CSVParser(CSVParseOptions options = CSVParseOptions());
+    
+    /**
+     * Parse a file (throws std::runtime_error if it cannot be read or a
+     * named column is missing)
+     */
+    std::vector<DataPoint> parse(const std::string& filepath);
+    
+    const CSVParseStats& getStats() const { return stats_; }
+    
+    /**
+     * NYC taxi trips: longitude, latitude, pickup time, passenger count,
+     * trip distance. Rows outside the NYC box (lon -74.3..-73.7, lat
+     * 40.5..40.9), with a negative count or distance, or with a missing or
+     * unparsable field are dropped. tools/convert_nyc_data_with_zones.py
+     * applies the same box but fills missing values with 0 and keeps
+     * negative counts and distances, so its output can hold more rows.
+     */
+    static CSVParseOptions nycTaxiOptions();
+    
+    /**
+     * Parse one field as a number or a date-time (exposed for testing)
+     */
+    static bool parseField(const char* begin, const char* end, double& value);
+
+private:
+    CSVParseOptions options_;
+    CSVParseStats stats_;
+};
+
+} // namespace flood
+
+#endif // CSV_PARSER_H
@@ -0,0 +1,122 @@
+#ifndef SYNTHETIC_GENERATOR_H
+#define SYNTHETIC_GENERATOR_H
+
+#include "data/data_point.h"
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+namespace flood {
+
+/**
+ * Point distributions of SyntheticGenerator
+ */
+enum class Distribution {
+    UNIFORM,          // Uniform in [0, 100]^d
+    CLUSTERED,        // Gaussian clusters of random size and spread
+    CORRELATED,       // Close to the diagonal: all dimensions rise together
+    ANTI_CORRELATED,  // Close to the plane where dimensions sum to a constant
+    POWER_LAW,        // Density falling off as a power of the distance from the origin
+    NYC_TAXI          // Pickup longitude, latitude, time, passengers, distance
+};
+
+/**
+ * Names as used on the command line: uniform, clustered, correlated,
+ * anti-correlated, power-law, nyc (parseDistribution throws
+ * std::invalid_argument for an unknown name)
+ */
+Distribution parseDistribution(const std::string& name);
+const char* distributionName(Distribution distribution);
+
+/**
+ * Settings for SyntheticGenerator
+ */
+struct SyntheticConfig {
+    Distribution distribution = Distribution::UNIFORM;
+    size_t dimensions = 3;
+    uint64_t seed = 42;
+    size_t num_threads = 0;          // 0 = all cores
+    
+    // CLUSTERED: number of clusters and their typical standard deviation
+    // (domain units; each cluster gets 0.5x to 2x of it)
+    size_t num_clusters = 16;
+    double cluster_spread = 2.0;
+    
+    // CORRELATED / ANTI_CORRELATED: 1 puts every point on the line (plane),
+    // lower values add Gaussian noise of (1 - correlation) x 50 around it
+    double correlation = 0.9;
+    
+    // POWER_LAW: each coordinate is 100 x u^skew for uniform u, so the
+    // density falls off as x^(1/skew - 1)
+    double skew = 3.0;
+    
+    // NYC_TAXI: days of pickups, starting Monday 2024-01-01
+    size_t days = 30;
+};
+
+/**
+ * SyntheticGenerator: seedable, parallel synthetic datasets for scale tests
+ *
+ * Points are generated in fixed chunks, each from its own generator seeded
+ * by (seed, chunk), so point i is the same however many threads produce it
+ * and whether the data is materialized or streamed to a file. Ids are the
+ * point numbers 0 .. n - 1.
+ *
+ * NYC_TAXI mimics cleaned NYC yellow-taxi pickups in the column order of
+ * CSVParser::nycTaxiOptions(): a mixture of Gaussians over Manhattan (along
+ * the island's axis), the airports and the denser parts of Brooklyn,
+ * Queens and the Bronx; Unix times (local wall clock) with the hourly
+ * pickup profile and quieter weekends; mostly single passengers; and
+ * log-normal trip distances, longer from the airports. Further dimensions
+ * are uniform.
+ */
+class SyntheticGenerator {
+public:
+    static constexpr size_t CHUNK_POINTS = 1 << 16;
+    
+    /**
+     * Throws std::invalid_argument for settings out of range
+     */
+    explicit SyntheticGenerator(SyntheticConfig config = SyntheticConfig());
+    
+    /**
+     * Materialize points 0 .. num_points - 1
+     */
+    std::vector<DataPoint> generate(size_t num_points) const;
+    
+    /**
+     * Stream num_points to a file without holding them in memory: the
+     * columnar format if the name ends in .fcol, else the row binary format
+     * (throws std::runtime_error on I/O errors)
+     */
+    void writeFile(size_t num_points, const std::string& filepath) const;
+    
+    /**
+     * Coordinates of points [begin, end) into columns[dim][i - begin]
+     * (cheapest for ranges that start on a chunk boundary)
+     */
+    void generateColumns(size_t begin, size_t end, std::vector<std::vector<double>>& columns) const;
+    
+    const SyntheticConfig& getConfig() const { return config_; }
+
+private:
+    struct Cluster {
+        std::vector<double> center;
+        double spread;
+    };
+    
+    SyntheticConfig config_;
+    std::vector<Cluster> clusters_;
+    std::vector<double> cluster_weights_;
+    std::vector<double> time_weights_;  // NYC_TAXI: per hour of the period
+    
+    /**
+     * The first count points of a chunk into columns (resized to count)
+     */
+    void generateChunk(size_t chunk, size_t count, std::vector<std::vector<double>>& columns) const;
+};
+
+} // namespace flood
+
+#endif // SYNTHETIC_GENERATOR_H
@@ -2,8 +2,12 @@
 #define BASE_INDEX_H
 
 #include "data/data_point.h"
+#include "data/attribute_table.h"
+#include "indexes/coordinate_store.h"
 #include <vector>
 #include <string>
+#include <memory>
+#include <atomic>
 #include <chrono>
 
 namespace flood {
@@ -22,6 +26,28 @@ struct IndexMetrics {
     std::string toCSV() const;
 };
 
+/**
+ * Scan statistics counter. Increments are relaxed atomic adds, so
+ * concurrent query() calls neither race on it nor lose each other's
+ * counts; queries add to it a few times each (per run, not per point).
+ */
+class ScanCounter {
+public:
+    ScanCounter(size_t value = 0) : value_(value) {}
+    ScanCounter(const ScanCounter& other) : value_(other.get()) {}
+    ScanCounter& operator=(const ScanCounter& other) { set(other.get()); return *this; }
+    ScanCounter& operator=(size_t value) { set(value); return *this; }
+    ScanCounter& operator+=(size_t n) { value_.fetch_add(n, std::memory_order_relaxed); return *this; }
+    ScanCounter& operator++() { value_.fetch_add(1, std::memory_order_relaxed); return *this; }
+    operator size_t() const { return get(); }
+    
+private:
+    size_t get() const { return value_.load(std::memory_order_relaxed); }
+    void set(size_t value) { value_.store(value, std::memory_order_relaxed); }
+    
+    std::atomic<size_t> value_;
+};
+
 /**
  * BaseIndex: Abstract base class for all spatial indexes
  * All index implementations must inherit from this class
@@ -67,12 +93,103 @@ public:
      * Reset metrics
      */
     void resetMetrics();
+    
+    /**
+     * Scan instrumentation accumulated by query() since the last reset.
+     * Indexes that scan candidate points in contiguous runs report the
+     * points they examined and the number of runs; others leave both at 0.
+     * Composites add up their parts' counters when asked rather than
+     * moving them into their own after each query, so concurrent queries
+     * never read and reset shared counters.
+     */
+    virtual size_t getScannedPoints() const { return scanned_points_; }
+    virtual size_t getScannedRuns() const { return scanned_runs_; }
+    virtual void resetScanStats() { scanned_points_ = 0; scanned_runs_ = 0; }
+    
+    /**
+     * Whether query() may run on several threads at once on a built index.
+     * Indexes whose queries update shared state beyond the scan counters
+     * (routing logs, buffer pools, pending bucket builds) return false;
+     * concurrent drivers then issue their queries one at a time.
+     */
+    virtual bool supportsConcurrentQueries() const { return true; }
+    
+    /**
+     * Whether insert() adds points to a built index in place. Indexes that
+     * cannot (the default) only see new data after another build().
+     */
+    virtual bool supportsInserts() const { return false; }
+    
+    /**
+     * Add points to a built index
+     * (throws std::logic_error unless supportsInserts())
+     */
+    virtual void insert(const std::vector<DataPoint>& points);
+    
+    /**
+     * Empty any caches the index keeps itself (buffer pools, page cache),
+     * e.g. before a cold-cache query; composites forward to their parts.
+     * Nothing to do for in-memory indexes (the default).
+     */
+    virtual void dropCaches() {}
+    
+    /**
+     * Coordinate storage used by the next build() (see CoordinateStore).
+     * Indexes that keep their points in a flat array honor it (Flood,
+     * Z-order, Hilbert, Grid, Quadtree/Octree, and composites through their
+     * parts); pointer-based trees keep storing doubles. exact_recheck keeps
+     * a full-precision copy too (see CoordinateStore): exact results for
+     * 12 instead of 8 bytes per 32-bit coordinate, so it is opt-in.
+     */
+    virtual void setCoordinateStorage(CoordinateEncoding encoding, bool exact_recheck = false) {
+        coordinate_encoding_ = encoding;
+        exact_recheck_ = exact_recheck;
+    }
+    CoordinateEncoding getCoordinateEncoding() const { return coordinate_encoding_; }
+    
+    /**
+     * Attribute columns carried by the next build(); row i describes data[i].
+     * Flat-array indexes permute them into index order, so queryProjected()
+     * gathers a hit's attributes from where it was found; other indexes
+     * join hits back to the table by id.
+     */
+    void setAttributes(std::shared_ptr<const AttributeTable> attributes) { attributes_ = std::move(attributes); }
+    const AttributeTable* getAttributes() const { return attributes_.get(); }
+    
+    /**
+     * query() plus the requested attribute columns of every hit
+     * (throws std::invalid_argument for a column the index does not carry)
+     */
+    virtual ProjectedResult queryProjected(const QueryRange& range, const std::vector<std::string>& columns);
 
 protected:
     // Metrics tracking
     IndexMetrics metrics_;
     double build_time_ms_ = 0.0;
     size_t data_size_ = 0;
+    ScanCounter scanned_points_;
+    ScanCounter scanned_runs_;
+    
+    // Coordinate storage requested for the next build
+    CoordinateEncoding coordinate_encoding_ = CoordinateEncoding::DOUBLE;
+    bool exact_recheck_ = false;
+    
+    // Attribute columns for the next build
+    std::shared_ptr<const AttributeTable> attributes_;
+    
+    /**
+     * Index-ordered point storage that carries the attributes, if any
+     */
+    virtual const CoordinateStore* pointStore() const { return nullptr; }
+    
+    /**
+     * query() that also appends the pointStore() position of every hit, in
+     * result order, to positions (if given). Indexes with a point store
+     * override it and implement query() through it; the positions are per
+     * call, so projected queries may run concurrently with other queries.
+     * The default throws std::logic_error when asked for positions.
+     */
+    virtual std::vector<DataPoint> queryWithPositions(const QueryRange& range, std::vector<size_t>* positions);
     
     // Helper function to measure time
     class Timer {
@@ -0,0 +1,138 @@
+#ifndef COORDINATE_STORE_H
+#define COORDINATE_STORE_H
+
+#include "data/data_point.h"
+#include "data/attribute_table.h"
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+namespace flood {
+
+/**
+ * How an index stores point coordinates
+ * - DOUBLE:  full precision (8 bytes per coordinate)
+ * - FLOAT32: float offset from the dimension's minimum (4 bytes; relative
+ *            precision 2^-24 of the offset, e.g. ~1e-7 degrees across a
+ *            one-degree box, ~2 s across a year of Unix time)
+ * - FIXED32: 32-bit fixed point between the dimension's bounds (4 bytes;
+ *            2^-32 of the range)
+ */
+enum class CoordinateEncoding {
+    DOUBLE,
+    FLOAT32,
+    FIXED32
+};
+
+/**
+ * Parse "double", "float"/"float32" or "fixed"/"fixed32" (throws
+ * std::invalid_argument otherwise)
+ */
+CoordinateEncoding parseCoordinateEncoding(const std::string& name);
+std::string coordinateEncodingName(CoordinateEncoding encoding);
+
+/**
+ * CoordinateStore: flat, index-ordered point storage in one encoding
+ *
+ * Coordinates are stored row-major (one contiguous row of codes per point)
+ * with ids in a parallel array. Both 32-bit encodings are monotone in the
+ * coordinate, so a query box is compiled to code bounds by encoding its
+ * bounds: every point inside the box passes the code test (no false
+ * negatives). A point whose code is strictly inside the code bounds in
+ * every dimension is certainly inside the box; one that ties a code bound
+ * may lie just outside it. By default ties are accepted and hits carry
+ * decoded coordinates: results may include points within one quantization
+ * step outside the box. With exact_recheck, a full-precision copy of the
+ * coordinates is kept off the scan path and consulted only for those ties
+ * and for the hits returned, so results are exact, at 12 rather than 4
+ * bytes per coordinate (the copy outweighs the codes).
+ *
+ * Attribute columns passed to build() are permuted into the same order and
+ * kept columnar, so a projected query gathers a hit's attributes from the
+ * position it was found at instead of looking its id up.
+ */
+class CoordinateStore {
+public:
+    /**
+     * A query box compiled against a store's encoding
+     */
+    struct Box {
+        std::vector<double> lo, hi;
+        std::vector<uint32_t> lo_fixed, hi_fixed;
+        std::vector<float> lo_float, hi_float;
+        // Bound lies beyond the data, so ties on it are certain hits
+        std::vector<uint8_t> lo_open, hi_open;
+    };
+    
+    CoordinateStore();
+    
+    /**
+     * Store data[order[0]], data[order[1]], ... in that order, with the
+     * matching rows of attributes if given (its rows must line up with data)
+     */
+    void build(const std::vector<DataPoint>& data, const std::vector<size_t>& order,
+               CoordinateEncoding encoding, bool exact_recheck = false,
+               const AttributeTable* attributes = nullptr);
+    void clear();
+    
+    size_t size() const { return ids_.size(); }
+    bool empty() const { return ids_.empty(); }
+    size_t getDimensions() const { return dimensions_; }
+    CoordinateEncoding getEncoding() const { return encoding_; }
+    
+    Box compile(const QueryRange& range) const;
+    
+    /**
+     * Append the points of [begin, end) inside the box / all of them, and
+     * their positions to positions if given (for projected queries)
+     */
+    void scan(size_t begin, size_t end, const Box& box, std::vector<DataPoint>& out,
+              std::vector<size_t>* positions = nullptr) const;
+    void append(size_t begin, size_t end, std::vector<DataPoint>& out,
+                std::vector<size_t>* positions = nullptr) const;
+    
+    DataPoint get(size_t i) const;
+    
+    bool hasAttributes() const { return !attribute_names_.empty(); }
+    
+    /**
+     * Gather the named attribute columns at the given positions into
+     * result (throws std::invalid_argument for an unknown column)
+     */
+    void project(const std::vector<size_t>& positions, const std::vector<std::string>& columns,
+                 ProjectedResult& result) const;
+    
+    /**
+     * Bytes per stored point, including the id, any exact copy and the
+     * attribute columns
+     */
+    size_t bytesPerPoint() const;
+
+private:
+    CoordinateEncoding encoding_;
+    size_t dimensions_;
+    std::vector<uint64_t> ids_;
+    std::vector<double> doubles_;   // DOUBLE codes, or the exact copy
+    std::vector<float> floats_;
+    std::vector<uint32_t> fixed_;
+    std::vector<double> min_bounds_;
+    std::vector<double> max_bounds_;
+    std::vector<double> scale_;     // FIXED32 step per code
+    std::vector<double> inv_scale_;
+    std::vector<std::string> attribute_names_;
+    std::vector<std::vector<double>> attributes_;   // Index order
+    
+    uint32_t encodeFixed(double value, size_t dim) const;
+    float encodeFloat(double value, size_t dim) const;
+    bool hasExact() const { return encoding_ != CoordinateEncoding::DOUBLE && !doubles_.empty(); }
+    
+    template <typename Code>
+    void scanCodes(const Code* codes, const Code* lo, const Code* hi,
+                   size_t begin, size_t end, const Box& box, std::vector<DataPoint>& out,
+                   std::vector<size_t>* positions) const;
+};
+
+} // namespace flood
+
+#endif // COORDINATE_STORE_H
@@ -0,0 +1,135 @@
+#ifndef CURVE_INDEX_H
+#define CURVE_INDEX_H
+
+#include "indexes/base_index.h"
+#include "indexes/space_filling_curve.h"
+#include "indexes/coordinate_store.h"
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+
+namespace flood {
+
+/**
+ * CurveIndex: Common base for space-filling-curve (linearized) indexes
+ *
+ * Every dimension is normalized to an integer cell coordinate with its own
+ * bit budget, and the cells are mapped to a 128-bit curve key by
+ * encodeCells(). Budgets come from the data: a dimension gets about
+ * log2(distinct values) bits (log2(n) + 1 if it looks continuous), and the
+ * widest dimensions are trimmed until the total fits in 128 bits.
+ *
+ * Points are stored in a flat array sorted by key (duplicates kept). A
+ * query box is decomposed into a bounded number of key ranges by refining
+ * aligned cells, so only those runs of the array are scanned and filtered.
+ *
+ * Key layout is level-interleaved from the least significant bit: level j
+ * holds bit j of every dimension whose budget exceeds j, higher dimensions
+ * in higher positions. Subclasses choose the curve within that layout.
+ */
+class CurveIndex : public BaseIndex {
+public:
+    /**
+     * @param max_key_ranges Upper bound on the number of key ranges a query
+     *                       box is decomposed into (more ranges = less
+     *                       over-scan, more binary searches)
+     */
+    explicit CurveIndex(size_t max_key_ranges = 64);
+    ~CurveIndex() override = default;
+    
+    void build(const std::vector<DataPoint>& data) override;
+    std::vector<DataPoint> query(const QueryRange& range) override;
+    double getIndexSize() const override;
+    
+    /**
+     * Bits of each dimension that went into the key (valid after build)
+     */
+    const std::vector<uint32_t>& getKeyBits() const { return key_bits_; }
+    
+    /**
+     * Cell coordinate of value within [min_bound, max_bound], scaled to
+     * [0, 2^bits - 1] and clamped (0 for a degenerate range)
+     */
+    static uint32_t normalizeToCell(double value, double min_bound, double max_bound, uint32_t bits) {
+        double range = max_bound - min_bound;
+        if (bits == 0 || range < 1e-10) return 0;  // Avoid division by zero
+        
+        double normalized = (value - min_bound) / range;
+        normalized = std::max(0.0, std::min(1.0, normalized));
+        
+        const double MAX_VAL = static_cast<double>((uint64_t(1) << bits) - 1);
+        return static_cast<uint32_t>(normalized * MAX_VAL);
+    }
+
+protected:
+    using Key = sfc::Key128;
+    
+    /**
+     * Map normalized cell coordinates (one per dimension, dimension i in
+     * [0, 2^key_bits_[i] - 1]) to a curve key
+     */
+    virtual Key encodeCells(const uint32_t* cells) const = 0;
+    
+    /**
+     * Hook to adjust the data-driven bit budgets before the key layout is
+     * fixed (the total must stay within 128 bits)
+     */
+    virtual void adjustKeyBits(std::vector<uint32_t>& /*bits*/) const {}
+    
+    /**
+     * Whether range decomposition must refine a whole level at a time.
+     * Morton keys can be refined one key bit at a time because every key
+     * bit splits one fixed dimension; Hilbert keys only align to cells at
+     * level boundaries.
+     */
+    virtual bool refinesByLevel() const { return false; }
+    
+    /**
+     * Morton interleave of cells under the current key layout
+     */
+    Key interleave(const uint32_t* cells) const;
+    
+    // Normalize coordinate to [0, 2^key_bits_[dim] - 1]
+    uint32_t normalizeCoordinate(double value, size_t dim) const;
+    
+    size_t dimensions_;
+    std::vector<uint32_t> key_bits_;  // Bit budget per dimension
+    uint32_t total_key_bits_;
+
+private:
+    // Curve keys sorted ascending; point i of points_ has key keys_[i]
+    std::vector<Key> keys_;
+    CoordinateStore points_;
+    size_t max_key_ranges_;
+    const CoordinateStore* pointStore() const override { return &points_; }
+    std::vector<DataPoint> queryWithPositions(const QueryRange& range, std::vector<size_t>* positions) override;
+    
+    // Normalization bounds for computing keys
+    std::vector<double> min_bounds_;
+    std::vector<double> max_bounds_;
+    
+    // Key layout: per-dimension deposit masks for the low and high 64-bit
+    // halves, and for each key bit from the most significant, the
+    // (dimension, coordinate bit) it holds
+    std::vector<uint64_t> mask_lo_;
+    std::vector<uint64_t> mask_hi_;
+    std::vector<uint32_t> mask_lo_bits_;
+    std::vector<std::pair<uint32_t, uint32_t>> layout_;
+    // 2 or 3 when every dimension has the same budget of at most
+    // sfc::MORTON_BITS, so the layout is the plain 2D/3D Morton code
+    // (sfc::mortonEncode2D/3D, magic numbers without BMI2); else 0
+    uint32_t morton_dims_ = 0;
+    
+    void chooseKeyBits(const std::vector<DataPoint>& data);
+    void buildKeyLayout();
+    Key computeKey(const DataPoint& point, std::vector<uint32_t>& cells) const;
+    
+    // Range decomposition for query: sorted, non-overlapping key ranges
+    // covering every cell the query box touches
+    void getRangeKeys(const QueryRange& range,
+                     std::vector<std::pair<Key, Key>>& key_ranges) const;
+};
+
+} // namespace flood
+
+#endif // CURVE_INDEX_H
@@ -0,0 +1,93 @@
+#ifndef DISK_FLOOD_INDEX_H
+#define DISK_FLOOD_INDEX_H
+
+#include "indexes/base_index.h"
+#include "indexes/flood_disk_format.h"
+#include "utils/buffer_pool.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace flood {
+
+/**
+ * Options for DiskFloodIndex
+ */
+struct DiskIndexOptions {
+    size_t buffer_pool_bytes = size_t(64) << 20;
+    size_t block_size = fidx::DEFAULT_BLOCK_SIZE;  // Used when build() writes the file
+    size_t readahead_blocks = 32;   // Blocks pinned and read per batch
+    bool direct_io = false;         // O_DIRECT: bypass the page cache, so
+                                    // the buffer pool is the only cache
+};
+
+/**
+ * DiskFloodIndex: Flood index served from an on-disk block file
+ *
+ * The sorted array lives in a .fidx file (see flood_disk_format.h); only
+ * the header (projection, bounds) and the block directory (min/max key
+ * per block) are held in memory. A query maps its box to one key
+ * interval, binary searches the directory for the blocks that interval
+ * spans, and scans them through a CLOCK BufferPool in batches: each batch
+ * is pinned with one coalesced preadv per run of missing blocks, and the
+ * next batch is handed to the kernel as a readahead hint while the current
+ * one is filtered. When the working set exceeds the pool, queries pay for
+ * the blocks they miss rather than failing or thrashing the whole index.
+ *
+ * build() writes the file with FloodExternalBuilder (through a temporary
+ * columnar file) and removes it again on destruction; open() serves an
+ * existing file, e.g. one written by the build_index tool.
+ */
+class DiskFloodIndex : public BaseIndex {
+public:
+    explicit DiskFloodIndex(std::string index_path, DiskIndexOptions options = DiskIndexOptions());
+    ~DiskFloodIndex() override;
+    
+    DiskFloodIndex(const DiskFloodIndex&) = delete;
+    DiskFloodIndex& operator=(const DiskFloodIndex&) = delete;
+    
+    void build(const std::vector<DataPoint>& data) override;
+    std::vector<DataPoint> query(const QueryRange& range) override;
+    
+    /**
+     * Memory-resident footprint: directory plus buffer pool (MB)
+     */
+    double getIndexSize() const override;
+    std::string getName() const override { return "Flood-disk"; }
+    bool supportsConcurrentQueries() const override { return false; }  // The buffer pool is not thread-safe
+    
+    /**
+     * Serve an existing index file (throws std::runtime_error if it cannot
+     * be read or is not a valid index)
+     */
+    void open();
+    
+    /**
+     * Empty the buffer pool and the file's page cache (cold-cache runs)
+     */
+    void dropCaches() override;
+    
+    const BufferPoolStats& getPoolStats() const;
+    void resetPoolStats();
+    
+    size_t getNumBlocks() const { return directory_.size(); }
+
+private:
+    std::string index_path_;
+    DiskIndexOptions options_;
+    bool owns_file_;
+    int fd_;
+    
+    fidx::FileHeader header_;
+    std::vector<double> projection_;
+    std::vector<double> min_bounds_;
+    std::vector<double> max_bounds_;
+    std::vector<fidx::BlockEntry> directory_;
+    std::unique_ptr<BufferPool> pool_;
+    
+    void close();
+};
+
+} // namespace flood
+
+#endif // DISK_FLOOD_INDEX_H
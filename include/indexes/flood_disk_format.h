@@ -0,0 +1,62 @@
+#ifndef FLOOD_DISK_FORMAT_H
+#define FLOOD_DISK_FORMAT_H
+
+#include <cstdint>
+#include <cstddef>
+
+namespace flood {
+
+/**
+ * On-disk Flood index layout (".fidx", version 1, native little-endian)
+ *
+ * - Header: FileHeader, then projection[d], min_bounds[d], max_bounds[d];
+ *   padded to a whole block
+ * - Data: num_blocks blocks of block_size bytes. Each holds up to
+ *   records_per_block records in flattened-key order; records never
+ *   straddle a block, and the tail of a block is zero padding
+ * - Directory: one BlockEntry per block, in key order
+ *
+ * A record is {double key, uint64_t id, double coords[d]}. Keys are the
+ * same flattened keys FloodIndex sorts by, so a query maps to one key
+ * interval and, through the directory, to a contiguous run of blocks.
+ */
+namespace fidx {
+
+constexpr char MAGIC[8] = {'F', 'L', 'O', 'O', 'D', 'I', 'D', 'X'};
+constexpr uint32_t FORMAT_VERSION = 1;
+constexpr size_t DEFAULT_BLOCK_SIZE = 4096;
+
+struct FileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t block_size;
+    uint64_t num_points;
+    uint64_t dimensions;
+    uint64_t record_size;
+    uint64_t records_per_block;
+    uint64_t num_blocks;
+    uint64_t data_offset;       // Offset of block 0 (the padded header size)
+    uint64_t directory_offset;
+};
+
+struct BlockEntry {
+    double min_key;
+    double max_key;
+    uint64_t first_record;  // Global position of the block's first record
+    uint64_t count;
+};
+
+inline size_t recordSize(size_t dims) {
+    return sizeof(double) + sizeof(uint64_t) + dims * sizeof(double);
+}
+
+inline size_t headerBytes(size_t dims, size_t block_size) {
+    size_t bytes = sizeof(FileHeader) + 3 * dims * sizeof(double);
+    return (bytes + block_size - 1) / block_size * block_size;
+}
+
+} // namespace fidx
+
+} // namespace flood
+
+#endif // FLOOD_DISK_FORMAT_H
@@ -0,0 +1,71 @@
+#ifndef FLOOD_EXTERNAL_BUILDER_H
+#define FLOOD_EXTERNAL_BUILDER_H
+
+#include "data/columnar_dataset.h"
+#include "indexes/flood_disk_format.h"
+#include <string>
+#include <cstddef>
+
+namespace flood {
+
+/**
+ * Options for FloodExternalBuilder
+ */
+struct ExternalBuildOptions {
+    size_t memory_budget_bytes = size_t(256) << 20;
+    size_t block_size = fidx::DEFAULT_BLOCK_SIZE;
+    std::string temp_dir;  // Sorted runs go here; empty = next to the index file
+};
+
+/**
+ * Figures from the last build
+ */
+struct ExternalBuildStats {
+    size_t points = 0;
+    size_t runs = 0;                 // Sorted runs written by run generation
+    size_t merge_passes = 0;         // 0 if the data fit in a single run
+    size_t peak_buffer_bytes = 0;    // Largest total of live sort/I/O buffers
+    size_t blocks = 0;
+    double elapsed_ms = 0.0;
+    
+    void print() const;
+};
+
+/**
+ * FloodExternalBuilder: out-of-core build of an on-disk Flood index
+ *
+ * Builds the same layout FloodIndex keeps in memory (points sorted by the
+ * variance-weighted flattened key) for datasets that do not fit in RAM:
+ * 1. One streaming pass over the columns computes per-dimension variances
+ *    (Welford); bounds come from the dataset header
+ * 2. Run generation reads row chunks sized to the memory budget, computes
+ *    keys, sorts each chunk and writes it as a run file
+ * 3. Runs are k-way merged with a heap, fan-in limited by the budget, in
+ *    as many passes as needed; the last pass writes the block file
+ *    (see flood_disk_format.h) and its directory
+ *
+ * Sort and I/O buffers stay within memory_budget_bytes; input pages are
+ * released as they are consumed. The block directory (32 bytes per block)
+ * is the only state that grows with the data. Temporary runs are removed
+ * even if the build fails.
+ */
+class FloodExternalBuilder {
+public:
+    explicit FloodExternalBuilder(ExternalBuildOptions options = ExternalBuildOptions());
+    
+    /**
+     * Build the index file (throws std::runtime_error on I/O errors and
+     * std::invalid_argument if a block cannot hold one record)
+     */
+    void build(const ColumnarDataset& input, const std::string& index_path);
+    
+    const ExternalBuildStats& getStats() const { return stats_; }
+
+private:
+    ExternalBuildOptions options_;
+    ExternalBuildStats stats_;
+};
+
+} // namespace flood
+
+#endif // FLOOD_EXTERNAL_BUILDER_H
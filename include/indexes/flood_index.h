@@ -2,8 +2,10 @@
 #define FLOOD_INDEX_H
 
 #include "indexes/base_index.h"
+#include "indexes/coordinate_store.h"
 #include <map>
 #include <functional>
+#include <ostream>
 
 namespace flood {
 
@@ -31,10 +33,38 @@ public:
      * This should be called after build() but before query()
      */
     void train(const std::vector<QueryRange>& training_queries);
+    
+    /**
+     * Enable/disable build and training progress output
+     */
+    void setVerbose(bool v) { verbose_ = v; }
+    
+    /**
+     * Projection weights build() derives from per-dimension variances
+     * (shared with the out-of-core builder, which streams the variances)
+     */
+    static std::vector<double> projectionFromVariances(const std::vector<double>& variances);
+    
+    /**
+     * Flattened key of raw coordinates: projection · coordinates normalized
+     * to [0, 1] by the bounds
+     */
+    static double flattenedKey(const double* coords,
+                               const std::vector<double>& projection,
+                               const std::vector<double>& min_bounds,
+                               const std::vector<double>& max_bounds) {
+        return flattenKey([coords](size_t i) { return coords[i]; },
+                          projection, min_bounds, max_bounds);
+    }
 
 private:
-    // Flattened 1D representation of data
-    std::vector<DataPoint> flattened_data_;
+    // Flattened 1D representation of data, and each point's flattened key
+    // (rounded to float: the rounding is monotone, so searches stay
+    // conservative and the scan filters exactly)
+    CoordinateStore flattened_data_;
+    std::vector<float> flattened_keys_;
+    const CoordinateStore* pointStore() const override { return &flattened_data_; }
+    std::vector<DataPoint> queryWithPositions(const QueryRange& range, std::vector<size_t>* positions) override;
     
     // Mapping from 1D position to original data point index
     std::vector<size_t> position_map_;
@@ -60,8 +90,32 @@ private:
     // The flattening function maps N-D space to 1-D line
     std::vector<double> projection_vector_;
     
+    bool verbose_;
+    
     // Helper functions
     
+    template <typename Coord>
+    static double flattenKey(Coord coord,
+                             const std::vector<double>& projection,
+                             const std::vector<double>& min_bounds,
+                             const std::vector<double>& max_bounds) {
+        double key = 0.0;
+        for (size_t i = 0; i < projection.size(); ++i) {
+            // Normalize coordinate to [0, 1]
+            double range = max_bounds[i] - min_bounds[i];
+            double normalized = (range > 1e-10) ?
+                (coord(i) - min_bounds[i]) / range : 0.0;
+            
+            key += projection[i] * normalized;
+        }
+        return key;
+    }
+    
+    /**
+     * Progress output stream (discards output when not verbose)
+     */
+    std::ostream& log() const;
+    
     /**
      * Compute the 1D flattened key for a data point
      */
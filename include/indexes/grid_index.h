@@ -0,0 +1,70 @@
+#ifndef GRID_INDEX_H
+#define GRID_INDEX_H
+
+#include "indexes/base_index.h"
+#include "indexes/coordinate_store.h"
+#include <vector>
+#include <cstdint>
+
+namespace flood {
+
+/**
+ * Grid file index: the simplest baseline Flood should beat
+ * 
+ * Each dimension is cut into a fixed number of partitions, either at
+ * equal-width boundaries (uniform) or at quantiles of the data
+ * (equi-depth). A dense cell directory stores the offset of each cell's
+ * points, which are kept contiguously in cell order. A query enumerates
+ * the cells its box overlaps; points in cells fully inside the box are
+ * copied without checks, only boundary cells are filtered exactly.
+ */
+class GridIndex : public BaseIndex {
+public:
+    /**
+     * @param target_cell_size Desired average number of points per cell
+     * @param equi_depth Quantile boundaries (true) or equal-width (false)
+     */
+    explicit GridIndex(size_t target_cell_size = 64, bool equi_depth = true);
+    ~GridIndex() override = default;
+    
+    void build(const std::vector<DataPoint>& data) override;
+    std::vector<DataPoint> query(const QueryRange& range) override;
+    double getIndexSize() const override;
+    std::string getName() const override { return equi_depth_ ? "Grid" : "Uniform Grid"; }
+    
+    /**
+     * Number of cells in the directory (valid after build)
+     */
+    size_t getNumCells() const { return cell_offsets_.empty() ? 0 : cell_offsets_.size() - 1; }
+
+private:
+    size_t target_cell_size_;
+    bool equi_depth_;
+    size_t dimensions_;
+    
+    // Inner boundaries per dimension; a value v falls in partition
+    // upper_bound(boundaries, v), so dimension i has boundaries.size() + 1
+    // partitions
+    std::vector<std::vector<double>> boundaries_;
+    std::vector<size_t> strides_;  // Directory stride of each dimension (dimension 0 is 1)
+    
+    // Outer edges of the data, used to decide if edge partitions are covered
+    std::vector<double> min_bounds_;
+    std::vector<double> max_bounds_;
+    
+    // Dense directory: cell c holds positions [cell_offsets_[c], cell_offsets_[c + 1]) in points_
+    std::vector<size_t> cell_offsets_;
+    CoordinateStore points_;
+    const CoordinateStore* pointStore() const override { return &points_; }
+    std::vector<DataPoint> queryWithPositions(const QueryRange& range, std::vector<size_t>* positions) override;
+    
+    // Helper functions
+    size_t partitionsPerDimension(size_t num_points) const;
+    void computeBoundaries(const std::vector<DataPoint>& data, size_t partitions);
+    size_t partitionOf(double value, size_t dim) const;
+    size_t cellOf(const DataPoint& point) const;
+};
+
+} // namespace flood
+
+#endif // GRID_INDEX_H
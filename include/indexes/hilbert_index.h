@@ -0,0 +1,33 @@
+#ifndef HILBERT_INDEX_H
+#define HILBERT_INDEX_H
+
+#include "indexes/curve_index.h"
+
+namespace flood {
+
+/**
+ * Hilbert curve implementation
+ * Same storage and query machinery as Z-order (see CurveIndex), but
+ * consecutive keys are always adjacent cells, so a query box maps to
+ * fewer and shorter key runs.
+ *
+ * Every dimension gets the same bit budget (floor(128 / d) at most), and
+ * range decomposition refines one full level (2^d cells) at a time, so the
+ * range budget is raised to at least 4 * 2^d.
+ */
+class HilbertIndex : public CurveIndex {
+public:
+    explicit HilbertIndex(size_t max_key_ranges = 64);
+    ~HilbertIndex() override = default;
+    
+    std::string getName() const override { return "Hilbert"; }
+
+protected:
+    Key encodeCells(const uint32_t* cells) const override;
+    void adjustKeyBits(std::vector<uint32_t>& bits) const override;
+    bool refinesByLevel() const override { return true; }
+};
+
+} // namespace flood
+
+#endif // HILBERT_INDEX_H
@@ -0,0 +1,87 @@
+#ifndef QUADTREE_INDEX_H
+#define QUADTREE_INDEX_H
+
+#include "indexes/base_index.h"
+#include "indexes/coordinate_store.h"
+#include <vector>
+#include <cstdint>
+
+namespace flood {
+
+/**
+ * Bucketed point-region quadtree (2-D) / octree (3-D)
+ * 
+ * Every node splits its box at the midpoint of the first split_dims
+ * dimensions into 2^split_dims children, until a node holds at most
+ * bucket_size points (or the depth limit is hit). Dense areas get deep
+ * trees and sparse areas stay shallow, which suits skewed data such as
+ * taxi pickups. Further dimensions are not split on and are only checked
+ * when filtering.
+ * 
+ * Nodes live in one flat array; the children of a node are contiguous and
+ * every node carries its locational code (a sentinel 1 bit followed by
+ * split_dims path bits per level), from which its box is derived. Points
+ * are stored in leaf order, so each subtree owns a contiguous range and
+ * subtrees fully inside a query are copied without checks.
+ */
+class QuadtreeIndex : public BaseIndex {
+public:
+    /**
+     * @param bucket_size Maximum number of points in a leaf
+     * @param max_split_dims Dimensions to split on (2 = quadtree, 3 = octree)
+     */
+    explicit QuadtreeIndex(size_t bucket_size = 64, size_t max_split_dims = 3);
+    ~QuadtreeIndex() override = default;
+    
+    void build(const std::vector<DataPoint>& data) override;
+    std::vector<DataPoint> query(const QueryRange& range) override;
+    double getIndexSize() const override;
+    // Named by configuration, so the name is the same before and after build
+    std::string getName() const override { return max_split_dims_ == 3 ? "Octree" : "Quadtree"; }
+    
+    /**
+     * Number of nodes and depth of the deepest leaf (valid after build)
+     */
+    size_t getNumNodes() const { return nodes_.size(); }
+    size_t getMaxDepth() const { return max_depth_reached_; }
+
+private:
+    static constexpr uint32_t NO_CHILDREN = 0;
+    
+    struct Node {
+        uint64_t code;         // Locational code (sentinel bit + path)
+        uint32_t first_child;  // Index of the first of 2^split_dims children, NO_CHILDREN for leaves
+        uint32_t begin;        // Points of the subtree: positions [begin, end) in points_
+        uint32_t end;
+    };
+    
+    size_t bucket_size_;
+    size_t max_split_dims_;
+    size_t split_dims_;
+    size_t dimensions_;
+    uint32_t depth_limit_;
+    size_t max_depth_reached_;
+    
+    std::vector<Node> nodes_;
+    CoordinateStore points_;
+    const CoordinateStore* pointStore() const override { return &points_; }
+    std::vector<DataPoint> queryWithPositions(const QueryRange& range, std::vector<size_t>* positions) override;
+    
+    // Root box (data bounds)
+    std::vector<double> min_bounds_;
+    std::vector<double> max_bounds_;
+    
+    // Helper functions
+    void buildNode(const std::vector<DataPoint>& data, std::vector<uint32_t>& order,
+                   std::vector<uint32_t>& scratch, size_t node_idx, uint32_t depth);
+    
+    // Coordinate of the boundary `numer / 2^depth` of the way across dim
+    double boundary(size_t dim, uint64_t numer, uint32_t depth) const;
+    
+    // Depth of a node and its integer cell coordinate in each split dimension
+    uint32_t decodeCode(uint64_t code, uint64_t* cells) const;
+};
+
+} // namespace flood
+
+#endif // QUADTREE_INDEX_H
@@ -0,0 +1,138 @@
+#ifndef ROUTER_INDEX_H
+#define ROUTER_INDEX_H
+
+#include "indexes/base_index.h"
+#include <vector>
+#include <memory>
+
+namespace flood {
+
+/**
+ * One routing decision, in query order
+ */
+struct RoutingDecision {
+    size_t index;          // Position of the chosen index
+    double predicted_ms;   // Its predicted latency
+    double actual_ms;      // Its measured latency
+};
+
+/**
+ * Router quality against an oracle that always picks the fastest index
+ */
+struct RegretReport {
+    size_t queries = 0;
+    double router_ms = 0.0;       // Total latency of the routed choices
+    double oracle_ms = 0.0;       // Total latency of the per-query best choices
+    double best_single_ms = 0.0;  // Total latency of the best fixed index
+    size_t optimal_picks = 0;     // Queries where the router chose the fastest index
+    
+    double regret() const { return router_ms - oracle_ms; }
+    void print() const;
+};
+
+/**
+ * RouterIndex: sends each query to the index predicted to be fastest
+ * 
+ * Holds several indexes over the same data. Each query is described by a
+ * few cheap features derived from per-dimension equi-depth histograms
+ * (estimated result rows, its log, and the log selectivity in every
+ * dimension), and a linear latency model per index, fit by least squares,
+ * predicts which index answers it fastest.
+ * 
+ * Models are calibrated from measured per-query latencies: either pass
+ * training queries to train() and they are timed on every index during
+ * build(), or feed latencies recorded elsewhere (e.g.
+ * BenchmarkResult::query_times_ms) to calibrate(). Until calibrated,
+ * every query goes to the first index.
+ */
+class RouterIndex : public BaseIndex {
+public:
+    explicit RouterIndex(std::vector<std::shared_ptr<BaseIndex>> indexes);
+    ~RouterIndex() override = default;
+    
+    void build(const std::vector<DataPoint>& data) override;
+    std::vector<DataPoint> query(const QueryRange& range) override;
+    double getIndexSize() const override;
+    std::string getName() const override { return "Router"; }
+    bool supportsConcurrentQueries() const override { return false; }  // Appends to the routing log
+    
+    /**
+     * Own counters plus those of every part
+     */
+    size_t getScannedPoints() const override;
+    size_t getScannedRuns() const override;
+    void resetScanStats() override;
+    
+    /**
+     * Applies to every member index
+     */
+    void setCoordinateStorage(CoordinateEncoding encoding, bool exact_recheck = false) override;
+    void dropCaches() override;
+    
+    /**
+     * Training queries timed on every index at the end of build()
+     */
+    void train(const std::vector<QueryRange>& training_queries);
+    
+    /**
+     * Fit the latency models (call after build())
+     * @param queries Calibration queries
+     * @param latencies_ms latencies_ms[i][q] = latency of index i on query q
+     */
+    void calibrate(const std::vector<QueryRange>& queries,
+                   const std::vector<std::vector<double>>& latencies_ms);
+    
+    bool isCalibrated() const { return calibrated_; }
+    
+    /**
+     * Index a query would be routed to, and its predicted latency
+     */
+    size_t route(const QueryRange& range, double* predicted_ms = nullptr) const;
+    
+    /**
+     * Run every query on every index, compare the routed choices with the
+     * per-query fastest index (not recorded in the routing log)
+     */
+    RegretReport evaluateRegret(const std::vector<QueryRange>& queries);
+    
+    const std::vector<RoutingDecision>& getRoutingLog() const { return routing_log_; }
+    void clearRoutingLog() { routing_log_.clear(); }
+    
+    /**
+     * How many logged queries went to each index
+     */
+    std::vector<size_t> getRouteCounts() const;
+    
+    const std::vector<std::shared_ptr<BaseIndex>>& getIndexes() const { return indexes_; }
+
+private:
+    std::vector<std::shared_ptr<BaseIndex>> indexes_;
+    size_t dimensions_;
+    
+    // Equi-depth histogram per dimension: HISTOGRAM_BUCKETS + 1 quantiles
+    std::vector<std::vector<double>> quantiles_;
+    
+    // Linear latency model per index over extractFeatures()
+    std::vector<std::vector<double>> weights_;
+    bool calibrated_;
+    
+    std::vector<QueryRange> training_queries_;
+    std::vector<RoutingDecision> routing_log_;
+    
+    // Helper functions
+    void buildHistograms(const std::vector<DataPoint>& data);
+    double estimateSelectivity(double lo, double hi, size_t dim) const;
+    std::vector<double> extractFeatures(const QueryRange& range) const;
+    std::vector<std::vector<double>> measureLatencies(const std::vector<QueryRange>& queries);
+    
+    /**
+     * Least squares weights for y ~ X (rows of X are feature vectors), with
+     * a small ridge term to keep the system well conditioned
+     */
+    static std::vector<double> fitLinear(const std::vector<std::vector<double>>& X,
+                                         const std::vector<double>& y);
+};
+
+} // namespace flood
+
+#endif // ROUTER_INDEX_H
@@ -0,0 +1,98 @@
+#ifndef SHARDED_INDEX_H
+#define SHARDED_INDEX_H
+
+#include "indexes/base_index.h"
+#include "utils/thread_pool.h"
+#include <vector>
+#include <memory>
+#include <functional>
+
+namespace flood {
+
+/**
+ * How ShardedIndex assigns points to shards
+ */
+enum class ShardPartitioning {
+    KEY_RANGE,    // Equal-count ranges of dimension 0
+    SPACE,        // Recursive median bisection of the widest dimension
+    ROUND_ROBIN   // Point i goes to shard i mod N
+};
+
+/**
+ * ShardedIndex: scatter-gather wrapper over N independent indexes
+ * 
+ * The data is partitioned into N shards, each indexed by its own instance
+ * of any BaseIndex type (created by a factory) and built in parallel. A
+ * query is sent only to shards whose bounding box intersects it; those
+ * run concurrently on a thread pool and their results are moved into one
+ * vector. KEY_RANGE and SPACE give tight shard boxes, so small queries
+ * touch few shards; ROUND_ROBIN spreads every query over all shards, which
+ * gives the most parallelism for large ones.
+ */
+class ShardedIndex : public BaseIndex {
+public:
+    using IndexFactory = std::function<std::shared_ptr<BaseIndex>()>;
+    
+    /**
+     * @param factory Creates one (unbuilt) index per shard
+     * @param num_shards Number of shards
+     * @param partitioning How points are assigned to shards
+     * @param num_threads Pool workers (0 = hardware concurrency - 1)
+     */
+    ShardedIndex(IndexFactory factory, size_t num_shards,
+                 ShardPartitioning partitioning = ShardPartitioning::SPACE,
+                 size_t num_threads = 0);
+    ~ShardedIndex() override = default;
+    
+    void build(const std::vector<DataPoint>& data) override;
+    std::vector<DataPoint> query(const QueryRange& range) override;
+    double getIndexSize() const override;
+    std::string getName() const override;
+    bool supportsConcurrentQueries() const override;
+    
+    /**
+     * Own counters plus those of every part
+     */
+    size_t getScannedPoints() const override;
+    size_t getScannedRuns() const override;
+    void resetScanStats() override;
+    
+    /**
+     * Applies to every shard
+     */
+    void setCoordinateStorage(CoordinateEncoding encoding, bool exact_recheck = false) override;
+    void dropCaches() override;
+    
+    size_t getNumShards() const { return shards_.size(); }
+    
+    /**
+     * Shards the last query was sent to (one of the latest, when queries
+     * run concurrently)
+     */
+    size_t getLastShardsQueried() const { return last_shards_queried_; }
+
+private:
+    struct Shard {
+        std::shared_ptr<BaseIndex> index;
+        size_t size = 0;
+        std::vector<double> min_bounds;
+        std::vector<double> max_bounds;
+    };
+    
+    std::vector<Shard> shards_;
+    ShardPartitioning partitioning_;
+    ThreadPool pool_;
+    size_t dimensions_;
+    ScanCounter last_shards_queried_;  // Written by concurrent queries
+    
+    // Helper functions
+    std::vector<size_t> assignShards(const std::vector<DataPoint>& data) const;
+    void bisect(const std::vector<DataPoint>& data, std::vector<size_t>& ids,
+                size_t begin, size_t end, size_t first_shard, size_t num_shards,
+                std::vector<size_t>& assignment) const;
+    bool intersects(const Shard& shard, const QueryRange& range) const;
+};
+
+} // namespace flood
+
+#endif // SHARDED_INDEX_H
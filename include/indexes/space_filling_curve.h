@@ -0,0 +1,79 @@
+#ifndef SPACE_FILLING_CURVE_H
+#define SPACE_FILLING_CURVE_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace flood {
+
+/**
+ * Shared kernels for space-filling-curve (linearized) indexes:
+ * Morton bit interleaving, Hilbert encoding and a stable radix sort over
+ * 64- and 128-bit keys.
+ */
+namespace sfc {
+
+#ifndef __SIZEOF_INT128__
+#error "128-bit curve keys need a compiler with unsigned __int128 (GCC or Clang)"
+#endif
+
+// Curve key wide enough for any dimensionality (at most 128 key bits)
+__extension__ typedef unsigned __int128 Key128;
+
+constexpr uint32_t MAX_KEY_BITS = 128;
+
+// Bits per coordinate used by the 2D/3D Morton encoders (21 * 3 = 63 bits)
+constexpr uint32_t MORTON_BITS = 21;
+
+/**
+ * True if the CPU supports BMI2 (PDEP/PEXT). Checked once at startup;
+ * the encoders below dispatch on it.
+ */
+bool cpuHasBMI2();
+
+/**
+ * Interleave the low 21 bits of x and y (x in bit 0)
+ */
+uint64_t mortonEncode2D(uint32_t x, uint32_t y);
+
+/**
+ * Interleave the low 21 bits of x, y and z (x in bit 0)
+ */
+uint64_t mortonEncode3D(uint32_t x, uint32_t y, uint32_t z);
+
+/**
+ * Portable magic-number implementations (always available, used as the
+ * fallback when BMI2 is missing)
+ */
+uint64_t mortonEncode2DMagic(uint32_t x, uint32_t y);
+uint64_t mortonEncode3DMagic(uint32_t x, uint32_t y, uint32_t z);
+
+/**
+ * Scatter the low bits of value to the set bit positions of mask, lowest
+ * first (PDEP when BMI2 is available)
+ */
+uint64_t depositBits(uint64_t value, uint64_t mask);
+
+/**
+ * Hilbert index of a cell (Skilling's transpose algorithm) in any number
+ * of dimensions, using the low `bits` bits of each coordinate
+ * (dims * bits must not exceed MAX_KEY_BITS, bits at most 32)
+ */
+Key128 hilbertEncode(const uint32_t* cells, size_t dims, uint32_t bits);
+
+/**
+ * Sort keys ascending with an LSD radix sort (8-bit digits, passes whose
+ * digit is constant across all keys are skipped). The sort is stable, so
+ * duplicate keys keep their input order.
+ * @param keys Keys to sort, sorted in place
+ * @return Permutation: sorted position i came from input position perm[i]
+ */
+std::vector<size_t> radixSortKeys(std::vector<uint64_t>& keys);
+std::vector<size_t> radixSortKeys(std::vector<Key128>& keys);
+
+} // namespace sfc
+
+} // namespace flood
+
+#endif // SPACE_FILLING_CURVE_H
@@ -0,0 +1,168 @@
+#ifndef TIME_PARTITIONED_INDEX_H
+#define TIME_PARTITIONED_INDEX_H
+
+#include "indexes/base_index.h"
+#include "utils/thread_pool.h"
+#include <vector>
+#include <map>
+#include <string>
+#include <memory>
+#include <future>
+#include <functional>
+#include <cstdint>
+
+namespace flood {
+
+/**
+ * TimePartitionedIndex: one immutable sub-index per time bucket
+ *
+ * Points are bucketed by floor(time / bucket_width) on the time dimension
+ * (dimension 2 for the (lon, lat, time) layout of Workload B), and every
+ * bucket is indexed by its own instance of any BaseIndex type. A query
+ * only visits the buckets its time bound overlaps (and whose bounding box
+ * it intersects), so "last N hours" queries touch N / bucket_width
+ * partitions however much history is kept.
+ *
+ * insert() ingests points in time order without rebuilding anything: the
+ * newest bucket buffers its points, and once a later bucket starts, the
+ * earlier one is sealed and its sub-index is built on a background worker.
+ * Until that build finishes, queries scan the bucket's points directly.
+ * Points arriving for an already sealed bucket go to a side buffer that
+ * is also scanned directly; once it outgrows MIN_LATE_POINTS and a
+ * quarter of the bucket, the bucket is resealed: its points and the late
+ * ones are rebuilt into a new sub-index in the background, so an
+ * out-of-order stream cannot turn queries into scans. (The indexed points
+ * are read back with a query over the bucket's bounding box, so any
+ * sub-index type works.) expireBefore() and the retention window
+ * drop whole buckets, O(1) each, instead of deleting points. Coordinate
+ * storage settings apply to the buckets built after they are set.
+ *
+ * Not thread-safe: insert(), query() and expiry come from one thread; only
+ * the sub-index builds run in the background.
+ */
+class TimePartitionedIndex : public BaseIndex {
+public:
+    using IndexFactory = std::function<std::shared_ptr<BaseIndex>()>;
+    
+    /**
+     * @param factory Creates one (unbuilt) index per bucket
+     * @param bucket_width Bucket length in time units (e.g. 3600 for hourly
+     *                     buckets of Unix seconds); <= 0 picks a width
+     *                     giving DEFAULT_BUCKETS buckets over the data
+     *                     passed to the first build() (insert() before
+     *                     that throws std::logic_error)
+     * @param time_dim Dimension holding time
+     * @param num_threads Background build workers (at least 1)
+     */
+    TimePartitionedIndex(IndexFactory factory, double bucket_width = 0.0,
+                         size_t time_dim = 2, size_t num_threads = 1);
+    ~TimePartitionedIndex() override = default;
+    
+    static constexpr size_t DEFAULT_BUCKETS = 24;
+    static constexpr size_t MIN_LATE_POINTS = 1024;
+    
+    /**
+     * Replace the contents with data, building every bucket (in parallel)
+     * before returning
+     */
+    void build(const std::vector<DataPoint>& data) override;
+    std::vector<DataPoint> query(const QueryRange& range) override;
+    double getIndexSize() const override;
+    std::string getName() const override { return name_; }
+    bool supportsConcurrentQueries() const override { return false; }  // Queries adopt finished builds
+    
+    /**
+     * Append points (expected in roughly ascending time). Buckets older
+     * than the newest one touched are sealed and built in the background;
+     * points behind the retention window are discarded. Throws
+     * std::invalid_argument if a point lacks the time dimension or has
+     * fewer dimensions than the indexed data.
+     */
+    void insert(const std::vector<DataPoint>& points) override;
+    bool supportsInserts() const override { return true; }
+    
+    /**
+     * Forwarded to the built buckets
+     */
+    void dropCaches() override;
+    
+    /**
+     * Seal the open bucket too, e.g. at the end of a stream
+     */
+    void flush();
+    
+    /**
+     * Block until every background build has finished and is installed
+     * (rethrows the first build error)
+     */
+    void waitForBuilds();
+    
+    /**
+     * Drop every bucket that ends at or before time; returns the number
+     * of buckets dropped
+     */
+    size_t expireBefore(double time);
+    
+    /**
+     * Keep only buckets overlapping the last window time units before the
+     * newest point seen (0 = keep everything); applied on every insert()
+     */
+    void setRetention(double window);
+    
+    double getBucketWidth() const { return bucket_width_; }
+    size_t getNumBuckets() const { return buckets_.size(); }
+    
+    /**
+     * Buckets whose sub-index is still being built
+     */
+    size_t getPendingBuilds() const;
+    
+    /**
+     * Buckets the last query visited
+     */
+    size_t getLastBucketsQueried() const { return last_buckets_queried_; }
+
+private:
+    struct Bucket {
+        std::shared_ptr<BaseIndex> index;                     // Built and immutable
+        std::shared_ptr<const std::vector<DataPoint>> sealed;  // Waiting for index
+        std::future<std::shared_ptr<BaseIndex>> building;
+        std::vector<DataPoint> open;   // Newest bucket, not yet sealed
+        std::vector<DataPoint> late;   // Arrived after sealing
+        bool is_sealed = false;
+        size_t size = 0;
+        std::vector<double> min_bounds;
+        std::vector<double> max_bounds;
+    };
+    
+    IndexFactory factory_;
+    std::string name_;
+    double bucket_width_;
+    size_t time_dim_;
+    size_t dimensions_;
+    double retention_;
+    double newest_time_;
+    size_t last_buckets_queried_;
+    
+    // Keyed by bucket number; erasing the front is amortized O(1)
+    std::map<int64_t, Bucket> buckets_;
+    
+    // Declared last so it is destroyed first: workers finish their
+    // builds before the buckets go away
+    ThreadPool pool_;
+    
+    // Helper functions
+    int64_t bucketOf(double time) const;
+    std::shared_ptr<BaseIndex> makeIndex() const;
+    void addPoint(Bucket& bucket, const DataPoint& point);
+    void seal(Bucket& bucket);
+    void reseal(Bucket& bucket);
+    void collectBuilds(bool wait);
+    bool intersects(const Bucket& bucket, const QueryRange& range) const;
+    void scanPoints(const std::vector<DataPoint>& points, const QueryRange& range,
+                    std::vector<DataPoint>& results);
+};
+
+} // namespace flood
+
+#endif // TIME_PARTITIONED_INDEX_H
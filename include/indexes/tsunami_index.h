@@ -0,0 +1,130 @@
+#ifndef TSUNAMI_INDEX_H
+#define TSUNAMI_INDEX_H
+
+#include "indexes/base_index.h"
+#include "indexes/flood_index.h"
+#include <vector>
+#include <memory>
+
+namespace flood {
+
+/**
+ * Tsunami-style skew-aware partitioned Flood
+ * Based on "Tsunami: A Learned Multi-dimensional Index for Correlated Data
+ * and Skewed Workloads" (VLDB '21)
+ * 
+ * 1. Grid Tree: the data space is split recursively along the dimension
+ *    where the training queries are most unevenly spread, at the points
+ *    where query density changes, so hot regions are isolated without
+ *    partitioning cold ones finely.
+ * 2. Each leaf region gets its own independently built Flood layout.
+ * 3. Functional mappings: within a region, a dimension y strongly
+ *    correlated with another dimension x is modelled as y = a + b * x with
+ *    exact residual bounds, so a filter on y also bounds x and the region's
+ *    Flood scans a narrower range.
+ * 
+ * Without training queries the whole space is a single region (still with
+ * functional mappings).
+ */
+class TsunamiIndex : public BaseIndex {
+public:
+    /**
+     * @param min_region_size Regions with fewer points are not split further
+     * @param max_depth Maximum depth of the grid tree
+     * @param skew_threshold Minimum query skew (0 = uniform) that justifies a split
+     */
+    explicit TsunamiIndex(size_t min_region_size = 1024, size_t max_depth = 4,
+                          double skew_threshold = 0.2);
+    ~TsunamiIndex() override = default;
+    
+    void build(const std::vector<DataPoint>& data) override;
+    std::vector<DataPoint> query(const QueryRange& range) override;
+    double getIndexSize() const override;
+    std::string getName() const override { return "Tsunami"; }
+    
+    /**
+     * Own counters plus those of every region
+     */
+    size_t getScannedPoints() const override;
+    size_t getScannedRuns() const override;
+    void resetScanStats() override;
+    
+    /**
+     * Provide a sample of the expected query workload
+     * This should be called before build(); it shapes the grid tree
+     */
+    void train(const std::vector<QueryRange>& training_queries);
+    
+    size_t getNumRegions() const { return regions_.size(); }
+    size_t getNumMappings() const;
+
+private:
+    /**
+     * y = intercept + slope * x + residual, residual in [min_residual, max_residual]
+     * for every point of the region
+     */
+    struct FunctionalMapping {
+        size_t dependent_dim;  // y
+        size_t source_dim;     // x
+        double intercept;
+        double slope;
+        double min_residual;
+        double max_residual;
+    };
+    
+    struct Region {
+        std::unique_ptr<FloodIndex> index;
+        size_t size = 0;
+        std::vector<double> min_bounds;
+        std::vector<double> max_bounds;
+        std::vector<FunctionalMapping> mappings;
+    };
+    
+    // Grid tree node: children partition the node along split_dim at
+    // splits (child c holds upper_bound(splits, v) == c); leaves own a region
+    struct GridNode {
+        size_t split_dim = 0;
+        std::vector<double> splits;
+        size_t first_child = 0;
+        size_t region = 0;
+        bool is_leaf = true;
+    };
+    
+    size_t min_region_size_;
+    size_t max_depth_;
+    double skew_threshold_;
+    size_t dimensions_;
+    
+    std::vector<QueryRange> training_queries_;
+    std::vector<GridNode> nodes_;
+    std::vector<Region> regions_;
+    
+    // Helper functions
+    void buildNode(const std::vector<DataPoint>& data, std::vector<size_t>& ids,
+                   const std::vector<size_t>& query_ids, size_t node_idx, size_t depth);
+    
+    /**
+     * Pick the dimension with the most skewed query distribution and the
+     * split points between its runs of similar query density
+     */
+    bool chooseSplit(const std::vector<DataPoint>& data, const std::vector<size_t>& ids,
+                     const std::vector<size_t>& query_ids,
+                     size_t& split_dim, std::vector<double>& splits) const;
+    
+    void buildRegion(const std::vector<DataPoint>& data, const std::vector<size_t>& ids,
+                     Region& region) const;
+    
+    void fitMappings(const std::vector<DataPoint>& data, const std::vector<size_t>& ids,
+                     Region& region) const;
+    
+    /**
+     * Narrow a query with the region's functional mappings (same result
+     * set within the region); false if it cannot match anything there
+     */
+    bool applyMappings(const Region& region, const QueryRange& range,
+                       std::vector<double>& q_min, std::vector<double>& q_max) const;
+};
+
+} // namespace flood
+
+#endif // TSUNAMI_INDEX_H
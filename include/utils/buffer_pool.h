@@ -0,0 +1,104 @@
+#ifndef BUFFER_POOL_H
+#define BUFFER_POOL_H
+
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+#include <cstddef>
+
+namespace flood {
+
+/**
+ * Counters of a BufferPool since construction or the last resetStats()
+ */
+struct BufferPoolStats {
+    size_t hits = 0;
+    size_t misses = 0;
+    size_t evictions = 0;
+    size_t read_calls = 0;   // preadv system calls
+    size_t bytes_read = 0;
+    
+    double hitRate() const {
+        return hits + misses > 0 ? static_cast<double>(hits) / (hits + misses) : 0.0;
+    }
+};
+
+/**
+ * BufferPool: fixed set of block-sized frames caching a file's blocks
+ *
+ * Replacement is CLOCK (second chance): a hit sets the frame's reference
+ * bit, and the hand clears bits until it finds an unpinned frame whose
+ * bit is already clear. pinRange() makes a run of consecutive blocks
+ * resident at once: the missing blocks are coalesced into runs and each
+ * run is read with a single preadv straight into its frames, so a scan
+ * over a block range costs one system call per gap rather than per block.
+ *
+ * Frames are page aligned, so the file may be opened with O_DIRECT to
+ * bypass the kernel page cache. Not thread-safe.
+ */
+class BufferPool {
+public:
+    /**
+     * @param fd          Open file descriptor (owned by the caller)
+     * @param base_offset File offset of block 0
+     * @param block_size  Bytes per block (and per frame)
+     * @param num_frames  Frames in the pool (at least 1)
+     */
+    BufferPool(int fd, uint64_t base_offset, size_t block_size, size_t num_frames);
+    ~BufferPool();
+    
+    BufferPool(const BufferPool&) = delete;
+    BufferPool& operator=(const BufferPool&) = delete;
+    
+    /**
+     * Make blocks [first, first + count) resident and pin them; frames[i]
+     * receives block first + i. count must not exceed the unpinned frames
+     * (throws std::logic_error) and read errors throw std::runtime_error.
+     */
+    void pinRange(uint64_t first, size_t count, std::vector<const char*>& frames);
+    void unpinRange(uint64_t first, size_t count);
+    
+    /**
+     * Hint that blocks [first, first + count) will be needed soon
+     * (posix_fadvise WILLNEED; the kernel reads them ahead in the background)
+     */
+    void prefetch(uint64_t first, size_t count) const;
+    
+    /**
+     * Drop every unpinned frame (and the file's page cache), e.g. before a
+     * cold-cache run
+     */
+    void clear();
+    
+    size_t numFrames() const { return frames_.size(); }
+    size_t blockSize() const { return block_size_; }
+    
+    const BufferPoolStats& getStats() const { return stats_; }
+    void resetStats() { stats_ = BufferPoolStats(); }
+
+private:
+    static constexpr uint64_t NO_BLOCK = ~uint64_t(0);
+    
+    struct Frame {
+        uint64_t block = NO_BLOCK;
+        uint32_t pins = 0;
+        bool referenced = false;
+    };
+    
+    int fd_;
+    uint64_t base_offset_;
+    size_t block_size_;
+    char* memory_;
+    std::vector<Frame> frames_;
+    std::unordered_map<uint64_t, size_t> block_to_frame_;
+    size_t hand_;
+    BufferPoolStats stats_;
+    
+    char* frameData(size_t frame) const { return memory_ + frame * block_size_; }
+    size_t evictFrame();
+    void readRun(uint64_t first, const std::vector<size_t>& frames);
+};
+
+} // namespace flood
+
+#endif // BUFFER_POOL_H
@@ -0,0 +1,49 @@
+#ifndef CACHE_FLUSHER_H
+#define CACHE_FLUSHER_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace flood {
+
+/**
+ * CacheFlusher: evicts the CPU caches by sweeping a large buffer
+ *
+ * flush() writes one byte of every cache line of a buffer well above the
+ * last-level cache size and reads them back, so whatever an index had in
+ * L1, L2 and the LLC (and most of the data TLB) is replaced by the
+ * buffer. A query timed right after flush() sees the cache state of one
+ * arriving after an idle period. Only the caches of the cores this thread
+ * runs on are affected; a sweep costs a few milliseconds per tens of MB.
+ */
+class CacheFlusher {
+public:
+    /**
+     * @param bytes Buffer size (0 = DEFAULT_LLC_MULTIPLE x the detected
+     *              last-level cache, at least MIN_BYTES)
+     */
+    explicit CacheFlusher(size_t bytes = 0);
+    
+    static constexpr size_t DEFAULT_LLC_MULTIPLE = 2;
+    static constexpr size_t MIN_BYTES = 32 << 20;
+    static constexpr size_t LINE_BYTES = 64;
+    
+    void flush();
+    
+    size_t size() const { return buffer_.size(); }
+    
+    /**
+     * Size of the largest data or unified cache this machine reports
+     * (sysconf, then /sys on Linux), or 0 if unknown
+     */
+    static size_t lastLevelCacheSize();
+
+private:
+    std::vector<uint8_t> buffer_;
+    uint8_t round_;
+};
+
+} // namespace flood
+
+#endif // CACHE_FLUSHER_H
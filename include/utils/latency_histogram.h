@@ -0,0 +1,79 @@
+#ifndef LATENCY_HISTOGRAM_H
+#define LATENCY_HISTOGRAM_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace flood {
+
+/**
+ * LatencyHistogram: HDR-style histogram of non-negative integer values
+ * (nanoseconds, by convention)
+ *
+ * Values are bucketed log-linearly, as in HdrHistogram: each power-of-two
+ * range is split into 2^k equal sub-buckets, so every recorded value is
+ * kept to within the requested number of significant decimal digits up to
+ * the highest trackable value, in constant memory and O(1) per record.
+ * Larger values are clamped to the highest trackable value (and counted in
+ * getClamped()). Histograms with the same settings can be merged, so each
+ * thread can record into its own and the results summed.
+ */
+class LatencyHistogram {
+public:
+    /**
+     * @param highest_trackable Largest value kept exactly (default 1 hour in ns)
+     * @param significant_digits Decimal digits of precision, 1 to 5
+     */
+    explicit LatencyHistogram(uint64_t highest_trackable = 3600ULL * 1000 * 1000 * 1000,
+                              int significant_digits = 3);
+    
+    void record(uint64_t value);
+    
+    /**
+     * Add another histogram's counts (throws std::invalid_argument if its
+     * settings differ)
+     */
+    void merge(const LatencyHistogram& other);
+    
+    void reset();
+    
+    uint64_t getCount() const { return total_; }
+    uint64_t getClamped() const { return clamped_; }
+    uint64_t getMin() const { return total_ ? min_ : 0; }
+    uint64_t getMax() const { return max_; }
+    double getMean() const;
+    
+    /**
+     * Smallest value v such that percentile% of the recorded values are at
+     * most v (to the histogram's precision; 0 when empty)
+     */
+    uint64_t valueAtPercentile(double percentile) const;
+    
+    /**
+     * Bytes used by the counts
+     */
+    size_t memoryBytes() const { return counts_.size() * sizeof(uint64_t); }
+
+private:
+    size_t countsIndex(uint64_t value) const;
+    uint64_t valueAtIndex(size_t index) const;
+    uint64_t highestEquivalentValue(uint64_t value) const;
+    
+    uint64_t highest_trackable_;
+    int significant_digits_;
+    uint32_t sub_bucket_half_magnitude_;   // log2(sub-buckets per range) - 1
+    uint64_t sub_bucket_count_;
+    uint64_t sub_bucket_mask_;
+    
+    std::vector<uint64_t> counts_;
+    uint64_t total_;
+    uint64_t clamped_;
+    uint64_t min_;
+    uint64_t max_;
+    long double sum_;
+};
+
+} // namespace flood
+
+#endif // LATENCY_HISTOGRAM_H
@@ -0,0 +1,94 @@
+#ifndef PERF_COUNTERS_H
+#define PERF_COUNTERS_H
+
+#include <array>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+namespace flood {
+
+/**
+ * Hardware events counted by PerfCounters
+ */
+enum class PerfEvent {
+    CYCLES,
+    INSTRUCTIONS,
+    L1D_MISSES,      // L1 data cache read misses
+    LLC_MISSES,      // Last-level cache misses
+    BRANCH_MISSES,
+    DTLB_MISSES      // Data TLB read misses
+};
+
+constexpr size_t NUM_PERF_EVENTS = 6;
+
+/**
+ * Short column-style name ("Cycles", "L1DMisses", ...)
+ */
+const char* perfEventName(PerfEvent event);
+
+/**
+ * Counter values over one measured interval (or a sum of intervals).
+ * Events the kernel did not grant are marked invalid and read as 0.
+ */
+struct PerfSample {
+    std::array<uint64_t, NUM_PERF_EVENTS> counts{};
+    std::array<bool, NUM_PERF_EVENTS> valid{};
+    
+    bool has(PerfEvent event) const { return valid[static_cast<size_t>(event)]; }
+    uint64_t get(PerfEvent event) const { return counts[static_cast<size_t>(event)]; }
+    bool any() const;
+    
+    /**
+     * Instructions per cycle (0 if either is unavailable)
+     */
+    double ipc() const;
+    
+    PerfSample& operator+=(const PerfSample& other);
+};
+
+/**
+ * PerfCounters: per-thread hardware counters through perf_event_open
+ *
+ * Each event is opened on its own (not as a group), user space only, so
+ * events the PMU or the kernel refuse are simply left out; when the kernel
+ * multiplexes more events than there are hardware counters, values are
+ * scaled by time enabled / time running. Nothing throws: if no event can
+ * be opened (perf_event_paranoid, a seccomp sandbox, a VM without a
+ * virtual PMU, a non-Linux build), available() is false, unavailableReason()
+ * says why, and stop() returns an empty sample.
+ *
+ * Counts only the calling thread, so work handed to a thread pool is not
+ * included. start()/stop() cost a few system calls each; time the
+ * measured code inside the window rather than around it.
+ */
+class PerfCounters {
+public:
+    PerfCounters();
+    ~PerfCounters();
+    
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+    
+    bool available() const;
+    bool has(PerfEvent event) const { return fds_[static_cast<size_t>(event)] >= 0; }
+    const std::string& unavailableReason() const { return reason_; }
+    
+    /**
+     * Reset and enable every open counter
+     */
+    void start();
+    
+    /**
+     * Disable the counters and read them
+     */
+    PerfSample stop();
+
+private:
+    std::array<int, NUM_PERF_EVENTS> fds_;
+    std::string reason_;
+};
+
+} // namespace flood
+
+#endif // PERF_COUNTERS_H
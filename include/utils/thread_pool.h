@@ -0,0 +1,69 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <vector>
+#include <queue>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+
+namespace flood {
+
+/**
+ * Fixed-size thread pool
+ * Workers pull tasks from a shared FIFO queue. parallelFor() lets the
+ * calling thread take part, so it never blocks on a pool that is busy
+ * and a pool of size 0 degrades to a plain loop.
+ */
+class ThreadPool {
+public:
+    /**
+     * @param num_threads Worker threads (0 = hardware concurrency - 1,
+     *                    since the caller of parallelFor also works)
+     */
+    explicit ThreadPool(size_t num_threads = 0);
+    ~ThreadPool();
+    
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+    
+    /**
+     * Queue a task; the future carries its result or exception
+     */
+    template <typename F>
+    auto submit(F&& task) -> std::future<decltype(task())> {
+        using Result = decltype(task());
+        auto packaged = std::make_shared<std::packaged_task<Result()>>(std::forward<F>(task));
+        std::future<Result> future = packaged->get_future();
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            tasks_.emplace([packaged]() { (*packaged)(); });
+        }
+        cv_.notify_one();
+        return future;
+    }
+    
+    /**
+     * Run fn(0) .. fn(n - 1) on the workers and the calling thread, and
+     * wait for all of them. The first exception thrown is rethrown.
+     */
+    void parallelFor(size_t n, const std::function<void(size_t)>& fn);
+    
+    size_t size() const { return workers_.size(); }
+
+private:
+    std::vector<std::thread> workers_;
+    std::queue<std::function<void()>> tasks_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    bool stopping_;
+    
+    void workerLoop();
+};
+
+} // namespace flood
+
+#endif // THREAD_POOL_H
@@ -6,10 +6,149 @@
 #include <chrono>
 #include <iomanip>
 #include <numeric>
+#include <unordered_map>
+#include <unordered_set>
 
 namespace flood {
 
-Benchmark::Benchmark() : warmup_queries_(0), verbose_(true) {}
+namespace {
+
+void writeCounterColumns(std::ostream& out, const PerfSample& sample, double divisor) {
+    for (size_t e = 0; e < NUM_PERF_EVENTS; ++e) {
+        out << ",";
+        if (sample.valid[e]) {
+            out << sample.counts[e] / divisor;
+        }
+    }
+}
+
+void writeCounterHeader(std::ostream& out, const std::string& prefix) {
+    for (size_t e = 0; e < NUM_PERF_EVENTS; ++e) {
+        out << "," << prefix << perfEventName(static_cast<PerfEvent>(e));
+    }
+}
+
+void printCounters(const PerfSample& sample, double divisor) {
+    for (size_t e = 0; e < NUM_PERF_EVENTS; ++e) {
+        if (sample.valid[e]) {
+            std::cout << " " << perfEventName(static_cast<PerfEvent>(e)) << "="
+                      << static_cast<uint64_t>(sample.counts[e] / divisor);
+        }
+    }
+    if (sample.ipc() > 0.0) {
+        std::cout << " IPC=" << sample.ipc();
+    }
+    std::cout << std::endl;
+}
+
+void printValidation(const BenchmarkResult& result, const std::string& indent) {
+    if (result.failed_queries == 0) {
+        std::cout << indent << "Validation: " << result.validated_queries
+                  << " queries checked, all correct" << std::endl;
+        return;
+    }
+    size_t missing = 0;
+    size_t extra = 0;
+    for (const auto& v : result.mismatches) {
+        missing += v.missing;
+        extra += v.extra;
+    }
+    std::cout << indent << "Validation: " << result.failed_queries << " of " << result.validated_queries
+              << " queries WRONG (" << missing << " points missing, " << extra << " extra)" << std::endl;
+    
+    auto ids = [](const std::vector<uint64_t>& list, size_t count) {
+        std::ostringstream oss;
+        for (size_t i = 0; i < list.size(); ++i) {
+            oss << (i ? ", " : "") << list[i];
+        }
+        if (count > list.size()) {
+            oss << ", ...";
+        }
+        return oss.str();
+    };
+    const size_t MAX_LISTED = 10;
+    for (size_t i = 0; i < std::min(MAX_LISTED, result.mismatches.size()); ++i) {
+        const QueryValidation& v = result.mismatches[i];
+        std::cout << indent << "  query " << v.query << ": " << v.returned << " returned, "
+                  << v.expected << " expected";
+        if (v.missing > 0) {
+            std::cout << "; missing " << v.missing << " (ids " << ids(v.missing_ids, v.missing) << ")";
+        }
+        if (v.extra > 0) {
+            std::cout << "; extra " << v.extra << " (ids " << ids(v.extra_ids, v.extra) << ")";
+        }
+        std::cout << std::endl;
+    }
+    if (result.mismatches.size() > MAX_LISTED) {
+        std::cout << indent << "  ... " << result.mismatches.size() - MAX_LISTED << " more" << std::endl;
+    }
+}
+
+double mean(const std::vector<double>& values) {
+    return values.empty() ? 0.0 : std::accumulate(values.begin(), values.end(), 0.0) / values.size();
+}
+
+double percentile(std::vector<double> values, double fraction) {
+    if (values.empty()) {
+        return 0.0;
+    }
+    size_t index = std::min(static_cast<size_t>(values.size() * fraction), values.size() - 1);
+    std::nth_element(values.begin(), values.begin() + index, values.end());
+    return values[index];
+}
+
+/**
+ * Whether results hold exactly the live points inside range (by id)
+ */
+bool matchesLive(const std::vector<DataPoint>& live, const QueryRange& range,
+                 const std::vector<DataPoint>& results) {
+    std::vector<uint64_t> expected;
+    for (const auto& point : live) {
+        if (range.contains(point)) {
+            expected.push_back(point.getId());
+        }
+    }
+    std::vector<uint64_t> returned;
+    returned.reserve(results.size());
+    for (const auto& point : results) {
+        returned.push_back(point.getId());
+    }
+    std::sort(expected.begin(), expected.end());
+    std::sort(returned.begin(), returned.end());
+    return expected == returned;
+}
+
+} // namespace
+
+Benchmark::Benchmark()
+    : warmup_queries_(0), verbose_(true), rebuild_every_(1000), validate_(false), validation_sample_(0) {}
+
+bool Benchmark::setPerfCounters(bool enabled) {
+    if (!enabled) {
+        perf_.reset();
+        return true;
+    }
+    auto counters = std::make_unique<PerfCounters>();
+    if (!counters->available()) {
+        std::cerr << "Hardware counters unavailable: " << counters->unavailableReason() << std::endl;
+        return false;
+    }
+    perf_ = std::move(counters);
+    return true;
+}
+
+void Benchmark::setValidation(bool enabled, size_t sample_queries) {
+    validate_ = enabled;
+    validation_sample_ = sample_queries;
+}
+
+void Benchmark::setColdCache(bool enabled, size_t flush_bytes) {
+    if (!enabled) {
+        flusher_.reset();
+        return;
+    }
+    flusher_ = std::make_unique<CacheFlusher>(flush_bytes);
+}
 
 std::vector<BenchmarkResult> Benchmark::runSuite(
     const std::vector<std::shared_ptr<BaseIndex>>& indexes,
@@ -24,18 +163,44 @@ std::vector<BenchmarkResult> Benchmark::runSuite(
     std::cout << "Data size: " << data.size() << " points" << std::endl;
     std::cout << "Indexes: " << indexes.size() << std::endl;
     std::cout << "Workloads: " << workloads.size() << std::endl;
+    if (flusher_) {
+        std::cout << "Cache: warm and cold (" << (flusher_->size() >> 20) << " MB flush before each cold query)"
+                  << std::endl;
+    }
     std::cout << "========================================\n" << std::endl;
     
+    if (validate_) {
+        validator_ = std::make_unique<ResultValidator>(data);
+    }
+    
+    // Build phase: every index once for all workloads
+    std::cout << "--- Building indexes ---" << std::endl;
+    std::vector<BenchmarkResult> builds(indexes.size());
+    for (size_t i = 0; i < indexes.size(); ++i) {
+        builds[i].index_name = indexes[i]->getName();
+        if (verbose_) {
+            std::cout << "\nBuilding " << indexes[i]->getName() << "..." << std::endl;
+        }
+        buildIndex(indexes[i].get(), data, builds[i]);
+    }
+    
+    // Query phase
     for (const auto& [workload_name, queries] : workloads) {
         std::cout << "\n--- Workload: " << workload_name << " ---" << std::endl;
         std::cout << "Queries: " << queries.size() << std::endl;
         
-        for (auto& index : indexes) {
-            auto result = runBenchmark(index.get(), data, queries, workload_name);
-            all_results.push_back(result);
+        for (size_t i = 0; i < indexes.size(); ++i) {
+            BenchmarkResult result = builds[i];
+            result.workload_name = workload_name;
+            if (verbose_) {
+                std::cout << "\nTesting " << result.index_name << "..." << std::endl;
+            }
+            runQueries(indexes[i].get(), data, queries, result);
+            all_results.push_back(std::move(result));
         }
     }
     
+    validator_.reset();
     return all_results;
 }
 
@@ -48,16 +213,23 @@ BenchmarkResult Benchmark::runBenchmark(
     BenchmarkResult result;
     result.index_name = index->getName();
     result.workload_name = workload_name;
-    result.total_queries = queries.size();
     
     if (verbose_) {
         std::cout << "\nTesting " << index->getName() << "..." << std::endl;
     }
     
-    // Build index
+    buildIndex(index, data, result);
+    runQueries(index, data, queries, result);
+    return result;
+}
+
+void Benchmark::buildIndex(BaseIndex* index, const std::vector<DataPoint>& data, BenchmarkResult& result) {
+    // Counters cover only this thread, not pool workers
+    if (perf_) perf_->start();
     auto build_start = std::chrono::high_resolution_clock::now();
     index->build(data);
     auto build_end = std::chrono::high_resolution_clock::now();
+    if (perf_) result.build_counters = perf_->stop();
     
     result.build_time_ms = std::chrono::duration<double, std::milli>(
         build_end - build_start).count();
@@ -67,6 +239,43 @@ BenchmarkResult Benchmark::runBenchmark(
         std::cout << "  Build time: " << result.build_time_ms << " ms" << std::endl;
         std::cout << "  Index size: " << result.index_size_mb << " MB" << std::endl;
     }
+}
+
+void Benchmark::runColdQueries(BaseIndex* index, const std::vector<QueryRange>& queries,
+                               BenchmarkResult& result) {
+    result.cold_measured = true;
+    result.cold_query_times_ms.clear();
+    result.cold_query_times_ms.reserve(queries.size());
+    for (const auto& query : queries) {
+        index->dropCaches();
+        flusher_->flush();
+        auto query_start = std::chrono::high_resolution_clock::now();
+        auto query_results = index->query(query);
+        auto query_end = std::chrono::high_resolution_clock::now();
+        result.cold_query_times_ms.push_back(std::chrono::duration<double, std::milli>(
+            query_end - query_start).count());
+    }
+    
+    std::vector<double> times = result.cold_query_times_ms;
+    result.cold_avg_query_time_ms = times.empty() ? 0.0 :
+        std::accumulate(times.begin(), times.end(), 0.0) / times.size();
+    result.cold_median_query_time_ms = calculateMedian(times);
+    result.cold_p95_query_time_ms = calculatePercentile(times, 0.95);
+    result.cold_p99_query_time_ms = calculatePercentile(times, 0.99);
+}
+
+void Benchmark::runQueries(
+    BaseIndex* index,
+    const std::vector<DataPoint>& data,
+    const std::vector<QueryRange>& queries,
+    BenchmarkResult& result) {
+    
+    result.total_queries = queries.size();
+    
+    // Cold first, so the warm-up below is what the warm pass starts from
+    if (flusher_) {
+        runColdQueries(index, queries, result);
+    }
     
     // Warmup queries
     if (warmup_queries_ > 0 && !queries.empty()) {
@@ -78,24 +287,61 @@ BenchmarkResult Benchmark::runBenchmark(
     // Run queries and collect timing
     std::vector<double> query_times;
     std::vector<size_t> result_counts;
+    std::vector<size_t> scanned_counts;
     query_times.reserve(queries.size());
     result_counts.reserve(queries.size());
+    scanned_counts.reserve(queries.size());
     
     result.total_results = 0;
+    index->resetScanStats();
     
-    for (const auto& query : queries) {
+    if (perf_) result.per_query_counters.reserve(queries.size());
+    
+    // Queries to validate, evenly spaced; their results are kept and
+    // checked after the timed loop so the reference scan cannot evict the
+    // index from cache between queries
+    std::vector<bool> sampled(queries.size(), false);
+    std::vector<std::pair<size_t, std::vector<DataPoint>>> sampled_results;
+    if (validate_) {
+        size_t count = validation_sample_ == 0 ? queries.size() : std::min(validation_sample_, queries.size());
+        for (size_t k = 0; k < count; ++k) {
+            sampled[k * queries.size() / count] = true;
+        }
+    }
+    
+    for (size_t q = 0; q < queries.size(); ++q) {
+        const QueryRange& query = queries[q];
+        size_t scanned_before = index->getScannedPoints();
+        // The clock runs inside the counter window, so the counter system
+        // calls do not inflate latency
+        if (perf_) perf_->start();
         auto query_start = std::chrono::high_resolution_clock::now();
         auto query_results = index->query(query);
         auto query_end = std::chrono::high_resolution_clock::now();
+        if (perf_) {
+            result.per_query_counters.push_back(perf_->stop());
+            result.query_counters += result.per_query_counters.back();
+        }
         
         double query_time = std::chrono::duration<double, std::milli>(
             query_end - query_start).count();
         
         query_times.push_back(query_time);
         result_counts.push_back(query_results.size());
+        scanned_counts.push_back(index->getScannedPoints() - scanned_before);
         result.total_results += query_results.size();
+        if (sampled[q]) {
+            sampled_results.emplace_back(q, std::move(query_results));
+        }
     }
     
+    if (validate_) {
+        validateResults(data, queries, sampled_results, result);
+    }
+    
+    // Keep per-query latencies (the statistics below sort query_times)
+    result.query_times_ms = query_times;
+    
     // Calculate statistics
     result.avg_query_time_ms = std::accumulate(
         query_times.begin(), query_times.end(), 0.0) / query_times.size();
@@ -104,9 +350,11 @@ BenchmarkResult Benchmark::runBenchmark(
     result.p95_query_time_ms = calculatePercentile(query_times, 0.95);
     result.p99_query_time_ms = calculatePercentile(query_times, 0.99);
     
-    // Scan overhead (simplified: assume we scan some fraction of data)
-    // For a more accurate measure, we'd need to instrument the index
-    result.scan_overhead = 1.0;  // Placeholder
+    // Scan overhead from the index's own instrumentation, if it has any
+    result.scan_overhead = index->getScannedPoints() > 0 ?
+        calculateScanOverhead(scanned_counts, result_counts) : 1.0;
+    result.avg_scanned_runs = queries.empty() ? 0.0 :
+        static_cast<double>(index->getScannedRuns()) / queries.size();
     
     if (verbose_) {
         std::cout << "  Avg query time: " << result.avg_query_time_ms << " ms" << std::endl;
@@ -114,11 +362,233 @@ BenchmarkResult Benchmark::runBenchmark(
         std::cout << "  P95: " << result.p95_query_time_ms << " ms" << std::endl;
         std::cout << "  P99: " << result.p99_query_time_ms << " ms" << std::endl;
         std::cout << "  Total results: " << result.total_results << std::endl;
+        if (index->getScannedPoints() > 0) {
+            std::cout << "  Scan overhead: " << result.scan_overhead << "x" << std::endl;
+            std::cout << "  Avg scanned runs: " << result.avg_scanned_runs << std::endl;
+        }
+        if (result.build_counters.any()) {
+            std::cout << "  Build counters:";
+            printCounters(result.build_counters, 1.0);
+        }
+        if (result.query_counters.any() && !queries.empty()) {
+            std::cout << "  Counters per query:";
+            printCounters(result.query_counters, static_cast<double>(queries.size()));
+        }
+        if (result.cold_measured) {
+            std::cout << "  Cold cache: avg " << result.cold_avg_query_time_ms << " ms, median "
+                      << result.cold_median_query_time_ms << " ms, P99 " << result.cold_p99_query_time_ms
+                      << " ms" << std::endl;
+        }
+        if (validate_) {
+            printValidation(result, "  ");
+        }
+    }
+}
+
+MixedResult Benchmark::runMixedBenchmark(
+    BaseIndex* index,
+    const MixedWorkload& workload,
+    const std::string& workload_name) {
+    
+    using Clock = std::chrono::high_resolution_clock;
+    
+    MixedResult result;
+    result.index_name = index->getName();
+    result.workload_name = workload_name;
+    result.mix = workload.mix.toString();
+    result.rebuild_every = rebuild_every_;
+    result.native_inserts = index->supportsInserts();
+    
+    if (verbose_) {
+        std::cout << "\nTesting " << index->getName() << " (" << result.mix << " query/insert/delete"
+                  << (result.native_inserts ? ", native inserts" : "") << ")..." << std::endl;
     }
     
+    // The live data, for rebuilds and validation; deletes swap with the last
+    std::vector<DataPoint> live = workload.initial;
+    std::unordered_map<uint64_t, size_t> position;
+    position.reserve(live.size() + workload.inserts.size());
+    for (size_t i = 0; i < live.size(); ++i) {
+        position[live[i].getId()] = i;
+    }
+    
+    auto applyToLive = [&](const Operation& operation) {
+        if (operation.type == OperationType::INSERT) {
+            position[workload.inserts[operation.arg].getId()] = live.size();
+            live.push_back(workload.inserts[operation.arg]);
+        } else if (operation.type == OperationType::DELETE) {
+            auto it = position.find(operation.arg);
+            if (it == position.end()) {
+                return;
+            }
+            size_t slot = it->second;
+            position.erase(it);
+            if (slot + 1 < live.size()) {
+                live[slot] = live.back();
+                position[live[slot].getId()] = slot;
+            }
+            live.pop_back();
+        }
+    };
+    
+    auto build_start = Clock::now();
+    index->build(live);
+    result.build_time_ms = std::chrono::duration<double, std::milli>(Clock::now() - build_start).count();
+    
+    if (warmup_queries_ > 0) {
+        for (size_t i = 0; i < std::min(warmup_queries_, workload.queries.size()); ++i) {
+            index->query(workload.queries[i]);
+        }
+    }
+    
+    // Updates the index does not reflect yet
+    std::vector<DataPoint> delta;
+    std::unordered_set<uint64_t> tombstones;
+    size_t pending = 0;
+    
+    size_t num_queries = std::count_if(workload.operations.begin(), workload.operations.end(),
+                                       [](const Operation& op) { return op.type == OperationType::QUERY; });
+    size_t validate_every = !validate_ || num_queries == 0 ? 0 :
+        std::max<size_t>(1, num_queries / (validation_sample_ == 0 ? num_queries :
+                                           std::min(validation_sample_, num_queries)));
+    
+    const size_t num_ops = workload.operations.size();
+    std::vector<double> op_times(num_ops);
+    std::vector<size_t> window_rebuilds(AGING_WINDOWS, 0);
+    std::vector<size_t> window_pending(AGING_WINDOWS, 0);
+    size_t query_count = 0;
+    size_t current_window = 0;
+    
+    for (size_t op = 0; op < num_ops; ++op) {
+        const Operation& operation = workload.operations[op];
+        std::vector<DataPoint> results;
+        bool rebuilt = false;
+        
+        auto start = Clock::now();
+        switch (operation.type) {
+            case OperationType::QUERY: {
+                const QueryRange& range = workload.queries[operation.arg];
+                results = index->query(range);
+                if (!tombstones.empty()) {
+                    results.erase(std::remove_if(results.begin(), results.end(), [&](const DataPoint& point) {
+                        return tombstones.count(point.getId()) > 0;
+                    }), results.end());
+                }
+                for (const auto& point : delta) {
+                    if (range.contains(point) && tombstones.count(point.getId()) == 0) {
+                        results.push_back(point);
+                    }
+                }
+                break;
+            }
+            case OperationType::INSERT:
+                if (result.native_inserts) {
+                    index->insert({workload.inserts[operation.arg]});
+                } else {
+                    delta.push_back(workload.inserts[operation.arg]);
+                    ++pending;
+                }
+                break;
+            case OperationType::DELETE:
+                tombstones.insert(operation.arg);
+                ++pending;
+                break;
+        }
+        if (rebuild_every_ > 0 && pending >= rebuild_every_) {
+            // The rebuilt index includes this operation's update
+            applyToLive(operation);
+            auto rebuild_start = Clock::now();
+            index->build(live);
+            result.rebuild_time_ms += std::chrono::duration<double, std::milli>(Clock::now() - rebuild_start).count();
+            ++result.rebuilds;
+            delta.clear();
+            tombstones.clear();
+            pending = 0;
+            rebuilt = true;
+        }
+        op_times[op] = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+        
+        // Bookkeeping outside the timed section
+        if (!rebuilt) {
+            applyToLive(operation);
+        }
+        if (operation.type == OperationType::QUERY) {
+            if (validate_every > 0 && query_count % validate_every == 0) {
+                ++result.validated_queries;
+                if (!matchesLive(live, workload.queries[operation.arg], results)) {
+                    ++result.failed_queries;
+                }
+            }
+            ++query_count;
+        }
+        while ((current_window + 1) * num_ops / AGING_WINDOWS <= op) {
+            ++current_window;
+        }
+        window_rebuilds[current_window] += rebuilt ? 1 : 0;
+        window_pending[current_window] = pending;
+    }
+    
+    // Per type (indexed by OperationType), and per window of the stream
+    std::vector<double> window_times[3];
+    size_t window_start = 0;
+    for (size_t w = 0; w < AGING_WINDOWS && num_ops > 0; ++w) {
+        size_t window_end = (w + 1) * num_ops / AGING_WINDOWS;
+        if (window_end == window_start) {
+            continue;
+        }
+        for (auto& times : window_times) {
+            times.clear();
+        }
+        for (size_t op = window_start; op < window_end; ++op) {
+            window_times[static_cast<int>(workload.operations[op].type)].push_back(op_times[op]);
+        }
+        MixedResult::Window window;
+        window.end_operation = window_end;
+        window.queries = window_times[0].size();
+        window.mean_query_ms = mean(window_times[0]);
+        window.p99_query_ms = percentile(window_times[0], 0.99);
+        window.inserts = window_times[1].size();
+        window.mean_insert_ms = mean(window_times[1]);
+        window.deletes = window_times[2].size();
+        window.mean_delete_ms = mean(window_times[2]);
+        window.rebuilds = window_rebuilds[w];
+        window.pending_updates = window_pending[w];
+        result.windows.push_back(window);
+        
+        result.query_times_ms.insert(result.query_times_ms.end(), window_times[0].begin(), window_times[0].end());
+        result.insert_times_ms.insert(result.insert_times_ms.end(), window_times[1].begin(), window_times[1].end());
+        result.delete_times_ms.insert(result.delete_times_ms.end(), window_times[2].begin(), window_times[2].end());
+        window_start = window_end;
+    }
+    
+    if (verbose_) {
+        result.print();
+    }
     return result;
 }
 
+void Benchmark::validateResults(const std::vector<DataPoint>& data,
+                                const std::vector<QueryRange>& queries,
+                                const std::vector<std::pair<size_t, std::vector<DataPoint>>>& sampled,
+                                BenchmarkResult& result) {
+    // A suite shares one reference copy of its data; a single run makes its own
+    std::unique_ptr<ResultValidator> own;
+    ResultValidator* validator = validator_.get();
+    if (!validator) {
+        own = std::make_unique<ResultValidator>(data);
+        validator = own.get();
+    }
+    
+    for (const auto& [q, points] : sampled) {
+        QueryValidation validation = validator->check(queries[q], points, q);
+        ++result.validated_queries;
+        if (!validation.ok()) {
+            ++result.failed_queries;
+            result.mismatches.push_back(std::move(validation));
+        }
+    }
+}
+
 void Benchmark::saveResults(const std::vector<BenchmarkResult>& results,
                            const std::string& filepath) {
     std::ofstream file(filepath);
@@ -130,7 +600,14 @@ void Benchmark::saveResults(const std::vector<BenchmarkResult>& results,
     // Write CSV header
     file << "Index,Workload,BuildTime_ms,IndexSize_MB,AvgQueryTime_ms,"
          << "MedianQueryTime_ms,P95QueryTime_ms,P99QueryTime_ms,"
-         << "TotalQueries,TotalResults\n";
+         << "TotalQueries,TotalResults,ScanOverhead,AvgScannedRuns,"
+         << "ValidatedQueries,FailedQueries,ColdAvgQueryTime_ms,ColdMedianQueryTime_ms,"
+         << "ColdP95QueryTime_ms,ColdP99QueryTime_ms";
+    // Cold and counter columns stay empty where they were not measured;
+    // Query_ columns are per-query averages
+    writeCounterHeader(file, "Build_");
+    writeCounterHeader(file, "Query_");
+    file << "\n";
     
     // Write results
     for (const auto& result : results) {
@@ -141,6 +618,66 @@ void Benchmark::saveResults(const std::vector<BenchmarkResult>& results,
     std::cout << "\nResults saved to " << filepath << std::endl;
 }
 
+void Benchmark::saveQueryTrace(const std::vector<BenchmarkResult>& results,
+                               const std::string& filepath) {
+    std::ofstream file(filepath);
+    if (!file.is_open()) {
+        std::cerr << "Failed to open file for writing: " << filepath << std::endl;
+        return;
+    }
+    
+    file << "Index,Workload,Query,Latency_ms,ColdLatency_ms";
+    writeCounterHeader(file, "");
+    file << "\n";
+    
+    file << std::fixed << std::setprecision(6);
+    for (const auto& result : results) {
+        for (size_t q = 0; q < result.query_times_ms.size(); ++q) {
+            file << result.index_name << "," << result.workload_name << "," << q << ","
+                 << result.query_times_ms[q] << ",";
+            if (q < result.cold_query_times_ms.size()) {
+                file << result.cold_query_times_ms[q];
+            }
+            writeCounterColumns(file, q < result.per_query_counters.size() ?
+                                      result.per_query_counters[q] : PerfSample(), 1.0);
+            file << "\n";
+        }
+    }
+    
+    file.close();
+    std::cout << "Query trace saved to " << filepath << std::endl;
+}
+
+void Benchmark::saveMixedResults(const std::vector<MixedResult>& results,
+                                 const std::string& filepath) {
+    std::ofstream file(filepath);
+    if (!file.is_open()) {
+        std::cerr << "Failed to open file for writing: " << filepath << std::endl;
+        return;
+    }
+    
+    file << "Index,Workload,Mix,RebuildEvery,NativeInserts,Window,EndOperation,"
+         << "Queries,MeanQuery_ms,P99Query_ms,Inserts,MeanInsert_ms,Deletes,MeanDelete_ms,"
+         << "Rebuilds,PendingUpdates\n";
+    
+    file << std::fixed << std::setprecision(6);
+    for (const auto& result : results) {
+        for (size_t w = 0; w < result.windows.size(); ++w) {
+            const MixedResult::Window& window = result.windows[w];
+            file << result.index_name << "," << result.workload_name << "," << result.mix << ","
+                 << result.rebuild_every << "," << (result.native_inserts ? 1 : 0) << ","
+                 << w << "," << window.end_operation << ","
+                 << window.queries << "," << window.mean_query_ms << "," << window.p99_query_ms << ","
+                 << window.inserts << "," << window.mean_insert_ms << ","
+                 << window.deletes << "," << window.mean_delete_ms << ","
+                 << window.rebuilds << "," << window.pending_updates << "\n";
+        }
+    }
+    
+    file.close();
+    std::cout << "Read/write results saved to " << filepath << std::endl;
+}
+
 double Benchmark::calculateScanOverhead(
     const std::vector<size_t>& scanned_counts,
     const std::vector<size_t>& result_counts) const {
@@ -197,7 +734,19 @@ std::string BenchmarkResult::toCSV() const {
         << p95_query_time_ms << ","
         << p99_query_time_ms << ","
         << total_queries << ","
-        << total_results;
+        << total_results << ","
+        << scan_overhead << ","
+        << avg_scanned_runs << ","
+        << validated_queries << ","
+        << failed_queries;
+    if (cold_measured) {
+        oss << "," << cold_avg_query_time_ms << "," << cold_median_query_time_ms << ","
+            << cold_p95_query_time_ms << "," << cold_p99_query_time_ms;
+    } else {
+        oss << ",,,,";
+    }
+    writeCounterColumns(oss, build_counters, 1.0);
+    writeCounterColumns(oss, query_counters, total_queries > 0 ? static_cast<double>(total_queries) : 1.0);
     return oss.str();
 }
 
@@ -212,8 +761,65 @@ void BenchmarkResult::print() const {
     std::cout << "Median query time: " << median_query_time_ms << " ms" << std::endl;
     std::cout << "P95 query time: " << p95_query_time_ms << " ms" << std::endl;
     std::cout << "P99 query time: " << p99_query_time_ms << " ms" << std::endl;
+    if (cold_measured) {
+        std::cout << "Cold avg query time: " << cold_avg_query_time_ms << " ms" << std::endl;
+        std::cout << "Cold median query time: " << cold_median_query_time_ms << " ms" << std::endl;
+        std::cout << "Cold P95 query time: " << cold_p95_query_time_ms << " ms" << std::endl;
+        std::cout << "Cold P99 query time: " << cold_p99_query_time_ms << " ms" << std::endl;
+    }
     std::cout << "Total queries: " << total_queries << std::endl;
     std::cout << "Total results: " << total_results << std::endl;
+    std::cout << "Scan overhead: " << scan_overhead << "x" << std::endl;
+    std::cout << "Avg scanned runs: " << avg_scanned_runs << std::endl;
+    if (build_counters.any()) {
+        std::cout << "Build counters:";
+        printCounters(build_counters, 1.0);
+    }
+    if (query_counters.any() && total_queries > 0) {
+        std::cout << "Counters per query:";
+        printCounters(query_counters, static_cast<double>(total_queries));
+    }
+    if (validated_queries > 0) {
+        printValidation(*this, "");
+    }
+}
+
+double MixedResult::degradation() const {
+    if (windows.empty() || windows.front().mean_query_ms <= 0.0) {
+        return 1.0;
+    }
+    return windows.back().mean_query_ms / windows.front().mean_query_ms;
+}
+
+void MixedResult::print() const {
+    auto line = [](const char* label, const std::vector<double>& times) {
+        if (times.empty()) {
+            return;
+        }
+        std::cout << "  " << label << " (" << times.size() << "): mean " << mean(times)
+                  << " ms, p50 " << percentile(times, 0.5) << " ms, p99 " << percentile(times, 0.99)
+                  << " ms, max " << *std::max_element(times.begin(), times.end()) << " ms" << std::endl;
+    };
+    std::cout << std::fixed << std::setprecision(4);
+    std::cout << "  Build time: " << build_time_ms << " ms" << std::endl;
+    line("Queries", query_times_ms);
+    line("Inserts", insert_times_ms);
+    line("Deletes", delete_times_ms);
+    if (rebuild_every > 0) {
+        std::cout << "  Rebuilds: " << rebuilds << " every " << rebuild_every << " updates, "
+                  << rebuild_time_ms << " ms in total" << std::endl;
+    }
+    std::cout << "  Mean query time by window:";
+    for (const auto& window : windows) {
+        std::cout << " " << window.mean_query_ms;
+    }
+    std::cout << std::endl;
+    std::cout << "  Degradation (last / first window): " << degradation() << "x" << std::endl;
+    if (validated_queries > 0) {
+        std::cout << "  Validation: " << validated_queries << " queries checked, "
+                  << (failed_queries == 0 ? std::string("all correct") :
+                      std::to_string(failed_queries) + " WRONG") << std::endl;
+    }
 }
 
 } // namespace flood
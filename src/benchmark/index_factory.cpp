@@ -0,0 +1,64 @@
+#include "benchmark/index_factory.h"
+#include "indexes/kdtree_index.h"
+#include "indexes/zorder_index.h"
+#include "indexes/hilbert_index.h"
+#include "indexes/grid_index.h"
+#include "indexes/quadtree_index.h"
+#include "indexes/rtree_index.h"
+#include "indexes/flood_index.h"
+#include "indexes/disk_flood_index.h"
+#include "indexes/tsunami_index.h"
+#include "indexes/router_index.h"
+#include "indexes/time_partitioned_index.h"
+#include <atomic>
+#include <cstdlib>
+#include <unistd.h>
+
+namespace flood {
+
+const char* const INDEX_NAMES =
+    "kdtree, zorder, hilbert, grid, grid-uniform, quadtree, octree, rtree, flood, flood-disk, flood-time, tsunami, router";
+
+std::shared_ptr<BaseIndex> createIndex(const std::string& name,
+                                       const std::vector<QueryRange>& training_queries) {
+    if (name == "kdtree") return std::make_shared<KDTreeIndex>();
+    if (name == "zorder") return std::make_shared<ZOrderIndex>();
+    if (name == "hilbert") return std::make_shared<HilbertIndex>();
+    if (name == "grid") return std::make_shared<GridIndex>();
+    if (name == "grid-uniform") return std::make_shared<GridIndex>(64, false);
+    if (name == "quadtree") return std::make_shared<QuadtreeIndex>(64, 2);
+    if (name == "octree") return std::make_shared<QuadtreeIndex>(64, 3);
+    if (name == "rtree") return std::make_shared<RTreeIndex>();
+    if (name == "flood") return std::make_shared<FloodIndex>();
+    if (name == "flood-disk") {
+        // Each instance (e.g. each shard) gets its own file, removed with it;
+        // factories may run concurrently (e.g. sharded builds)
+        static std::atomic<size_t> next_file(0);
+        const char* tmp = std::getenv("TMPDIR");
+        std::string path = std::string(tmp ? tmp : "/tmp") + "/run_benchmark_flood_" +
+                           std::to_string(::getpid()) + "_" + std::to_string(next_file++) + ".fidx";
+        DiskIndexOptions options;
+        options.buffer_pool_bytes = size_t(4) << 20;
+        return std::make_shared<DiskFloodIndex>(path, options);
+    }
+    if (name == "tsunami") {
+        auto tsunami = std::make_shared<TsunamiIndex>();
+        tsunami->train(training_queries);
+        return tsunami;
+    }
+    if (name == "flood-time") {
+        return std::make_shared<TimePartitionedIndex>([]() { return std::make_shared<FloodIndex>(); });
+    }
+    if (name == "router") {
+        std::vector<std::shared_ptr<BaseIndex>> members;
+        for (const char* member : {"kdtree", "zorder", "grid", "octree", "flood"}) {
+            members.push_back(createIndex(member, training_queries));
+        }
+        auto router = std::make_shared<RouterIndex>(members);
+        router->train(training_queries);
+        return router;
+    }
+    return nullptr;
+}
+
+} // namespace flood
@@ -0,0 +1,272 @@
+#include "benchmark/load_generator.h"
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <random>
+#include <stdexcept>
+#include <thread>
+
+namespace flood {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Request {
+    Clock::time_point intended;
+    size_t query;
+};
+
+uint64_t nanosBetween(Clock::time_point from, Clock::time_point to) {
+    return to > from ? static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(to - from).count())
+                     : 0;
+}
+
+/**
+ * Sleep most of the way, then spin: sleep_until alone overshoots by tens
+ * of microseconds, which would bunch up requests at high rates
+ */
+void sleepUntil(Clock::time_point when) {
+    const auto SPIN = std::chrono::microseconds(200);
+    while (true) {
+        auto now = Clock::now();
+        if (now >= when) {
+            return;
+        }
+        if (when - now > SPIN) {
+            std::this_thread::sleep_for(when - now - SPIN / 2);
+        } else {
+            std::this_thread::yield();
+        }
+    }
+}
+
+double micros(uint64_t ns) {
+    return ns / 1000.0;
+}
+
+} // namespace
+
+ArrivalProcess parseArrivalProcess(const std::string& name) {
+    if (name == "constant") return ArrivalProcess::CONSTANT;
+    if (name == "poisson") return ArrivalProcess::POISSON;
+    throw std::invalid_argument("Unknown arrival process: " + name + " (expected constant or poisson)");
+}
+
+const char* arrivalProcessName(ArrivalProcess arrivals) {
+    return arrivals == ArrivalProcess::CONSTANT ? "constant" : "poisson";
+}
+
+const char* const LoadGenerator::CSV_HEADER =
+    "Index,Arrivals,OfferedQPS,AchievedQPS,Issued,Completed,MaxQueueDepth,Serialized,"
+    "Mean_us,P50_us,P90_us,P99_us,P999_us,Max_us,ServiceP50_us,ServiceP99_us";
+
+LoadGenerator::LoadGenerator(LoadConfig config) : config_(std::move(config)) {
+    if (config_.duration_s <= 0.0) {
+        throw std::invalid_argument("Load duration must be positive");
+    }
+    if (config_.generator_threads == 0 || config_.worker_threads == 0) {
+        throw std::invalid_argument("Load generator needs at least one generator and one worker thread");
+    }
+}
+
+LoadPoint LoadGenerator::run(BaseIndex& index, const std::vector<QueryRange>& queries, double rate_qps) const {
+    if (!(rate_qps > 0.0)) {
+        throw std::invalid_argument("Offered rate must be positive");
+    }
+    if (queries.empty()) {
+        throw std::invalid_argument("Load generator needs at least one query");
+    }
+    
+    LoadPoint point;
+    point.offered_qps = rate_qps;
+    point.serialized = !index.supportsConcurrentQueries();
+    
+    const size_t num_generators = config_.generator_threads;
+    const size_t num_workers = config_.worker_threads;
+    
+    std::mutex queue_mutex;
+    std::condition_variable queue_cv;
+    std::deque<Request> queue;
+    size_t generators_running = num_generators;
+    size_t max_depth = 0;
+    
+    std::mutex index_mutex;  // Only taken when the index is serialized
+    std::atomic<size_t> next_query(0);
+    std::atomic<uint64_t> issued(0);
+    
+    // Every thread starts against the same schedule, a little in the future
+    const Clock::time_point start = Clock::now() + std::chrono::milliseconds(10);
+    const Clock::time_point end = start + std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double>(config_.duration_s));
+    
+    struct WorkerStats {
+        LatencyHistogram latency;
+        LatencyHistogram service;
+        uint64_t completed = 0;
+        Clock::time_point last_completion;
+    };
+    std::vector<WorkerStats> stats(num_workers);
+    
+    std::vector<std::thread> workers;
+    workers.reserve(num_workers);
+    for (size_t w = 0; w < num_workers; ++w) {
+        workers.emplace_back([&, w]() {
+            WorkerStats& mine = stats[w];
+            mine.last_completion = start;
+            while (true) {
+                Request request;
+                {
+                    std::unique_lock<std::mutex> lock(queue_mutex);
+                    queue_cv.wait(lock, [&] { return !queue.empty() || generators_running == 0; });
+                    if (queue.empty()) {
+                        return;
+                    }
+                    request = queue.front();
+                    queue.pop_front();
+                }
+                
+                Clock::time_point begin = Clock::now();
+                if (point.serialized) {
+                    std::lock_guard<std::mutex> lock(index_mutex);
+                    index.query(queries[request.query]);
+                } else {
+                    index.query(queries[request.query]);
+                }
+                Clock::time_point finish = Clock::now();
+                
+                mine.latency.record(nanosBetween(request.intended, finish));
+                mine.service.record(nanosBetween(begin, finish));
+                ++mine.completed;
+                mine.last_completion = std::max(mine.last_completion, finish);
+            }
+        });
+    }
+    
+    std::vector<std::thread> generators;
+    generators.reserve(num_generators);
+    for (size_t g = 0; g < num_generators; ++g) {
+        generators.emplace_back([&, g]() {
+            const double rate = rate_qps / num_generators;
+            std::mt19937_64 rng(config_.seed + g);
+            std::exponential_distribution<double> poisson_gap(rate);
+            const double period = 1.0 / rate;
+            
+            // Constant-rate generators are staggered across one period
+            double offset = config_.arrivals == ArrivalProcess::CONSTANT ?
+                period * g / num_generators : poisson_gap(rng);
+            Clock::time_point intended = start + std::chrono::duration_cast<Clock::duration>(
+                std::chrono::duration<double>(offset));
+            double elapsed = offset;
+            
+            while (intended < end) {
+                // A generator that falls behind sends at once; the request
+                // keeps its intended time, so the delay is still counted
+                sleepUntil(intended);
+                {
+                    std::lock_guard<std::mutex> lock(queue_mutex);
+                    queue.push_back({intended, next_query++ % queries.size()});
+                    max_depth = std::max(max_depth, queue.size());
+                }
+                queue_cv.notify_one();
+                ++issued;
+                
+                elapsed += config_.arrivals == ArrivalProcess::CONSTANT ? period : poisson_gap(rng);
+                intended = start + std::chrono::duration_cast<Clock::duration>(
+                    std::chrono::duration<double>(elapsed));
+            }
+            
+            {
+                std::lock_guard<std::mutex> lock(queue_mutex);
+                --generators_running;
+            }
+            queue_cv.notify_all();
+        });
+    }
+    
+    for (auto& thread : generators) {
+        thread.join();
+    }
+    for (auto& thread : workers) {
+        thread.join();
+    }
+    
+    Clock::time_point last_completion = start;
+    for (const auto& worker : stats) {
+        point.latency.merge(worker.latency);
+        point.service.merge(worker.service);
+        point.completed += worker.completed;
+        last_completion = std::max(last_completion, worker.last_completion);
+    }
+    point.issued = issued;
+    point.max_queue_depth = max_depth;
+    // The window is the sending time, or longer if the backlog took longer to drain
+    double seconds = std::max(config_.duration_s, std::chrono::duration<double>(last_completion - start).count());
+    point.achieved_qps = seconds > 0.0 ? point.completed / seconds : 0.0;
+    
+    return point;
+}
+
+std::vector<LoadPoint> LoadGenerator::sweep(BaseIndex& index, const std::vector<QueryRange>& queries,
+                                            const std::vector<double>& rates_qps) const {
+    std::vector<LoadPoint> curve;
+    for (double rate : rates_qps) {
+        curve.push_back(run(index, queries, rate));
+        const LoadPoint& point = curve.back();
+        std::cout << "  " << std::fixed << std::setprecision(0) << rate << " qps offered: "
+                  << point.achieved_qps << " achieved, p99 "
+                  << std::setprecision(1) << micros(point.latency.valueAtPercentile(99.0)) << " us" << std::endl;
+        
+        if (config_.saturation_cutoff > 0.0 && point.achieved_qps < config_.saturation_cutoff * rate) {
+            std::cout << "  Saturated; stopping the sweep" << std::endl;
+            break;
+        }
+    }
+    return curve;
+}
+
+std::string LoadGenerator::toCSV(const std::string& index_name, ArrivalProcess arrivals, const LoadPoint& point) {
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(3);
+    oss << index_name << "," << arrivalProcessName(arrivals) << ","
+        << point.offered_qps << "," << point.achieved_qps << ","
+        << point.issued << "," << point.completed << ","
+        << point.max_queue_depth << "," << (point.serialized ? 1 : 0) << ","
+        << micros(static_cast<uint64_t>(point.latency.getMean())) << ","
+        << micros(point.latency.valueAtPercentile(50.0)) << ","
+        << micros(point.latency.valueAtPercentile(90.0)) << ","
+        << micros(point.latency.valueAtPercentile(99.0)) << ","
+        << micros(point.latency.valueAtPercentile(99.9)) << ","
+        << micros(point.latency.getMax()) << ","
+        << micros(point.service.valueAtPercentile(50.0)) << ","
+        << micros(point.service.valueAtPercentile(99.0));
+    return oss.str();
+}
+
+void LoadGenerator::printCurve(const std::string& index_name, const std::vector<LoadPoint>& curve) {
+    std::cout << "\n" << index_name << (curve.empty() || !curve[0].serialized ? "" : " (serialized)")
+              << " - latency from intended send time, us:" << std::endl;
+    std::cout << std::setw(12) << "Offered" << std::setw(12) << "Achieved"
+              << std::setw(11) << "p50" << std::setw(11) << "p90" << std::setw(11) << "p99"
+              << std::setw(11) << "p99.9" << std::setw(11) << "max" << std::setw(10) << "Queue" << std::endl;
+    std::cout << std::string(89, '-') << std::endl;
+    for (const auto& point : curve) {
+        std::cout << std::fixed << std::setprecision(0)
+                  << std::setw(12) << point.offered_qps << std::setw(12) << point.achieved_qps
+                  << std::setprecision(1)
+                  << std::setw(11) << micros(point.latency.valueAtPercentile(50.0))
+                  << std::setw(11) << micros(point.latency.valueAtPercentile(90.0))
+                  << std::setw(11) << micros(point.latency.valueAtPercentile(99.0))
+                  << std::setw(11) << micros(point.latency.valueAtPercentile(99.9))
+                  << std::setw(11) << micros(point.latency.getMax())
+                  << std::setw(10) << point.max_queue_depth << std::endl;
+    }
+}
+
+} // namespace flood
@@ -0,0 +1,392 @@
+#include "benchmark/microbench.h"
+#include "benchmark/sweep.h"
+#include "indexes/flood_index.h"
+#include "indexes/curve_index.h"
+#include "indexes/space_filling_curve.h"
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <map>
+#include <memory>
+#include <random>
+#include <stdexcept>
+
+namespace flood {
+
+namespace {
+
+constexpr size_t DIMS = 3;
+
+// Each sample's repeat count is capped so a kernel that is far faster than
+// its registered op count suggests cannot loop for hours
+constexpr size_t MAX_REPEATS = size_t(1) << 30;
+
+double elapsedNs(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+}
+
+double median(std::vector<double> values) {
+    std::sort(values.begin(), values.end());
+    size_t mid = values.size() / 2;
+    return values.size() % 2 ? values[mid] : (values[mid - 1] + values[mid]) / 2.0;
+}
+
+/**
+ * batch_size points in [0, 100)^3, row-major
+ */
+std::vector<double> generateCoords(const std::string& distribution, size_t batch_size, uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    std::vector<double> coords(batch_size * DIMS);
+    
+    if (distribution == "uniform") {
+        for (double& c : coords) {
+            c = 100.0 * unit(rng);
+        }
+    } else if (distribution == "clustered") {
+        // A few tight hot spots, like pickups around transit hubs
+        const size_t NUM_CLUSTERS = 8;
+        std::vector<double> centers(NUM_CLUSTERS * DIMS);
+        for (double& c : centers) {
+            c = 10.0 + 80.0 * unit(rng);
+        }
+        std::normal_distribution<double> spread(0.0, 2.0);
+        std::uniform_int_distribution<size_t> pick(0, NUM_CLUSTERS - 1);
+        for (size_t i = 0; i < batch_size; ++i) {
+            size_t cluster = pick(rng);
+            for (size_t d = 0; d < DIMS; ++d) {
+                double c = centers[cluster * DIMS + d] + spread(rng);
+                coords[i * DIMS + d] = std::min(std::max(c, 0.0), 99.999);
+            }
+        }
+    } else {
+        // Skewed: density falls off polynomially from the origin
+        for (double& c : coords) {
+            double u = unit(rng);
+            c = 100.0 * u * u * u;
+        }
+    }
+    return coords;
+}
+
+/**
+ * Inputs shared by the kernels of one distribution
+ */
+struct KernelInputs {
+    explicit KernelInputs(QueryRange query_box) : box(std::move(query_box)) {}
+    
+    std::vector<double> coords;
+    std::vector<uint32_t> cells;        // 21-bit cells of coords
+    std::vector<DataPoint> points;
+    std::vector<double> projection;
+    std::vector<double> min_bounds;
+    std::vector<double> max_bounds;
+    QueryRange box;
+};
+
+std::shared_ptr<KernelInputs> makeInputs(const std::string& distribution, size_t batch_size, uint32_t seed) {
+    // Central box covering 10% of the volume: selectivity, and with it the
+    // branch pattern, depends on the distribution
+    double side = 100.0 * std::cbrt(0.1);
+    std::vector<double> lo(DIMS, 50.0 - side / 2.0);
+    std::vector<double> hi(DIMS, 50.0 + side / 2.0);
+    
+    auto inputs = std::make_shared<KernelInputs>(QueryRange(lo, hi));
+    inputs->coords = generateCoords(distribution, batch_size, seed);
+    inputs->min_bounds.assign(DIMS, 0.0);
+    inputs->max_bounds.assign(DIMS, 100.0);
+    inputs->projection = FloodIndex::projectionFromVariances(std::vector<double>{4.0, 2.0, 1.0});
+    
+    inputs->cells.resize(inputs->coords.size());
+    inputs->points.reserve(batch_size);
+    for (size_t i = 0; i < batch_size; ++i) {
+        std::vector<double> point(DIMS);
+        for (size_t d = 0; d < DIMS; ++d) {
+            double c = inputs->coords[i * DIMS + d];
+            inputs->cells[i * DIMS + d] = CurveIndex::normalizeToCell(c, 0.0, 100.0, sfc::MORTON_BITS);
+            point[d] = c;
+        }
+        inputs->points.emplace_back(point, i);
+    }
+    return inputs;
+}
+
+} // namespace
+
+const char* const MicroBenchmark::CSV_HEADER =
+    "Kernel,Samples,OpsPerSample,Median_ns,Min_ns,Mean_ns,CI_Low_ns,CI_High_ns,Ops_per_s";
+
+MicroBenchmark::MicroBenchmark(MicroConfig config) : config_(std::move(config)) {
+    if (config_.samples == 0) {
+        throw std::invalid_argument("MicroBenchmark needs at least one sample");
+    }
+    studentT(1, config_.confidence);  // Rejects unsupported confidence levels
+}
+
+void MicroBenchmark::add(const std::string& name, size_t ops_per_call, Kernel kernel) {
+    if (ops_per_call == 0 || !kernel) {
+        throw std::invalid_argument("Kernel " + name + " needs a function and a positive op count");
+    }
+    for (const auto& entry : entries_) {
+        if (entry.name == name) {
+            throw std::invalid_argument("Duplicate kernel: " + name);
+        }
+    }
+    entries_.push_back({name, ops_per_call, std::move(kernel)});
+}
+
+std::vector<std::string> MicroBenchmark::names() const {
+    std::vector<std::string> result;
+    for (const auto& entry : entries_) {
+        if (entry.name.find(config_.filter) != std::string::npos) {
+            result.push_back(entry.name);
+        }
+    }
+    return result;
+}
+
+std::vector<MicroResult> MicroBenchmark::run() const {
+    std::vector<MicroResult> results;
+    for (const auto& entry : entries_) {
+        if (entry.name.find(config_.filter) == std::string::npos) {
+            continue;
+        }
+        results.push_back(measure(entry));
+        if (config_.verbose) {
+            const MicroResult& r = results.back();
+            std::cout << std::left << std::setw(28) << r.name << std::right << std::fixed
+                      << std::setprecision(3) << std::setw(10) << r.median_ns << " ns/op  "
+                      << std::setprecision(1) << std::setw(8) << r.opsPerSecond() / 1e6 << " M/s"
+                      << std::endl;
+        }
+    }
+    return results;
+}
+
+MicroResult MicroBenchmark::measure(const Entry& entry) const {
+    const double min_sample_ns = config_.min_sample_ms * 1e6;
+    
+    // Calibrate (and warm up): grow the repeats until a call is long enough
+    size_t repeats = 1;
+    while (true) {
+        auto start = std::chrono::steady_clock::now();
+        entry.kernel(repeats);
+        double ns = elapsedNs(start);
+        if (ns >= min_sample_ns || repeats >= MAX_REPEATS) {
+            break;
+        }
+        // Jump close to the target once the timing is meaningful
+        double scale = ns > 1e5 ? 1.2 * min_sample_ns / ns : 2.0;
+        repeats = std::min(MAX_REPEATS, std::max(repeats + 1, static_cast<size_t>(repeats * std::min(scale, 10.0))));
+    }
+    
+    MicroResult result;
+    result.name = entry.name;
+    result.samples = config_.samples;
+    result.ops_per_sample = static_cast<uint64_t>(repeats) * entry.ops_per_call;
+    
+    std::vector<double> per_op(config_.samples);
+    for (size_t s = 0; s < config_.samples; ++s) {
+        auto start = std::chrono::steady_clock::now();
+        entry.kernel(repeats);
+        per_op[s] = elapsedNs(start) / result.ops_per_sample;
+    }
+    
+    SweepStat stat = SweepStat::of(per_op, config_.confidence);
+    result.median_ns = median(per_op);
+    result.min_ns = *std::min_element(per_op.begin(), per_op.end());
+    result.mean_ns = stat.mean;
+    result.ci_low_ns = stat.ci_low;
+    result.ci_high_ns = stat.ci_high;
+    return result;
+}
+
+void MicroBenchmark::saveResults(const std::vector<MicroResult>& results, const std::string& filepath) {
+    std::ofstream file(filepath);
+    if (!file.is_open()) {
+        throw std::runtime_error("Cannot write microbenchmark results: " + filepath);
+    }
+    file << CSV_HEADER << "\n";
+    file << std::setprecision(9);
+    for (const auto& r : results) {
+        file << r.name << "," << r.samples << "," << r.ops_per_sample << ","
+             << r.median_ns << "," << r.min_ns << "," << r.mean_ns << ","
+             << r.ci_low_ns << "," << r.ci_high_ns << "," << r.opsPerSecond() << "\n";
+    }
+}
+
+std::vector<MicroResult> MicroBenchmark::loadResults(const std::string& filepath) {
+    std::ifstream file(filepath);
+    if (!file.is_open()) {
+        throw std::runtime_error("Cannot open microbenchmark baseline: " + filepath);
+    }
+    std::vector<MicroResult> results;
+    std::string line;
+    std::getline(file, line);  // Header
+    size_t line_number = 1;
+    while (std::getline(file, line)) {
+        ++line_number;
+        if (line.empty()) {
+            continue;
+        }
+        std::vector<std::string> fields;
+        std::stringstream ss(line);
+        std::string field;
+        while (std::getline(ss, field, ',')) {
+            fields.push_back(field);
+        }
+        if (fields.size() < 8) {
+            throw std::runtime_error(filepath + ":" + std::to_string(line_number) + ": expected 8 fields");
+        }
+        MicroResult r;
+        try {
+            r.name = fields[0];
+            r.samples = std::stoul(fields[1]);
+            r.ops_per_sample = std::stoull(fields[2]);
+            r.median_ns = std::stod(fields[3]);
+            r.min_ns = std::stod(fields[4]);
+            r.mean_ns = std::stod(fields[5]);
+            r.ci_low_ns = std::stod(fields[6]);
+            r.ci_high_ns = std::stod(fields[7]);
+        } catch (const std::exception&) {
+            throw std::runtime_error(filepath + ":" + std::to_string(line_number) + ": bad number");
+        }
+        results.push_back(r);
+    }
+    return results;
+}
+
+std::vector<MicroComparison> MicroBenchmark::compare(const std::vector<MicroResult>& baseline,
+                                                     const std::vector<MicroResult>& current,
+                                                     double threshold) {
+    std::map<std::string, const MicroResult*> by_name;
+    for (const auto& r : baseline) {
+        by_name[r.name] = &r;
+    }
+    
+    std::vector<MicroComparison> comparison;
+    for (const auto& r : current) {
+        MicroComparison c;
+        c.name = r.name;
+        c.current_ns = r.median_ns;
+        auto it = by_name.find(r.name);
+        if (it != by_name.end() && it->second->median_ns > 0.0) {
+            const MicroResult& base = *it->second;
+            c.baseline_ns = base.median_ns;
+            c.change = r.median_ns / base.median_ns - 1.0;
+            c.regression = c.change > threshold && r.ci_low_ns > base.ci_high_ns;
+            c.improvement = c.change < -threshold && r.ci_high_ns < base.ci_low_ns;
+        }
+        comparison.push_back(c);
+    }
+    return comparison;
+}
+
+void MicroBenchmark::printResults(const std::vector<MicroResult>& results) {
+    std::cout << std::left << std::setw(28) << "Kernel" << std::right
+              << std::setw(12) << "Median ns" << std::setw(12) << "Min ns"
+              << std::setw(30) << "Mean ns (CI)" << std::setw(12) << "M ops/s" << std::endl;
+    std::cout << std::string(94, '-') << std::endl;
+    for (const auto& r : results) {
+        std::ostringstream ci;
+        ci << std::fixed << std::setprecision(3) << r.mean_ns << " ("
+           << r.ci_low_ns << "-" << r.ci_high_ns << ")";
+        std::cout << std::left << std::setw(28) << r.name << std::right << std::fixed
+                  << std::setprecision(3) << std::setw(12) << r.median_ns
+                  << std::setw(12) << r.min_ns << std::setw(30) << ci.str()
+                  << std::setprecision(1) << std::setw(12) << r.opsPerSecond() / 1e6 << std::endl;
+    }
+}
+
+void MicroBenchmark::printComparison(const std::vector<MicroComparison>& comparison) {
+    std::cout << std::left << std::setw(28) << "Kernel" << std::right
+              << std::setw(14) << "Baseline ns" << std::setw(14) << "Current ns"
+              << std::setw(10) << "Change" << "  Verdict" << std::endl;
+    std::cout << std::string(76, '-') << std::endl;
+    for (const auto& c : comparison) {
+        std::cout << std::left << std::setw(28) << c.name << std::right << std::fixed << std::setprecision(3);
+        if (c.baseline_ns > 0.0) {
+            std::ostringstream change;
+            change << std::showpos << std::fixed << std::setprecision(1) << c.change * 100.0 << "%";
+            std::cout << std::setw(14) << c.baseline_ns << std::setw(14) << c.current_ns
+                      << std::setw(10) << change.str() << "  "
+                      << (c.regression ? "SLOWER" : c.improvement ? "faster" : "same") << std::endl;
+        } else {
+            std::cout << std::setw(14) << "-" << std::setw(14) << c.current_ns
+                      << std::setw(10) << "-" << "  new" << std::endl;
+        }
+    }
+}
+
+void addIndexKernels(MicroBenchmark& bench, size_t batch_size, uint32_t seed) {
+    if (batch_size == 0) {
+        throw std::invalid_argument("Microbenchmark batch size must be positive");
+    }
+    
+    const char* const DISTRIBUTIONS[] = {"uniform", "clustered", "skewed"};
+    for (const char* dist : DISTRIBUTIONS) {
+        std::shared_ptr<const KernelInputs> in = makeInputs(dist, batch_size, seed);
+        const std::string suffix = std::string("/") + dist;
+        
+        bench.add("flattened_key" + suffix, batch_size, [in, batch_size](size_t repeats) {
+            for (size_t r = 0; r < repeats; ++r) {
+                for (size_t i = 0; i < batch_size; ++i) {
+                    doNotOptimize(FloodIndex::flattenedKey(&in->coords[i * DIMS], in->projection,
+                                                           in->min_bounds, in->max_bounds));
+                }
+            }
+        });
+        
+        bench.add("normalize" + suffix, batch_size * DIMS, [in, batch_size](size_t repeats) {
+            for (size_t r = 0; r < repeats; ++r) {
+                for (size_t i = 0; i < batch_size; ++i) {
+                    for (size_t d = 0; d < DIMS; ++d) {
+                        doNotOptimize(CurveIndex::normalizeToCell(in->coords[i * DIMS + d], in->min_bounds[d],
+                                                                  in->max_bounds[d], sfc::MORTON_BITS));
+                    }
+                }
+            }
+        });
+        
+        bench.add("morton3d" + suffix, batch_size, [in, batch_size](size_t repeats) {
+            const uint32_t* cells = in->cells.data();
+            for (size_t r = 0; r < repeats; ++r) {
+                for (size_t i = 0; i < batch_size; ++i) {
+                    doNotOptimize(sfc::mortonEncode3D(cells[i * DIMS], cells[i * DIMS + 1], cells[i * DIMS + 2]));
+                }
+            }
+        });
+        
+        bench.add("morton3d_magic" + suffix, batch_size, [in, batch_size](size_t repeats) {
+            const uint32_t* cells = in->cells.data();
+            for (size_t r = 0; r < repeats; ++r) {
+                for (size_t i = 0; i < batch_size; ++i) {
+                    doNotOptimize(sfc::mortonEncode3DMagic(cells[i * DIMS], cells[i * DIMS + 1], cells[i * DIMS + 2]));
+                }
+            }
+        });
+        
+        bench.add("hilbert3d" + suffix, batch_size, [in, batch_size](size_t repeats) {
+            for (size_t r = 0; r < repeats; ++r) {
+                for (size_t i = 0; i < batch_size; ++i) {
+                    sfc::Key128 key = sfc::hilbertEncode(&in->cells[i * DIMS], DIMS, sfc::MORTON_BITS);
+                    doNotOptimize(static_cast<uint64_t>(key));
+                }
+            }
+        });
+        
+        bench.add("contains" + suffix, batch_size, [in](size_t repeats) {
+            for (size_t r = 0; r < repeats; ++r) {
+                for (const auto& point : in->points) {
+                    doNotOptimize(in->box.contains(point));
+                }
+            }
+        });
+    }
+}
+
+} // namespace flood
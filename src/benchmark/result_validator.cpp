@@ -0,0 +1,109 @@
+#include "benchmark/result_validator.h"
+#include <algorithm>
+#include <stdexcept>
+
+namespace flood {
+
+namespace {
+
+// Rows per parallel task; the mask of a chunk stays in L1/L2
+constexpr size_t CHUNK_ROWS = 16384;
+
+} // namespace
+
+ResultValidator::ResultValidator(const std::vector<DataPoint>& data, size_t num_threads)
+    : pool_(num_threads) {
+    size_t dims = data.empty() ? 0 : data[0].getDimensions();
+    columns_.assign(dims, std::vector<double>(data.size()));
+    ids_.resize(data.size());
+    for (size_t i = 0; i < data.size(); ++i) {
+        if (data[i].getDimensions() != dims) {
+            throw std::invalid_argument("ResultValidator needs points of equal dimensionality");
+        }
+        for (size_t d = 0; d < dims; ++d) {
+            columns_[d][i] = data[i].getCoordinate(d);
+        }
+        ids_[i] = data[i].getId();
+    }
+}
+
+std::vector<uint64_t> ResultValidator::expectedIds(const QueryRange& range) {
+    const size_t n = ids_.size();
+    const size_t dims = std::min(columns_.size(), range.getDimensions());
+    std::vector<double> lo(dims);
+    std::vector<double> hi(dims);
+    for (size_t d = 0; d < dims; ++d) {
+        lo[d] = range.getMinBound(d);
+        hi[d] = range.getMaxBound(d);
+    }
+    
+    const size_t num_chunks = (n + CHUNK_ROWS - 1) / CHUNK_ROWS;
+    std::vector<std::vector<uint64_t>> matches(num_chunks);
+    pool_.parallelFor(num_chunks, [&](size_t c) {
+        const size_t begin = c * CHUNK_ROWS;
+        const size_t rows = std::min(n, begin + CHUNK_ROWS) - begin;
+        std::vector<uint8_t> mask(rows, 1);
+        for (size_t d = 0; d < dims; ++d) {
+            const double* col = columns_[d].data() + begin;
+            const double low = lo[d];
+            const double high = hi[d];
+            // Written as !(c < lo) & !(c > hi) to match contains() exactly
+            // (NaN included) and without branches, so it vectorizes
+            for (size_t i = 0; i < rows; ++i) {
+                mask[i] &= static_cast<uint8_t>(!(col[i] < low) & !(col[i] > high));
+            }
+        }
+        for (size_t i = 0; i < rows; ++i) {
+            if (mask[i]) {
+                matches[c].push_back(ids_[begin + i]);
+            }
+        }
+    });
+    
+    std::vector<uint64_t> ids;
+    for (const auto& part : matches) {
+        ids.insert(ids.end(), part.begin(), part.end());
+    }
+    std::sort(ids.begin(), ids.end());
+    return ids;
+}
+
+QueryValidation ResultValidator::check(const QueryRange& range, const std::vector<DataPoint>& results,
+                                       size_t query) {
+    QueryValidation validation;
+    validation.query = query;
+    
+    std::vector<uint64_t> expected = expectedIds(range);
+    std::vector<uint64_t> returned;
+    returned.reserve(results.size());
+    for (const auto& point : results) {
+        returned.push_back(point.getId());
+    }
+    std::sort(returned.begin(), returned.end());
+    validation.expected = expected.size();
+    validation.returned = returned.size();
+    
+    // Multiset difference in one merge pass
+    size_t e = 0;
+    size_t r = 0;
+    auto report = [](std::vector<uint64_t>& ids, size_t& count, uint64_t id) {
+        if (ids.size() < MAX_REPORTED_IDS) {
+            ids.push_back(id);
+        }
+        ++count;
+    };
+    while (e < expected.size() || r < returned.size()) {
+        if (r == returned.size() || (e < expected.size() && expected[e] < returned[r])) {
+            report(validation.missing_ids, validation.missing, expected[e++]);
+        } else if (e == expected.size() || returned[r] < expected[e]) {
+            report(validation.extra_ids, validation.extra, returned[r++]);
+        } else {
+            ++e;
+            ++r;
+        }
+    }
+    
+    return validation;
+}
+
+} // namespace flood
@@ -2,34 +2,84 @@
 #include <memory>
 #include <vector>
 #include <string>
+#include <sstream>
+#include <iomanip>
+#include <cstdlib>
+#include <algorithm>
+#include <cctype>
+#include <numeric>
 
 #include "data/data_point.h"
-#include "indexes/kdtree_index.h"
-#include "indexes/zorder_index.h"
-#include "indexes/rtree_index.h"
-#include "indexes/flood_index.h"
+#include "data/columnar_dataset.h"
+#include "data/synthetic_generator.h"
+#include "indexes/sharded_index.h"
+#include "indexes/router_index.h"
 #include "benchmark/workload_generator.h"
 #include "benchmark/benchmark.h"
+#include "benchmark/index_factory.h"
+#include "benchmark/sweep.h"
 
 using namespace flood;
 
-// Generate synthetic data for testing
-std::vector<DataPoint> generateSyntheticData(size_t num_points, size_t dimensions) {
-    std::vector<DataPoint> data;
-    data.reserve(num_points);
-    
-    std::mt19937 rng(42);
-    std::uniform_real_distribution<double> dist(0.0, 100.0);
-    
-    for (size_t i = 0; i < num_points; ++i) {
-        std::vector<double> coords(dimensions);
-        for (size_t j = 0; j < dimensions; ++j) {
-            coords[j] = dist(rng);
-        }
-        data.emplace_back(coords, i);
+void printUsage(const char* prog) {
+    std::cerr << "Usage: " << prog << " [--indexes name[,name...]] [--shards N] [--shard-by key|space|rr]"
+              << " [--data file.fcol] [--coords double|float32|fixed32] [--recheck] [--perf]"
+              << " [--validate [N]] [--workloads name[,name...]] [--trace file] [--calibrate]"
+              << " [--distribution name] [--size N] [--mix Q/I[/D][,...]] [--rebuild-every N]"
+              << " [--operations N] [--cold [MB]] [--output file]" << std::endl;
+    std::cerr << "  Indexes: " << INDEX_NAMES << std::endl;
+    std::cerr << "  Default: kdtree,zorder,hilbert,grid,octree,rtree,flood,tsunami" << std::endl;
+    std::cerr << "  --shards N wraps every index in a ShardedIndex of N shards (default 1)" << std::endl;
+    std::cerr << "  --data loads a columnar dataset (see process_data) instead of synthetic data" << std::endl;
+    std::cerr << "  --output sets the results CSV (default benchmark_results.csv); the per-query and" << std::endl;
+    std::cerr << "    read/write CSVs go to the same directory" << std::endl;
+    std::cerr << "  --distribution picks the synthetic data: uniform (default), clustered, correlated," << std::endl;
+    std::cerr << "    anti-correlated, power-law or nyc; --size sets its number of points (default 50K)" << std::endl;
+    std::cerr << "  --coords stores coordinates compactly in indexes that support it (4 bytes per" << std::endl;
+    std::cerr << "    coordinate; hits may lie up to one quantization step outside the query); --recheck" << std::endl;
+    std::cerr << "    also keeps exact doubles to recheck boundary hits (exact, but 12 bytes per coordinate)" << std::endl;
+    std::cerr << "  --perf collects hardware counters per build and per query (perf_event_open) and" << std::endl;
+    std::cerr << "    writes per-query latency and counters to benchmark_queries.csv" << std::endl;
+    std::cerr << "  --validate checks query results against a brute-force scan (N evenly spaced" << std::endl;
+    std::cerr << "    queries per run, default all) and exits with status 3 if any are wrong" << std::endl;
+    std::cerr << "  --workloads picks from spatial, temporal, mixed, centered, hotspot, rush-hour" << std::endl;
+    std::cerr << "    and zone (default spatial,temporal,mixed); --trace adds a replayed workload file" << std::endl;
+    std::cerr << "  --calibrate sizes each generated query to return its workload's selectivity" << std::endl;
+    std::cerr << "    (within 10%) on the data, rather than that fraction of the domain" << std::endl;
+    std::cerr << "  --cold also times every query right after flushing the CPU caches (sweeping a" << std::endl;
+    std::cerr << "    buffer of MB, default 2x the last-level cache), as after an idle period" << std::endl;
+    std::cerr << "  --mix adds read/write runs, one per query/insert/delete mix (e.g. 90/10,50/25/25):" << std::endl;
+    std::cerr << "    each index is built on the older half of the data, then --operations (default" << std::endl;
+    std::cerr << "    10000) operations interleave the first workload's queries with time-ordered" << std::endl;
+    std::cerr << "    inserts of the rest and deletes; indexes that cannot insert are rebuilt every" << std::endl;
+    std::cerr << "    --rebuild-every updates (default 1000, 0 = never). Writes mixed_results.csv" << std::endl;
+}
+
+// Result label and selectivity of each workload in the suite
+std::string workloadLabel(WorkloadType type) {
+    switch (type) {
+        case WorkloadType::SPATIAL: return "Workload_A_Spatial";
+        case WorkloadType::TEMPORAL: return "Workload_B_Temporal";
+        case WorkloadType::MIXED: return "Workload_C_Mixed";
+        case WorkloadType::RUSH_HOUR: return "Workload_RushHour";
+        default: break;
+    }
+    std::string name = workloadTypeName(type);
+    name[0] = static_cast<char>(std::toupper(static_cast<unsigned char>(name[0])));
+    return "Workload_" + name;
+}
+
+double workloadSelectivity(WorkloadType type) {
+    switch (type) {
+        case WorkloadType::TEMPORAL:
+        case WorkloadType::RUSH_HOUR:
+            return 0.005;
+        case WorkloadType::MIXED:
+        case WorkloadType::CENTERED:
+            return 0.01;
+        default:
+            return 0.001;
     }
-    
-    return data;
 }
 
 int main(int argc, char* argv[]) {
@@ -40,27 +90,211 @@ int main(int argc, char* argv[]) {
     // Configuration
     size_t data_size = 50000;  // 50K points
     size_t dimensions = 3;      // 3D data (x, y, time)
+    Distribution distribution = Distribution::UNIFORM;
     size_t num_queries = 100;   // 100 queries per workload
+    std::string index_list = "kdtree,zorder,hilbert,grid,octree,rtree,flood,tsunami";
+    size_t num_shards = 1;
+    ShardPartitioning partitioning = ShardPartitioning::SPACE;
+    std::string data_file;
+    std::string output_file = "benchmark_results.csv";
+    CoordinateEncoding encoding = CoordinateEncoding::DOUBLE;
+    bool exact_recheck = false;
+    bool perf_counters = false;
+    bool validate = false;
+    size_t validation_sample = 0;
+    std::vector<WorkloadType> workload_types = {WorkloadType::SPATIAL, WorkloadType::TEMPORAL, WorkloadType::MIXED};
+    std::string trace_file;
+    bool calibrate = false;
+    std::vector<OperationMix> mixes;
+    size_t rebuild_every = 1000;
+    size_t num_operations = 10000;
+    bool cold_cache = false;
+    size_t flush_mb = 0;
+    
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--indexes" && i + 1 < argc) {
+            index_list = argv[++i];
+        } else if (arg.rfind("--indexes=", 0) == 0) {
+            index_list = arg.substr(std::string("--indexes=").size());
+        } else if (arg == "--data" && i + 1 < argc) {
+            data_file = argv[++i];
+        } else if (arg == "--output" && i + 1 < argc) {
+            output_file = argv[++i];
+        } else if ((arg == "--distribution" || arg == "--size") && i + 1 < argc) {
+            try {
+                if (arg == "--distribution") {
+                    distribution = parseDistribution(argv[++i]);
+                } else {
+                    data_size = parseSizeList(argv[++i]).front();
+                }
+            } catch (const std::invalid_argument& e) {
+                std::cerr << e.what() << std::endl;
+                printUsage(argv[0]);
+                return 1;
+            }
+        } else if (arg == "--coords" && i + 1 < argc) {
+            try {
+                encoding = parseCoordinateEncoding(argv[++i]);
+            } catch (const std::invalid_argument&) {
+                printUsage(argv[0]);
+                return 1;
+            }
+        } else if (arg == "--recheck") {
+            exact_recheck = true;
+        } else if (arg == "--perf") {
+            perf_counters = true;
+        } else if (arg == "--validate") {
+            validate = true;
+            if (i + 1 < argc && std::isdigit(static_cast<unsigned char>(argv[i + 1][0]))) {
+                validation_sample = std::strtoull(argv[++i], nullptr, 10);
+            }
+        } else if (arg == "--workloads" && i + 1 < argc) {
+            workload_types.clear();
+            std::stringstream names(argv[++i]);
+            std::string workload;
+            try {
+                while (std::getline(names, workload, ',')) {
+                    workload_types.push_back(parseWorkloadType(workload));
+                    if (workload_types.back() == WorkloadType::TRACE) {
+                        throw std::invalid_argument("Use --trace to replay a workload");
+                    }
+                }
+            } catch (const std::invalid_argument& e) {
+                std::cerr << e.what() << std::endl;
+                printUsage(argv[0]);
+                return 1;
+            }
+        } else if (arg == "--trace" && i + 1 < argc) {
+            trace_file = argv[++i];
+        } else if (arg == "--calibrate") {
+            calibrate = true;
+        } else if (arg == "--mix" && i + 1 < argc) {
+            std::stringstream list(argv[++i]);
+            std::string mix;
+            try {
+                while (std::getline(list, mix, ',')) {
+                    mixes.push_back(parseOperationMix(mix));
+                }
+            } catch (const std::invalid_argument& e) {
+                std::cerr << e.what() << std::endl;
+                printUsage(argv[0]);
+                return 1;
+            }
+        } else if (arg == "--cold") {
+            cold_cache = true;
+            if (i + 1 < argc && std::isdigit(static_cast<unsigned char>(argv[i + 1][0]))) {
+                flush_mb = std::strtoull(argv[++i], nullptr, 10);
+            }
+        } else if (arg == "--rebuild-every" && i + 1 < argc) {
+            rebuild_every = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--operations" && i + 1 < argc) {
+            num_operations = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--shards" && i + 1 < argc) {
+            num_shards = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--shard-by" && i + 1 < argc) {
+            std::string mode = argv[++i];
+            if (mode == "key") {
+                partitioning = ShardPartitioning::KEY_RANGE;
+            } else if (mode == "space") {
+                partitioning = ShardPartitioning::SPACE;
+            } else if (mode == "rr") {
+                partitioning = ShardPartitioning::ROUND_ROBIN;
+            } else {
+                printUsage(argv[0]);
+                return 1;
+            }
+        } else {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
     
     std::cout << "Configuration:" << std::endl;
-    std::cout << "  Data size: " << data_size << " points" << std::endl;
-    std::cout << "  Dimensions: " << dimensions << std::endl;
+    if (data_file.empty()) {
+        std::cout << "  Data size: " << data_size << " points" << std::endl;
+        std::cout << "  Dimensions: " << dimensions << std::endl;
+        std::cout << "  Distribution: " << distributionName(distribution) << std::endl;
+    } else {
+        std::cout << "  Data file: " << data_file << std::endl;
+    }
     std::cout << "  Queries per workload: " << num_queries << std::endl;
+    if (num_shards > 1) {
+        std::cout << "  Shards per index: " << num_shards << std::endl;
+    }
+    if (validate) {
+        std::cout << "  Validation: " << (validation_sample == 0 ? std::string("every query") :
+                                          std::to_string(validation_sample) + " queries per run") << std::endl;
+    }
+    if (!mixes.empty()) {
+        std::cout << "  Read/write mixes:";
+        for (const auto& mix : mixes) {
+            std::cout << " " << mix.toString();
+        }
+        std::cout << " (" << num_operations << " operations, rebuild every " << rebuild_every << " updates)"
+                  << std::endl;
+    }
+    if (encoding != CoordinateEncoding::DOUBLE) {
+        std::cout << "  Coordinates: " << coordinateEncodingName(encoding)
+                  << (exact_recheck ? " (exact recheck)" : " (no recheck)") << std::endl;
+    }
     std::cout << std::endl;
     
-    // Generate synthetic data
-    std::cout << "Generating synthetic data..." << std::endl;
-    auto data = generateSyntheticData(data_size, dimensions);
-    std::cout << "Generated " << data.size() << " points" << std::endl;
+    // Map a columnar dataset, or generate synthetic data
+    std::vector<DataPoint> data;
+    if (!data_file.empty()) {
+        std::cout << "Mapping dataset..." << std::endl;
+        try {
+            ColumnarDataset dataset(data_file);
+            data = dataset.toDataPoints();
+        } catch (const std::exception& e) {
+            std::cerr << "Error: " << e.what() << std::endl;
+            return 1;
+        }
+        std::cout << "Loaded " << data.size() << " points, "
+                  << (data.empty() ? 0 : data[0].getDimensions()) << " dimensions" << std::endl;
+    } else {
+        std::cout << "Generating synthetic data..." << std::endl;
+        SyntheticConfig synthetic;
+        synthetic.distribution = distribution;
+        synthetic.dimensions = dimensions;
+        data = SyntheticGenerator(synthetic).generate(data_size);
+        std::cout << "Generated " << data.size() << " points" << std::endl;
+    }
     std::cout << std::endl;
     
+    // Training sample for workload-aware indexes, drawn separately from
+    // the benchmark workloads (a replayed trace is never trained on)
+    std::vector<QueryRange> training_queries;
+    {
+        WorkloadGenerator training_generator(7);
+        for (auto type : workload_types) {
+            WorkloadConfig config(type, num_queries, 0.005);
+            auto sample = training_generator.generateWorkload(data, config);
+            training_queries.insert(training_queries.end(), sample.begin(), sample.end());
+        }
+    }
+    
     // Create indexes
     std::cout << "Creating indexes..." << std::endl;
     std::vector<std::shared_ptr<BaseIndex>> indexes;
-    indexes.push_back(std::make_shared<KDTreeIndex>());
-    indexes.push_back(std::make_shared<ZOrderIndex>());
-    indexes.push_back(std::make_shared<RTreeIndex>());
-    indexes.push_back(std::make_shared<FloodIndex>());
+    std::stringstream index_names(index_list);
+    std::string name;
+    while (std::getline(index_names, name, ',')) {
+        auto index = createIndex(name, training_queries);
+        if (!index) {
+            std::cerr << "Unknown index: " << name << std::endl;
+            printUsage(argv[0]);
+            return 1;
+        }
+        if (num_shards > 1) {
+            index = std::make_shared<ShardedIndex>(
+                [name, training_queries]() { return createIndex(name, training_queries); },
+                num_shards, partitioning);
+        }
+        index->setCoordinateStorage(encoding, exact_recheck);
+        indexes.push_back(index);
+    }
     std::cout << "Created " << indexes.size() << " indexes" << std::endl;
     std::cout << std::endl;
     
@@ -70,21 +304,23 @@ int main(int argc, char* argv[]) {
     
     std::vector<std::pair<std::string, std::vector<QueryRange>>> workloads;
     
-    // Workload A: Spatial queries (0.1% selectivity)
-    WorkloadConfig config_a(WorkloadType::SPATIAL, num_queries, 0.001);
-    auto workload_a = generator.generateWorkload(data, config_a);
-    workloads.push_back({"Workload_A_Spatial", workload_a});
-    
-    // Workload B: Temporal queries (0.5% selectivity)
-    WorkloadConfig config_b(WorkloadType::TEMPORAL, num_queries, 0.005);
-    config_b.temporal_range_hours = 24.0;
-    auto workload_b = generator.generateWorkload(data, config_b);
-    workloads.push_back({"Workload_B_Temporal", workload_b});
-    
-    // Workload C: Mixed queries (1% selectivity)
-    WorkloadConfig config_c(WorkloadType::MIXED, num_queries, 0.01);
-    auto workload_c = generator.generateWorkload(data, config_c);
-    workloads.push_back({"Workload_C_Mixed", workload_c});
+    // Workload A: spatial (0.1%), B: temporal (0.5%, 24 h windows) and
+    // C: mixed (1%) by default, then any data-driven workloads and a trace
+    if (!trace_file.empty()) {
+        workload_types.push_back(WorkloadType::TRACE);
+    }
+    try {
+        for (auto type : workload_types) {
+            WorkloadConfig config(type, num_queries, workloadSelectivity(type));
+            config.temporal_range_hours = 24.0;
+            config.trace_file = trace_file;
+            config.calibrate = calibrate;
+            workloads.push_back({workloadLabel(type), generator.generateWorkload(data, config)});
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
     
     std::cout << "Generated " << workloads.size() << " workloads" << std::endl;
     std::cout << std::endl;
@@ -92,13 +328,50 @@ int main(int argc, char* argv[]) {
     // Run benchmarks
     Benchmark benchmark;
     benchmark.setVerbose(true);
-    benchmark.setWarmupQueries(10);
+    // Warm runs start with every query of the workload run once
+    benchmark.setWarmupQueries(num_queries);
+    benchmark.setColdCache(cold_cache, flush_mb << 20);
+    if (perf_counters && !benchmark.setPerfCounters(true)) {
+        std::cout << "Continuing without hardware counters" << std::endl;
+    }
+    benchmark.setValidation(validate, validation_sample);
     
     auto results = benchmark.runSuite(indexes, data, workloads);
     
-    // Save results
-    std::string output_file = "benchmark_results.csv";
+    // Save results; the other CSVs go next to the main one
+    const std::string output_dir = output_file.substr(0, output_file.find_last_of('/') + 1);
     benchmark.saveResults(results, output_file);
+    if (benchmark.getPerfCounters() || cold_cache) {
+        benchmark.saveQueryTrace(results, output_dir + "benchmark_queries.csv");
+    }
+    
+    // Read/write streams over the first workload's query type
+    std::vector<MixedResult> mixed_results;
+    if (!mixes.empty() && !workloads.empty()) {
+        std::cout << "\n========================================" << std::endl;
+        std::cout << "  Read/Write Workloads" << std::endl;
+        std::cout << "========================================" << std::endl;
+        benchmark.setRebuildPolicy(rebuild_every);
+        try {
+            for (const auto& mix : mixes) {
+                MixedWorkloadConfig config;
+                config.mix = mix;
+                config.num_operations = num_operations;
+                config.queries = WorkloadConfig(workload_types.front(), 0, workloadSelectivity(workload_types.front()));
+                config.queries.trace_file = trace_file;
+                config.queries.calibrate = calibrate;
+                MixedWorkload stream = generator.generateOperationStream(data, config);
+                std::cout << "\n--- Mix " << mix.toString() << " (" << workloads.front().first << ") ---" << std::endl;
+                for (auto& index : indexes) {
+                    mixed_results.push_back(benchmark.runMixedBenchmark(index.get(), stream, workloads.front().first));
+                }
+            }
+        } catch (const std::exception& e) {
+            std::cerr << "Error: " << e.what() << std::endl;
+            return 1;
+        }
+        benchmark.saveMixedResults(mixed_results, output_dir + "mixed_results.csv");
+    }
     
     // Print summary
     std::cout << "\n========================================" << std::endl;
@@ -113,8 +386,12 @@ int main(int argc, char* argv[]) {
                   << std::setw(15) << "Build(ms)"
                   << std::setw(15) << "Size(MB)"
                   << std::setw(15) << "AvgQuery(ms)"
-                  << std::setw(15) << "P95(ms)" << std::endl;
-        std::cout << std::string(71, '-') << std::endl;
+                  << std::setw(15) << "P95(ms)"
+                  << std::setw(12) << "Runs/Query";
+        if (cold_cache) {
+            std::cout << std::setw(15) << "ColdAvg(ms)" << std::setw(15) << "ColdP95(ms)";
+        }
+        std::cout << std::endl << std::string(cold_cache ? 113 : 83, '-') << std::endl;
         
         for (const auto& result : results) {
             if (result.workload_name == workload_name) {
@@ -122,12 +399,123 @@ int main(int argc, char* argv[]) {
                           << std::setw(15) << result.build_time_ms
                           << std::setw(15) << result.index_size_mb
                           << std::setw(15) << result.avg_query_time_ms
-                          << std::setw(15) << result.p95_query_time_ms << std::endl;
+                          << std::setw(15) << result.p95_query_time_ms
+                          << std::setw(12) << result.avg_scanned_runs;
+                if (result.cold_measured) {
+                    std::cout << std::setw(15) << result.cold_avg_query_time_ms
+                              << std::setw(15) << result.cold_p95_query_time_ms;
+                }
+                std::cout << std::endl;
+            }
+        }
+    }
+    
+    if (!mixed_results.empty()) {
+        std::cout << "\nRead/write (" << workloads.front().first << "):" << std::endl;
+        std::cout << std::setw(12) << "Index" << std::setw(10) << "Mix"
+                  << std::setw(15) << "Query(ms)" << std::setw(15) << "Insert(ms)"
+                  << std::setw(15) << "Delete(ms)" << std::setw(10) << "Rebuilds"
+                  << std::setw(15) << "Rebuild(ms)" << std::setw(12) << "Slowdown" << std::endl;
+        std::cout << std::string(104, '-') << std::endl;
+        auto mean = [](const std::vector<double>& times) {
+            return times.empty() ? 0.0 : std::accumulate(times.begin(), times.end(), 0.0) / times.size();
+        };
+        for (const auto& result : mixed_results) {
+            std::cout << std::setw(12) << result.index_name << std::setw(10) << result.mix
+                      << std::setw(15) << mean(result.query_times_ms)
+                      << std::setw(15) << mean(result.insert_times_ms)
+                      << std::setw(15) << mean(result.delete_times_ms)
+                      << std::setw(10) << result.rebuilds
+                      << std::setw(15) << result.rebuild_time_ms
+                      << std::setw(12) << result.degradation() << std::endl;
+        }
+    }
+    
+    // Where the time goes: per-query counters for each index
+    if (benchmark.getPerfCounters()) {
+        std::cout << "\nHardware counters per query:" << std::endl;
+        std::cout << std::setprecision(2);
+        for (const auto& [workload_name, queries] : workloads) {
+            std::cout << "\n" << workload_name << ":" << std::endl;
+            std::cout << std::setw(12) << "Index" << std::setw(12) << "Cycles" << std::setw(8) << "IPC";
+            for (auto event : {PerfEvent::L1D_MISSES, PerfEvent::LLC_MISSES,
+                               PerfEvent::BRANCH_MISSES, PerfEvent::DTLB_MISSES}) {
+                std::cout << std::setw(14) << perfEventName(event);
+            }
+            std::cout << std::endl << std::string(88, '-') << std::endl;
+            
+            for (const auto& result : results) {
+                if (result.workload_name != workload_name || queries.empty()) {
+                    continue;
+                }
+                const PerfSample& counters = result.query_counters;
+                auto per_query = [&](PerfEvent event) -> std::string {
+                    if (!counters.has(event)) return "n/a";
+                    return std::to_string(counters.get(event) / queries.size());
+                };
+                std::cout << std::setw(12) << result.index_name << std::setw(12) << per_query(PerfEvent::CYCLES)
+                          << std::setw(8) << counters.ipc();
+                for (auto event : {PerfEvent::L1D_MISSES, PerfEvent::LLC_MISSES,
+                                   PerfEvent::BRANCH_MISSES, PerfEvent::DTLB_MISSES}) {
+                    std::cout << std::setw(14) << per_query(event);
+                }
+                std::cout << std::endl;
+            }
+        }
+    }
+    
+    // Router decisions and regret against the per-query oracle
+    for (const auto& index : indexes) {
+        auto* router = dynamic_cast<RouterIndex*>(index.get());
+        if (!router) {
+            continue;
+        }
+        
+        std::cout << "\nRouter picks (all workloads):" << std::endl;
+        auto counts = router->getRouteCounts();
+        for (size_t i = 0; i < counts.size(); ++i) {
+            std::cout << std::setw(12) << router->getIndexes()[i]->getName()
+                      << std::setw(8) << counts[i] << std::endl;
+        }
+        for (const auto& [workload_name, queries] : workloads) {
+            std::cout << "\n" << workload_name << ":" << std::endl;
+            router->evaluateRegret(queries).print();
+        }
+    }
+    
+    // Speedups only count if the results are right
+    size_t wrong_runs = 0;
+    if (validate) {
+        std::cout << "\nResult validation:" << std::endl;
+        for (const auto& result : results) {
+            if (result.failed_queries > 0) {
+                std::cout << std::setw(12) << result.index_name << "  " << result.workload_name << ": "
+                          << result.failed_queries << " of " << result.validated_queries
+                          << " queries wrong" << std::endl;
+                ++wrong_runs;
             }
         }
+        for (const auto& result : mixed_results) {
+            if (result.failed_queries > 0) {
+                std::cout << std::setw(12) << result.index_name << "  mix " << result.mix << ": "
+                          << result.failed_queries << " of " << result.validated_queries
+                          << " queries wrong" << std::endl;
+                ++wrong_runs;
+            }
+        }
+        if (wrong_runs == 0) {
+            std::cout << "  All " << results.size() + mixed_results.size() << " runs returned correct results"
+                      << std::endl;
+        }
     }
     
     std::cout << "\n========================================" << std::endl;
+    if (wrong_runs > 0) {
+        std::cout << "Benchmark completed with WRONG RESULTS in " << wrong_runs << " runs" << std::endl;
+        std::cout << "Results saved to: " << output_file << std::endl;
+        std::cout << "========================================" << std::endl;
+        return 3;
+    }
     std::cout << "Benchmark completed successfully!" << std::endl;
     std::cout << "Results saved to: " << output_file << std::endl;
     std::cout << "========================================" << std::endl;
@@ -0,0 +1,156 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <stdexcept>
+
+#include "data/columnar_dataset.h"
+#include "data/synthetic_generator.h"
+#include "benchmark/workload_generator.h"
+#include "benchmark/load_generator.h"
+#include "benchmark/index_factory.h"
+#include "benchmark/sweep.h"
+
+using namespace flood;
+
+void printUsage(const char* prog) {
+    std::cerr << "Usage: " << prog << " [options]" << std::endl;
+    std::cerr << "  --indexes <list>      Indexes to load, one curve each (default flood); any of" << std::endl;
+    std::cerr << "                        " << INDEX_NAMES << std::endl;
+    std::cerr << "  --rates <list>        Offered rates in queries/s, e.g. 1K,5K or 1K:64K:x2 (default)" << std::endl;
+    std::cerr << "  --arrivals <kind>     poisson (default) or constant" << std::endl;
+    std::cerr << "  --duration <s>        Sending time per rate (default 2)" << std::endl;
+    std::cerr << "  --workers <n>         Query threads sharing the index (default 4)" << std::endl;
+    std::cerr << "  --generators <n>      Request generator threads (default 1)" << std::endl;
+    std::cerr << "  --no-stop             Run every rate, also past saturation" << std::endl;
+    std::cerr << "  --data <file.fcol>    Columnar dataset (default: uniform synthetic data)" << std::endl;
+    std::cerr << "  --distribution <d>    Synthetic data: uniform (default), clustered, correlated," << std::endl;
+    std::cerr << "                        anti-correlated, power-law or nyc" << std::endl;
+    std::cerr << "  --size <n>            Synthetic data size (default 100K)" << std::endl;
+    std::cerr << "  --queries <n>         Distinct queries, cycled through (default 1000)" << std::endl;
+    std::cerr << "  --workload <kind>     spatial, temporal, mixed (default), centered, hotspot," << std::endl;
+    std::cerr << "                        rush-hour or zone" << std::endl;
+    std::cerr << "  --trace <file>        Replay a saved workload instead" << std::endl;
+    std::cerr << "  --selectivity <x>     Query selectivity (default 0.001)" << std::endl;
+    std::cerr << "  --calibrate           Size each query to return the selectivity on the data" << std::endl;
+    std::cerr << "  --output <file>       Curve CSV (default load_curve.csv)" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    LoadConfig config;
+    std::string index_list = "flood";
+    std::vector<double> rates = {1000, 2000, 4000, 8000, 16000, 32000, 64000};
+    std::string data_file;
+    size_t data_size = 100000;
+    SyntheticConfig synthetic;
+    size_t num_queries = 1000;
+    WorkloadType workload = WorkloadType::MIXED;
+    std::string trace_file;
+    bool calibrate = false;
+    double selectivity = 0.001;
+    std::string output_file = "load_curve.csv";
+    
+    try {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            bool has_value = i + 1 < argc;
+            if (arg == "--no-stop") {
+                config.saturation_cutoff = 0.0;
+            } else if (arg == "--indexes" && has_value) {
+                index_list = argv[++i];
+            } else if (arg == "--rates" && has_value) {
+                rates = parseValueList(argv[++i]);
+            } else if (arg == "--arrivals" && has_value) {
+                config.arrivals = parseArrivalProcess(argv[++i]);
+            } else if (arg == "--duration" && has_value) {
+                config.duration_s = std::stod(argv[++i]);
+            } else if (arg == "--workers" && has_value) {
+                config.worker_threads = std::stoul(argv[++i]);
+            } else if (arg == "--generators" && has_value) {
+                config.generator_threads = std::stoul(argv[++i]);
+            } else if (arg == "--data" && has_value) {
+                data_file = argv[++i];
+            } else if (arg == "--distribution" && has_value) {
+                synthetic.distribution = parseDistribution(argv[++i]);
+            } else if (arg == "--size" && has_value) {
+                data_size = parseSizeList(argv[++i]).front();
+            } else if (arg == "--queries" && has_value) {
+                num_queries = parseSizeList(argv[++i]).front();
+            } else if (arg == "--workload" && has_value) {
+                workload = parseWorkloadType(argv[++i]);
+            } else if (arg == "--trace" && has_value) {
+                workload = WorkloadType::TRACE;
+                trace_file = argv[++i];
+            } else if (arg == "--calibrate") {
+                calibrate = true;
+            } else if (arg == "--selectivity" && has_value) {
+                selectivity = std::stod(argv[++i]);
+            } else if (arg == "--output" && has_value) {
+                output_file = argv[++i];
+            } else {
+                printUsage(argv[0]);
+                return 1;
+            }
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        printUsage(argv[0]);
+        return 1;
+    }
+    
+    try {
+        LoadGenerator generator(config);
+        
+        std::vector<DataPoint> data;
+        if (!data_file.empty()) {
+            data = ColumnarDataset(data_file).toDataPoints();
+        } else {
+            data = SyntheticGenerator(synthetic).generate(data_size);
+        }
+        
+        WorkloadConfig workload_config(workload, num_queries, selectivity);
+        workload_config.trace_file = trace_file;
+        workload_config.calibrate = calibrate;
+        std::vector<QueryRange> queries = WorkloadGenerator(42).generateWorkload(data, workload_config);
+        workload_config.num_queries = 100;
+        std::vector<QueryRange> training_queries = WorkloadGenerator(7).generateWorkload(data, workload_config);
+        
+        std::ofstream csv(output_file);
+        if (!csv.is_open()) {
+            throw std::runtime_error("Cannot write " + output_file);
+        }
+        csv << LoadGenerator::CSV_HEADER << "\n";
+        
+        std::cout << "Open-loop load: " << data.size() << " points, " << queries.size() << " queries, "
+                  << arrivalProcessName(config.arrivals) << " arrivals, " << config.generator_threads
+                  << " generator(s), " << config.worker_threads << " worker(s), "
+                  << config.duration_s << " s per rate" << std::endl;
+        
+        std::stringstream names(index_list);
+        std::string name;
+        while (std::getline(names, name, ',')) {
+            auto index = createIndex(name, training_queries);
+            if (!index) {
+                throw std::invalid_argument("Unknown index: " + name);
+            }
+            index->build(data);
+            
+            std::cout << "\n" << index->getName() << ":" << std::endl;
+            std::vector<LoadPoint> curve = generator.sweep(*index, queries, rates);
+            LoadGenerator::printCurve(index->getName(), curve);
+            for (const auto& point : curve) {
+                csv << LoadGenerator::toCSV(index->getName(), config.arrivals, point) << "\n";
+            }
+            csv.flush();
+        }
+        
+        std::cout << "\nLatency-throughput curve saved to " << output_file << std::endl;
+        std::cout << "Plot with: python3 tools/generate_plots.py --load " << output_file << std::endl;
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+    
+    return 0;
+}
@@ -0,0 +1,113 @@
+#include <iostream>
+#include <string>
+#include <stdexcept>
+
+#include "benchmark/microbench.h"
+
+using namespace flood;
+
+void printUsage(const char* prog) {
+    std::cerr << "Usage: " << prog << " [options]" << std::endl;
+    std::cerr << "  --filter <text>     Only kernels whose name contains text" << std::endl;
+    std::cerr << "  --list              List kernels and exit" << std::endl;
+    std::cerr << "  --samples <n>       Timed samples per kernel (default 20)" << std::endl;
+    std::cerr << "  --min-time <ms>     Minimum duration of one sample (default 10)" << std::endl;
+    std::cerr << "  --batch <n>         Inputs per kernel call (default 4096)" << std::endl;
+    std::cerr << "  --seed <n>          Input generator seed (default 42)" << std::endl;
+    std::cerr << "  --save <file>       Write results as CSV (e.g. to keep as a baseline)" << std::endl;
+    std::cerr << "  --baseline <file>   Compare against saved results; exits 2 on a regression" << std::endl;
+    std::cerr << "  --threshold <x>     Relative change treated as noise (default 0.05)" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    MicroConfig config;
+    size_t batch_size = 4096;
+    uint32_t seed = 42;
+    double threshold = 0.05;
+    std::string save_path;
+    std::string baseline_path;
+    bool list_only = false;
+    
+    try {
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            bool has_value = i + 1 < argc;
+            if (arg == "--list") {
+                list_only = true;
+            } else if (arg == "--filter" && has_value) {
+                config.filter = argv[++i];
+            } else if (arg == "--samples" && has_value) {
+                config.samples = std::stoul(argv[++i]);
+            } else if (arg == "--min-time" && has_value) {
+                config.min_sample_ms = std::stod(argv[++i]);
+            } else if (arg == "--batch" && has_value) {
+                batch_size = std::stoul(argv[++i]);
+            } else if (arg == "--seed" && has_value) {
+                seed = static_cast<uint32_t>(std::stoul(argv[++i]));
+            } else if (arg == "--save" && has_value) {
+                save_path = argv[++i];
+            } else if (arg == "--baseline" && has_value) {
+                baseline_path = argv[++i];
+            } else if (arg == "--threshold" && has_value) {
+                threshold = std::stod(argv[++i]);
+            } else {
+                printUsage(argv[0]);
+                return 1;
+            }
+        }
+    } catch (const std::exception&) {
+        printUsage(argv[0]);
+        return 1;
+    }
+    
+    try {
+        MicroBenchmark bench(config);
+        addIndexKernels(bench, batch_size, seed);
+        
+        if (list_only) {
+            for (const auto& name : bench.names()) {
+                std::cout << name << std::endl;
+            }
+            return 0;
+        }
+        
+        // Load the baseline first so a bad path fails before the run
+        std::vector<MicroResult> baseline;
+        if (!baseline_path.empty()) {
+            baseline = MicroBenchmark::loadResults(baseline_path);
+        }
+        
+        std::cout << "Microbenchmarks: " << bench.names().size() << " kernels, "
+                  << config.samples << " samples of >= " << config.min_sample_ms
+                  << " ms, batch " << batch_size << std::endl;
+        std::vector<MicroResult> results = bench.run();
+        
+        std::cout << std::endl;
+        MicroBenchmark::printResults(results);
+        
+        if (!save_path.empty()) {
+            MicroBenchmark::saveResults(results, save_path);
+            std::cout << "\nResults saved to " << save_path << std::endl;
+        }
+        
+        if (!baseline_path.empty()) {
+            std::vector<MicroComparison> comparison = MicroBenchmark::compare(baseline, results, threshold);
+            std::cout << "\nAgainst " << baseline_path << ":" << std::endl;
+            MicroBenchmark::printComparison(comparison);
+            
+            size_t regressions = 0;
+            for (const auto& c : comparison) {
+                regressions += c.regression ? 1 : 0;
+            }
+            if (regressions > 0) {
+                std::cout << "\n" << regressions << " kernel(s) regressed" << std::endl;
+                return 2;
+            }
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+    
+    return 0;
+}
@@ -0,0 +1,79 @@
+#include <iostream>
+#include <string>
+#include <stdexcept>
+
+#include "benchmark/sweep.h"
+#include "benchmark/index_factory.h"
+
+using namespace flood;
+
+void printUsage(const char* prog) {
+    std::cerr << "Usage: " << prog << " [--config file] [--<key> value ...] [--dry-run]" << std::endl;
+    std::cerr << "  Keys (also 'key = value' lines in the config file; flags override it):" << std::endl;
+    std::cerr << "    sizes          data sizes, e.g. 1K,10K or 1K:100M:x10 (default 10K,100K)" << std::endl;
+    std::cerr << "    dims           dimensionalities (default 3)" << std::endl;
+    std::cerr << "    selectivities  e.g. 0.0001:0.01:x10 (default 0.001,0.01)" << std::endl;
+    std::cerr << "    queries        queries per trial (default 100)" << std::endl;
+    std::cerr << "    workloads      spatial, temporal, mixed, centered, hotspot, rush-hour, zone" << std::endl;
+    std::cerr << "                   (default mixed)" << std::endl;
+    std::cerr << "    calibrate      true: size each query to return the selectivity (default false)" << std::endl;
+    std::cerr << "    distribution   synthetic data: uniform (default), clustered, correlated," << std::endl;
+    std::cerr << "                   anti-correlated, power-law or nyc" << std::endl;
+    std::cerr << "    indexes        default kdtree,grid,flood; any of " << INDEX_NAMES << std::endl;
+    std::cerr << "    shards         shard counts (default 1)" << std::endl;
+    std::cerr << "    coords         double, float32, fixed32 (default double)" << std::endl;
+    std::cerr << "    recheck        true: also keep exact doubles so compact coords give exact" << std::endl;
+    std::cerr << "                   results (12 instead of 4 bytes per coordinate; default false)" << std::endl;
+    std::cerr << "    trials         repetitions per point (default 5)" << std::endl;
+    std::cerr << "    confidence     0.90, 0.95 or 0.99 (default 0.95)" << std::endl;
+    std::cerr << "    seed           base random seed (default 42)" << std::endl;
+    std::cerr << "    output         tidy CSV path (default sweep_results.csv)" << std::endl;
+    std::cerr << "  Plot with: python3 tools/generate_plots.py --sweep sweep_results.csv" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    SweepConfig config;
+    bool dry_run = false;
+    
+    try {
+        // The config file is applied first so flags override it
+        for (int i = 1; i + 1 < argc; ++i) {
+            if (std::string(argv[i]) == "--config") {
+                config.loadFile(argv[i + 1]);
+            }
+        }
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            if (arg == "--dry-run") {
+                dry_run = true;
+            } else if (arg == "--config" && i + 1 < argc) {
+                ++i;
+            } else if (arg.rfind("--", 0) == 0 && i + 1 < argc) {
+                config.set(arg.substr(2), argv[++i]);
+            } else {
+                printUsage(argv[0]);
+                return 1;
+            }
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        printUsage(argv[0]);
+        return 1;
+    }
+    
+    std::cout << "Parameter sweep: " << config.numConfigurations() << " configurations x "
+              << config.trials << " trials -> " << config.output << std::endl;
+    if (dry_run) {
+        return 0;
+    }
+    
+    try {
+        size_t rows = ParameterSweep(config).run();
+        std::cout << "Wrote " << rows << " rows to " << config.output << std::endl;
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+    
+    return 0;
+}
@@ -0,0 +1,413 @@
+#include "benchmark/sweep.h"
+#include "benchmark/benchmark.h"
+#include "benchmark/index_factory.h"
+#include "benchmark/workload_generator.h"
+#include "indexes/sharded_index.h"
+#include "data/synthetic_generator.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <stdexcept>
+
+namespace flood {
+
+namespace {
+
+// Two-sided critical values for 1..30 degrees of freedom; beyond that the
+// normal quantile (the t distribution is within 2% of it there)
+constexpr double T_90[30] = {6.314, 2.920, 2.353, 2.132, 2.015, 1.943, 1.895, 1.860, 1.833, 1.812,
+                             1.796, 1.782, 1.771, 1.761, 1.753, 1.746, 1.740, 1.734, 1.729, 1.725,
+                             1.721, 1.717, 1.714, 1.711, 1.708, 1.706, 1.703, 1.701, 1.699, 1.697};
+constexpr double T_95[30] = {12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+                             2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+                             2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042};
+constexpr double T_99[30] = {63.657, 9.925, 5.841, 4.604, 4.032, 3.707, 3.499, 3.355, 3.250, 3.169,
+                             3.106, 3.055, 3.012, 2.977, 2.947, 2.921, 2.898, 2.878, 2.861, 2.845,
+                             2.831, 2.819, 2.807, 2.797, 2.787, 2.779, 2.771, 2.763, 2.756, 2.750};
+
+std::string trim(const std::string& text) {
+    size_t begin = text.find_first_not_of(" \t\r\n");
+    if (begin == std::string::npos) {
+        return "";
+    }
+    size_t end = text.find_last_not_of(" \t\r\n");
+    return text.substr(begin, end - begin + 1);
+}
+
+std::vector<std::string> splitList(const std::string& text) {
+    std::vector<std::string> items;
+    std::stringstream stream(text);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        item = trim(item);
+        if (!item.empty()) {
+            items.push_back(item);
+        }
+    }
+    return items;
+}
+
+// A number with an optional K/M/G suffix
+double parseNumber(const std::string& text) {
+    std::string body = trim(text);
+    double multiplier = 1.0;
+    if (!body.empty()) {
+        char suffix = static_cast<char>(std::toupper(static_cast<unsigned char>(body.back())));
+        if (suffix == 'K') multiplier = 1e3;
+        if (suffix == 'M') multiplier = 1e6;
+        if (suffix == 'G') multiplier = 1e9;
+        if (multiplier != 1.0) body.pop_back();
+    }
+    size_t used = 0;
+    double value = 0.0;
+    try {
+        value = std::stod(body, &used);
+    } catch (const std::exception&) {
+        used = 0;
+    }
+    if (used == 0 || used != body.size()) {
+        throw std::invalid_argument("Not a number: " + text);
+    }
+    return value * multiplier;
+}
+
+std::vector<double> parseNumbers(const std::string& text) {
+    std::vector<double> values;
+    size_t colon = text.find(':');
+    if (colon == std::string::npos) {
+        for (const auto& item : splitList(text)) {
+            values.push_back(parseNumber(item));
+        }
+    } else {
+        // start:end:xfactor
+        size_t second = text.find(':', colon + 1);
+        std::string factor_text = second == std::string::npos ? "" : trim(text.substr(second + 1));
+        if (factor_text.empty() || (factor_text[0] != 'x' && factor_text[0] != 'X')) {
+            throw std::invalid_argument("Expected start:end:xfactor, got " + text);
+        }
+        double start = parseNumber(text.substr(0, colon));
+        double end = parseNumber(text.substr(colon + 1, second - colon - 1));
+        double factor = parseNumber(factor_text.substr(1));
+        if (start <= 0.0 || factor <= 1.0) {
+            throw std::invalid_argument("Range needs start > 0 and factor > 1: " + text);
+        }
+        // Tolerate rounding in the last step (1e-3 * 10 * 10 != 1e-1)
+        for (double value = start; value <= end * (1.0 + 1e-9); value *= factor) {
+            values.push_back(value);
+        }
+    }
+    if (values.empty()) {
+        throw std::invalid_argument("Empty value list: " + text);
+    }
+    return values;
+}
+
+// Generated workloads only: a replayed trace has no selectivity or query count to sweep
+WorkloadType parseWorkload(const std::string& name) {
+    WorkloadType type = parseWorkloadType(name);
+    if (type == WorkloadType::TRACE) {
+        throw std::invalid_argument("Trace workloads cannot be swept");
+    }
+    return type;
+}
+
+size_t parseCount(const std::string& text) {
+    double value = parseNumber(text);
+    if (value < 1.0 || value != std::floor(value)) {
+        throw std::invalid_argument("Expected a positive integer: " + text);
+    }
+    return static_cast<size_t>(value);
+}
+
+} // namespace
+
+double studentT(size_t degrees_of_freedom, double confidence) {
+    const double* table = nullptr;
+    double normal = 0.0;
+    if (std::abs(confidence - 0.90) < 1e-9) {
+        table = T_90;
+        normal = 1.645;
+    } else if (std::abs(confidence - 0.95) < 1e-9) {
+        table = T_95;
+        normal = 1.960;
+    } else if (std::abs(confidence - 0.99) < 1e-9) {
+        table = T_99;
+        normal = 2.576;
+    } else {
+        throw std::invalid_argument("Supported confidence levels are 0.90, 0.95 and 0.99");
+    }
+    if (degrees_of_freedom == 0) {
+        return 0.0;
+    }
+    return degrees_of_freedom <= 30 ? table[degrees_of_freedom - 1] : normal;
+}
+
+SweepStat SweepStat::of(const std::vector<double>& samples, double confidence) {
+    SweepStat stat;
+    stat.trials = samples.size();
+    if (samples.empty()) {
+        return stat;
+    }
+    double sum = 0.0;
+    for (double sample : samples) {
+        sum += sample;
+    }
+    stat.mean = sum / samples.size();
+    if (samples.size() > 1) {
+        double squares = 0.0;
+        for (double sample : samples) {
+            squares += (sample - stat.mean) * (sample - stat.mean);
+        }
+        stat.stddev = std::sqrt(squares / (samples.size() - 1));
+    }
+    double half_width = studentT(samples.size() - 1, confidence) * stat.stddev / std::sqrt(samples.size());
+    stat.ci_low = stat.mean - half_width;
+    stat.ci_high = stat.mean + half_width;
+    return stat;
+}
+
+std::vector<size_t> parseSizeList(const std::string& text) {
+    std::vector<size_t> sizes;
+    for (double value : parseNumbers(text)) {
+        if (value < 1.0) {
+            throw std::invalid_argument("Sizes must be positive: " + text);
+        }
+        sizes.push_back(static_cast<size_t>(std::llround(value)));
+    }
+    return sizes;
+}
+
+std::vector<double> parseValueList(const std::string& text) {
+    return parseNumbers(text);
+}
+
+void SweepConfig::set(const std::string& key, const std::string& value) {
+    // Values are parsed in full before anything is assigned, so a bad
+    // value leaves the configuration unchanged
+    if (key == "sizes") {
+        data_sizes = parseSizeList(value);
+    } else if (key == "dims") {
+        dimensions = parseSizeList(value);
+    } else if (key == "selectivities") {
+        std::vector<double> values = parseValueList(value);
+        for (double selectivity : values) {
+            if (selectivity <= 0.0 || selectivity > 1.0) {
+                throw std::invalid_argument("Selectivities must lie in (0, 1]: " + value);
+            }
+        }
+        selectivities = values;
+    } else if (key == "queries") {
+        query_counts = parseSizeList(value);
+    } else if (key == "shards") {
+        shards = parseSizeList(value);
+    } else if (key == "workloads" || key == "indexes" || key == "coords") {
+        std::vector<std::string> names = splitList(value);
+        if (names.empty()) {
+            throw std::invalid_argument("Empty value for " + key);
+        }
+        for (const auto& name : names) {
+            if (key == "workloads") parseWorkload(name);
+            if (key == "coords") parseCoordinateEncoding(name);
+        }
+        if (key == "workloads") {
+            workloads = names;
+        } else if (key == "indexes") {
+            indexes = names;
+        } else {
+            coords = names;
+        }
+    } else if (key == "calibrate" || key == "recheck") {
+        std::string flag = trim(value);
+        bool enabled;
+        if (flag == "true" || flag == "1") {
+            enabled = true;
+        } else if (flag == "false" || flag == "0") {
+            enabled = false;
+        } else {
+            throw std::invalid_argument("Expected true or false for " + key + ": " + value);
+        }
+        (key == "calibrate" ? calibrate : recheck) = enabled;
+    } else if (key == "distribution") {
+        parseDistribution(trim(value));
+        distribution = trim(value);
+    } else if (key == "trials") {
+        trials = parseCount(value);
+    } else if (key == "confidence") {
+        double level = parseNumber(value);
+        studentT(1, level);
+        confidence = level;
+    } else if (key == "seed") {
+        seed = static_cast<uint32_t>(parseNumber(value));
+    } else if (key == "output") {
+        if (trim(value).empty()) {
+            throw std::invalid_argument("Empty value for output");
+        }
+        output = trim(value);
+    } else {
+        throw std::invalid_argument("Unknown sweep parameter: " + key);
+    }
+}
+
+void SweepConfig::loadFile(const std::string& path) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        throw std::runtime_error("Failed to open sweep config: " + path);
+    }
+    std::string line;
+    size_t line_number = 0;
+    while (std::getline(file, line)) {
+        ++line_number;
+        line = trim(line.substr(0, line.find('#')));
+        if (line.empty()) {
+            continue;
+        }
+        size_t equals = line.find('=');
+        if (equals == std::string::npos) {
+            throw std::invalid_argument(path + ":" + std::to_string(line_number) + ": expected key = value");
+        }
+        set(trim(line.substr(0, equals)), trim(line.substr(equals + 1)));
+    }
+}
+
+size_t SweepConfig::numConfigurations() const {
+    return data_sizes.size() * dimensions.size() * workloads.size() * selectivities.size() *
+           query_counts.size() * indexes.size() * shards.size() * coords.size();
+}
+
+const char* const ParameterSweep::CSV_HEADER =
+    "Index,Config,Shards,Coords,Workload,DataSize,Dimensions,Selectivity,"
+    "NumQueries,Metric,Trials,Mean,StdDev,CI_Low,CI_High,Confidence";
+
+ParameterSweep::ParameterSweep(SweepConfig config) : config_(std::move(config)) {}
+
+size_t ParameterSweep::run() {
+    // Validate index names up front rather than hours into the sweep
+    for (const auto& name : config_.indexes) {
+        if (!createIndex(name, {})) {
+            throw std::invalid_argument("Unknown index: " + name);
+        }
+    }
+    
+    std::ofstream file(config_.output);
+    if (!file.is_open()) {
+        throw std::runtime_error("Failed to open " + config_.output + " for writing");
+    }
+    file << CSV_HEADER << "\n";
+    
+    struct IndexConfig {
+        std::string name;
+        size_t shards;
+        std::string coords;
+    };
+    std::vector<IndexConfig> index_configs;
+    for (const auto& name : config_.indexes) {
+        for (size_t shards : config_.shards) {
+            for (const auto& coords : config_.coords) {
+                index_configs.push_back({name, shards, coords});
+            }
+        }
+    }
+    
+    static const char* const METRICS[] = {"BuildTime_ms", "IndexSize_MB", "AvgQueryTime_ms",
+                                          "P95QueryTime_ms", "P99QueryTime_ms", "Throughput_qps",
+                                          "ScanOverhead", "AchievedSelectivity"};
+    constexpr size_t NUM_METRICS = sizeof(METRICS) / sizeof(METRICS[0]);
+    
+    Benchmark benchmark;
+    benchmark.setVerbose(false);
+    benchmark.setWarmupQueries(10);
+    
+    size_t rows = 0;
+    size_t point = 0;
+    const size_t total_points = config_.numConfigurations() / index_configs.size();
+    
+    for (size_t data_size : config_.data_sizes) {
+        for (size_t dims : config_.dimensions) {
+            SyntheticConfig synthetic;
+            synthetic.distribution = parseDistribution(config_.distribution);
+            synthetic.dimensions = dims;
+            synthetic.seed = config_.seed;
+            std::vector<DataPoint> data = SyntheticGenerator(synthetic).generate(data_size);
+            
+            for (const auto& workload : config_.workloads) {
+                for (double selectivity : config_.selectivities) {
+                    for (size_t num_queries : config_.query_counts) {
+                        ++point;
+                        std::cout << "[" << point << "/" << total_points << "] " << data_size << " points, "
+                                  << dims << "-d, " << workload << ", selectivity " << selectivity
+                                  << ", " << num_queries << " queries" << std::endl;
+                        
+                        // samples[config][metric] holds one value per trial
+                        std::vector<std::vector<std::vector<double>>> samples(
+                            index_configs.size(), std::vector<std::vector<double>>(NUM_METRICS));
+                        std::vector<std::string> index_names(index_configs.size());
+                        
+                        for (size_t trial = 0; trial < config_.trials; ++trial) {
+                            uint32_t trial_seed = config_.seed + 1000 * static_cast<uint32_t>(trial + 1);
+                            WorkloadGenerator generator(trial_seed);
+                            WorkloadConfig workload_config(parseWorkload(workload), num_queries, selectivity);
+                            workload_config.seed = trial_seed;
+                            workload_config.calibrate = config_.calibrate;
+                            auto queries = generator.generateWorkload(data, workload_config);
+                            workload_config.seed = trial_seed + 1;
+                            auto training_queries = generator.generateWorkload(data, workload_config);
+                            
+                            for (size_t c = 0; c < index_configs.size(); ++c) {
+                                const IndexConfig& index_config = index_configs[c];
+                                std::shared_ptr<BaseIndex> index;
+                                if (index_config.shards > 1) {
+                                    std::string name = index_config.name;
+                                    index = std::make_shared<ShardedIndex>(
+                                        [name, training_queries]() { return createIndex(name, training_queries); },
+                                        index_config.shards);
+                                } else {
+                                    index = createIndex(index_config.name, training_queries);
+                                }
+                                index->setCoordinateStorage(parseCoordinateEncoding(index_config.coords), config_.recheck);
+                                
+                                BenchmarkResult result = benchmark.runBenchmark(index.get(), data, queries, workload);
+                                index_names[c] = result.index_name;
+                                double values[NUM_METRICS] = {
+                                    result.build_time_ms, result.index_size_mb, result.avg_query_time_ms,
+                                    result.p95_query_time_ms, result.p99_query_time_ms,
+                                    result.avg_query_time_ms > 0.0 ? 1000.0 / result.avg_query_time_ms : 0.0,
+                                    result.scan_overhead,
+                                    result.total_queries > 0 ?
+                                        static_cast<double>(result.total_results) / result.total_queries / data.size() : 0.0
+                                };
+                                for (size_t m = 0; m < NUM_METRICS; ++m) {
+                                    samples[c][m].push_back(values[m]);
+                                }
+                            }
+                        }
+                        
+                        for (size_t c = 0; c < index_configs.size(); ++c) {
+                            for (size_t m = 0; m < NUM_METRICS; ++m) {
+                                SweepStat stat = SweepStat::of(samples[c][m], config_.confidence);
+                                file << index_names[c] << "," << index_configs[c].name << ","
+                                     << index_configs[c].shards << "," << index_configs[c].coords
+                                     << (config_.recheck && index_configs[c].coords != "double" ? "+recheck" : "")
+                                     << ","
+                                     << workload << "," << data_size << "," << dims << ","
+                                     << selectivity << "," << num_queries << "," << METRICS[m] << ","
+                                     << stat.trials << "," << std::setprecision(6) << stat.mean << ","
+                                     << stat.stddev << "," << stat.ci_low << "," << stat.ci_high << ","
+                                     << config_.confidence << "\n";
+                                ++rows;
+                            }
+                        }
+                        file.flush();
+                    }
+                }
+            }
+        }
+    }
+    
+    return rows;
+}
+
+} // namespace flood
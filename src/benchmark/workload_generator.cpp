@@ -1,11 +1,147 @@
 #include "benchmark/workload_generator.h"
+#include "utils/thread_pool.h"
 #include <iostream>
 #include <fstream>
+#include <iomanip>
+#include <sstream>
 #include <cmath>
 #include <limits>
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
 
 namespace flood {
 
+namespace {
+
+const double SECONDS_PER_DAY = 86400.0;
+
+// Points per parallel task of measureSelectivity
+const size_t SELECTIVITY_CHUNK = 4096;
+
+// Weekday morning and evening peaks, in seconds since midnight
+const double PEAK_HOURS[2][2] = {{7 * 3600.0, 10 * 3600.0}, {16 * 3600.0, 19 * 3600.0}};
+
+/**
+ * Restrict one dimension of a query to extent around center, shifted to
+ * stay inside the domain
+ */
+void placeAround(size_t dim, double center, double extent,
+                 const std::vector<double>& min_bounds, const std::vector<double>& max_bounds,
+                 std::vector<double>& query_min, std::vector<double>& query_max) {
+    if (extent >= max_bounds[dim] - min_bounds[dim]) {
+        query_min[dim] = min_bounds[dim];
+        query_max[dim] = max_bounds[dim];
+        return;
+    }
+    double start = std::min(std::max(center - extent / 2, min_bounds[dim]), max_bounds[dim] - extent);
+    query_min[dim] = start;
+    query_max[dim] = start + extent;
+}
+
+/**
+ * Peak (0 or 1) whose hours contain a timestamp, or -1
+ */
+int peakOf(double timestamp, bool weekdays_only) {
+    double day = std::floor(timestamp / SECONDS_PER_DAY);
+    double time_of_day = timestamp - day * SECONDS_PER_DAY;
+    if (weekdays_only) {
+        // Day 0 (1970-01-01) was a Thursday; count from Monday = 0
+        int64_t weekday = ((static_cast<int64_t>(day) + 3) % 7 + 7) % 7;
+        if (weekday >= 5) {
+            return -1;
+        }
+    }
+    for (int peak = 0; peak < 2; ++peak) {
+        if (time_of_day >= PEAK_HOURS[peak][0] && time_of_day < PEAK_HOURS[peak][1]) {
+            return peak;
+        }
+    }
+    return -1;
+}
+
+/**
+ * Smallest scale s such that the box center +- s * half_widths (on dims)
+ * contains k of the points, with coordinate(i, dim) giving point i
+ */
+template <typename Coordinate>
+double scaleForCount(size_t num_points, Coordinate coordinate,
+                     const std::vector<double>& center, const std::vector<double>& half_widths,
+                     const std::vector<size_t>& dims, size_t k, std::vector<double>& radius) {
+    radius.resize(num_points);
+    for (size_t i = 0; i < num_points; ++i) {
+        double r = 0.0;
+        for (size_t dim : dims) {
+            r = std::max(r, std::fabs(coordinate(i, dim) - center[dim]) / half_widths[dim]);
+        }
+        radius[i] = r;
+    }
+    k = std::min(std::max(k, size_t(1)), num_points);
+    std::nth_element(radius.begin(), radius.begin() + (k - 1), radius.end());
+    return radius[k - 1];
+}
+
+} // namespace
+
+WorkloadType parseWorkloadType(const std::string& name) {
+    if (name == "spatial") return WorkloadType::SPATIAL;
+    if (name == "temporal") return WorkloadType::TEMPORAL;
+    if (name == "mixed") return WorkloadType::MIXED;
+    if (name == "centered") return WorkloadType::CENTERED;
+    if (name == "hotspot") return WorkloadType::HOTSPOT;
+    if (name == "rush-hour") return WorkloadType::RUSH_HOUR;
+    if (name == "zone") return WorkloadType::ZONE;
+    if (name == "trace") return WorkloadType::TRACE;
+    throw std::invalid_argument("Unknown workload: " + name);
+}
+
+const char* workloadTypeName(WorkloadType type) {
+    switch (type) {
+        case WorkloadType::SPATIAL: return "spatial";
+        case WorkloadType::TEMPORAL: return "temporal";
+        case WorkloadType::MIXED: return "mixed";
+        case WorkloadType::CENTERED: return "centered";
+        case WorkloadType::HOTSPOT: return "hotspot";
+        case WorkloadType::RUSH_HOUR: return "rush-hour";
+        case WorkloadType::ZONE: return "zone";
+        case WorkloadType::TRACE: return "trace";
+    }
+    return "unknown";
+}
+
+std::string OperationMix::toString() const {
+    std::ostringstream oss;
+    oss << std::llround(query * 100) << "/" << std::llround(insert * 100) << "/" << std::llround(remove * 100);
+    return oss.str();
+}
+
+OperationMix parseOperationMix(const std::string& text) {
+    std::vector<double> shares;
+    std::stringstream parts(text);
+    std::string part;
+    try {
+        while (std::getline(parts, part, '/')) {
+            size_t used = 0;
+            shares.push_back(std::stod(part, &used));
+            if (used != part.size() || !(shares.back() >= 0.0)) {
+                throw std::invalid_argument(part);
+            }
+        }
+    } catch (const std::logic_error&) {
+        shares.clear();
+    }
+    double total = std::accumulate(shares.begin(), shares.end(), 0.0);
+    if (shares.size() < 2 || shares.size() > 3 || !(total > 0.0)) {
+        throw std::invalid_argument("Bad operation mix: " + text +
+                                    " (expected query/insert[/delete] shares, e.g. 90/10 or 50/25/25)");
+    }
+    OperationMix mix;
+    mix.query = shares[0] / total;
+    mix.insert = shares[1] / total;
+    mix.remove = shares.size() > 2 ? shares[2] / total : 0.0;
+    return mix;
+}
+
 WorkloadGenerator::WorkloadGenerator(uint32_t seed) : rng_(seed) {}
 
 std::vector<QueryRange> WorkloadGenerator::generateWorkload(
@@ -13,21 +149,65 @@ std::vector<QueryRange> WorkloadGenerator::generateWorkload(
     const WorkloadConfig& config) {
     
     rng_.seed(config.seed);
+    achieved_selectivities_.clear();
     
+    std::vector<QueryRange> workload;
     switch (config.type) {
         case WorkloadType::SPATIAL:
-            return generateSpatialWorkload(data, config.num_queries, config.selectivity);
+            workload = generateSpatialWorkload(data, config.num_queries, config.selectivity);
+            break;
         
         case WorkloadType::TEMPORAL:
-            return generateTemporalWorkload(data, config.num_queries, 
-                                          config.selectivity, config.temporal_range_hours);
+            workload = generateTemporalWorkload(data, config.num_queries,
+                                                config.selectivity, config.temporal_range_hours);
+            break;
         
         case WorkloadType::MIXED:
-            return generateMixedWorkload(data, config.num_queries, config.selectivity);
+            workload = generateMixedWorkload(data, config.num_queries, config.selectivity);
+            break;
+        
+        case WorkloadType::CENTERED:
+            workload = generateCenteredWorkload(data, config.num_queries, config.selectivity);
+            break;
+        
+        case WorkloadType::HOTSPOT:
+            workload = generateHotspotWorkload(data, config.num_queries, config.selectivity,
+                                               config.num_hotspots, config.zipf_exponent);
+            break;
+        
+        case WorkloadType::RUSH_HOUR:
+            workload = generateRushHourWorkload(data, config.num_queries,
+                                                config.selectivity, config.temporal_range_hours);
+            break;
+        
+        case WorkloadType::ZONE:
+            workload = generateZoneWorkload(data, config.num_queries, config.selectivity);
+            break;
+        
+        case WorkloadType::TRACE: {
+            if (config.trace_file.empty()) {
+                throw std::invalid_argument("Trace workload needs a trace file");
+            }
+            workload = replayWorkload(config.trace_file, config.num_queries);
+            if (!data.empty() && workload[0].getDimensions() != data[0].getDimensions()) {
+                throw std::invalid_argument("Trace " + config.trace_file + " has " +
+                                            std::to_string(workload[0].getDimensions()) +
+                                            "-d queries for " + std::to_string(data[0].getDimensions()) +
+                                            "-d data");
+            }
+            // A trace is replayed as recorded, never calibrated
+            return workload;
+        }
         
         default:
             return {};
     }
+    
+    if (config.calibrate) {
+        achieved_selectivities_ = calibrateWorkload(data, workload, config.selectivity,
+                                                    config.selectivity_tolerance, config.calibration_sample);
+    }
+    return workload;
 }
 
 std::vector<QueryRange> WorkloadGenerator::generateSpatialWorkload(
@@ -172,6 +352,499 @@ std::vector<QueryRange> WorkloadGenerator::generateMixedWorkload(
     return workload;
 }
 
+std::vector<QueryRange> WorkloadGenerator::generateCenteredWorkload(
+    const std::vector<DataPoint>& data,
+    size_t num_queries,
+    double selectivity) {
+    
+    std::vector<QueryRange> workload;
+    workload.reserve(num_queries);
+    
+    if (data.empty()) {
+        return workload;
+    }
+    
+    std::vector<double> min_bounds, max_bounds;
+    computeDataBounds(data, min_bounds, max_bounds);
+    
+    size_t dimensions = data[0].getDimensions();
+    double per_dim_selectivity = std::pow(selectivity, 1.0 / dimensions);
+    
+    for (size_t i = 0; i < num_queries; ++i) {
+        const DataPoint& center = samplePoint(data);
+        std::vector<double> query_min(dimensions);
+        std::vector<double> query_max(dimensions);
+        for (size_t dim = 0; dim < dimensions; ++dim) {
+            double range_size = (max_bounds[dim] - min_bounds[dim]) * per_dim_selectivity;
+            placeAround(dim, center.getCoordinate(dim), range_size, min_bounds, max_bounds, query_min, query_max);
+        }
+        workload.emplace_back(query_min, query_max);
+    }
+    
+    std::cout << "Generated Centered workload: " << num_queries
+              << " queries, selectivity=" << selectivity << std::endl;
+    
+    return workload;
+}
+
+std::vector<QueryRange> WorkloadGenerator::generateHotspotWorkload(
+    const std::vector<DataPoint>& data,
+    size_t num_queries,
+    double selectivity,
+    size_t num_hotspots,
+    double zipf_exponent) {
+    
+    if (num_hotspots == 0 || zipf_exponent < 0.0) {
+        throw std::invalid_argument("Hotspot workload needs at least one hotspot and a non-negative Zipf exponent");
+    }
+    
+    std::vector<QueryRange> workload;
+    workload.reserve(num_queries);
+    
+    if (data.empty()) {
+        return workload;
+    }
+    
+    std::vector<double> min_bounds, max_bounds;
+    computeDataBounds(data, min_bounds, max_bounds);
+    
+    size_t dimensions = data[0].getDimensions();
+    size_t spatial_dims = std::min(size_t(2), dimensions);
+    
+    // Hotspot k (from 0) is picked with weight 1 / (k + 1)^s
+    std::vector<const DataPoint*> hotspots;
+    std::vector<double> weights;
+    for (size_t k = 0; k < num_hotspots; ++k) {
+        hotspots.push_back(&samplePoint(data));
+        weights.push_back(1.0 / std::pow(static_cast<double>(k + 1), zipf_exponent));
+    }
+    std::discrete_distribution<size_t> pick_hotspot(weights.begin(), weights.end());
+    
+    // Queries spread around their hotspot by about a quarter of their size
+    std::normal_distribution<double> jitter(0.0, 0.25);
+    
+    for (size_t i = 0; i < num_queries; ++i) {
+        const DataPoint& hotspot = *hotspots[pick_hotspot(rng_)];
+        std::vector<double> query_min = min_bounds;
+        std::vector<double> query_max = max_bounds;
+        for (size_t dim = 0; dim < spatial_dims; ++dim) {
+            double range_size = (max_bounds[dim] - min_bounds[dim]) * std::sqrt(selectivity);
+            double center = hotspot.getCoordinate(dim) + jitter(rng_) * range_size;
+            placeAround(dim, center, range_size, min_bounds, max_bounds, query_min, query_max);
+        }
+        workload.emplace_back(query_min, query_max);
+    }
+    
+    std::cout << "Generated Hotspot workload: " << num_queries << " queries around "
+              << num_hotspots << " hotspots (Zipf s=" << zipf_exponent
+              << "), selectivity=" << selectivity << std::endl;
+    
+    return workload;
+}
+
+std::vector<QueryRange> WorkloadGenerator::generateRushHourWorkload(
+    const std::vector<DataPoint>& data,
+    size_t num_queries,
+    double selectivity,
+    double time_range_hours) {
+    
+    std::vector<QueryRange> workload;
+    workload.reserve(num_queries);
+    
+    if (data.empty()) {
+        return workload;
+    }
+    
+    std::vector<double> min_bounds, max_bounds;
+    computeDataBounds(data, min_bounds, max_bounds);
+    
+    size_t dimensions = data[0].getDimensions();
+    
+    // Centers: weekday peak-hour points, else peak-hour points on any day
+    std::vector<size_t> candidates;
+    if (dimensions > 2) {
+        for (bool weekdays_only : {true, false}) {
+            for (size_t i = 0; i < data.size(); ++i) {
+                if (peakOf(data[i].getCoordinate(2), weekdays_only) >= 0) {
+                    candidates.push_back(i);
+                }
+            }
+            if (!candidates.empty()) {
+                break;
+            }
+        }
+    }
+    bool at_peaks = !candidates.empty();
+    if (!at_peaks) {
+        candidates.resize(data.size());
+        std::iota(candidates.begin(), candidates.end(), size_t(0));
+    }
+    std::uniform_int_distribution<size_t> pick(0, candidates.size() - 1);
+    
+    double window = time_range_hours * 3600.0;
+    
+    for (size_t i = 0; i < num_queries; ++i) {
+        const DataPoint& center = data[candidates[pick(rng_)]];
+        std::vector<double> query_min = min_bounds;
+        std::vector<double> query_max = max_bounds;
+        
+        // Spatial dimensions (0, 1), sized as in Workload B
+        for (size_t dim = 0; dim < std::min(size_t(2), dimensions); ++dim) {
+            double range_size = (max_bounds[dim] - min_bounds[dim]) * std::sqrt(selectivity * 0.5);
+            placeAround(dim, center.getCoordinate(dim), range_size, min_bounds, max_bounds, query_min, query_max);
+        }
+        
+        // Temporal dimension (2): a window containing the center's time,
+        // inside its peak if it has one
+        if (dimensions > 2) {
+            double t = center.getCoordinate(2);
+            double lo = min_bounds[2];
+            double hi = max_bounds[2];
+            if (at_peaks) {
+                double day = std::floor(t / SECONDS_PER_DAY) * SECONDS_PER_DAY;
+                const double* peak = PEAK_HOURS[peakOf(t, false)];
+                lo = day + peak[0];
+                hi = day + peak[1];
+            }
+            double length = std::min(window, hi - lo);
+            std::uniform_real_distribution<double> dist(std::max(lo, t - length), std::min(hi - length, t));
+            double start = dist(rng_);
+            query_min[2] = start;
+            query_max[2] = start + length;
+        }
+        
+        workload.emplace_back(query_min, query_max);
+    }
+    
+    std::cout << "Generated Rush-hour workload: " << num_queries << " queries"
+              << (at_peaks ? "" : " (no peak-hour data; windows around any point)")
+              << ", selectivity=" << selectivity << std::endl;
+    
+    return workload;
+}
+
+std::vector<QueryRange> WorkloadGenerator::generateZoneWorkload(
+    const std::vector<DataPoint>& data,
+    size_t num_queries,
+    double selectivity) {
+    
+    std::vector<QueryRange> workload;
+    workload.reserve(num_queries);
+    
+    if (data.empty()) {
+        return workload;
+    }
+    
+    std::vector<double> min_bounds, max_bounds;
+    computeDataBounds(data, min_bounds, max_bounds);
+    
+    size_t dimensions = data[0].getDimensions();
+    size_t n = data.size();
+    
+    // Cuts per dimension, so that there are about 1 / selectivity zones
+    double target_zones = std::max(1.0, std::round(1.0 / selectivity));
+    size_t cuts = dimensions > 1 ?
+        std::min(static_cast<size_t>(std::max(1.0, std::round(std::sqrt(target_zones)))),
+                 static_cast<size_t>(std::sqrt(static_cast<double>(n)))) :
+        std::min(static_cast<size_t>(target_zones), n);
+    cuts = std::max(cuts, size_t(1));
+    
+    // Quantile slabs along dimension 0, each cut by quantiles along dimension 1
+    std::vector<size_t> order(n);
+    std::iota(order.begin(), order.end(), size_t(0));
+    auto byDim = [&data](size_t dim) {
+        return [&data, dim](size_t a, size_t b) { return data[a].getCoordinate(dim) < data[b].getCoordinate(dim); };
+    };
+    std::sort(order.begin(), order.end(), byDim(0));
+    
+    std::vector<std::pair<std::vector<double>, std::vector<double>>> zones;
+    for (size_t slab = 0; slab < cuts; ++slab) {
+        size_t slab_begin = slab * n / cuts;
+        size_t slab_end = (slab + 1) * n / cuts;
+        size_t cells = 1;
+        if (dimensions > 1) {
+            std::sort(order.begin() + slab_begin, order.begin() + slab_end, byDim(1));
+            cells = cuts;
+        }
+        for (size_t cell = 0; cell < cells; ++cell) {
+            size_t begin = slab_begin + cell * (slab_end - slab_begin) / cells;
+            size_t end = slab_begin + (cell + 1) * (slab_end - slab_begin) / cells;
+            if (begin == end) {
+                continue;
+            }
+            std::vector<double> zone_min = min_bounds;
+            std::vector<double> zone_max = max_bounds;
+            for (size_t dim = 0; dim < std::min(size_t(2), dimensions); ++dim) {
+                zone_min[dim] = std::numeric_limits<double>::max();
+                zone_max[dim] = std::numeric_limits<double>::lowest();
+                for (size_t i = begin; i < end; ++i) {
+                    double coord = data[order[i]].getCoordinate(dim);
+                    zone_min[dim] = std::min(zone_min[dim], coord);
+                    zone_max[dim] = std::max(zone_max[dim], coord);
+                }
+            }
+            zones.emplace_back(std::move(zone_min), std::move(zone_max));
+        }
+    }
+    
+    std::uniform_int_distribution<size_t> pick(0, zones.size() - 1);
+    for (size_t i = 0; i < num_queries; ++i) {
+        const auto& zone = zones[pick(rng_)];
+        workload.emplace_back(zone.first, zone.second);
+    }
+    
+    std::cout << "Generated Zone workload: " << num_queries << " queries over "
+              << zones.size() << " zones, selectivity=" << selectivity << std::endl;
+    
+    return workload;
+}
+
+std::vector<QueryRange> WorkloadGenerator::replayWorkload(
+    const std::string& filepath,
+    size_t num_queries) {
+    
+    std::vector<QueryRange> workload = loadWorkload(filepath);
+    if (workload.empty()) {
+        throw std::runtime_error("No queries to replay in " + filepath);
+    }
+    if (num_queries > 0 && num_queries < workload.size()) {
+        workload.erase(workload.begin() + num_queries, workload.end());
+    }
+    
+    std::cout << "Replaying " << workload.size() << " queries from " << filepath << std::endl;
+    
+    return workload;
+}
+
+std::vector<double> WorkloadGenerator::calibrateWorkload(
+    const std::vector<DataPoint>& data,
+    std::vector<QueryRange>& workload,
+    double target_selectivity,
+    double tolerance,
+    size_t sample_size) {
+    
+    if (!(target_selectivity > 0.0 && target_selectivity <= 1.0) || tolerance < 0.0) {
+        throw std::invalid_argument("Calibration needs a selectivity in (0, 1] and a non-negative tolerance");
+    }
+    if (data.empty() || workload.empty()) {
+        return std::vector<double>(workload.size(), 0.0);
+    }
+    
+    std::vector<double> min_bounds, max_bounds;
+    computeDataBounds(data, min_bounds, max_bounds);
+    
+    size_t dimensions = data[0].getDimensions();
+    size_t n = data.size();
+    
+    // Column-wise sample (with replacement), large enough that a query is
+    // expected to hold about 100 sampled points
+    size_t sample_n = std::min(n, std::max(sample_size,
+                                           static_cast<size_t>(std::ceil(100.0 / target_selectivity))));
+    std::vector<std::vector<double>> sample(dimensions, std::vector<double>(sample_n));
+    std::uniform_int_distribution<size_t> pick(0, n - 1);
+    for (size_t i = 0; i < sample_n; ++i) {
+        const DataPoint& point = sample_n == n ? data[i] : data[pick(rng_)];
+        for (size_t dim = 0; dim < dimensions; ++dim) {
+            sample[dim][i] = point.getCoordinate(dim);
+        }
+    }
+    auto sampleCoordinate = [&sample](size_t i, size_t dim) { return sample[dim][i]; };
+    auto dataCoordinate = [&data](size_t i, size_t dim) { return data[i].getCoordinate(dim); };
+    
+    // Center, half widths and restricted (scalable) dimensions of each query
+    struct Shape {
+        std::vector<double> center;
+        std::vector<double> half_widths;
+        std::vector<size_t> dims;
+    };
+    std::vector<Shape> shapes(workload.size());
+    for (size_t q = 0; q < workload.size(); ++q) {
+        Shape& shape = shapes[q];
+        shape.center.resize(dimensions);
+        shape.half_widths.resize(dimensions);
+        for (size_t dim = 0; dim < dimensions; ++dim) {
+            double lo = workload[q].getMinBound(dim);
+            double hi = workload[q].getMaxBound(dim);
+            shape.center[dim] = (lo + hi) / 2;
+            shape.half_widths[dim] = (hi - lo) / 2;
+            if ((lo > min_bounds[dim] || hi < max_bounds[dim]) && hi > lo) {
+                shape.dims.push_back(dim);
+            }
+        }
+    }
+    
+    auto rescale = [&](size_t q, double scale) {
+        const Shape& shape = shapes[q];
+        std::vector<double> query_min(dimensions);
+        std::vector<double> query_max(dimensions);
+        for (size_t dim = 0; dim < dimensions; ++dim) {
+            query_min[dim] = workload[q].getMinBound(dim);
+            query_max[dim] = workload[q].getMaxBound(dim);
+        }
+        for (size_t dim : shape.dims) {
+            double half = scale * shape.half_widths[dim];
+            query_min[dim] = std::max(min_bounds[dim], shape.center[dim] - half);
+            query_max[dim] = std::min(max_bounds[dim], shape.center[dim] + half);
+        }
+        workload[q] = QueryRange(query_min, query_max);
+    };
+    
+    std::vector<double> radius;
+    size_t sample_k = static_cast<size_t>(std::llround(target_selectivity * sample_n));
+    for (size_t q = 0; q < workload.size(); ++q) {
+        if (!shapes[q].dims.empty()) {
+            rescale(q, scaleForCount(sample_n, sampleCoordinate, shapes[q].center, shapes[q].half_widths,
+                                     shapes[q].dims, sample_k, radius));
+        }
+    }
+    
+    // Sampling error: recalibrate the queries that missed on all the data
+    std::vector<double> achieved = measureSelectivity(data, workload);
+    auto missed = [&](double selectivity) {
+        return std::fabs(selectivity - target_selectivity) > tolerance * target_selectivity;
+    };
+    size_t refined = 0;
+    if (sample_n < n) {
+        size_t k = static_cast<size_t>(std::llround(target_selectivity * n));
+        std::vector<size_t> retargeted;
+        for (size_t q = 0; q < workload.size(); ++q) {
+            if (missed(achieved[q]) && !shapes[q].dims.empty()) {
+                rescale(q, scaleForCount(n, dataCoordinate, shapes[q].center, shapes[q].half_widths,
+                                         shapes[q].dims, k, radius));
+                retargeted.push_back(q);
+            }
+        }
+        // Remeasured together, in one more pass over the data
+        std::vector<QueryRange> queries;
+        for (size_t q : retargeted) {
+            queries.push_back(workload[q]);
+        }
+        std::vector<double> remeasured = measureSelectivity(data, queries);
+        for (size_t i = 0; i < retargeted.size(); ++i) {
+            achieved[retargeted[i]] = remeasured[i];
+        }
+        refined = retargeted.size();
+    }
+    
+    size_t misses = std::count_if(achieved.begin(), achieved.end(), missed);
+    std::vector<double> sorted = achieved;
+    std::nth_element(sorted.begin(), sorted.begin() + sorted.size() / 2, sorted.end());
+    std::cout << "Calibrated " << workload.size() << " queries to selectivity " << target_selectivity << " on ";
+    if (sample_n < n) {
+        std::cout << "a " << sample_n << "-point sample (" << refined << " refined on all " << n << " points)";
+    } else {
+        std::cout << "all " << n << " points";
+    }
+    std::cout << ": median achieved " << sorted[sorted.size() / 2] << ", " << misses
+              << " outside +-" << tolerance * 100 << "%" << std::endl;
+    
+    return achieved;
+}
+
+MixedWorkload WorkloadGenerator::generateOperationStream(
+    const std::vector<DataPoint>& data,
+    const MixedWorkloadConfig& config) {
+    
+    if (!(config.initial_fraction >= 0.0 && config.initial_fraction <= 1.0)) {
+        throw std::invalid_argument("Initial fraction must lie in [0, 1]");
+    }
+    
+    MixedWorkload workload;
+    workload.mix = config.mix;
+    
+    // Oldest points first; the sort is stable, so ties keep the data order
+    std::vector<size_t> order(data.size());
+    std::iota(order.begin(), order.end(), 0);
+    if (!data.empty() && config.time_dim < data[0].getDimensions()) {
+        std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+            return data[a].getCoordinate(config.time_dim) < data[b].getCoordinate(config.time_dim);
+        });
+    }
+    size_t num_initial = static_cast<size_t>(std::llround(config.initial_fraction * data.size()));
+    workload.initial.reserve(num_initial);
+    for (size_t i = 0; i < order.size(); ++i) {
+        (i < num_initial ? workload.initial : workload.inserts).push_back(data[order[i]]);
+    }
+    
+    // Draw the operation types; deletes pick from the live ids, which
+    // are removed by swapping with the last
+    rng_.seed(config.queries.seed);
+    std::discrete_distribution<int> pick({config.mix.query, config.mix.insert, config.mix.remove});
+    std::vector<uint64_t> live;
+    live.reserve(data.size());
+    for (const auto& point : workload.initial) {
+        live.push_back(point.getId());
+    }
+    size_t next_insert = 0;
+    size_t num_queries = 0;
+    workload.operations.reserve(config.num_operations);
+    for (size_t op = 0; op < config.num_operations; ++op) {
+        int type = pick(rng_);
+        if (type == 1 && next_insert < workload.inserts.size()) {
+            live.push_back(workload.inserts[next_insert].getId());
+            workload.operations.push_back({OperationType::INSERT, next_insert++});
+        } else if (type == 2 && !live.empty()) {
+            size_t victim = std::uniform_int_distribution<size_t>(0, live.size() - 1)(rng_);
+            workload.operations.push_back({OperationType::DELETE, live[victim]});
+            live[victim] = live.back();
+            live.pop_back();
+        } else {
+            workload.operations.push_back({OperationType::QUERY, num_queries++});
+        }
+    }
+    // Points the stream never reached are not part of it
+    workload.inserts.resize(next_insert);
+    
+    WorkloadConfig query_config = config.queries;
+    query_config.num_queries = num_queries;
+    if (num_queries > 0) {
+        workload.queries = generateWorkload(data, query_config);
+        if (workload.queries.empty()) {
+            throw std::invalid_argument("Mixed workload has query operations but no queries to run "
+                                        "(empty data or unsupported workload type)");
+        }
+        // A short trace is cycled through
+        for (auto& operation : workload.operations) {
+            if (operation.type == OperationType::QUERY) {
+                operation.arg %= workload.queries.size();
+            }
+        }
+    }
+    return workload;
+}
+
+std::vector<double> WorkloadGenerator::measureSelectivity(
+    const std::vector<DataPoint>& data,
+    const std::vector<QueryRange>& workload) {
+    
+    std::vector<double> selectivities(workload.size(), 0.0);
+    if (data.empty() || workload.empty()) {
+        return selectivities;
+    }
+    
+    // One parallel pass over the data: each chunk is small enough to stay
+    // in cache while every query is counted over it
+    const size_t num_chunks = (data.size() + SELECTIVITY_CHUNK - 1) / SELECTIVITY_CHUNK;
+    std::vector<std::vector<size_t>> counts(num_chunks, std::vector<size_t>(workload.size(), 0));
+    ThreadPool pool;
+    pool.parallelFor(num_chunks, [&](size_t c) {
+        auto begin = data.begin() + c * SELECTIVITY_CHUNK;
+        auto end = data.begin() + std::min(data.size(), (c + 1) * SELECTIVITY_CHUNK);
+        for (size_t q = 0; q < workload.size(); ++q) {
+            counts[c][q] = std::count_if(begin, end, [&](const DataPoint& point) { return workload[q].contains(point); });
+        }
+    });
+    for (const auto& chunk : counts) {
+        for (size_t q = 0; q < workload.size(); ++q) {
+            selectivities[q] += chunk[q];
+        }
+    }
+    for (double& selectivity : selectivities) {
+        selectivity /= data.size();
+    }
+    return selectivities;
+}
+
 void WorkloadGenerator::saveWorkload(const std::vector<QueryRange>& workload,
                                     const std::string& filepath) {
     std::ofstream file(filepath);
@@ -180,6 +853,9 @@ void WorkloadGenerator::saveWorkload(const std::vector<QueryRange>& workload,
         return;
     }
     
+    // Full precision, so a replayed trace hits exactly the same points
+    file << std::setprecision(std::numeric_limits<double>::max_digits10);
+    
     // Write number of queries and dimensions
     if (!workload.empty()) {
         file << workload.size() << " " << workload[0].getDimensions() << "\n";
@@ -264,6 +940,11 @@ QueryRange WorkloadGenerator::generateRandomQuery(
     return QueryRange(query_min, query_max);
 }
 
+const DataPoint& WorkloadGenerator::samplePoint(const std::vector<DataPoint>& data) {
+    std::uniform_int_distribution<size_t> dist(0, data.size() - 1);
+    return data[dist(rng_)];
+}
+
 void WorkloadGenerator::computeDataBounds(
     const std::vector<DataPoint>& data,
     std::vector<double>& min_bounds,
@@ -0,0 +1,67 @@
+#include "data/attribute_table.h"
+#include <algorithm>
+#include <stdexcept>
+
+namespace flood {
+
+AttributeTable::AttributeTable(const std::vector<DataPoint>& data) {
+    ids_.reserve(data.size());
+    rows_.reserve(data.size());
+    for (size_t row = 0; row < data.size(); ++row) {
+        ids_.push_back(data[row].getId());
+        rows_.emplace(data[row].getId(), row);
+    }
+}
+
+void AttributeTable::addColumn(const std::string& name, std::vector<double> values) {
+    if (values.size() != ids_.size()) {
+        throw std::invalid_argument("Attribute column " + name + " has " + std::to_string(values.size()) +
+                                    " values for " + std::to_string(ids_.size()) + " rows");
+    }
+    if (std::find(names_.begin(), names_.end(), name) != names_.end()) {
+        throw std::invalid_argument("Duplicate attribute column: " + name);
+    }
+    names_.push_back(name);
+    columns_.push_back(std::move(values));
+}
+
+size_t AttributeTable::findColumn(const std::string& name) const {
+    auto it = std::find(names_.begin(), names_.end(), name);
+    if (it == names_.end()) {
+        throw std::invalid_argument("Unknown attribute column: " + name);
+    }
+    return static_cast<size_t>(it - names_.begin());
+}
+
+size_t AttributeTable::rowOf(uint64_t id) const {
+    auto it = rows_.find(id);
+    if (it == rows_.end()) {
+        throw std::out_of_range("No attribute row for point id " + std::to_string(id));
+    }
+    return it->second;
+}
+
+void AttributeTable::project(const std::vector<std::string>& columns, ProjectedResult& result) const {
+    std::vector<size_t> selected;
+    for (const auto& name : columns) {
+        selected.push_back(findColumn(name));
+    }
+    
+    std::vector<size_t> rows;
+    rows.reserve(result.points.size());
+    for (const auto& point : result.points) {
+        rows.push_back(rowOf(point.getId()));
+    }
+    
+    result.column_names = columns;
+    result.columns.assign(selected.size(), std::vector<double>());
+    for (size_t c = 0; c < selected.size(); ++c) {
+        const std::vector<double>& column = columns_[selected[c]];
+        result.columns[c].reserve(rows.size());
+        for (size_t row : rows) {
+            result.columns[c].push_back(column[row]);
+        }
+    }
+}
+
+} // namespace flood
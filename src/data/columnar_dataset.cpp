@@ -0,0 +1,363 @@
+#include "data/columnar_dataset.h"
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+#include <cstring>
+#include <cerrno>
+#include <algorithm>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace flood {
+
+namespace {
+
+const char MAGIC[8] = {'F', 'L', 'O', 'O', 'D', 'C', 'O', 'L'};
+constexpr uint64_t ENDIAN_MARKER = 0x0102030405060708ULL;
+
+// Fixed part of the header; min and max bounds (double[dimensions] each)
+// follow immediately
+struct FileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t header_bytes;   // Offset of the id column
+    uint64_t num_points;
+    uint64_t dimensions;
+    uint64_t column_stride;  // Bytes from one column start to the next
+    uint64_t endian_marker;
+};
+
+size_t alignUp(size_t bytes) {
+    return (bytes + ColumnarDataset::PAGE_ALIGNMENT - 1) / ColumnarDataset::PAGE_ALIGNMENT
+           * ColumnarDataset::PAGE_ALIGNMENT;
+}
+
+std::runtime_error ioError(const std::string& what, const std::string& filepath) {
+    return std::runtime_error(what + " " + filepath + ": " + std::strerror(errno));
+}
+
+} // namespace
+
+void ColumnarDataset::write(const std::vector<DataPoint>& data, const std::string& filepath) {
+    const size_t n = data.size();
+    const size_t dims = data.empty() ? 0 : data[0].getDimensions();
+    
+    FileHeader header;
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = FORMAT_VERSION;
+    header.header_bytes = static_cast<uint32_t>(alignUp(sizeof(FileHeader) + 2 * dims * sizeof(double)));
+    header.num_points = n;
+    header.dimensions = dims;
+    header.column_stride = alignUp(n * sizeof(double));
+    header.endian_marker = ENDIAN_MARKER;
+    
+    std::vector<double> min_bounds(dims, std::numeric_limits<double>::max());
+    std::vector<double> max_bounds(dims, std::numeric_limits<double>::lowest());
+    for (const auto& point : data) {
+        for (size_t i = 0; i < dims; ++i) {
+            min_bounds[i] = std::min(min_bounds[i], point.getCoordinate(i));
+            max_bounds[i] = std::max(max_bounds[i], point.getCoordinate(i));
+        }
+    }
+    
+    std::ofstream file(filepath, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        throw ioError("Failed to open file for writing:", filepath);
+    }
+    
+    const std::vector<char> padding(PAGE_ALIGNMENT, 0);
+    auto pad = [&](size_t written, size_t target) {
+        file.write(padding.data(), target - written);
+    };
+    
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(min_bounds.data()), dims * sizeof(double));
+    file.write(reinterpret_cast<const char*>(max_bounds.data()), dims * sizeof(double));
+    pad(sizeof(header) + 2 * dims * sizeof(double), header.header_bytes);
+    
+    // Columns are written through a small buffer, one column at a time
+    const size_t BUFFER_POINTS = 1 << 16;
+    std::vector<uint64_t> id_buffer;
+    std::vector<double> coord_buffer;
+    for (size_t col = 0; col <= dims; ++col) {
+        for (size_t begin = 0; begin < n; begin += BUFFER_POINTS) {
+            size_t end = std::min(n, begin + BUFFER_POINTS);
+            if (col == 0) {
+                id_buffer.clear();
+                for (size_t i = begin; i < end; ++i) {
+                    id_buffer.push_back(data[i].getId());
+                }
+                file.write(reinterpret_cast<const char*>(id_buffer.data()), id_buffer.size() * sizeof(uint64_t));
+            } else {
+                coord_buffer.clear();
+                for (size_t i = begin; i < end; ++i) {
+                    coord_buffer.push_back(data[i].getCoordinate(col - 1));
+                }
+                file.write(reinterpret_cast<const char*>(coord_buffer.data()), coord_buffer.size() * sizeof(double));
+            }
+        }
+        pad(n * sizeof(double), header.column_stride);
+    }
+    
+    if (!file) {
+        throw ioError("Failed to write", filepath);
+    }
+}
+
+bool ColumnarDataset::isColumnarFile(const std::string& filepath) {
+    std::ifstream file(filepath, std::ios::binary);
+    char magic[sizeof(MAGIC)];
+    return file.read(magic, sizeof(magic)) && std::memcmp(magic, MAGIC, sizeof(MAGIC)) == 0;
+}
+
+ColumnarDataset::ColumnarDataset(const std::string& filepath)
+    : mapping_(nullptr), mapping_size_(0), num_points_(0), dimensions_(0),
+      ids_(nullptr), min_bounds_(nullptr), max_bounds_(nullptr) {
+    int fd = ::open(filepath.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw ioError("Failed to open", filepath);
+    }
+    
+    struct stat st;
+    if (::fstat(fd, &st) != 0) {
+        ::close(fd);
+        throw ioError("Failed to stat", filepath);
+    }
+    mapping_size_ = static_cast<size_t>(st.st_size);
+    if (mapping_size_ < sizeof(FileHeader)) {
+        ::close(fd);
+        throw std::runtime_error("Not a columnar dataset (file too small): " + filepath);
+    }
+    
+    // The mapping stays valid after the descriptor is closed
+    mapping_ = ::mmap(nullptr, mapping_size_, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (mapping_ == MAP_FAILED) {
+        mapping_ = nullptr;
+        throw ioError("Failed to map", filepath);
+    }
+    
+    const char* base = static_cast<const char*>(mapping_);
+    FileHeader header;
+    std::memcpy(&header, base, sizeof(header));
+    
+    std::string problem;
+    if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0) {
+        problem = "bad magic";
+    } else if (header.version != FORMAT_VERSION) {
+        problem = "unsupported version " + std::to_string(header.version);
+    } else if (header.endian_marker != ENDIAN_MARKER) {
+        problem = "written with a different byte order";
+    } else if (header.dimensions > (mapping_size_ - sizeof(FileHeader)) / (2 * sizeof(double)) ||
+               header.num_points > mapping_size_ / sizeof(double) ||
+               header.header_bytes > mapping_size_ || header.column_stride > mapping_size_) {
+        // Fields are bounded by the file size first, so the products below
+        // cannot overflow and wrap around to a layout that fits
+        problem = "truncated or inconsistent layout";
+    } else if (header.header_bytes % PAGE_ALIGNMENT != 0 || header.column_stride % PAGE_ALIGNMENT != 0 ||
+               header.header_bytes < sizeof(FileHeader) + 2 * header.dimensions * sizeof(double) ||
+               header.column_stride < header.num_points * sizeof(double) ||
+               (header.column_stride > 0 &&
+                header.dimensions + 1 > (mapping_size_ - header.header_bytes) / header.column_stride)) {
+        problem = "truncated or inconsistent layout";
+    }
+    if (!problem.empty()) {
+        unmap();
+        throw std::runtime_error("Invalid columnar dataset " + filepath + ": " + problem);
+    }
+    
+    num_points_ = header.num_points;
+    dimensions_ = header.dimensions;
+    min_bounds_ = reinterpret_cast<const double*>(base + sizeof(FileHeader));
+    max_bounds_ = min_bounds_ + dimensions_;
+    ids_ = reinterpret_cast<const uint64_t*>(base + header.header_bytes);
+    columns_.resize(dimensions_);
+    for (size_t dim = 0; dim < dimensions_; ++dim) {
+        columns_[dim] = reinterpret_cast<const double*>(
+            base + header.header_bytes + (dim + 1) * header.column_stride);
+    }
+}
+
+ColumnarDataset::~ColumnarDataset() {
+    unmap();
+}
+
+ColumnarDataset::ColumnarDataset(ColumnarDataset&& other) noexcept
+    : mapping_(other.mapping_), mapping_size_(other.mapping_size_),
+      num_points_(other.num_points_), dimensions_(other.dimensions_),
+      ids_(other.ids_), columns_(std::move(other.columns_)),
+      min_bounds_(other.min_bounds_), max_bounds_(other.max_bounds_) {
+    other.mapping_ = nullptr;
+    other.mapping_size_ = 0;
+    other.num_points_ = 0;
+    other.dimensions_ = 0;
+}
+
+ColumnarDataset& ColumnarDataset::operator=(ColumnarDataset&& other) noexcept {
+    if (this != &other) {
+        unmap();
+        mapping_ = other.mapping_;
+        mapping_size_ = other.mapping_size_;
+        num_points_ = other.num_points_;
+        dimensions_ = other.dimensions_;
+        ids_ = other.ids_;
+        columns_ = std::move(other.columns_);
+        min_bounds_ = other.min_bounds_;
+        max_bounds_ = other.max_bounds_;
+        other.mapping_ = nullptr;
+        other.mapping_size_ = 0;
+        other.num_points_ = 0;
+        other.dimensions_ = 0;
+    }
+    return *this;
+}
+
+DataPoint ColumnarDataset::getPoint(size_t i) const {
+    std::vector<double> coords(dimensions_);
+    for (size_t dim = 0; dim < dimensions_; ++dim) {
+        coords[dim] = columns_[dim][i];
+    }
+    return DataPoint(coords, ids_[i]);
+}
+
+std::vector<DataPoint> ColumnarDataset::toDataPoints() const {
+    std::vector<DataPoint> data;
+    data.reserve(num_points_);
+    for (size_t i = 0; i < num_points_; ++i) {
+        data.push_back(getPoint(i));
+    }
+    return data;
+}
+
+void ColumnarDataset::prefetch() const {
+    if (mapping_) {
+        ::madvise(mapping_, mapping_size_, MADV_WILLNEED);
+    }
+}
+
+void ColumnarDataset::release(size_t begin, size_t end) const {
+    if (!mapping_ || begin >= end) {
+        return;
+    }
+    
+    // Only whole pages inside the row range are dropped, so neighbouring
+    // rows on a shared page stay resident
+    auto drop = [](const void* column_start, size_t elem_size, size_t begin, size_t end) {
+        uintptr_t first = reinterpret_cast<uintptr_t>(column_start) + begin * elem_size;
+        uintptr_t last = reinterpret_cast<uintptr_t>(column_start) + end * elem_size;
+        first = (first + PAGE_ALIGNMENT - 1) / PAGE_ALIGNMENT * PAGE_ALIGNMENT;
+        last = last / PAGE_ALIGNMENT * PAGE_ALIGNMENT;
+        if (first < last) {
+            ::madvise(reinterpret_cast<void*>(first), last - first, MADV_DONTNEED);
+        }
+    };
+    
+    end = std::min(end, num_points_);
+    drop(ids_, sizeof(uint64_t), begin, end);
+    for (const double* column : columns_) {
+        drop(column, sizeof(double), begin, end);
+    }
+}
+
+void ColumnarDataset::unmap() {
+    if (mapping_) {
+        ::munmap(mapping_, mapping_size_);
+        mapping_ = nullptr;
+        mapping_size_ = 0;
+    }
+}
+
+ColumnarWriter::ColumnarWriter(const std::string& filepath, size_t num_points, size_t dimensions)
+    : filepath_(filepath), fd_(-1), num_points_(num_points), dimensions_(dimensions),
+      header_bytes_(alignUp(sizeof(FileHeader) + 2 * dimensions * sizeof(double))),
+      column_stride_(alignUp(num_points * sizeof(double))),
+      min_bounds_(dimensions, std::numeric_limits<double>::max()),
+      max_bounds_(dimensions, std::numeric_limits<double>::lowest()) {
+    fd_ = ::open(filepath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd_ < 0) {
+        throw ioError("Failed to open file for writing:", filepath);
+    }
+    // Sparse until written; the header page stays zero (no magic) until finish()
+    if (::ftruncate(fd_, static_cast<off_t>(header_bytes_ + (dimensions + 1) * column_stride_)) != 0) {
+        ::close(fd_);
+        fd_ = -1;
+        throw ioError("Failed to size", filepath);
+    }
+}
+
+ColumnarWriter::~ColumnarWriter() {
+    if (fd_ >= 0) {
+        ::close(fd_);
+    }
+}
+
+void ColumnarWriter::writeAt(const void* data, size_t bytes, size_t offset) {
+    const char* bytes_left = static_cast<const char*>(data);
+    while (bytes > 0) {
+        ssize_t written = ::pwrite(fd_, bytes_left, bytes, static_cast<off_t>(offset));
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw ioError("Failed to write", filepath_);
+        }
+        bytes_left += written;
+        bytes -= static_cast<size_t>(written);
+        offset += static_cast<size_t>(written);
+    }
+}
+
+void ColumnarWriter::writeRows(size_t begin, size_t count, const uint64_t* ids,
+                               const std::vector<const double*>& columns) {
+    if (fd_ < 0) {
+        throw std::runtime_error("ColumnarWriter already finished: " + filepath_);
+    }
+    if (begin > num_points_ || count > num_points_ - begin || columns.size() != dimensions_) {
+        throw std::out_of_range("Rows outside the columnar dataset being written: " + filepath_);
+    }
+    
+    std::vector<double> local_min(dimensions_), local_max(dimensions_);
+    writeAt(ids, count * sizeof(uint64_t), header_bytes_ + begin * sizeof(uint64_t));
+    for (size_t dim = 0; dim < dimensions_; ++dim) {
+        writeAt(columns[dim], count * sizeof(double),
+                header_bytes_ + (dim + 1) * column_stride_ + begin * sizeof(double));
+        auto [lo, hi] = std::minmax_element(columns[dim], columns[dim] + count);
+        local_min[dim] = count ? *lo : std::numeric_limits<double>::max();
+        local_max[dim] = count ? *hi : std::numeric_limits<double>::lowest();
+    }
+    
+    std::lock_guard<std::mutex> lock(bounds_mutex_);
+    for (size_t dim = 0; dim < dimensions_; ++dim) {
+        min_bounds_[dim] = std::min(min_bounds_[dim], local_min[dim]);
+        max_bounds_[dim] = std::max(max_bounds_[dim], local_max[dim]);
+    }
+}
+
+void ColumnarWriter::finish() {
+    if (fd_ < 0) {
+        return;
+    }
+    
+    FileHeader header;
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = ColumnarDataset::FORMAT_VERSION;
+    header.header_bytes = static_cast<uint32_t>(header_bytes_);
+    header.num_points = num_points_;
+    header.dimensions = dimensions_;
+    header.column_stride = column_stride_;
+    header.endian_marker = ENDIAN_MARKER;
+    
+    writeAt(min_bounds_.data(), dimensions_ * sizeof(double), sizeof(header));
+    writeAt(max_bounds_.data(), dimensions_ * sizeof(double), sizeof(header) + dimensions_ * sizeof(double));
+    writeAt(&header, sizeof(header), 0);
+    
+    int result = ::close(fd_);
+    fd_ = -1;
+    if (result != 0) {
+        throw ioError("Failed to close", filepath_);
+    }
+}
+
+} // namespace flood
@@ -0,0 +1,365 @@
+#include "data/csv_parser.h"
+#include "utils/thread_pool.h"
+#include <iostream>
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <cerrno>
+#include <cctype>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace flood {
+
+namespace {
+
+// Work is split into this many chunks per thread so uneven chunks balance
+constexpr size_t CHUNKS_PER_THREAD = 4;
+
+// Read-only mapping of a whole file
+class MappedFile {
+public:
+    explicit MappedFile(const std::string& filepath) : data_(nullptr), size_(0) {
+        int fd = ::open(filepath.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw std::runtime_error("Failed to open " + filepath + ": " + std::strerror(errno));
+        }
+        struct stat st;
+        if (::fstat(fd, &st) != 0) {
+            ::close(fd);
+            throw std::runtime_error("Failed to stat " + filepath + ": " + std::strerror(errno));
+        }
+        size_ = static_cast<size_t>(st.st_size);
+        if (size_ > 0) {
+            void* mapping = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapping == MAP_FAILED) {
+                ::close(fd);
+                throw std::runtime_error("Failed to map " + filepath + ": " + std::strerror(errno));
+            }
+            ::madvise(mapping, size_, MADV_SEQUENTIAL);
+            data_ = static_cast<const char*>(mapping);
+        }
+        ::close(fd);
+    }
+    
+    ~MappedFile() {
+        if (data_) {
+            ::munmap(const_cast<char*>(data_), size_);
+        }
+    }
+    
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    
+    const char* begin() const { return data_; }
+    const char* end() const { return data_ + size_; }
+    size_t size() const { return size_; }
+
+private:
+    const char* data_;
+    size_t size_;
+};
+
+const char* findLineEnd(const char* p, const char* end) {
+    const void* nl = std::memchr(p, '\n', end - p);
+    return nl ? static_cast<const char*>(nl) : end;
+}
+
+// Split a line into fields (no quoting rules), calling fn(index, begin, end)
+template <typename Fn>
+void forEachField(const char* p, const char* line_end, char delimiter, Fn&& fn) {
+    size_t index = 0;
+    while (true) {
+        const void* d = std::memchr(p, delimiter, line_end - p);
+        const char* field_end = d ? static_cast<const char*>(d) : line_end;
+        fn(index++, p, field_end);
+        if (!d) {
+            break;
+        }
+        p = field_end + 1;
+    }
+}
+
+bool parseDigits(const char* begin, const char* end, int& value) {
+    auto [ptr, ec] = std::from_chars(begin, end, value);
+    return ec == std::errc() && ptr == end;
+}
+
+// Days since 1970-01-01 of a proleptic Gregorian date
+int64_t daysFromCivil(int64_t y, unsigned m, unsigned d) {
+    y -= m <= 2;
+    const int64_t era = (y >= 0 ? y : y - 399) / 400;
+    const unsigned yoe = static_cast<unsigned>(y - era * 400);
+    const unsigned doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+    const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + static_cast<int64_t>(doe) - 719468;
+}
+
+// "YYYY-MM-DD HH:MM:SS[.fff]" (or 'T' separator) to Unix seconds, UTC
+bool parseDateTime(const char* begin, const char* end, double& value) {
+    if (end - begin < 19 || begin[4] != '-' || begin[7] != '-' ||
+        (begin[10] != ' ' && begin[10] != 'T') || begin[13] != ':' || begin[16] != ':') {
+        return false;
+    }
+    int year, month, day, hour, minute, second;
+    if (!parseDigits(begin, begin + 4, year) || !parseDigits(begin + 5, begin + 7, month) ||
+        !parseDigits(begin + 8, begin + 10, day) || !parseDigits(begin + 11, begin + 13, hour) ||
+        !parseDigits(begin + 14, begin + 16, minute) || !parseDigits(begin + 17, begin + 19, second)) {
+        return false;
+    }
+    if (month < 1 || month > 12 || day < 1 || day > 31 || hour > 23 || minute > 59 || second > 60) {
+        return false;
+    }
+    
+    double fraction = 0.0;
+    if (end - begin > 19) {
+        if (begin[19] != '.') {
+            return false;
+        }
+        auto [ptr, ec] = std::from_chars(begin + 19, end, fraction);
+        if (ec != std::errc() || ptr != end) {
+            return false;
+        }
+    }
+    
+    int64_t days = daysFromCivil(year, static_cast<unsigned>(month), static_cast<unsigned>(day));
+    value = static_cast<double>(days * 86400 + hour * 3600 + minute * 60 + second) + fraction;
+    return true;
+}
+
+std::string toLower(std::string s) {
+    std::transform(s.begin(), s.end(), s.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return s;
+}
+
+struct ChunkResult {
+    std::vector<double> values;  // Kept rows, row-major
+    size_t rows = 0;
+    size_t malformed = 0;
+    size_t filtered = 0;
+};
+
+} // namespace
+
+void CSVParseStats::print() const {
+    std::cout << "CSV rows read: " << rows_read << ", kept: " << rows_kept
+              << ", malformed: " << rows_malformed << ", filtered: " << rows_filtered
+              << " (" << elapsed_ms << " ms)" << std::endl;
+}
+
+CSVParser::CSVParser(CSVParseOptions options) : options_(std::move(options)) {}
+
+CSVParseOptions CSVParser::nycTaxiOptions() {
+    CSVParseOptions options;
+    options.column_names = {
+        "pickup_longitude",
+        "pickup_latitude",
+        "pickup_datetime|tpep_pickup_datetime|lpep_pickup_datetime",
+        "passenger_count",
+        "trip_distance"
+    };
+    const double inf = std::numeric_limits<double>::infinity();
+    options.bounds = {
+        {-74.3, -73.7},  // Longitude
+        {40.5, 40.9},    // Latitude
+        {-inf, inf},     // Pickup time
+        {0.0, inf},      // Passengers
+        {0.0, inf}       // Distance (miles)
+    };
+    return options;
+}
+
+bool CSVParser::parseField(const char* begin, const char* end, double& value) {
+    // Trim whitespace, carriage returns and surrounding quotes
+    while (begin < end && (*begin == ' ' || *begin == '"' || *begin == '\t')) ++begin;
+    while (end > begin && (end[-1] == ' ' || end[-1] == '"' || end[-1] == '\r' || end[-1] == '\t')) --end;
+    if (begin == end) {
+        return false;
+    }
+    
+    // from_chars rejects a leading '+'
+    const char* digits = (*begin == '+') ? begin + 1 : begin;
+    auto [ptr, ec] = std::from_chars(digits, end, value);
+    if (ec == std::errc() && ptr == end) {
+        return true;
+    }
+    return parseDateTime(begin, end, value);
+}
+
+std::vector<DataPoint> CSVParser::parse(const std::string& filepath) {
+    auto start = std::chrono::high_resolution_clock::now();
+    stats_ = CSVParseStats();
+    
+    MappedFile file(filepath);
+    const char* body = file.begin();
+    const char* end = file.end();
+    if (file.size() == 0) {
+        return {};
+    }
+    
+    // Resolve the output columns
+    const char delimiter = options_.delimiter;
+    std::vector<size_t> columns = options_.columns;
+    if (options_.has_header || columns.empty()) {
+        const char* first_end = findLineEnd(body, end);
+        std::vector<std::string> header;
+        forEachField(body, first_end, delimiter, [&](size_t, const char* b, const char* e) {
+            std::string name(b, e);
+            name.erase(std::remove_if(name.begin(), name.end(),
+                                      [](char c) { return c == '"' || c == '\r' || c == ' '; }),
+                       name.end());
+            header.push_back(toLower(name));
+        });
+        
+        if (!options_.column_names.empty()) {
+            columns.clear();
+            for (const auto& wanted : options_.column_names) {
+                size_t found = header.size();
+                size_t pos = 0;
+                std::string alternatives = toLower(wanted) + "|";
+                while (found == header.size() && pos < alternatives.size()) {
+                    size_t bar = alternatives.find('|', pos);
+                    std::string name = alternatives.substr(pos, bar - pos);
+                    found = std::find(header.begin(), header.end(), name) - header.begin();
+                    pos = bar + 1;
+                }
+                if (found == header.size()) {
+                    throw std::runtime_error("Column " + wanted + " not found in " + filepath);
+                }
+                columns.push_back(found);
+            }
+        } else if (columns.empty()) {
+            for (size_t i = 0; i < header.size(); ++i) {
+                columns.push_back(i);
+            }
+        }
+        
+        if (options_.has_header) {
+            body = (first_end < end) ? first_end + 1 : end;
+        }
+    }
+    
+    const size_t dims = columns.size();
+    if (dims == 0) {
+        return {};
+    }
+    
+    // Field position -> output dimension
+    size_t max_column = *std::max_element(columns.begin(), columns.end());
+    std::vector<int> slot(max_column + 1, -1);
+    for (size_t d = 0; d < dims; ++d) {
+        slot[columns[d]] = static_cast<int>(d);
+    }
+    const auto& bounds = options_.bounds;
+    
+    // The calling thread parses too, so the pool gets num_threads - 1 workers
+    std::unique_ptr<ThreadPool> pool;
+    if (options_.num_threads != 1) {
+        pool = std::make_unique<ThreadPool>(options_.num_threads == 0 ? 0 : options_.num_threads - 1);
+    }
+    const size_t threads = pool ? pool->size() + 1 : 1;
+    
+    // Newline-aligned chunks
+    size_t num_chunks = std::max<size_t>(1, std::min(threads * CHUNKS_PER_THREAD,
+                                                     static_cast<size_t>(end - body) / std::max<size_t>(1, options_.min_chunk_bytes)));
+    std::vector<const char*> cuts = {body};
+    for (size_t c = 1; c < num_chunks; ++c) {
+        const char* cut = body + (end - body) * c / num_chunks;
+        cut = std::max(cut, cuts.back());
+        cut = findLineEnd(cut, end);
+        cuts.push_back(cut < end ? cut + 1 : end);
+    }
+    cuts.push_back(end);
+    
+    std::vector<ChunkResult> chunks(num_chunks);
+    auto parseChunk = [&](size_t c) {
+        ChunkResult& out = chunks[c];
+        std::vector<double> row(dims);
+        std::vector<char> seen(dims);
+        
+        for (const char* p = cuts[c]; p < cuts[c + 1];) {
+            const char* line_end = findLineEnd(p, cuts[c + 1]);
+            const char* next = (line_end < cuts[c + 1]) ? line_end + 1 : line_end;
+            
+            // Skip blank lines
+            const char* q = p;
+            while (q < line_end && (*q == '\r' || *q == ' ')) ++q;
+            if (q == line_end) {
+                p = next;
+                continue;
+            }
+            
+            ++out.rows;
+            std::fill(seen.begin(), seen.end(), 0);
+            bool ok = true;
+            forEachField(p, line_end, delimiter, [&](size_t index, const char* b, const char* e) {
+                if (!ok || index > max_column || slot[index] < 0) {
+                    return;
+                }
+                size_t d = static_cast<size_t>(slot[index]);
+                ok = parseField(b, e, row[d]) && std::isfinite(row[d]);
+                seen[d] = 1;
+            });
+            ok = ok && std::find(seen.begin(), seen.end(), 0) == seen.end();
+            
+            if (!ok) {
+                ++out.malformed;
+            } else {
+                bool keep = true;
+                for (size_t d = 0; d < bounds.size() && d < dims; ++d) {
+                    keep = keep && row[d] >= bounds[d].first && row[d] <= bounds[d].second;
+                }
+                if (keep) {
+                    out.values.insert(out.values.end(), row.begin(), row.end());
+                } else {
+                    ++out.filtered;
+                }
+            }
+            p = next;
+        }
+    };
+    
+    if (pool) {
+        pool->parallelFor(num_chunks, parseChunk);
+    } else {
+        for (size_t c = 0; c < num_chunks; ++c) {
+            parseChunk(c);
+        }
+    }
+    
+    // Materialize points in file order
+    size_t total = 0;
+    for (const auto& chunk : chunks) {
+        total += chunk.values.size() / dims;
+        stats_.rows_read += chunk.rows;
+        stats_.rows_malformed += chunk.malformed;
+        stats_.rows_filtered += chunk.filtered;
+    }
+    
+    std::vector<DataPoint> data;
+    data.reserve(total);
+    for (auto& chunk : chunks) {
+        for (size_t offset = 0; offset < chunk.values.size(); offset += dims) {
+            data.emplace_back(std::vector<double>(chunk.values.begin() + offset,
+                                                  chunk.values.begin() + offset + dims),
+                              data.size());
+        }
+        std::vector<double>().swap(chunk.values);
+    }
+    
+    stats_.rows_kept = data.size();
+    stats_.elapsed_ms = std::chrono::duration<double, std::milli>(
+        std::chrono::high_resolution_clock::now() - start).count();
+    
+    return data;
+}
+
+} // namespace flood
@@ -0,0 +1,384 @@
+#include "data/synthetic_generator.h"
+#include "data/columnar_dataset.h"
+#include "utils/thread_pool.h"
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <memory>
+#include <stdexcept>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace flood {
+
+namespace {
+
+const double DOMAIN = 100.0;
+const double PI = 3.14159265358979323846;
+
+// NYC_TAXI: the period starts Monday 2024-01-01 00:00
+const double NYC_START = 1704067200.0;
+
+// Relative pickups per hour of the day: a trough before dawn, a morning
+// rise and the highest peak in the early evening
+const double HOURLY_PICKUPS[24] = {
+    3.0, 2.2, 1.6, 1.2, 0.9, 0.9, 1.8, 3.2, 4.0, 4.0, 3.8, 3.9,
+    4.1, 4.1, 4.3, 4.2, 4.1, 4.8, 5.5, 5.3, 4.8, 4.7, 4.5, 3.8
+};
+
+// Relative pickups per day of the week, from Monday
+const double DAILY_PICKUPS[7] = {1.0, 1.0, 1.0, 1.0, 1.0, 0.9, 0.75};
+
+// Share of trips with 1 .. 6 passengers
+const double PASSENGER_SHARES[6] = {0.70, 0.15, 0.05, 0.03, 0.04, 0.03};
+
+/**
+ * One component of the pickup mixture: a Gaussian with standard deviations
+ * in degrees of latitude along and across an axis rotated from north
+ */
+struct PickupArea {
+    double lon;
+    double lat;
+    double along;
+    double across;
+    double rotation;  // Radians east of north
+    double weight;
+    bool airport;
+};
+
+// Manhattan's street grid (and the island) runs about 29 degrees east of north
+const double MANHATTAN_AXIS = 29.0 * PI / 180.0;
+
+const PickupArea PICKUP_AREAS[] = {
+    {-73.982, 40.756, 0.022, 0.007, MANHATTAN_AXIS, 0.45, false},  // Midtown
+    {-74.006, 40.714, 0.010, 0.006, MANHATTAN_AXIS, 0.12, false},  // Lower Manhattan
+    {-73.958, 40.785, 0.018, 0.006, MANHATTAN_AXIS, 0.13, false},  // Upper Manhattan
+    {-73.778, 40.641, 0.004, 0.004, 0.0, 0.05, true},              // JFK
+    {-73.874, 40.777, 0.003, 0.003, 0.0, 0.04, true},              // LaGuardia
+    {-73.960, 40.690, 0.020, 0.025, 0.0, 0.11, false},             // Brooklyn
+    {-73.920, 40.748, 0.015, 0.018, 0.0, 0.06, false},             // Queens
+    {-73.905, 40.840, 0.018, 0.020, 0.0, 0.04, false}              // Bronx
+};
+
+// Cleaning bounds of CSVParser::nycTaxiOptions()
+const double NYC_LON[2] = {-74.3, -73.7};
+const double NYC_LAT[2] = {40.5, 40.9};
+
+uint64_t splitmix64(uint64_t x) {
+    x += 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+/**
+ * Fold a value back into [0, DOMAIN], so noise does not pile points up
+ * on the boundary
+ */
+double reflect(double x) {
+    x = std::fmod(std::fabs(x), 2 * DOMAIN);
+    return x > DOMAIN ? 2 * DOMAIN - x : x;
+}
+
+void writeAll(int fd, const void* data, size_t bytes, size_t offset, const std::string& filepath) {
+    const char* next = static_cast<const char*>(data);
+    while (bytes > 0) {
+        ssize_t written = ::pwrite(fd, next, bytes, static_cast<off_t>(offset));
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw std::runtime_error("Failed to write " + filepath + ": " + std::strerror(errno));
+        }
+        next += written;
+        bytes -= static_cast<size_t>(written);
+        offset += static_cast<size_t>(written);
+    }
+}
+
+bool endsWith(const std::string& s, const std::string& suffix) {
+    return s.size() >= suffix.size() && s.compare(s.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+} // namespace
+
+Distribution parseDistribution(const std::string& name) {
+    if (name == "uniform") return Distribution::UNIFORM;
+    if (name == "clustered") return Distribution::CLUSTERED;
+    if (name == "correlated") return Distribution::CORRELATED;
+    if (name == "anti-correlated") return Distribution::ANTI_CORRELATED;
+    if (name == "power-law") return Distribution::POWER_LAW;
+    if (name == "nyc") return Distribution::NYC_TAXI;
+    throw std::invalid_argument("Unknown distribution: " + name +
+                                " (expected uniform, clustered, correlated, anti-correlated, power-law or nyc)");
+}
+
+const char* distributionName(Distribution distribution) {
+    switch (distribution) {
+        case Distribution::UNIFORM: return "uniform";
+        case Distribution::CLUSTERED: return "clustered";
+        case Distribution::CORRELATED: return "correlated";
+        case Distribution::ANTI_CORRELATED: return "anti-correlated";
+        case Distribution::POWER_LAW: return "power-law";
+        case Distribution::NYC_TAXI: return "nyc";
+    }
+    return "unknown";
+}
+
+SyntheticGenerator::SyntheticGenerator(SyntheticConfig config) : config_(std::move(config)) {
+    if (config_.dimensions == 0) {
+        throw std::invalid_argument("Synthetic data needs at least one dimension");
+    }
+    if (config_.num_clusters == 0 || !(config_.cluster_spread > 0.0)) {
+        throw std::invalid_argument("Clustered data needs at least one cluster and a positive spread");
+    }
+    if (!(config_.correlation >= 0.0 && config_.correlation <= 1.0)) {
+        throw std::invalid_argument("Correlation must lie in [0, 1]");
+    }
+    if (!(config_.skew > 0.0) || config_.days == 0) {
+        throw std::invalid_argument("Power-law skew and the number of days must be positive");
+    }
+    
+    // The model shared by all chunks comes from the seed alone
+    std::mt19937_64 rng(splitmix64(config_.seed));
+    if (config_.distribution == Distribution::CLUSTERED) {
+        std::uniform_real_distribution<double> position(0.0, DOMAIN);
+        std::uniform_real_distribution<double> log_spread(-1.0, 1.0);
+        std::uniform_real_distribution<double> weight(0.1, 1.0);
+        for (size_t c = 0; c < config_.num_clusters; ++c) {
+            Cluster cluster;
+            for (size_t dim = 0; dim < config_.dimensions; ++dim) {
+                cluster.center.push_back(position(rng));
+            }
+            cluster.spread = config_.cluster_spread * std::pow(2.0, log_spread(rng));
+            clusters_.push_back(std::move(cluster));
+            cluster_weights_.push_back(weight(rng));
+        }
+    } else if (config_.distribution == Distribution::NYC_TAXI) {
+        for (size_t hour = 0; hour < config_.days * 24; ++hour) {
+            time_weights_.push_back(HOURLY_PICKUPS[hour % 24] * DAILY_PICKUPS[(hour / 24) % 7]);
+        }
+    }
+}
+
+void SyntheticGenerator::generateChunk(size_t chunk, size_t count,
+                                       std::vector<std::vector<double>>& columns) const {
+    const size_t dims = config_.dimensions;
+    columns.resize(dims);
+    for (auto& column : columns) {
+        column.resize(count);
+    }
+    
+    std::mt19937_64 rng(splitmix64(config_.seed ^ splitmix64(chunk + 1)));
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    std::normal_distribution<double> normal(0.0, 1.0);
+    const double noise = (1.0 - config_.correlation) * DOMAIN / 2;
+    
+    switch (config_.distribution) {
+        case Distribution::UNIFORM:
+            for (size_t i = 0; i < count; ++i) {
+                for (size_t dim = 0; dim < dims; ++dim) {
+                    columns[dim][i] = DOMAIN * unit(rng);
+                }
+            }
+            break;
+        
+        case Distribution::CLUSTERED: {
+            std::discrete_distribution<size_t> pick(cluster_weights_.begin(), cluster_weights_.end());
+            for (size_t i = 0; i < count; ++i) {
+                const Cluster& cluster = clusters_[pick(rng)];
+                for (size_t dim = 0; dim < dims; ++dim) {
+                    columns[dim][i] = cluster.center[dim] + cluster.spread * normal(rng);
+                }
+            }
+            break;
+        }
+        
+        case Distribution::CORRELATED:
+            for (size_t i = 0; i < count; ++i) {
+                double t = DOMAIN * unit(rng);
+                for (size_t dim = 0; dim < dims; ++dim) {
+                    columns[dim][i] = reflect(t + noise * normal(rng));
+                }
+            }
+            break;
+        
+        case Distribution::ANTI_CORRELATED: {
+            // A uniform point of the unit cube, moved along the diagonal onto
+            // the plane through its center (coordinates sum to dims x 50)
+            std::vector<double> u(dims);
+            for (size_t i = 0; i < count; ++i) {
+                double mean = 0.0;
+                for (size_t dim = 0; dim < dims; ++dim) {
+                    u[dim] = unit(rng);
+                    mean += u[dim] / dims;
+                }
+                for (size_t dim = 0; dim < dims; ++dim) {
+                    columns[dim][i] = reflect(DOMAIN * (0.5 + u[dim] - mean) + noise * normal(rng));
+                }
+            }
+            break;
+        }
+        
+        case Distribution::POWER_LAW:
+            for (size_t i = 0; i < count; ++i) {
+                for (size_t dim = 0; dim < dims; ++dim) {
+                    columns[dim][i] = DOMAIN * std::pow(unit(rng), config_.skew);
+                }
+            }
+            break;
+        
+        case Distribution::NYC_TAXI: {
+            std::vector<double> area_weights;
+            for (const auto& area : PICKUP_AREAS) {
+                area_weights.push_back(area.weight);
+            }
+            std::discrete_distribution<size_t> pick_area(area_weights.begin(), area_weights.end());
+            std::discrete_distribution<size_t> pick_hour(time_weights_.begin(), time_weights_.end());
+            std::discrete_distribution<int> pick_passengers(std::begin(PASSENGER_SHARES), std::end(PASSENGER_SHARES));
+            std::lognormal_distribution<double> city_miles(0.55, 0.75);
+            std::lognormal_distribution<double> airport_miles(2.6, 0.3);
+            
+            double values[5];
+            for (size_t i = 0; i < count; ++i) {
+                const PickupArea* area;
+                do {
+                    area = &PICKUP_AREAS[pick_area(rng)];
+                    double a = area->along * normal(rng);
+                    double c = area->across * normal(rng);
+                    double north = a * std::cos(area->rotation) - c * std::sin(area->rotation);
+                    double east = a * std::sin(area->rotation) + c * std::cos(area->rotation);
+                    values[1] = area->lat + north;
+                    values[0] = area->lon + east / std::cos(area->lat * PI / 180.0);
+                } while (values[0] < NYC_LON[0] || values[0] > NYC_LON[1] ||
+                         values[1] < NYC_LAT[0] || values[1] > NYC_LAT[1]);
+                values[2] = NYC_START + 3600.0 * (pick_hour(rng) + unit(rng));
+                values[3] = pick_passengers(rng) + 1;
+                values[4] = area->airport ? airport_miles(rng) : city_miles(rng);
+                
+                for (size_t dim = 0; dim < dims; ++dim) {
+                    columns[dim][i] = dim < 5 ? values[dim] : DOMAIN * unit(rng);
+                }
+            }
+            break;
+        }
+    }
+}
+
+void SyntheticGenerator::generateColumns(size_t begin, size_t end,
+                                         std::vector<std::vector<double>>& columns) const {
+    const size_t dims = config_.dimensions;
+    columns.assign(dims, std::vector<double>());
+    for (auto& column : columns) {
+        column.reserve(end > begin ? end - begin : 0);
+    }
+    
+    // A chunk is only reproducible from its start
+    std::vector<std::vector<double>> chunk_columns;
+    for (size_t chunk = begin / CHUNK_POINTS; chunk * CHUNK_POINTS < end; ++chunk) {
+        size_t chunk_begin = chunk * CHUNK_POINTS;
+        generateChunk(chunk, std::min(end - chunk_begin, CHUNK_POINTS), chunk_columns);
+        size_t skip = begin > chunk_begin ? begin - chunk_begin : 0;
+        for (size_t dim = 0; dim < dims; ++dim) {
+            columns[dim].insert(columns[dim].end(), chunk_columns[dim].begin() + skip, chunk_columns[dim].end());
+        }
+    }
+}
+
+std::vector<DataPoint> SyntheticGenerator::generate(size_t num_points) const {
+    const size_t dims = config_.dimensions;
+    const size_t num_chunks = (num_points + CHUNK_POINTS - 1) / CHUNK_POINTS;
+    
+    std::vector<std::vector<DataPoint>> parts(num_chunks);
+    ThreadPool pool(config_.num_threads == 0 ? 0 : config_.num_threads - 1);
+    pool.parallelFor(num_chunks, [&](size_t chunk) {
+        size_t begin = chunk * CHUNK_POINTS;
+        size_t count = std::min(CHUNK_POINTS, num_points - begin);
+        std::vector<std::vector<double>> columns;
+        generateChunk(chunk, count, columns);
+        
+        std::vector<double> coords(dims);
+        parts[chunk].reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            for (size_t dim = 0; dim < dims; ++dim) {
+                coords[dim] = columns[dim][i];
+            }
+            parts[chunk].emplace_back(coords, begin + i);
+        }
+    });
+    
+    std::vector<DataPoint> data;
+    data.reserve(num_points);
+    for (auto& part : parts) {
+        data.insert(data.end(), std::make_move_iterator(part.begin()), std::make_move_iterator(part.end()));
+        std::vector<DataPoint>().swap(part);
+    }
+    return data;
+}
+
+void SyntheticGenerator::writeFile(size_t num_points, const std::string& filepath) const {
+    const size_t dims = config_.dimensions;
+    const size_t num_chunks = (num_points + CHUNK_POINTS - 1) / CHUNK_POINTS;
+    ThreadPool pool(config_.num_threads == 0 ? 0 : config_.num_threads - 1);
+    
+    if (endsWith(filepath, ".fcol")) {
+        ColumnarWriter writer(filepath, num_points, dims);
+        pool.parallelFor(num_chunks, [&](size_t chunk) {
+            size_t begin = chunk * CHUNK_POINTS;
+            size_t count = std::min(CHUNK_POINTS, num_points - begin);
+            std::vector<std::vector<double>> columns;
+            generateChunk(chunk, count, columns);
+            
+            std::vector<uint64_t> ids(count);
+            for (size_t i = 0; i < count; ++i) {
+                ids[i] = begin + i;
+            }
+            std::vector<const double*> column_ptrs;
+            for (const auto& column : columns) {
+                column_ptrs.push_back(column.data());
+            }
+            writer.writeRows(begin, count, ids.data(), column_ptrs);
+        });
+        writer.finish();
+        return;
+    }
+    
+    // Row binary format: num_points and dimensions (size_t), then each
+    // point's id (uint64_t) and coordinates, written at their offsets
+    int fd = ::open(filepath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        throw std::runtime_error("Failed to open file for writing: " + filepath + ": " + std::strerror(errno));
+    }
+    const size_t header[2] = {num_points, dims};
+    const size_t row_bytes = sizeof(uint64_t) + dims * sizeof(double);
+    try {
+        writeAll(fd, header, sizeof(header), 0, filepath);
+        pool.parallelFor(num_chunks, [&](size_t chunk) {
+            size_t begin = chunk * CHUNK_POINTS;
+            size_t count = std::min(CHUNK_POINTS, num_points - begin);
+            std::vector<std::vector<double>> columns;
+            generateChunk(chunk, count, columns);
+            
+            std::vector<char> rows(count * row_bytes);
+            char* row = rows.data();
+            for (size_t i = 0; i < count; ++i, row += row_bytes) {
+                uint64_t id = begin + i;
+                std::memcpy(row, &id, sizeof(id));
+                for (size_t dim = 0; dim < dims; ++dim) {
+                    std::memcpy(row + sizeof(id) + dim * sizeof(double), &columns[dim][i], sizeof(double));
+                }
+            }
+            writeAll(fd, rows.data(), rows.size(), sizeof(header) + begin * row_bytes, filepath);
+        });
+    } catch (...) {
+        ::close(fd);
+        throw;
+    }
+    if (::close(fd) != 0) {
+        throw std::runtime_error("Failed to close " + filepath + ": " + std::strerror(errno));
+    }
+}
+
+} // namespace flood
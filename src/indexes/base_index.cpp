@@ -2,6 +2,7 @@
 #include <iostream>
 #include <iomanip>
 #include <sstream>
+#include <stdexcept>
 
 namespace flood {
 
@@ -30,4 +31,34 @@ void BaseIndex::resetMetrics() {
     build_time_ms_ = 0.0;
 }
 
+void BaseIndex::insert(const std::vector<DataPoint>& /*points*/) {
+    throw std::logic_error(getName() + " does not support inserts; rebuild it instead");
+}
+
+std::vector<DataPoint> BaseIndex::queryWithPositions(const QueryRange& range, std::vector<size_t>* positions) {
+    if (positions) {
+        throw std::logic_error("Index " + getName() + " does not report point positions");
+    }
+    return query(range);
+}
+
+ProjectedResult BaseIndex::queryProjected(const QueryRange& range, const std::vector<std::string>& columns) {
+    ProjectedResult result;
+    const CoordinateStore* store = pointStore();
+    if (store && store->hasAttributes()) {
+        std::vector<size_t> positions;
+        result.points = queryWithPositions(range, &positions);
+        store->project(positions, columns, result);
+        return result;
+    }
+    
+    result.points = query(range);
+    if (attributes_) {
+        attributes_->project(columns, result);
+    } else if (!columns.empty()) {
+        throw std::invalid_argument("Index " + getName() + " carries no attribute columns");
+    }
+    return result;
+}
+
 } // namespace flood
@@ -0,0 +1,284 @@
+#include "indexes/coordinate_store.h"
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+namespace flood {
+
+namespace {
+
+constexpr double MAX_FIXED = 4294967295.0;  // 2^32 - 1
+constexpr double MAX_FLOAT = std::numeric_limits<float>::max();
+
+} // namespace
+
+CoordinateEncoding parseCoordinateEncoding(const std::string& name) {
+    if (name == "double") return CoordinateEncoding::DOUBLE;
+    if (name == "float" || name == "float32") return CoordinateEncoding::FLOAT32;
+    if (name == "fixed" || name == "fixed32") return CoordinateEncoding::FIXED32;
+    throw std::invalid_argument("Unknown coordinate encoding: " + name);
+}
+
+std::string coordinateEncodingName(CoordinateEncoding encoding) {
+    switch (encoding) {
+        case CoordinateEncoding::FLOAT32: return "float32";
+        case CoordinateEncoding::FIXED32: return "fixed32";
+        default: return "double";
+    }
+}
+
+CoordinateStore::CoordinateStore() : encoding_(CoordinateEncoding::DOUBLE), dimensions_(0) {}
+
+void CoordinateStore::build(const std::vector<DataPoint>& data, const std::vector<size_t>& order,
+                            CoordinateEncoding encoding, bool exact_recheck,
+                            const AttributeTable* attributes) {
+    clear();
+    encoding_ = encoding;
+    if (order.empty()) {
+        return;
+    }
+    dimensions_ = data[order[0]].getDimensions();
+    const size_t n = order.size();
+    const size_t d = dimensions_;
+    
+    min_bounds_.assign(d, std::numeric_limits<double>::max());
+    max_bounds_.assign(d, std::numeric_limits<double>::lowest());
+    for (size_t src : order) {
+        for (size_t dim = 0; dim < d; ++dim) {
+            min_bounds_[dim] = std::min(min_bounds_[dim], data[src].getCoordinate(dim));
+            max_bounds_[dim] = std::max(max_bounds_[dim], data[src].getCoordinate(dim));
+        }
+    }
+    scale_.assign(d, 0.0);
+    inv_scale_.assign(d, 0.0);
+    for (size_t dim = 0; dim < d; ++dim) {
+        double range = max_bounds_[dim] - min_bounds_[dim];
+        if (range > 0.0) {
+            scale_[dim] = range / MAX_FIXED;
+            inv_scale_[dim] = MAX_FIXED / range;
+        }
+    }
+    
+    ids_.reserve(n);
+    bool keep_doubles = encoding_ == CoordinateEncoding::DOUBLE || exact_recheck;
+    if (keep_doubles) doubles_.reserve(n * d);
+    if (encoding_ == CoordinateEncoding::FLOAT32) floats_.reserve(n * d);
+    if (encoding_ == CoordinateEncoding::FIXED32) fixed_.reserve(n * d);
+    
+    for (size_t src : order) {
+        const DataPoint& point = data[src];
+        ids_.push_back(point.getId());
+        for (size_t dim = 0; dim < d; ++dim) {
+            double value = point.getCoordinate(dim);
+            if (keep_doubles) doubles_.push_back(value);
+            if (encoding_ == CoordinateEncoding::FLOAT32) floats_.push_back(encodeFloat(value, dim));
+            if (encoding_ == CoordinateEncoding::FIXED32) fixed_.push_back(encodeFixed(value, dim));
+        }
+    }
+    
+    if (attributes && attributes->numColumns() > 0) {
+        if (attributes->numRows() != data.size()) {
+            throw std::invalid_argument("Attribute table has " + std::to_string(attributes->numRows()) +
+                                        " rows for " + std::to_string(data.size()) + " points");
+        }
+        for (size_t c = 0; c < attributes->numColumns(); ++c) {
+            const std::vector<double>& column = attributes->getColumn(c);
+            std::vector<double> permuted;
+            permuted.reserve(n);
+            for (size_t src : order) {
+                permuted.push_back(column[src]);
+            }
+            attribute_names_.push_back(attributes->getName(c));
+            attributes_.push_back(std::move(permuted));
+        }
+    }
+}
+
+void CoordinateStore::clear() {
+    dimensions_ = 0;
+    ids_ = std::vector<uint64_t>();
+    doubles_ = std::vector<double>();
+    floats_ = std::vector<float>();
+    fixed_ = std::vector<uint32_t>();
+    min_bounds_.clear();
+    max_bounds_.clear();
+    scale_.clear();
+    inv_scale_.clear();
+    attribute_names_.clear();
+    attributes_.clear();
+}
+
+uint32_t CoordinateStore::encodeFixed(double value, size_t dim) const {
+    // Every step (subtract, scale, clamp, round) is monotone, so the code
+    // order never contradicts the coordinate order
+    double scaled = (value - min_bounds_[dim]) * inv_scale_[dim];
+    scaled = std::min(std::max(scaled, 0.0), MAX_FIXED);
+    return static_cast<uint32_t>(scaled + 0.5);
+}
+
+float CoordinateStore::encodeFloat(double value, size_t dim) const {
+    // Clamped so that query bounds far beyond the data convert to a finite
+    // float; rounding to nearest is monotone like the fixed-point path
+    double offset = value - min_bounds_[dim];
+    offset = std::min(std::max(offset, -MAX_FLOAT), MAX_FLOAT);
+    return static_cast<float>(offset);
+}
+
+CoordinateStore::Box CoordinateStore::compile(const QueryRange& range) const {
+    Box box;
+    box.lo.resize(dimensions_);
+    box.hi.resize(dimensions_);
+    box.lo_open.resize(dimensions_);
+    box.hi_open.resize(dimensions_);
+    for (size_t dim = 0; dim < dimensions_; ++dim) {
+        // Dimensions the query does not constrain are unbounded
+        bool bounded = dim < range.getDimensions();
+        box.lo[dim] = bounded ? range.getMinBound(dim) : std::numeric_limits<double>::lowest();
+        box.hi[dim] = bounded ? range.getMaxBound(dim) : std::numeric_limits<double>::max();
+        box.lo_open[dim] = box.lo[dim] <= min_bounds_[dim];
+        box.hi_open[dim] = box.hi[dim] >= max_bounds_[dim];
+    }
+    
+    if (encoding_ == CoordinateEncoding::FLOAT32) {
+        for (size_t dim = 0; dim < dimensions_; ++dim) {
+            box.lo_float.push_back(encodeFloat(box.lo[dim], dim));
+            box.hi_float.push_back(encodeFloat(box.hi[dim], dim));
+        }
+    } else if (encoding_ == CoordinateEncoding::FIXED32) {
+        for (size_t dim = 0; dim < dimensions_; ++dim) {
+            // A bound beyond the data on the wrong side would clamp into
+            // range, so an empty interval is made explicit
+            if (box.hi[dim] < min_bounds_[dim] || box.lo[dim] > max_bounds_[dim]) {
+                box.lo_fixed.push_back(1);
+                box.hi_fixed.push_back(0);
+            } else {
+                box.lo_fixed.push_back(encodeFixed(box.lo[dim], dim));
+                box.hi_fixed.push_back(encodeFixed(box.hi[dim], dim));
+            }
+        }
+    }
+    return box;
+}
+
+void CoordinateStore::scan(size_t begin, size_t end, const Box& box, std::vector<DataPoint>& out,
+                           std::vector<size_t>* positions) const {
+    end = std::min(end, size());
+    switch (encoding_) {
+        case CoordinateEncoding::FLOAT32:
+            scanCodes(floats_.data(), box.lo_float.data(), box.hi_float.data(), begin, end, box, out, positions);
+            break;
+        case CoordinateEncoding::FIXED32:
+            scanCodes(fixed_.data(), box.lo_fixed.data(), box.hi_fixed.data(), begin, end, box, out, positions);
+            break;
+        default:
+            for (size_t i = begin; i < end; ++i) {
+                const double* row = doubles_.data() + i * dimensions_;
+                bool inside = true;
+                for (size_t dim = 0; dim < dimensions_ && inside; ++dim) {
+                    inside = row[dim] >= box.lo[dim] && row[dim] <= box.hi[dim];
+                }
+                if (inside) {
+                    out.push_back(get(i));
+                    if (positions) positions->push_back(i);
+                }
+            }
+            break;
+    }
+}
+
+template <typename Code>
+void CoordinateStore::scanCodes(const Code* codes, const Code* lo, const Code* hi,
+                                size_t begin, size_t end, const Box& box,
+                                std::vector<DataPoint>& out, std::vector<size_t>* positions) const {
+    const bool recheck = hasExact();
+    for (size_t i = begin; i < end; ++i) {
+        const Code* row = codes + i * dimensions_;
+        bool inside = true;
+        bool certain = true;
+        for (size_t dim = 0; dim < dimensions_; ++dim) {
+            Code c = row[dim];
+            if (c < lo[dim] || c > hi[dim]) {
+                inside = false;
+                break;
+            }
+            certain = certain && (c > lo[dim] || box.lo_open[dim]) && (c < hi[dim] || box.hi_open[dim]);
+        }
+        if (!inside) {
+            continue;
+        }
+        if (!certain && recheck) {
+            const double* exact = doubles_.data() + i * dimensions_;
+            for (size_t dim = 0; dim < dimensions_ && inside; ++dim) {
+                inside = exact[dim] >= box.lo[dim] && exact[dim] <= box.hi[dim];
+            }
+        }
+        if (inside) {
+            out.push_back(get(i));
+            if (positions) positions->push_back(i);
+        }
+    }
+}
+
+void CoordinateStore::append(size_t begin, size_t end, std::vector<DataPoint>& out,
+                             std::vector<size_t>* positions) const {
+    end = std::min(end, size());
+    out.reserve(out.size() + (end > begin ? end - begin : 0));
+    for (size_t i = begin; i < end; ++i) {
+        out.push_back(get(i));
+        if (positions) positions->push_back(i);
+    }
+}
+
+DataPoint CoordinateStore::get(size_t i) const {
+    std::vector<double> coords(dimensions_);
+    if (!doubles_.empty()) {
+        std::copy_n(doubles_.data() + i * dimensions_, dimensions_, coords.begin());
+    } else if (encoding_ == CoordinateEncoding::FLOAT32) {
+        for (size_t dim = 0; dim < dimensions_; ++dim) {
+            coords[dim] = min_bounds_[dim] + floats_[i * dimensions_ + dim];
+        }
+    } else {
+        for (size_t dim = 0; dim < dimensions_; ++dim) {
+            coords[dim] = min_bounds_[dim] + fixed_[i * dimensions_ + dim] * scale_[dim];
+        }
+    }
+    return DataPoint(coords, ids_[i]);
+}
+
+void CoordinateStore::project(const std::vector<size_t>& positions, const std::vector<std::string>& columns,
+                              ProjectedResult& result) const {
+    std::vector<const std::vector<double>*> selected;
+    for (const auto& name : columns) {
+        auto it = std::find(attribute_names_.begin(), attribute_names_.end(), name);
+        if (it == attribute_names_.end()) {
+            throw std::invalid_argument("Unknown attribute column: " + name);
+        }
+        selected.push_back(&attributes_[it - attribute_names_.begin()]);
+    }
+    
+    // Positions ascend within each scanned run, so the gather walks each
+    // column mostly forward
+    result.column_names = columns;
+    result.columns.assign(selected.size(), std::vector<double>());
+    for (size_t c = 0; c < selected.size(); ++c) {
+        const std::vector<double>& column = *selected[c];
+        result.columns[c].reserve(positions.size());
+        for (size_t i : positions) {
+            result.columns[c].push_back(column[i]);
+        }
+    }
+}
+
+size_t CoordinateStore::bytesPerPoint() const {
+    size_t bytes = sizeof(uint64_t);
+    if (encoding_ != CoordinateEncoding::DOUBLE) {
+        bytes += dimensions_ * sizeof(uint32_t);
+    }
+    if (!doubles_.empty()) {
+        bytes += dimensions_ * sizeof(double);
+    }
+    bytes += attributes_.size() * sizeof(double);
+    return bytes;
+}
+
+} // namespace flood
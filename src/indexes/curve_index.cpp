@@ -0,0 +1,358 @@
+#include "indexes/curve_index.h"
+#include <iostream>
+#include <algorithm>
+#include <limits>
+
+namespace flood {
+
+namespace {
+
+// Smallest b with 2^b >= x
+uint32_t ceilLog2(size_t x) {
+    uint32_t bits = 0;
+    while (bits < 64 && (size_t(1) << bits) < x) {
+        ++bits;
+    }
+    return bits;
+}
+
+} // namespace
+
+CurveIndex::CurveIndex(size_t max_key_ranges)
+    : dimensions_(0), total_key_bits_(0), max_key_ranges_(std::max<size_t>(1, max_key_ranges)) {}
+
+void CurveIndex::build(const std::vector<DataPoint>& data) {
+    Timer timer;
+    
+    keys_.clear();
+    points_.clear();
+    
+    if (data.empty()) {
+        data_size_ = 0;
+        build_time_ms_ = timer.elapsed();
+        return;
+    }
+    
+    dimensions_ = data[0].getDimensions();
+    
+    // Compute min/max bounds for normalization
+    min_bounds_.assign(dimensions_, std::numeric_limits<double>::max());
+    max_bounds_.assign(dimensions_, std::numeric_limits<double>::lowest());
+    
+    for (const auto& point : data) {
+        for (size_t i = 0; i < dimensions_; ++i) {
+            double coord = point.getCoordinate(i);
+            min_bounds_[i] = std::min(min_bounds_[i], coord);
+            max_bounds_[i] = std::max(max_bounds_[i], coord);
+        }
+    }
+    
+    // Per-dimension bit budgets and the key layout they imply
+    chooseKeyBits(data);
+    buildKeyLayout();
+    
+    // Encode all points, then radix sort keys (stable, so duplicates survive)
+    keys_.resize(data.size());
+    std::vector<uint32_t> cells(dimensions_);
+    for (size_t i = 0; i < data.size(); ++i) {
+        keys_[i] = computeKey(data[i], cells);
+    }
+    std::vector<size_t> perm = sfc::radixSortKeys(keys_);
+    points_.build(data, perm, coordinate_encoding_, exact_recheck_, attributes_.get());
+    
+    data_size_ = data.size();
+    build_time_ms_ = timer.elapsed();
+    
+    std::cout << getName() << " index built: " << points_.size() << " points, "
+              << total_key_bits_ << "-bit keys, " << build_time_ms_ << " ms" << std::endl;
+}
+
+std::vector<DataPoint> CurveIndex::query(const QueryRange& range) {
+    return queryWithPositions(range, nullptr);
+}
+
+std::vector<DataPoint> CurveIndex::queryWithPositions(const QueryRange& range, std::vector<size_t>* positions) {
+    std::vector<DataPoint> results;
+    
+    if (keys_.empty()) {
+        return results;
+    }
+    
+    // Decompose the query box into key ranges, then scan only those
+    std::vector<std::pair<Key, Key>> key_ranges;
+    getRangeKeys(range, key_ranges);
+    scanned_runs_ += key_ranges.size();
+    
+    CoordinateStore::Box box = points_.compile(range);
+    auto search_from = keys_.begin();
+    for (const auto& [lo, hi] : key_ranges) {
+        // Ranges are sorted, so each search can start where the last one ended
+        auto first = std::lower_bound(search_from, keys_.end(), lo);
+        auto last = std::upper_bound(first, keys_.end(), hi);
+        size_t begin = std::distance(keys_.begin(), first);
+        size_t end = std::distance(keys_.begin(), last);
+        scanned_points_ += end - begin;
+        points_.scan(begin, end, box, results, positions);
+        search_from = last;
+    }
+    
+    return results;
+}
+
+double CurveIndex::getIndexSize() const {
+    // Flat arrays: 128-bit key + stored point per entry
+    size_t entry_size = sizeof(Key) + points_.bytesPerPoint();
+    size_t total_bytes = points_.size() * entry_size;
+    
+    return total_bytes / (1024.0 * 1024.0);
+}
+
+CurveIndex::Key CurveIndex::interleave(const uint32_t* cells) const {
+    if (morton_dims_ == 2) {
+        return sfc::mortonEncode2D(cells[0], cells[1]);
+    }
+    if (morton_dims_ == 3) {
+        return sfc::mortonEncode3D(cells[0], cells[1], cells[2]);
+    }
+    Key key = 0;
+    for (size_t i = 0; i < dimensions_; ++i) {
+        if (key_bits_[i] == 0) {
+            continue;
+        }
+        uint64_t lo = sfc::depositBits(cells[i], mask_lo_[i]);
+        uint64_t hi = mask_hi_[i] ?
+            sfc::depositBits(uint64_t(cells[i]) >> mask_lo_bits_[i], mask_hi_[i]) : 0;
+        key |= (Key(hi) << 64) | lo;
+    }
+    return key;
+}
+
+uint32_t CurveIndex::normalizeCoordinate(double value, size_t dim) const {
+    if (dim >= dimensions_) return 0;
+    return normalizeToCell(value, min_bounds_[dim], max_bounds_[dim], key_bits_[dim]);
+}
+
+void CurveIndex::chooseKeyBits(const std::vector<DataPoint>& data) {
+    // Estimate each dimension's resolution needs from a strided sample
+    const size_t SAMPLE_SIZE = 16384;
+    const size_t stride = std::max<size_t>(1, data.size() / SAMPLE_SIZE);
+    const uint32_t continuous_bits = std::min<uint32_t>(32, ceilLog2(data.size()) + 1);
+    
+    key_bits_.assign(dimensions_, 0);
+    std::vector<double> values;
+    for (size_t dim = 0; dim < dimensions_; ++dim) {
+        values.clear();
+        for (size_t i = 0; i < data.size(); i += stride) {
+            values.push_back(data[i].getCoordinate(dim));
+        }
+        std::sort(values.begin(), values.end());
+        size_t distinct = std::unique(values.begin(), values.end()) - values.begin();
+        
+        uint32_t bits = ceilLog2(distinct);
+        if (distinct * 2 > values.size()) {
+            // Mostly unique values: enough bits to separate n points
+            bits = std::max(bits, continuous_bits);
+        }
+        key_bits_[dim] = std::min<uint32_t>(bits, 32);
+    }
+    
+    // Trim the widest dimensions until the key fits
+    uint32_t total = 0;
+    for (uint32_t bits : key_bits_) {
+        total += bits;
+    }
+    while (total > sfc::MAX_KEY_BITS) {
+        auto widest = std::max_element(key_bits_.begin(), key_bits_.end());
+        --*widest;
+        --total;
+    }
+    
+    adjustKeyBits(key_bits_);
+}
+
+void CurveIndex::buildKeyLayout() {
+    mask_lo_.assign(dimensions_, 0);
+    mask_hi_.assign(dimensions_, 0);
+    mask_lo_bits_.assign(dimensions_, 0);
+    layout_.clear();
+    
+    uint32_t max_bits = 0;
+    for (uint32_t bits : key_bits_) {
+        max_bits = std::max(max_bits, bits);
+    }
+    
+    // Assign key positions from the least significant bit upward
+    uint32_t pos = 0;
+    for (uint32_t level = 0; level < max_bits; ++level) {
+        for (size_t i = 0; i < dimensions_; ++i) {
+            if (key_bits_[i] <= level) {
+                continue;
+            }
+            if (pos < 64) {
+                mask_lo_[i] |= 1ull << pos;
+            } else {
+                mask_hi_[i] |= 1ull << (pos - 64);
+            }
+            layout_.emplace_back(static_cast<uint32_t>(i), level);
+            ++pos;
+        }
+    }
+    total_key_bits_ = pos;
+    
+    // Decomposition walks key bits from the most significant
+    std::reverse(layout_.begin(), layout_.end());
+    for (size_t i = 0; i < dimensions_; ++i) {
+        mask_lo_bits_[i] = __builtin_popcountll(mask_lo_[i]);
+    }
+    
+    bool uniform = std::all_of(key_bits_.begin(), key_bits_.end(),
+                               [max_bits](uint32_t bits) { return bits == max_bits; });
+    morton_dims_ = (dimensions_ == 2 || dimensions_ == 3) && uniform && max_bits > 0 &&
+                   max_bits <= sfc::MORTON_BITS ? static_cast<uint32_t>(dimensions_) : 0;
+}
+
+CurveIndex::Key CurveIndex::computeKey(const DataPoint& point,
+                                       std::vector<uint32_t>& cells) const {
+    for (size_t i = 0; i < dimensions_; ++i) {
+        cells[i] = normalizeCoordinate(point.getCoordinate(i), i);
+    }
+    return encodeCells(cells.data());
+}
+
+void CurveIndex::getRangeKeys(const QueryRange& range,
+                              std::vector<std::pair<Key, Key>>& key_ranges) const {
+    // Decomposition in the quantized key space. A cell whose key prefix of
+    // length p is fixed covers one contiguous run of keys, so we refine
+    // cells that straddle the query boundary (one key bit, or one level
+    // for curves that need it, at a time) until the range budget is spent,
+    // then emit what's left whole. Points in partially covered cells are
+    // filtered exactly by the caller.
+    
+    key_ranges.clear();
+    const size_t d = dimensions_;
+    if (d == 0) {
+        return;
+    }
+    
+    // Query box in cell coordinates (dimensions the query omits are unbounded)
+    std::vector<uint32_t> q_lo(d, 0);
+    std::vector<uint32_t> q_hi(d, 0);
+    for (size_t i = 0; i < d; ++i) {
+        q_hi[i] = static_cast<uint32_t>((uint64_t(1) << key_bits_[i]) - 1);
+        if (i < range.getDimensions()) {
+            if (range.getMaxBound(i) < min_bounds_[i] || range.getMinBound(i) > max_bounds_[i] ||
+                range.getMinBound(i) > range.getMaxBound(i)) {
+                return;  // Query box misses the data entirely
+            }
+            q_lo[i] = normalizeCoordinate(range.getMinBound(i), i);
+            q_hi[i] = normalizeCoordinate(range.getMaxBound(i), i);
+        }
+    }
+    
+    const Key ALL_ONES = ~Key(0);
+    auto emitCell = [&](const uint32_t* origin, uint32_t prefix) {
+        // Any key inside the cell carries the cell's prefix; clear the rest
+        uint32_t free_bits = total_key_bits_ - prefix;
+        Key span = (free_bits >= 128) ? ALL_ONES : ((Key(1) << free_bits) - 1);
+        Key lo = encodeCells(origin) & ~span;
+        key_ranges.emplace_back(lo, lo | span);
+    };
+    
+    // Cells still straddling the query boundary, stored flat (d origins
+    // each); all share the same prefix length and per-dimension free bits
+    std::vector<uint32_t> partial(d, 0);
+    std::vector<uint32_t> next;
+    std::vector<uint32_t> child(d);
+    std::vector<uint32_t> free_bits = key_bits_;
+    std::vector<std::pair<uint32_t, uint32_t>> step;
+    uint32_t prefix = 0;
+    const bool by_level = refinesByLevel();
+    
+    // Level-wise refinement multiplies cells by 2^d per step; allow a few
+    // steps' worth so high-dimensional boxes are refined at all
+    size_t budget = max_key_ranges_;
+    if (by_level) {
+        budget = std::max(budget, size_t(4) << std::min<size_t>(d, 16));
+    }
+    
+    while (!partial.empty()) {
+        size_t num_partial = partial.size() / d;
+        
+        // Key bits the next refinement step fixes
+        step.clear();
+        if (prefix < total_key_bits_) {
+            step.push_back(layout_[prefix]);
+            while (by_level && prefix + step.size() < total_key_bits_ &&
+                   layout_[prefix + step.size()].second == layout_[prefix].second) {
+                step.push_back(layout_[prefix + step.size()]);
+            }
+        }
+        
+        size_t fanout = size_t(1) << std::min<size_t>(step.size(), 16);
+        if (step.empty() || step.size() > 16 ||
+            key_ranges.size() + num_partial * fanout > budget) {
+            for (size_t c = 0; c < num_partial; ++c) {
+                emitCell(&partial[c * d], prefix);
+            }
+            break;
+        }
+        
+        for (const auto& [dim, bit] : step) {
+            free_bits[dim] = bit;
+        }
+        uint32_t child_prefix = prefix + static_cast<uint32_t>(step.size());
+        next.clear();
+        
+        for (size_t c = 0; c < num_partial; ++c) {
+            for (size_t m = 0; m < fanout; ++m) {
+                std::copy(partial.begin() + c * d, partial.begin() + (c + 1) * d, child.begin());
+                for (size_t k = 0; k < step.size(); ++k) {
+                    if ((m >> k) & 1) {
+                        child[step[k].first] |= 1u << step[k].second;
+                    }
+                }
+                
+                bool disjoint = false;
+                bool inside = true;
+                for (size_t i = 0; i < d; ++i) {
+                    uint64_t cell_lo = child[i];
+                    uint64_t cell_hi = cell_lo + ((uint64_t(1) << free_bits[i]) - 1);
+                    if (cell_lo > q_hi[i] || cell_hi < q_lo[i]) {
+                        disjoint = true;
+                        break;
+                    }
+                    if (cell_lo < q_lo[i] || cell_hi > q_hi[i]) {
+                        inside = false;
+                    }
+                }
+                
+                if (disjoint) {
+                    continue;
+                }
+                if (inside) {
+                    emitCell(child.data(), child_prefix);
+                } else {
+                    next.insert(next.end(), child.begin(), child.end());
+                }
+            }
+        }
+        
+        partial.swap(next);
+        prefix = child_prefix;
+    }
+    
+    // Sort and coalesce adjacent runs
+    std::sort(key_ranges.begin(), key_ranges.end());
+    size_t out = 0;
+    for (size_t i = 0; i < key_ranges.size(); ++i) {
+        if (out > 0 && (key_ranges[out - 1].second == ALL_ONES ||
+                        key_ranges[i].first <= key_ranges[out - 1].second + 1)) {
+            key_ranges[out - 1].second = std::max(key_ranges[out - 1].second, key_ranges[i].second);
+        } else {
+            key_ranges[out++] = key_ranges[i];
+        }
+    }
+    key_ranges.resize(out);
+}
+
+} // namespace flood
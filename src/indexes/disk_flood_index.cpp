@@ -0,0 +1,250 @@
+#include "indexes/disk_flood_index.h"
+#include "indexes/flood_index.h"
+#include "indexes/flood_external_builder.h"
+#include "data/columnar_dataset.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <cerrno>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace flood {
+
+namespace {
+
+// Read exactly bytes at offset (the header and directory are read once,
+// outside the buffer pool)
+void readFully(int fd, void* buffer, size_t bytes, uint64_t offset, const std::string& path) {
+    char* out = static_cast<char*>(buffer);
+    while (bytes > 0) {
+        ssize_t got = ::pread(fd, out, bytes, static_cast<off_t>(offset));
+        if (got < 0 && errno == EINTR) {
+            continue;
+        }
+        if (got <= 0) {
+            throw std::runtime_error("Failed to read " + path + ": " +
+                                     (got < 0 ? std::strerror(errno) : "file is truncated"));
+        }
+        out += got;
+        bytes -= static_cast<size_t>(got);
+        offset += static_cast<uint64_t>(got);
+    }
+}
+
+} // namespace
+
+DiskFloodIndex::DiskFloodIndex(std::string index_path, DiskIndexOptions options)
+    : index_path_(std::move(index_path)), options_(options), owns_file_(false), fd_(-1) {
+    std::memset(&header_, 0, sizeof(header_));
+}
+
+DiskFloodIndex::~DiskFloodIndex() {
+    close();
+    if (owns_file_) {
+        std::remove(index_path_.c_str());
+    }
+}
+
+void DiskFloodIndex::build(const std::vector<DataPoint>& data) {
+    Timer timer;
+    close();
+    
+    // The builder streams from a columnar file, so stage the points in one
+    std::string staging_path = index_path_ + ".build.fcol";
+    try {
+        ColumnarDataset::write(data, staging_path);
+        ColumnarDataset dataset(staging_path);
+        ExternalBuildOptions build_options;
+        build_options.block_size = options_.block_size;
+        FloodExternalBuilder(build_options).build(dataset, index_path_);
+    } catch (...) {
+        std::remove(staging_path.c_str());
+        throw;
+    }
+    std::remove(staging_path.c_str());
+    owns_file_ = true;
+    
+    open();
+    build_time_ms_ = timer.elapsed();
+    
+    std::cout << "Flood-disk index built: " << data_size_ << " points in "
+              << directory_.size() << " blocks, " << build_time_ms_ << " ms" << std::endl;
+}
+
+void DiskFloodIndex::open() {
+    close();
+    
+    int flags = O_RDONLY;
+#ifdef O_DIRECT
+    if (options_.direct_io && options_.block_size % 512 == 0) {
+        flags |= O_DIRECT;
+    }
+#endif
+    fd_ = ::open(index_path_.c_str(), flags);
+    if (fd_ < 0 && flags != O_RDONLY) {
+        // Some file systems (tmpfs) refuse O_DIRECT; fall back to cached reads
+        fd_ = ::open(index_path_.c_str(), O_RDONLY);
+    }
+    if (fd_ < 0) {
+        throw std::runtime_error("Failed to open " + index_path_ + ": " + std::strerror(errno));
+    }
+    
+    try {
+        // Header and directory offsets are not block aligned in general,
+        // so they go through a plain descriptor
+        int meta_fd = ::open(index_path_.c_str(), O_RDONLY);
+        if (meta_fd < 0) {
+            throw std::runtime_error("Failed to open " + index_path_ + ": " + std::strerror(errno));
+        }
+        try {
+            readFully(meta_fd, &header_, sizeof(header_), 0, index_path_);
+            if (std::memcmp(header_.magic, fidx::MAGIC, sizeof(fidx::MAGIC)) != 0 ||
+                header_.version != fidx::FORMAT_VERSION ||
+                header_.record_size != fidx::recordSize(header_.dimensions) ||
+                header_.records_per_block == 0 ||
+                header_.records_per_block * header_.record_size > header_.block_size) {
+                throw std::runtime_error("Invalid Flood index file: " + index_path_);
+            }
+            
+            size_t dims = header_.dimensions;
+            std::vector<double> meta(3 * dims);
+            readFully(meta_fd, meta.data(), meta.size() * sizeof(double), sizeof(header_), index_path_);
+            projection_.assign(meta.begin(), meta.begin() + dims);
+            min_bounds_.assign(meta.begin() + dims, meta.begin() + 2 * dims);
+            max_bounds_.assign(meta.begin() + 2 * dims, meta.end());
+            
+            directory_.resize(header_.num_blocks);
+            readFully(meta_fd, directory_.data(), directory_.size() * sizeof(fidx::BlockEntry),
+                      header_.directory_offset, index_path_);
+        } catch (...) {
+            ::close(meta_fd);
+            throw;
+        }
+        ::close(meta_fd);
+    } catch (...) {
+        close();
+        throw;
+    }
+    
+    size_t num_frames = std::max<size_t>(2, options_.buffer_pool_bytes / header_.block_size);
+    pool_ = std::make_unique<BufferPool>(fd_, header_.data_offset, header_.block_size, num_frames);
+    options_.readahead_blocks = std::max<size_t>(1, std::min(options_.readahead_blocks, num_frames / 2));
+    data_size_ = header_.num_points;
+}
+
+std::vector<DataPoint> DiskFloodIndex::query(const QueryRange& range) {
+    std::vector<DataPoint> results;
+    if (!pool_ || directory_.empty()) {
+        return results;
+    }
+    
+    const size_t dims = header_.dimensions;
+    std::vector<double> lo(dims), hi(dims), lo_corner(dims), hi_corner(dims);
+    for (size_t dim = 0; dim < dims; ++dim) {
+        // Dimensions the query does not constrain are unbounded
+        bool bounded = dim < range.getDimensions();
+        lo[dim] = bounded ? range.getMinBound(dim) : -std::numeric_limits<double>::infinity();
+        hi[dim] = bounded ? range.getMaxBound(dim) : std::numeric_limits<double>::infinity();
+        // Every point lies within the data bounds, so the key corners can
+        // be clamped to them (keeps the keys finite)
+        lo_corner[dim] = std::max(lo[dim], min_bounds_[dim]);
+        hi_corner[dim] = std::min(hi[dim], max_bounds_[dim]);
+    }
+    
+    // Projection weights are non-negative, so the box's key interval runs
+    // from its min corner to its max corner
+    double min_key = FloodIndex::flattenedKey(lo_corner.data(), projection_, min_bounds_, max_bounds_);
+    double max_key = FloodIndex::flattenedKey(hi_corner.data(), projection_, min_bounds_, max_bounds_);
+    
+    // Blocks whose key span intersects [min_key, max_key]
+    auto first_it = std::lower_bound(directory_.begin(), directory_.end(), min_key,
+        [](const fidx::BlockEntry& entry, double key) { return entry.max_key < key; });
+    auto end_it = std::upper_bound(first_it, directory_.end(), max_key,
+        [](double key, const fidx::BlockEntry& entry) { return key < entry.min_key; });
+    uint64_t first = static_cast<uint64_t>(first_it - directory_.begin());
+    uint64_t end = static_cast<uint64_t>(end_it - directory_.begin());
+    if (first >= end) {
+        return results;
+    }
+    ++scanned_runs_;
+    
+    const size_t batch = options_.readahead_blocks;
+    std::vector<const char*> frames;
+    std::vector<double> coords(dims);
+    size_t scanned = 0;
+    for (uint64_t begin = first; begin < end; begin += batch) {
+        size_t count = static_cast<size_t>(std::min<uint64_t>(batch, end - begin));
+        if (begin + count < end) {
+            pool_->prefetch(begin + count, static_cast<size_t>(std::min<uint64_t>(batch, end - begin - count)));
+        }
+        
+        pool_->pinRange(begin, count, frames);
+        for (size_t b = 0; b < count; ++b) {
+            const char* record = frames[b];
+            for (uint64_t r = 0; r < directory_[begin + b].count; ++r, record += header_.record_size) {
+                double key;
+                std::memcpy(&key, record, sizeof(key));
+                if (key < min_key || key > max_key) {
+                    continue;
+                }
+                ++scanned;
+                
+                std::memcpy(coords.data(), record + 2 * sizeof(double), dims * sizeof(double));
+                bool inside = true;
+                for (size_t dim = 0; dim < dims && inside; ++dim) {
+                    inside = coords[dim] >= lo[dim] && coords[dim] <= hi[dim];
+                }
+                if (inside) {
+                    uint64_t id;
+                    std::memcpy(&id, record + sizeof(double), sizeof(id));
+                    results.emplace_back(coords, id);
+                }
+            }
+        }
+        pool_->unpinRange(begin, count);
+    }
+    scanned_points_ += scanned;
+    
+    return results;
+}
+
+double DiskFloodIndex::getIndexSize() const {
+    size_t directory_size = directory_.size() * sizeof(fidx::BlockEntry);
+    size_t pool_size = pool_ ? pool_->numFrames() * pool_->blockSize() : 0;
+    size_t meta_size = 3 * projection_.size() * sizeof(double);
+    
+    return (directory_size + pool_size + meta_size) / (1024.0 * 1024.0);
+}
+
+void DiskFloodIndex::dropCaches() {
+    if (pool_) {
+        pool_->clear();
+    }
+}
+
+const BufferPoolStats& DiskFloodIndex::getPoolStats() const {
+    static const BufferPoolStats empty;
+    return pool_ ? pool_->getStats() : empty;
+}
+
+void DiskFloodIndex::resetPoolStats() {
+    if (pool_) {
+        pool_->resetStats();
+    }
+}
+
+void DiskFloodIndex::close() {
+    pool_.reset();
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+    directory_.clear();
+    data_size_ = 0;
+}
+
+} // namespace flood
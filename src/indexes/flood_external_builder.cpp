@@ -0,0 +1,469 @@
+#include "indexes/flood_external_builder.h"
+#include "indexes/flood_index.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <cerrno>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <queue>
+#include <stdexcept>
+#include <vector>
+
+namespace flood {
+
+namespace {
+
+constexpr size_t MAX_STREAM_BUFFER = size_t(1) << 20;
+
+std::runtime_error ioError(const std::string& what, const std::string& filepath) {
+    return std::runtime_error(what + " " + filepath + ": " + std::strerror(errno));
+}
+
+double recordKey(const char* record) {
+    double key;
+    std::memcpy(&key, record, sizeof(key));
+    return key;
+}
+
+/**
+ * Tracks live buffer bytes and their high-water mark
+ */
+class BufferAccount {
+public:
+    explicit BufferAccount(size_t& peak) : peak_(peak) {}
+    
+    void add(size_t bytes) {
+        live_ += bytes;
+        peak_ = std::max(peak_, live_);
+    }
+    void remove(size_t bytes) { live_ -= bytes; }
+
+private:
+    size_t& peak_;
+    size_t live_ = 0;
+};
+
+/**
+ * Removes the temporary run files it knows about when destroyed
+ */
+class TempFiles {
+public:
+    ~TempFiles() {
+        for (const auto& path : paths_) {
+            std::remove(path.c_str());
+        }
+    }
+    
+    void add(const std::string& path) { paths_.push_back(path); }
+    
+    void remove(const std::string& path) {
+        std::remove(path.c_str());
+        paths_.erase(std::find(paths_.begin(), paths_.end(), path));
+    }
+
+private:
+    std::vector<std::string> paths_;
+};
+
+/**
+ * Sequential writer of fixed-size records to a run file
+ */
+class RunWriter {
+public:
+    RunWriter(const std::string& path, size_t record_size, size_t buffer_bytes)
+        : path_(path), file_(path, std::ios::binary | std::ios::trunc),
+          record_size_(record_size), buffer_(buffer_bytes), used_(0) {
+        if (!file_.is_open()) {
+            throw ioError("Failed to create run file", path);
+        }
+    }
+    
+    void append(const char* record) {
+        if (used_ + record_size_ > buffer_.size()) {
+            flush();
+        }
+        std::memcpy(buffer_.data() + used_, record, record_size_);
+        used_ += record_size_;
+    }
+    
+    void finish() {
+        flush();
+        file_.close();
+        if (!file_) {
+            throw ioError("Failed to write run file", path_);
+        }
+    }
+
+private:
+    std::string path_;
+    std::ofstream file_;
+    size_t record_size_;
+    std::vector<char> buffer_;
+    size_t used_;
+    
+    void flush() {
+        file_.write(buffer_.data(), used_);
+        used_ = 0;
+    }
+};
+
+/**
+ * Buffered sequential reader of a run file
+ */
+class RunReader {
+public:
+    RunReader(const std::string& path, size_t record_size, size_t buffer_bytes)
+        : path_(path), file_(path, std::ios::binary), record_size_(record_size),
+          buffer_(buffer_bytes), pos_(0), filled_(0) {
+        if (!file_.is_open()) {
+            throw ioError("Failed to open run file", path);
+        }
+        refill();
+    }
+    
+    bool exhausted() const { return pos_ >= filled_; }
+    const char* current() const { return buffer_.data() + pos_; }
+    
+    void advance() {
+        pos_ += record_size_;
+        if (pos_ >= filled_) {
+            refill();
+        }
+    }
+
+private:
+    std::string path_;
+    std::ifstream file_;
+    size_t record_size_;
+    std::vector<char> buffer_;
+    size_t pos_;
+    size_t filled_;
+    
+    void refill() {
+        file_.read(buffer_.data(), buffer_.size());
+        filled_ = static_cast<size_t>(file_.gcount());
+        pos_ = 0;
+        if (filled_ % record_size_ != 0 || (!file_ && !file_.eof())) {
+            throw std::runtime_error("Corrupt or unreadable run file " + path_);
+        }
+    }
+};
+
+/**
+ * Packs records into fixed-size blocks and writes the index file:
+ * header space first, then blocks as they fill, then the directory and
+ * finally the header itself
+ */
+class BlockWriter {
+public:
+    BlockWriter(const std::string& path, const fidx::FileHeader& header, size_t buffer_blocks)
+        : path_(path), file_(path, std::ios::binary | std::ios::trunc), header_(header),
+          buffer_(std::max<size_t>(1, buffer_blocks) * header.block_size, 0),
+          buffered_blocks_(0), in_block_(0), records_written_(0) {
+        if (!file_.is_open()) {
+            throw ioError("Failed to open index file for writing:", path);
+        }
+        std::vector<char> zeros(header_.data_offset, 0);
+        file_.write(zeros.data(), zeros.size());
+    }
+    
+    size_t bufferBytes() const { return buffer_.size(); }
+    
+    void append(const char* record) {
+        char* block = buffer_.data() + buffered_blocks_ * header_.block_size;
+        std::memcpy(block + in_block_ * header_.record_size, record, header_.record_size);
+        
+        double key = recordKey(record);
+        if (in_block_ == 0) {
+            directory_.push_back({key, key, records_written_, 0});
+        }
+        directory_.back().max_key = key;
+        directory_.back().count++;
+        ++records_written_;
+        
+        if (++in_block_ == header_.records_per_block) {
+            in_block_ = 0;
+            if (++buffered_blocks_ * header_.block_size == buffer_.size()) {
+                flush();
+            }
+        }
+    }
+    
+    /**
+     * Write the remaining blocks, the directory and the header
+     */
+    void finish(const std::vector<double>& projection,
+                const std::vector<double>& min_bounds,
+                const std::vector<double>& max_bounds) {
+        if (in_block_ > 0) {
+            ++buffered_blocks_;
+            in_block_ = 0;
+        }
+        flush();
+        
+        header_.num_points = records_written_;
+        header_.num_blocks = directory_.size();
+        header_.directory_offset = header_.data_offset + header_.num_blocks * header_.block_size;
+        file_.write(reinterpret_cast<const char*>(directory_.data()),
+                    directory_.size() * sizeof(fidx::BlockEntry));
+        
+        file_.seekp(0);
+        file_.write(reinterpret_cast<const char*>(&header_), sizeof(header_));
+        for (const auto* values : {&projection, &min_bounds, &max_bounds}) {
+            file_.write(reinterpret_cast<const char*>(values->data()), values->size() * sizeof(double));
+        }
+        
+        file_.close();
+        if (!file_) {
+            throw ioError("Failed to write", path_);
+        }
+    }
+    
+    size_t numBlocks() const { return directory_.size(); }
+
+private:
+    std::string path_;
+    std::ofstream file_;
+    fidx::FileHeader header_;
+    std::vector<char> buffer_;
+    size_t buffered_blocks_;
+    size_t in_block_;
+    uint64_t records_written_;
+    std::vector<fidx::BlockEntry> directory_;
+    
+    void flush() {
+        file_.write(buffer_.data(), buffered_blocks_ * header_.block_size);
+        // Zero the buffer so block tails are written as padding
+        std::fill(buffer_.begin(), buffer_.end(), 0);
+        buffered_blocks_ = 0;
+    }
+};
+
+/**
+ * K-way merge of run files into a sink, smallest key first (ties go to
+ * the earlier run, so the output stays in input order for equal keys)
+ */
+template <typename Sink>
+void mergeRuns(const std::vector<std::string>& runs, size_t record_size,
+               size_t buffer_bytes, Sink& sink) {
+    std::vector<std::unique_ptr<RunReader>> readers;
+    for (const auto& path : runs) {
+        readers.push_back(std::make_unique<RunReader>(path, record_size, buffer_bytes));
+    }
+    
+    using Head = std::pair<double, size_t>;
+    std::priority_queue<Head, std::vector<Head>, std::greater<Head>> heap;
+    for (size_t i = 0; i < readers.size(); ++i) {
+        if (!readers[i]->exhausted()) {
+            heap.emplace(recordKey(readers[i]->current()), i);
+        }
+    }
+    
+    while (!heap.empty()) {
+        size_t i = heap.top().second;
+        heap.pop();
+        sink.append(readers[i]->current());
+        readers[i]->advance();
+        if (!readers[i]->exhausted()) {
+            heap.emplace(recordKey(readers[i]->current()), i);
+        }
+    }
+}
+
+} // namespace
+
+void ExternalBuildStats::print() const {
+    std::cout << "External build: " << points << " points, " << runs << " runs, "
+              << merge_passes << " merge passes, " << blocks << " blocks, peak buffers "
+              << peak_buffer_bytes / (1024.0 * 1024.0) << " MB (" << elapsed_ms << " ms)"
+              << std::endl;
+}
+
+FloodExternalBuilder::FloodExternalBuilder(ExternalBuildOptions options)
+    : options_(std::move(options)) {}
+
+void FloodExternalBuilder::build(const ColumnarDataset& input, const std::string& index_path) {
+    auto start = std::chrono::high_resolution_clock::now();
+    stats_ = ExternalBuildStats();
+    
+    const size_t n = input.size();
+    const size_t dims = input.getDimensions();
+    const size_t record_size = fidx::recordSize(dims);
+    const size_t block_size = options_.block_size;
+    if (block_size < record_size) {
+        throw std::invalid_argument("Block size " + std::to_string(block_size) +
+                                    " cannot hold a " + std::to_string(record_size) + "-byte record");
+    }
+    
+    // Every stream (run writer, run reader, block writer) gets the same
+    // buffer size; run generation spends the rest of the budget on the
+    // chunk being sorted (record + sort entry per row)
+    struct SortEntry {
+        double key;
+        uint64_t row;
+    };
+    const size_t budget = options_.memory_budget_bytes;
+    size_t stream_bytes = std::min(MAX_STREAM_BUFFER, budget / 16);
+    stream_bytes = std::max(record_size, stream_bytes / record_size * record_size);
+    const size_t chunk_rows = std::max<size_t>(
+        1, (budget > stream_bytes ? budget - stream_bytes : 0) / (record_size + sizeof(SortEntry)));
+    const size_t fan_in = std::max<size_t>(2, budget / stream_bytes - 1);
+    const size_t stream_blocks = std::max<size_t>(1, stream_bytes / block_size);
+    
+    std::vector<double> min_bounds(dims), max_bounds(dims);
+    for (size_t dim = 0; dim < dims; ++dim) {
+        min_bounds[dim] = input.getMinBound(dim);
+        max_bounds[dim] = input.getMaxBound(dim);
+    }
+    
+    // Pass 1: per-dimension variances, streamed chunk by chunk
+    std::vector<double> means(dims, 0.0), m2(dims, 0.0);
+    for (size_t begin = 0; begin < n; begin += chunk_rows) {
+        size_t end = std::min(n, begin + chunk_rows);
+        for (size_t dim = 0; dim < dims; ++dim) {
+            const double* column = input.column(dim);
+            double mean = means[dim], acc = m2[dim];
+            for (size_t i = begin; i < end; ++i) {
+                double delta = column[i] - mean;
+                mean += delta / static_cast<double>(i + 1);
+                acc += delta * (column[i] - mean);
+            }
+            means[dim] = mean;
+            m2[dim] = acc;
+        }
+        input.release(begin, end);
+    }
+    std::vector<double> variances(dims, 0.0);
+    for (size_t dim = 0; dim < dims && n > 0; ++dim) {
+        variances[dim] = m2[dim] / static_cast<double>(n);
+    }
+    std::vector<double> projection = FloodIndex::projectionFromVariances(variances);
+    
+    fidx::FileHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, fidx::MAGIC, sizeof(fidx::MAGIC));
+    header.version = fidx::FORMAT_VERSION;
+    header.block_size = static_cast<uint32_t>(block_size);
+    header.dimensions = dims;
+    header.record_size = record_size;
+    header.records_per_block = block_size / record_size;
+    header.data_offset = fidx::headerBytes(dims, block_size);
+    
+    std::string run_prefix = index_path;
+    if (!options_.temp_dir.empty()) {
+        size_t slash = index_path.find_last_of('/');
+        run_prefix = options_.temp_dir + "/" +
+            (slash == std::string::npos ? index_path : index_path.substr(slash + 1));
+    }
+    TempFiles temp_files;
+    BufferAccount buffers(stats_.peak_buffer_bytes);
+    
+    // Pass 2: run generation. If everything fits in one chunk, the sorted
+    // chunk goes straight into the index file.
+    std::vector<std::string> runs;
+    {
+        std::vector<char> records(std::min(n, chunk_rows) * record_size);
+        std::vector<SortEntry> order(std::min(n, chunk_rows));
+        buffers.add(records.size() + order.size() * sizeof(SortEntry));
+        
+        std::vector<double> coords(dims);
+        for (size_t begin = 0; begin < n; begin += chunk_rows) {
+            size_t end = std::min(n, begin + chunk_rows);
+            size_t rows = end - begin;
+            
+            for (size_t r = 0; r < rows; ++r) {
+                for (size_t dim = 0; dim < dims; ++dim) {
+                    coords[dim] = input.column(dim)[begin + r];
+                }
+                double key = FloodIndex::flattenedKey(coords.data(), projection, min_bounds, max_bounds);
+                uint64_t id = input.ids()[begin + r];
+                
+                char* record = records.data() + r * record_size;
+                std::memcpy(record, &key, sizeof(key));
+                std::memcpy(record + sizeof(key), &id, sizeof(id));
+                std::memcpy(record + sizeof(key) + sizeof(id), coords.data(), dims * sizeof(double));
+                order[r] = {key, r};
+            }
+            input.release(begin, end);
+            
+            std::sort(order.begin(), order.begin() + rows, [](const SortEntry& a, const SortEntry& b) {
+                return a.key < b.key || (a.key == b.key && a.row < b.row);
+            });
+            
+            if (n <= chunk_rows) {
+                BlockWriter writer(index_path, header, stream_blocks);
+                buffers.add(writer.bufferBytes());
+                for (size_t r = 0; r < rows; ++r) {
+                    writer.append(records.data() + order[r].row * record_size);
+                }
+                writer.finish(projection, min_bounds, max_bounds);
+                stats_.blocks = writer.numBlocks();
+                buffers.remove(writer.bufferBytes());
+            } else {
+                std::string path = run_prefix + ".run0_" + std::to_string(runs.size());
+                temp_files.add(path);
+                RunWriter writer(path, record_size, stream_bytes);
+                buffers.add(stream_bytes);
+                for (size_t r = 0; r < rows; ++r) {
+                    writer.append(records.data() + order[r].row * record_size);
+                }
+                writer.finish();
+                buffers.remove(stream_bytes);
+                runs.push_back(path);
+            }
+        }
+        buffers.remove(records.size() + order.size() * sizeof(SortEntry));
+    }
+    stats_.runs = runs.size();
+    
+    if (n == 0) {
+        BlockWriter writer(index_path, header, 1);
+        writer.finish(projection, min_bounds, max_bounds);
+    }
+    
+    // Intermediate merge passes until one final merge can take every run
+    while (runs.size() > fan_in) {
+        ++stats_.merge_passes;
+        std::vector<std::string> merged;
+        for (size_t first = 0; first < runs.size(); first += fan_in) {
+            std::vector<std::string> group(runs.begin() + first,
+                                           runs.begin() + std::min(runs.size(), first + fan_in));
+            std::string path = run_prefix + ".run" + std::to_string(stats_.merge_passes) +
+                               "_" + std::to_string(merged.size());
+            temp_files.add(path);
+            
+            RunWriter writer(path, record_size, stream_bytes);
+            buffers.add((group.size() + 1) * stream_bytes);
+            mergeRuns(group, record_size, stream_bytes, writer);
+            writer.finish();
+            buffers.remove((group.size() + 1) * stream_bytes);
+            
+            for (const auto& run : group) {
+                temp_files.remove(run);
+            }
+            merged.push_back(path);
+        }
+        runs.swap(merged);
+    }
+    
+    // Final merge into the block file
+    if (!runs.empty()) {
+        ++stats_.merge_passes;
+        BlockWriter writer(index_path, header, stream_blocks);
+        buffers.add(runs.size() * stream_bytes + writer.bufferBytes());
+        mergeRuns(runs, record_size, stream_bytes, writer);
+        writer.finish(projection, min_bounds, max_bounds);
+        stats_.blocks = writer.numBlocks();
+        buffers.remove(runs.size() * stream_bytes + writer.bufferBytes());
+    }
+    
+    stats_.points = n;
+    stats_.elapsed_ms = std::chrono::duration<double, std::milli>(
+        std::chrono::high_resolution_clock::now() - start).count();
+}
+
+} // namespace flood
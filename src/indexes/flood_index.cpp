@@ -7,7 +7,13 @@
 
 namespace flood {
 
-FloodIndex::FloodIndex() : dimensions_(0) {}
+FloodIndex::FloodIndex() : dimensions_(0), verbose_(true) {}
+
+std::ostream& FloodIndex::log() const {
+    // Unbuffered stream that drops everything when logging is off
+    static std::ostream null_stream(nullptr);
+    return verbose_ ? std::cout : null_stream;
+}
 
 void FloodIndex::build(const std::vector<DataPoint>& data) {
     Timer timer;
@@ -20,28 +26,32 @@ void FloodIndex::build(const std::vector<DataPoint>& data) {
     
     dimensions_ = data[0].getDimensions();
     
-    std::cout << "Building Flood index..." << std::endl;
+    log() << "Building Flood index..." << std::endl;
     
     // Step 1: Analyze data distribution
-    std::cout << "  1. Analyzing data distribution..." << std::endl;
+    log() << "  1. Analyzing data distribution..." << std::endl;
     analyzeDistribution(data);
     
     // Step 2: Learn projection vector (simplified PCA approach)
-    std::cout << "  2. Learning projection vector..." << std::endl;
+    log() << "  2. Learning projection vector..." << std::endl;
     learnProjection(data);
     
     // Step 3: Flatten data to 1D
-    std::cout << "  3. Flattening data to 1D..." << std::endl;
+    log() << "  3. Flattening data to 1D..." << std::endl;
     flattenData(data);
     
     data_size_ = data.size();
     build_time_ms_ = timer.elapsed();
     
-    std::cout << "Flood index built: " << flattened_data_.size() << " points, "
-              << build_time_ms_ << " ms" << std::endl;
+    log() << "Flood index built: " << flattened_data_.size() << " points, "
+          << build_time_ms_ << " ms" << std::endl;
 }
 
 std::vector<DataPoint> FloodIndex::query(const QueryRange& range) {
+    return queryWithPositions(range, nullptr);
+}
+
+std::vector<DataPoint> FloodIndex::queryWithPositions(const QueryRange& range, std::vector<size_t>* positions) {
     std::vector<DataPoint> results;
     
     if (flattened_data_.empty()) {
@@ -52,21 +62,20 @@ std::vector<DataPoint> FloodIndex::query(const QueryRange& range) {
     auto intervals = mapRangeToIntervals(range);
     
     // Scan each interval and filter results
+    scanned_runs_ += intervals.size();
+    CoordinateStore::Box box = flattened_data_.compile(range);
     for (const auto& [start, end] : intervals) {
-        for (size_t i = start; i <= end && i < flattened_data_.size(); ++i) {
-            const auto& point = flattened_data_[i];
-            if (range.contains(point)) {
-                results.push_back(point);
-            }
-        }
+        size_t stop = std::min(end + 1, flattened_data_.size());
+        scanned_points_ += stop - start;
+        flattened_data_.scan(start, stop, box, results, positions);
     }
     
     return results;
 }
 
 double FloodIndex::getIndexSize() const {
-    // Flattened data + projection vector + cost model
-    size_t point_size = dimensions_ * sizeof(double) + sizeof(uint64_t);
+    // Flattened data and keys + projection vector + cost model
+    size_t point_size = flattened_data_.bytesPerPoint() + sizeof(float);
     size_t data_size = flattened_data_.size() * point_size;
     size_t projection_size = projection_vector_.size() * sizeof(double);
     size_t model_size = sizeof(CostModel) + cost_model_.dimension_weights.size() * sizeof(double);
@@ -76,8 +85,8 @@ double FloodIndex::getIndexSize() const {
 }
 
 void FloodIndex::train(const std::vector<QueryRange>& training_queries) {
-    std::cout << "Training cost model with " << training_queries.size() 
-              << " queries..." << std::endl;
+    log() << "Training cost model with " << training_queries.size() 
+          << " queries..." << std::endl;
     trainCostModel(training_queries);
 }
 
@@ -87,17 +96,27 @@ double FloodIndex::computeFlattenedKey(const DataPoint& point) const {
     }
     
     // Compute dot product: key = projection_vector · normalized_point
-    double key = 0.0;
-    for (size_t i = 0; i < dimensions_; ++i) {
-        // Normalize coordinate to [0, 1]
-        double range = max_bounds_[i] - min_bounds_[i];
-        double normalized = (range > 1e-10) ? 
-            (point.getCoordinate(i) - min_bounds_[i]) / range : 0.0;
-        
-        key += projection_vector_[i] * normalized;
+    return flattenKey([&point](size_t i) { return point.getCoordinate(i); },
+                      projection_vector_, min_bounds_, max_bounds_);
+}
+
+std::vector<double> FloodIndex::projectionFromVariances(const std::vector<double>& variances) {
+    std::vector<double> projection(variances.size(), 0.0);
+    
+    // Normalize variances to get projection weights
+    double total_var = std::accumulate(variances.begin(), variances.end(), 0.0);
+    if (total_var > 1e-10) {
+        for (size_t i = 0; i < variances.size(); ++i) {
+            projection[i] = std::sqrt(variances[i] / total_var);
+        }
+    } else {
+        // Equal weights if no variance
+        for (size_t i = 0; i < variances.size(); ++i) {
+            projection[i] = 1.0 / std::sqrt(variances.size());
+        }
     }
     
-    return key;
+    return projection;
 }
 
 void FloodIndex::learnProjection(const std::vector<DataPoint>& data) {
@@ -129,33 +148,22 @@ void FloodIndex::learnProjection(const std::vector<DataPoint>& data) {
         variances[i] /= data.size();
     }
     
-    // Normalize variances to get projection weights
-    double total_var = std::accumulate(variances.begin(), variances.end(), 0.0);
-    if (total_var > 1e-10) {
-        for (size_t i = 0; i < dimensions_; ++i) {
-            projection_vector_[i] = std::sqrt(variances[i] / total_var);
-        }
-    } else {
-        // Equal weights if no variance
-        for (size_t i = 0; i < dimensions_; ++i) {
-            projection_vector_[i] = 1.0 / std::sqrt(dimensions_);
-        }
-    }
+    projection_vector_ = projectionFromVariances(variances);
     
     // Initialize cost model dimension weights
     cost_model_.dimension_weights = projection_vector_;
     
-    std::cout << "    Projection vector learned (variance-based)" << std::endl;
+    log() << "    Projection vector learned (variance-based)" << std::endl;
 }
 
 void FloodIndex::flattenData(const std::vector<DataPoint>& data) {
-    // Create pairs of (flattened_key, data_point)
-    std::vector<std::pair<double, DataPoint>> keyed_data;
+    // Create pairs of (flattened_key, data_point index)
+    std::vector<std::pair<double, size_t>> keyed_data;
     keyed_data.reserve(data.size());
     
-    for (const auto& point : data) {
-        double key = computeFlattenedKey(point);
-        keyed_data.emplace_back(key, point);
+    for (size_t i = 0; i < data.size(); ++i) {
+        double key = computeFlattenedKey(data[i]);
+        keyed_data.emplace_back(key, i);
     }
     
     // Sort by flattened key
@@ -163,22 +171,24 @@ void FloodIndex::flattenData(const std::vector<DataPoint>& data) {
               [](const auto& a, const auto& b) { return a.first < b.first; });
     
     // Extract sorted data
-    flattened_data_.clear();
-    flattened_data_.reserve(data.size());
+    std::vector<size_t> order(keyed_data.size());
+    flattened_keys_.resize(keyed_data.size());
     position_map_.clear();
     position_map_.reserve(data.size());
     
     for (size_t i = 0; i < keyed_data.size(); ++i) {
-        flattened_data_.push_back(keyed_data[i].second);
+        order[i] = keyed_data[i].second;
+        flattened_keys_[i] = static_cast<float>(keyed_data[i].first);
         position_map_.push_back(i);
     }
+    flattened_data_.build(data, order, coordinate_encoding_, exact_recheck_, attributes_.get());
     
-    std::cout << "    Data flattened and sorted by projection" << std::endl;
+    log() << "    Data flattened and sorted by projection" << std::endl;
 }
 
 void FloodIndex::trainCostModel(const std::vector<QueryRange>& queries) {
     if (queries.empty()) {
-        std::cout << "    No training queries provided, using default model" << std::endl;
+        log() << "    No training queries provided, using default model" << std::endl;
         return;
     }
     
@@ -189,8 +199,8 @@ void FloodIndex::trainCostModel(const std::vector<QueryRange>& queries) {
     cost_model_.alpha = 1.0;   // Sequential scan cost
     cost_model_.beta = 0.1;    // Random access cost
     
-    std::cout << "    Cost model trained (alpha=" << cost_model_.alpha 
-              << ", beta=" << cost_model_.beta << ")" << std::endl;
+    log() << "    Cost model trained (alpha=" << cost_model_.alpha 
+          << ", beta=" << cost_model_.beta << ")" << std::endl;
 }
 
 std::vector<std::pair<size_t, size_t>> FloodIndex::mapRangeToIntervals(
@@ -216,14 +226,8 @@ std::vector<std::pair<size_t, size_t>> FloodIndex::mapRangeToIntervals(
         }
         
         // Compute flattened key for this corner
-        double key = 0.0;
-        for (size_t i = 0; i < dimensions_; ++i) {
-            double range_width = max_bounds_[i] - min_bounds_[i];
-            double normalized = (range_width > 1e-10) ?
-                (coords[i] - min_bounds_[i]) / range_width : 0.0;
-            key += projection_vector_[i] * normalized;
-        }
-        corner_keys.push_back(key);
+        corner_keys.push_back(flattenedKey(coords.data(), projection_vector_,
+                                           min_bounds_, max_bounds_));
     }
     
     // Find min and max keys
@@ -247,16 +251,10 @@ size_t FloodIndex::findStartPosition(double key) const {
     }
     
     // Binary search for the first position with flattened key >= key
-    auto it = std::lower_bound(
-        flattened_data_.begin(), 
-        flattened_data_.end(),
-        key,
-        [this](const DataPoint& point, double value) {
-            return computeFlattenedKey(point) < value;
-        }
-    );
+    auto it = std::lower_bound(flattened_keys_.begin(), flattened_keys_.end(),
+                               static_cast<float>(key));
     
-    return std::distance(flattened_data_.begin(), it);
+    return std::distance(flattened_keys_.begin(), it);
 }
 
 size_t FloodIndex::findEndPosition(double key) const {
@@ -265,20 +263,14 @@ size_t FloodIndex::findEndPosition(double key) const {
     }
     
     // Binary search for the last position with flattened key <= key
-    auto it = std::upper_bound(
-        flattened_data_.begin(),
-        flattened_data_.end(),
-        key,
-        [this](double value, const DataPoint& point) {
-            return value < computeFlattenedKey(point);
-        }
-    );
+    auto it = std::upper_bound(flattened_keys_.begin(), flattened_keys_.end(),
+                               static_cast<float>(key));
     
-    if (it == flattened_data_.begin()) {
+    if (it == flattened_keys_.begin()) {
         return 0;
     }
     
-    return std::distance(flattened_data_.begin(), it) - 1;
+    return std::distance(flattened_keys_.begin(), it) - 1;
 }
 
 void FloodIndex::analyzeDistribution(const std::vector<DataPoint>& data) {
@@ -294,7 +286,7 @@ void FloodIndex::analyzeDistribution(const std::vector<DataPoint>& data) {
         }
     }
     
-    std::cout << "    Data bounds computed for " << dimensions_ << " dimensions" << std::endl;
+    log() << "    Data bounds computed for " << dimensions_ << " dimensions" << std::endl;
 }
 
 } // namespace flood
@@ -0,0 +1,231 @@
+#include "indexes/grid_index.h"
+#include <iostream>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace flood {
+
+GridIndex::GridIndex(size_t target_cell_size, bool equi_depth)
+    : target_cell_size_(std::max<size_t>(1, target_cell_size)),
+      equi_depth_(equi_depth), dimensions_(0) {}
+
+void GridIndex::build(const std::vector<DataPoint>& data) {
+    Timer timer;
+    
+    points_.clear();
+    cell_offsets_.clear();
+    
+    if (data.empty()) {
+        data_size_ = 0;
+        build_time_ms_ = timer.elapsed();
+        return;
+    }
+    
+    dimensions_ = data[0].getDimensions();
+    
+    // Compute data bounds
+    min_bounds_.assign(dimensions_, std::numeric_limits<double>::max());
+    max_bounds_.assign(dimensions_, std::numeric_limits<double>::lowest());
+    for (const auto& point : data) {
+        for (size_t i = 0; i < dimensions_; ++i) {
+            double coord = point.getCoordinate(i);
+            min_bounds_[i] = std::min(min_bounds_[i], coord);
+            max_bounds_[i] = std::max(max_bounds_[i], coord);
+        }
+    }
+    
+    // Partition boundaries and directory layout
+    computeBoundaries(data, partitionsPerDimension(data.size()));
+    
+    strides_.assign(dimensions_, 1);
+    for (size_t i = 1; i < dimensions_; ++i) {
+        strides_[i] = strides_[i - 1] * (boundaries_[i - 1].size() + 1);
+    }
+    size_t num_cells = strides_[dimensions_ - 1] * (boundaries_[dimensions_ - 1].size() + 1);
+    
+    // Counting sort of points by cell
+    std::vector<size_t> cells(data.size());
+    cell_offsets_.assign(num_cells + 1, 0);
+    for (size_t i = 0; i < data.size(); ++i) {
+        cells[i] = cellOf(data[i]);
+        ++cell_offsets_[cells[i] + 1];
+    }
+    for (size_t c = 0; c < num_cells; ++c) {
+        cell_offsets_[c + 1] += cell_offsets_[c];
+    }
+    
+    std::vector<size_t> order(data.size());
+    std::vector<size_t> write_pos(cell_offsets_.begin(), cell_offsets_.end() - 1);
+    for (size_t i = 0; i < data.size(); ++i) {
+        order[write_pos[cells[i]]++] = i;
+    }
+    
+    points_.build(data, order, coordinate_encoding_, exact_recheck_, attributes_.get());
+    
+    data_size_ = data.size();
+    build_time_ms_ = timer.elapsed();
+    
+    std::cout << getName() << " index built: " << points_.size() << " points, "
+              << num_cells << " cells, " << build_time_ms_ << " ms" << std::endl;
+}
+
+std::vector<DataPoint> GridIndex::query(const QueryRange& range) {
+    return queryWithPositions(range, nullptr);
+}
+
+std::vector<DataPoint> GridIndex::queryWithPositions(const QueryRange& range, std::vector<size_t>* positions) {
+    std::vector<DataPoint> results;
+    
+    if (points_.empty()) {
+        return results;
+    }
+    
+    // Per dimension: overlapped partitions [lo, hi], and whether the first
+    // and last of them lie entirely inside the query
+    const size_t d = dimensions_;
+    std::vector<size_t> lo(d), hi(d);
+    std::vector<bool> lo_covered(d), hi_covered(d);
+    
+    for (size_t i = 0; i < d; ++i) {
+        size_t last = boundaries_[i].size();
+        if (i >= range.getDimensions()) {
+            lo[i] = 0;
+            hi[i] = last;
+            lo_covered[i] = hi_covered[i] = true;
+            continue;
+        }
+        
+        double q_min = range.getMinBound(i);
+        double q_max = range.getMaxBound(i);
+        if (q_max < min_bounds_[i] || q_min > max_bounds_[i] || q_min > q_max) {
+            return results;  // Query box misses the data entirely
+        }
+        
+        lo[i] = partitionOf(q_min, i);
+        hi[i] = partitionOf(q_max, i);
+        
+        // Partition p holds [boundaries[p - 1], boundaries[p]); the outer
+        // partitions are closed by the data bounds
+        double lower = (lo[i] == 0) ? min_bounds_[i] : boundaries_[i][lo[i] - 1];
+        double upper = (hi[i] == last) ? max_bounds_[i] : boundaries_[i][hi[i]];
+        lo_covered[i] = lower >= q_min;
+        hi_covered[i] = upper <= q_max;
+    }
+    
+    auto covered = [&](size_t dim, size_t p) {
+        return (p > lo[dim] || lo_covered[dim]) && (p < hi[dim] || hi_covered[dim]);
+    };
+    
+    // Walk the overlapped cells; dimension 0 has stride 1, so each
+    // combination of the other partitions is one contiguous run
+    CoordinateStore::Box box = points_.compile(range);
+    std::vector<size_t> cur(lo);
+    while (true) {
+        size_t base = 0;
+        bool outer_covered = true;
+        for (size_t i = 1; i < d; ++i) {
+            base += cur[i] * strides_[i];
+            outer_covered = outer_covered && covered(i, cur[i]);
+        }
+        
+        ++scanned_runs_;
+        for (size_t p = lo[0]; p <= hi[0]; ++p) {
+            size_t begin = cell_offsets_[base + p];
+            size_t end = cell_offsets_[base + p + 1];
+            scanned_points_ += end - begin;
+            
+            if (outer_covered && covered(0, p)) {
+                // Interior cell: every point qualifies
+                points_.append(begin, end, results, positions);
+            } else {
+                // Boundary cell: exact refinement
+                points_.scan(begin, end, box, results, positions);
+            }
+        }
+        
+        // Advance the odometer over dimensions 1..d-1
+        size_t i = 1;
+        for (; i < d; ++i) {
+            if (cur[i] < hi[i]) {
+                ++cur[i];
+                break;
+            }
+            cur[i] = lo[i];
+        }
+        if (i >= d) {
+            break;
+        }
+    }
+    
+    return results;
+}
+
+double GridIndex::getIndexSize() const {
+    // Points + dense directory + boundaries
+    size_t total_bytes = points_.size() * points_.bytesPerPoint() + cell_offsets_.size() * sizeof(size_t);
+    for (const auto& b : boundaries_) {
+        total_bytes += b.size() * sizeof(double);
+    }
+    
+    return total_bytes / (1024.0 * 1024.0);
+}
+
+size_t GridIndex::partitionsPerDimension(size_t num_points) const {
+    // k^d cells of about target_cell_size_ points each
+    double cells = std::max(1.0, static_cast<double>(num_points) / target_cell_size_);
+    double k = std::floor(std::pow(cells, 1.0 / dimensions_) + 1e-9);
+    return std::max<size_t>(1, static_cast<size_t>(k));
+}
+
+void GridIndex::computeBoundaries(const std::vector<DataPoint>& data, size_t partitions) {
+    boundaries_.assign(dimensions_, {});
+    if (partitions <= 1) {
+        return;
+    }
+    
+    const size_t SAMPLE_SIZE = 100000;
+    const size_t stride = std::max<size_t>(1, data.size() / SAMPLE_SIZE);
+    std::vector<double> sample;
+    
+    for (size_t dim = 0; dim < dimensions_; ++dim) {
+        auto& b = boundaries_[dim];
+        
+        if (equi_depth_) {
+            // Quantiles of a strided sample
+            sample.clear();
+            for (size_t i = 0; i < data.size(); i += stride) {
+                sample.push_back(data[i].getCoordinate(dim));
+            }
+            std::sort(sample.begin(), sample.end());
+            for (size_t j = 1; j < partitions; ++j) {
+                b.push_back(sample[j * sample.size() / partitions]);
+            }
+        } else {
+            double width = (max_bounds_[dim] - min_bounds_[dim]) / partitions;
+            for (size_t j = 1; j < partitions; ++j) {
+                b.push_back(min_bounds_[dim] + j * width);
+            }
+        }
+        
+        // Heavy duplicates collapse quantiles; drop repeats and boundaries
+        // that would leave the first partition empty
+        b.erase(std::unique(b.begin(), b.end()), b.end());
+        b.erase(b.begin(), std::upper_bound(b.begin(), b.end(), min_bounds_[dim]));
+    }
+}
+
+size_t GridIndex::partitionOf(double value, size_t dim) const {
+    const auto& b = boundaries_[dim];
+    return std::upper_bound(b.begin(), b.end(), value) - b.begin();
+}
+
+size_t GridIndex::cellOf(const DataPoint& point) const {
+    size_t cell = 0;
+    for (size_t i = 0; i < dimensions_; ++i) {
+        cell += partitionOf(point.getCoordinate(i), i) * strides_[i];
+    }
+    return cell;
+}
+
+} // namespace flood
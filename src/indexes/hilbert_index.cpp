@@ -0,0 +1,23 @@
+#include "indexes/hilbert_index.h"
+#include <algorithm>
+
+namespace flood {
+
+HilbertIndex::HilbertIndex(size_t max_key_ranges) : CurveIndex(max_key_ranges) {}
+
+CurveIndex::Key HilbertIndex::encodeCells(const uint32_t* cells) const {
+    return sfc::hilbertEncode(cells, dimensions_, key_bits_.empty() ? 0 : key_bits_[0]);
+}
+
+void HilbertIndex::adjustKeyBits(std::vector<uint32_t>& bits) const {
+    // The Hilbert curve needs the same number of bits in every dimension:
+    // use the widest budget that still fits the key
+    if (bits.empty()) {
+        return;
+    }
+    uint32_t widest = *std::max_element(bits.begin(), bits.end());
+    uint32_t uniform = std::min<uint32_t>(widest, sfc::MAX_KEY_BITS / bits.size());
+    std::fill(bits.begin(), bits.end(), uniform);
+}
+
+} // namespace flood
@@ -0,0 +1,252 @@
+#include "indexes/quadtree_index.h"
+#include <iostream>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace flood {
+
+QuadtreeIndex::QuadtreeIndex(size_t bucket_size, size_t max_split_dims)
+    : bucket_size_(std::max<size_t>(1, bucket_size)),
+      max_split_dims_(std::min<size_t>(std::max<size_t>(1, max_split_dims), 3)),
+      split_dims_(0), dimensions_(0), depth_limit_(0), max_depth_reached_(0) {}
+
+void QuadtreeIndex::build(const std::vector<DataPoint>& data) {
+    Timer timer;
+    
+    nodes_.clear();
+    points_.clear();
+    max_depth_reached_ = 0;
+    
+    if (data.empty()) {
+        data_size_ = 0;
+        build_time_ms_ = timer.elapsed();
+        return;
+    }
+    if (data.size() > std::numeric_limits<uint32_t>::max()) {
+        throw std::runtime_error("Quadtree index supports at most 2^32 - 1 points");
+    }
+    
+    dimensions_ = data[0].getDimensions();
+    split_dims_ = std::min(max_split_dims_, dimensions_);
+    // Sentinel bit + split_dims_ bits per level must fit in the 64-bit code
+    depth_limit_ = static_cast<uint32_t>(std::min<size_t>(63 / split_dims_, 32));
+    
+    // Root box
+    min_bounds_.assign(dimensions_, std::numeric_limits<double>::max());
+    max_bounds_.assign(dimensions_, std::numeric_limits<double>::lowest());
+    for (const auto& point : data) {
+        for (size_t i = 0; i < dimensions_; ++i) {
+            double coord = point.getCoordinate(i);
+            min_bounds_[i] = std::min(min_bounds_[i], coord);
+            max_bounds_[i] = std::max(max_bounds_[i], coord);
+        }
+    }
+    
+    // Recursively split, permuting point ids so every subtree is contiguous
+    std::vector<uint32_t> order(data.size());
+    for (size_t i = 0; i < order.size(); ++i) {
+        order[i] = static_cast<uint32_t>(i);
+    }
+    std::vector<uint32_t> scratch(data.size());
+    
+    nodes_.push_back(Node{1, NO_CHILDREN, 0, static_cast<uint32_t>(data.size())});
+    buildNode(data, order, scratch, 0, 0);
+    
+    points_.build(data, std::vector<size_t>(order.begin(), order.end()),
+                  coordinate_encoding_, exact_recheck_, attributes_.get());
+    
+    data_size_ = data.size();
+    build_time_ms_ = timer.elapsed();
+    
+    std::cout << getName() << " index built: " << points_.size() << " points, "
+              << nodes_.size() << " nodes, depth " << max_depth_reached_ << ", "
+              << build_time_ms_ << " ms" << std::endl;
+}
+
+void QuadtreeIndex::buildNode(const std::vector<DataPoint>& data, std::vector<uint32_t>& order,
+                              std::vector<uint32_t>& scratch, size_t node_idx, uint32_t depth) {
+    const uint32_t begin = nodes_[node_idx].begin;
+    const uint32_t end = nodes_[node_idx].end;
+    
+    if (end - begin <= bucket_size_ || depth >= depth_limit_) {
+        max_depth_reached_ = std::max<size_t>(max_depth_reached_, depth);
+        return;  // Leaf
+    }
+    
+    // Split at the midpoint of the node's box in every split dimension
+    uint64_t cells[3];
+    decodeCode(nodes_[node_idx].code, cells);
+    double mids[3];
+    for (size_t i = 0; i < split_dims_; ++i) {
+        mids[i] = boundary(i, 2 * cells[i] + 1, depth + 1);
+    }
+    
+    auto childOf = [&](uint32_t id) {
+        uint32_t child = 0;
+        for (size_t i = 0; i < split_dims_; ++i) {
+            if (data[id].getCoordinate(i) >= mids[i]) {
+                child |= 1u << i;
+            }
+        }
+        return child;
+    };
+    
+    // Counting sort of the node's points by child
+    const uint32_t fanout = 1u << split_dims_;
+    uint32_t offsets[9] = {0};
+    for (uint32_t j = begin; j < end; ++j) {
+        ++offsets[childOf(order[j]) + 1];
+    }
+    offsets[0] = begin;
+    for (uint32_t c = 0; c < fanout; ++c) {
+        offsets[c + 1] += offsets[c];
+    }
+    
+    uint32_t write_pos[8];
+    std::copy(offsets, offsets + fanout, write_pos);
+    for (uint32_t j = begin; j < end; ++j) {
+        scratch[write_pos[childOf(order[j])]++] = order[j];
+    }
+    std::copy(scratch.begin() + begin, scratch.begin() + end, order.begin() + begin);
+    
+    // Children are allocated as one contiguous block
+    if (nodes_.size() + fanout > std::numeric_limits<uint32_t>::max()) {
+        throw std::runtime_error("Quadtree index node array overflow");
+    }
+    const uint32_t first = static_cast<uint32_t>(nodes_.size());
+    const uint64_t code = nodes_[node_idx].code;
+    nodes_[node_idx].first_child = first;
+    for (uint32_t c = 0; c < fanout; ++c) {
+        nodes_.push_back(Node{(code << split_dims_) | c, NO_CHILDREN, offsets[c], offsets[c + 1]});
+    }
+    
+    for (uint32_t c = 0; c < fanout; ++c) {
+        buildNode(data, order, scratch, first + c, depth + 1);
+    }
+}
+
+std::vector<DataPoint> QuadtreeIndex::query(const QueryRange& range) {
+    return queryWithPositions(range, nullptr);
+}
+
+std::vector<DataPoint> QuadtreeIndex::queryWithPositions(const QueryRange& range, std::vector<size_t>* positions) {
+    std::vector<DataPoint> results;
+    
+    if (points_.empty()) {
+        return results;
+    }
+    
+    // Query bounds in the split dimensions (unbounded if the query omits
+    // them), and whether the query spans the data in all other dimensions
+    double q_min[3], q_max[3];
+    bool rest_covered = true;
+    for (size_t i = 0; i < dimensions_; ++i) {
+        double lo = -std::numeric_limits<double>::infinity();
+        double hi = std::numeric_limits<double>::infinity();
+        if (i < range.getDimensions()) {
+            lo = range.getMinBound(i);
+            hi = range.getMaxBound(i);
+            if (hi < min_bounds_[i] || lo > max_bounds_[i] || lo > hi) {
+                return results;  // Query box misses the data entirely
+            }
+        }
+        if (i < split_dims_) {
+            q_min[i] = lo;
+            q_max[i] = hi;
+        } else if (lo > min_bounds_[i] || hi < max_bounds_[i]) {
+            rest_covered = false;
+        }
+    }
+    
+    CoordinateStore::Box box = points_.compile(range);
+    std::vector<uint32_t> stack = {0};
+    uint64_t cells[3];
+    
+    while (!stack.empty()) {
+        const Node& node = nodes_[stack.back()];
+        stack.pop_back();
+        
+        if (node.begin == node.end) {
+            continue;
+        }
+        
+        // Node box from its locational code; points satisfy lo <= x < hi
+        // (x <= hi on the upper edge of the root)
+        uint32_t depth = decodeCode(node.code, cells);
+        bool disjoint = false;
+        bool covered = rest_covered;
+        for (size_t i = 0; i < split_dims_; ++i) {
+            double lo = boundary(i, cells[i], depth);
+            double hi = boundary(i, cells[i] + 1, depth);
+            if (hi < q_min[i] || lo > q_max[i]) {
+                disjoint = true;
+                break;
+            }
+            if (lo < q_min[i] || hi > q_max[i]) {
+                covered = false;
+            }
+        }
+        if (disjoint) {
+            continue;
+        }
+        
+        if (covered) {
+            // Whole subtree inside the query
+            ++scanned_runs_;
+            scanned_points_ += node.end - node.begin;
+            points_.append(node.begin, node.end, results, positions);
+        } else if (node.first_child == NO_CHILDREN) {
+            ++scanned_runs_;
+            scanned_points_ += node.end - node.begin;
+            points_.scan(node.begin, node.end, box, results, positions);
+        } else {
+            // Push children in reverse so results come out in leaf order
+            for (uint32_t c = 1u << split_dims_; c-- > 0;) {
+                stack.push_back(node.first_child + c);
+            }
+        }
+    }
+    
+    return results;
+}
+
+double QuadtreeIndex::getIndexSize() const {
+    // Points + node array
+    size_t total_bytes = points_.size() * points_.bytesPerPoint() + nodes_.size() * sizeof(Node);
+    
+    return total_bytes / (1024.0 * 1024.0);
+}
+
+double QuadtreeIndex::boundary(size_t dim, uint64_t numer, uint32_t depth) const {
+    // Build and query both go through here, so splits and node boxes agree
+    // exactly; the outer edges are pinned to the data bounds
+    if (numer == 0) {
+        return min_bounds_[dim];
+    }
+    if (numer == (uint64_t(1) << depth)) {
+        return max_bounds_[dim];
+    }
+    double extent = max_bounds_[dim] - min_bounds_[dim];
+    return min_bounds_[dim] + extent * std::ldexp(static_cast<double>(numer), -static_cast<int>(depth));
+}
+
+uint32_t QuadtreeIndex::decodeCode(uint64_t code, uint64_t* cells) const {
+    uint32_t depth = static_cast<uint32_t>((63 - __builtin_clzll(code)) / split_dims_);
+    const uint64_t group_mask = (uint64_t(1) << split_dims_) - 1;
+    
+    for (size_t i = 0; i < split_dims_; ++i) {
+        cells[i] = 0;
+    }
+    // Path groups from the root (most significant) down
+    for (uint32_t level = depth; level-- > 0;) {
+        uint64_t group = (code >> (level * split_dims_)) & group_mask;
+        for (size_t i = 0; i < split_dims_; ++i) {
+            cells[i] = (cells[i] << 1) | ((group >> i) & 1);
+        }
+    }
+    return depth;
+}
+
+} // namespace flood
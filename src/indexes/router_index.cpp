@@ -0,0 +1,359 @@
+#include "indexes/router_index.h"
+#include <iostream>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace flood {
+
+namespace {
+
+constexpr size_t HISTOGRAM_BUCKETS = 64;
+constexpr size_t HISTOGRAM_SAMPLE_SIZE = 100000;
+
+// Selectivities are clamped here before taking logs
+constexpr double MIN_SELECTIVITY = 1e-9;
+
+} // namespace
+
+void RegretReport::print() const {
+    std::cout << "Router regret over " << queries << " queries:" << std::endl;
+    std::cout << "  Routed total:      " << router_ms << " ms" << std::endl;
+    std::cout << "  Oracle total:      " << oracle_ms << " ms" << std::endl;
+    std::cout << "  Best single index: " << best_single_ms << " ms" << std::endl;
+    std::cout << "  Regret:            " << regret() << " ms" << std::endl;
+    std::cout << "  Optimal picks:     " << optimal_picks << "/" << queries << std::endl;
+}
+
+RouterIndex::RouterIndex(std::vector<std::shared_ptr<BaseIndex>> indexes)
+    : indexes_(std::move(indexes)), dimensions_(0), calibrated_(false) {
+    if (indexes_.empty()) {
+        throw std::invalid_argument("RouterIndex needs at least one index");
+    }
+}
+
+void RouterIndex::train(const std::vector<QueryRange>& training_queries) {
+    training_queries_ = training_queries;
+}
+
+void RouterIndex::setCoordinateStorage(CoordinateEncoding encoding, bool exact_recheck) {
+    BaseIndex::setCoordinateStorage(encoding, exact_recheck);
+    for (auto& index : indexes_) {
+        index->setCoordinateStorage(encoding, exact_recheck);
+    }
+}
+
+void RouterIndex::dropCaches() {
+    for (auto& index : indexes_) {
+        index->dropCaches();
+    }
+}
+
+void RouterIndex::build(const std::vector<DataPoint>& data) {
+    Timer timer;
+    
+    dimensions_ = data.empty() ? 0 : data[0].getDimensions();
+    data_size_ = data.size();
+    calibrated_ = false;
+    routing_log_.clear();
+    
+    for (auto& index : indexes_) {
+        index->build(data);
+    }
+    buildHistograms(data);
+    
+    if (!training_queries_.empty() && !data.empty()) {
+        calibrate(training_queries_, measureLatencies(training_queries_));
+    }
+    
+    build_time_ms_ = timer.elapsed();
+    
+    std::cout << "Router index built: " << indexes_.size() << " indexes, "
+              << (calibrated_ ? "calibrated on " + std::to_string(training_queries_.size()) + " queries"
+                              : "uncalibrated")
+              << ", " << build_time_ms_ << " ms" << std::endl;
+}
+
+std::vector<DataPoint> RouterIndex::query(const QueryRange& range) {
+    RoutingDecision decision;
+    decision.index = route(range, &decision.predicted_ms);
+    BaseIndex& target = *indexes_[decision.index];
+    
+    Timer timer;
+    auto results = target.query(range);
+    decision.actual_ms = timer.elapsed();
+    routing_log_.push_back(decision);
+    
+    return results;
+}
+
+size_t RouterIndex::getScannedPoints() const {
+    size_t total = scanned_points_;
+    for (const auto& index : indexes_) {
+        total += index->getScannedPoints();
+    }
+    return total;
+}
+
+size_t RouterIndex::getScannedRuns() const {
+    size_t total = scanned_runs_;
+    for (const auto& index : indexes_) {
+        total += index->getScannedRuns();
+    }
+    return total;
+}
+
+void RouterIndex::resetScanStats() {
+    BaseIndex::resetScanStats();
+    for (auto& index : indexes_) {
+        index->resetScanStats();
+    }
+}
+
+double RouterIndex::getIndexSize() const {
+    // All member indexes + histograms + models
+    double total = 0.0;
+    for (const auto& index : indexes_) {
+        total += index->getIndexSize();
+    }
+    size_t meta_bytes = 0;
+    for (const auto& q : quantiles_) {
+        meta_bytes += q.size() * sizeof(double);
+    }
+    for (const auto& w : weights_) {
+        meta_bytes += w.size() * sizeof(double);
+    }
+    
+    return total + meta_bytes / (1024.0 * 1024.0);
+}
+
+void RouterIndex::calibrate(const std::vector<QueryRange>& queries,
+                            const std::vector<std::vector<double>>& latencies_ms) {
+    if (latencies_ms.size() != indexes_.size()) {
+        throw std::invalid_argument("RouterIndex::calibrate needs latencies for every index");
+    }
+    if (queries.empty()) {
+        return;
+    }
+    
+    std::vector<std::vector<double>> features;
+    features.reserve(queries.size());
+    for (const auto& range : queries) {
+        features.push_back(extractFeatures(range));
+    }
+    
+    weights_.clear();
+    for (const auto& latencies : latencies_ms) {
+        if (latencies.size() != queries.size()) {
+            throw std::invalid_argument("RouterIndex::calibrate needs one latency per query");
+        }
+        weights_.push_back(fitLinear(features, latencies));
+    }
+    calibrated_ = true;
+}
+
+size_t RouterIndex::route(const QueryRange& range, double* predicted_ms) const {
+    size_t best = 0;
+    double best_cost = 0.0;
+    
+    if (calibrated_) {
+        auto features = extractFeatures(range);
+        best_cost = std::numeric_limits<double>::max();
+        for (size_t i = 0; i < weights_.size(); ++i) {
+            double cost = 0.0;
+            for (size_t f = 0; f < features.size(); ++f) {
+                cost += weights_[i][f] * features[f];
+            }
+            if (cost < best_cost) {
+                best_cost = cost;
+                best = i;
+            }
+        }
+    }
+    
+    if (predicted_ms) {
+        *predicted_ms = std::max(0.0, best_cost);
+    }
+    return best;
+}
+
+RegretReport RouterIndex::evaluateRegret(const std::vector<QueryRange>& queries) {
+    RegretReport report;
+    report.queries = queries.size();
+    
+    auto latencies = measureLatencies(queries);
+    std::vector<double> per_index_total(indexes_.size(), 0.0);
+    
+    for (size_t q = 0; q < queries.size(); ++q) {
+        size_t fastest = 0;
+        for (size_t i = 0; i < indexes_.size(); ++i) {
+            per_index_total[i] += latencies[i][q];
+            if (latencies[i][q] < latencies[fastest][q]) {
+                fastest = i;
+            }
+        }
+        
+        size_t chosen = route(queries[q]);
+        report.router_ms += latencies[chosen][q];
+        report.oracle_ms += latencies[fastest][q];
+        if (chosen == fastest) {
+            ++report.optimal_picks;
+        }
+    }
+    
+    report.best_single_ms = per_index_total.empty() ? 0.0 :
+        *std::min_element(per_index_total.begin(), per_index_total.end());
+    
+    return report;
+}
+
+std::vector<size_t> RouterIndex::getRouteCounts() const {
+    std::vector<size_t> counts(indexes_.size(), 0);
+    for (const auto& decision : routing_log_) {
+        ++counts[decision.index];
+    }
+    return counts;
+}
+
+void RouterIndex::buildHistograms(const std::vector<DataPoint>& data) {
+    quantiles_.assign(dimensions_, {});
+    if (data.empty()) {
+        return;
+    }
+    
+    const size_t stride = std::max<size_t>(1, data.size() / HISTOGRAM_SAMPLE_SIZE);
+    std::vector<double> sample;
+    for (size_t dim = 0; dim < dimensions_; ++dim) {
+        sample.clear();
+        for (size_t i = 0; i < data.size(); i += stride) {
+            sample.push_back(data[i].getCoordinate(dim));
+        }
+        std::sort(sample.begin(), sample.end());
+        
+        auto& q = quantiles_[dim];
+        for (size_t b = 0; b <= HISTOGRAM_BUCKETS; ++b) {
+            q.push_back(sample[std::min(sample.size() - 1, b * sample.size() / HISTOGRAM_BUCKETS)]);
+        }
+        q.back() = sample.back();
+    }
+}
+
+double RouterIndex::estimateSelectivity(double lo, double hi, size_t dim) const {
+    const auto& q = quantiles_[dim];
+    
+    // Fraction of the data at or below v, interpolated within a bucket
+    auto cdf = [&](double v) {
+        if (v < q.front()) return 0.0;
+        if (v >= q.back()) return 1.0;
+        size_t b = std::upper_bound(q.begin(), q.end(), v) - q.begin() - 1;
+        double width = q[b + 1] - q[b];
+        double within = width > 0.0 ? (v - q[b]) / width : 1.0;
+        return (b + within) / HISTOGRAM_BUCKETS;
+    };
+    
+    return std::clamp(cdf(hi) - cdf(lo), 0.0, 1.0);
+}
+
+std::vector<double> RouterIndex::extractFeatures(const QueryRange& range) const {
+    // [1, estimated rows / 1000, log2(1 + estimated rows), log2(selectivity) per dimension]
+    std::vector<double> features(3 + dimensions_, 0.0);
+    
+    double selectivity = 1.0;
+    for (size_t dim = 0; dim < dimensions_; ++dim) {
+        double s = 1.0;
+        if (dim < range.getDimensions()) {
+            s = estimateSelectivity(range.getMinBound(dim), range.getMaxBound(dim), dim);
+        }
+        // Point-like ranges on discrete values estimate to 0; keep them finite
+        s = std::max(s, MIN_SELECTIVITY);
+        selectivity *= s;
+        features[3 + dim] = std::log2(s);
+    }
+    
+    double rows = selectivity * data_size_;
+    features[0] = 1.0;
+    features[1] = rows / 1000.0;
+    features[2] = std::log2(1.0 + rows);
+    
+    return features;
+}
+
+std::vector<std::vector<double>> RouterIndex::measureLatencies(const std::vector<QueryRange>& queries) {
+    std::vector<std::vector<double>> latencies(indexes_.size());
+    
+    for (size_t i = 0; i < indexes_.size(); ++i) {
+        BaseIndex& index = *indexes_[i];
+        latencies[i].reserve(queries.size());
+        
+        // One untimed pass to warm caches
+        for (size_t q = 0; q < std::min<size_t>(10, queries.size()); ++q) {
+            index.query(queries[q]);
+        }
+        for (const auto& range : queries) {
+            Timer timer;
+            index.query(range);
+            latencies[i].push_back(timer.elapsed());
+        }
+        index.resetScanStats();
+    }
+    
+    return latencies;
+}
+
+std::vector<double> RouterIndex::fitLinear(const std::vector<std::vector<double>>& X,
+                                           const std::vector<double>& y) {
+    const size_t k = X.empty() ? 0 : X[0].size();
+    
+    // Normal equations (X^T X + ridge * I) w = X^T y
+    std::vector<std::vector<double>> A(k, std::vector<double>(k + 1, 0.0));
+    for (size_t r = 0; r < X.size(); ++r) {
+        for (size_t i = 0; i < k; ++i) {
+            for (size_t j = 0; j < k; ++j) {
+                A[i][j] += X[r][i] * X[r][j];
+            }
+            A[i][k] += X[r][i] * y[r];
+        }
+    }
+    double trace = 0.0;
+    for (size_t i = 0; i < k; ++i) {
+        trace += A[i][i];
+    }
+    double ridge = 1e-6 * (trace > 0.0 ? trace / k : 1.0);
+    for (size_t i = 0; i < k; ++i) {
+        A[i][i] += ridge;
+    }
+    
+    // Gaussian elimination with partial pivoting
+    for (size_t col = 0; col < k; ++col) {
+        size_t pivot = col;
+        for (size_t r = col + 1; r < k; ++r) {
+            if (std::abs(A[r][col]) > std::abs(A[pivot][col])) {
+                pivot = r;
+            }
+        }
+        std::swap(A[col], A[pivot]);
+        if (std::abs(A[col][col]) < 1e-300) {
+            continue;
+        }
+        for (size_t r = 0; r < k; ++r) {
+            if (r == col) {
+                continue;
+            }
+            double factor = A[r][col] / A[col][col];
+            for (size_t c = col; c <= k; ++c) {
+                A[r][c] -= factor * A[col][c];
+            }
+        }
+    }
+    
+    std::vector<double> w(k, 0.0);
+    for (size_t i = 0; i < k; ++i) {
+        if (std::abs(A[i][i]) >= 1e-300) {
+            w[i] = A[i][k] / A[i][i];
+        }
+    }
+    return w;
+}
+
+} // namespace flood
@@ -0,0 +1,243 @@
+#include "indexes/sharded_index.h"
+#include <iostream>
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+namespace flood {
+
+ShardedIndex::ShardedIndex(IndexFactory factory, size_t num_shards,
+                           ShardPartitioning partitioning, size_t num_threads)
+    : partitioning_(partitioning), pool_(num_threads),
+      dimensions_(0), last_shards_queried_(0) {
+    if (!factory || num_shards == 0) {
+        throw std::invalid_argument("ShardedIndex needs an index factory and at least one shard");
+    }
+    
+    shards_.resize(num_shards);
+    for (auto& shard : shards_) {
+        shard.index = factory();
+    }
+}
+
+std::string ShardedIndex::getName() const {
+    return shards_[0].index->getName() + " x" + std::to_string(shards_.size());
+}
+
+void ShardedIndex::setCoordinateStorage(CoordinateEncoding encoding, bool exact_recheck) {
+    BaseIndex::setCoordinateStorage(encoding, exact_recheck);
+    for (auto& shard : shards_) {
+        shard.index->setCoordinateStorage(encoding, exact_recheck);
+    }
+}
+
+void ShardedIndex::dropCaches() {
+    for (auto& shard : shards_) {
+        shard.index->dropCaches();
+    }
+}
+
+void ShardedIndex::build(const std::vector<DataPoint>& data) {
+    Timer timer;
+    
+    dimensions_ = data.empty() ? 0 : data[0].getDimensions();
+    
+    // Scatter points to shards and compute each shard's bounding box
+    std::vector<size_t> assignment = assignShards(data);
+    std::vector<std::vector<DataPoint>> parts(shards_.size());
+    for (auto& shard : shards_) {
+        shard.size = 0;
+        shard.min_bounds.assign(dimensions_, std::numeric_limits<double>::max());
+        shard.max_bounds.assign(dimensions_, std::numeric_limits<double>::lowest());
+    }
+    for (size_t i = 0; i < data.size(); ++i) {
+        ++shards_[assignment[i]].size;
+    }
+    for (size_t s = 0; s < shards_.size(); ++s) {
+        parts[s].reserve(shards_[s].size);
+    }
+    for (size_t i = 0; i < data.size(); ++i) {
+        Shard& shard = shards_[assignment[i]];
+        for (size_t d = 0; d < dimensions_; ++d) {
+            double coord = data[i].getCoordinate(d);
+            shard.min_bounds[d] = std::min(shard.min_bounds[d], coord);
+            shard.max_bounds[d] = std::max(shard.max_bounds[d], coord);
+        }
+        parts[assignment[i]].push_back(data[i]);
+    }
+    
+    // Shards are independent, so they build concurrently
+    pool_.parallelFor(shards_.size(), [&](size_t s) {
+        shards_[s].index->build(parts[s]);
+        std::vector<DataPoint>().swap(parts[s]);
+    });
+    
+    data_size_ = data.size();
+    build_time_ms_ = timer.elapsed();
+    
+    std::cout << getName() << " index built: " << data.size() << " points, "
+              << shards_.size() << " shards, " << pool_.size() + 1 << " threads, "
+              << build_time_ms_ << " ms" << std::endl;
+}
+
+std::vector<DataPoint> ShardedIndex::query(const QueryRange& range) {
+    // Prune shards by bounding box
+    std::vector<size_t> targets;
+    for (size_t s = 0; s < shards_.size(); ++s) {
+        if (shards_[s].size > 0 && intersects(shards_[s], range)) {
+            targets.push_back(s);
+        }
+    }
+    last_shards_queried_ = targets.size();
+    
+    std::vector<std::vector<DataPoint>> partial(targets.size());
+    if (targets.size() == 1) {
+        partial[0] = shards_[targets[0]].index->query(range);
+    } else {
+        pool_.parallelFor(targets.size(), [&](size_t t) {
+            partial[t] = shards_[targets[t]].index->query(range);
+        });
+    }
+    
+    // Gather: move every partial result into one vector
+    size_t total = 0;
+    for (const auto& part : partial) {
+        total += part.size();
+    }
+    
+    std::vector<DataPoint> results;
+    if (!partial.empty()) {
+        results = std::move(partial[0]);
+        results.reserve(total);
+        for (size_t t = 1; t < partial.size(); ++t) {
+            results.insert(results.end(), std::make_move_iterator(partial[t].begin()),
+                           std::make_move_iterator(partial[t].end()));
+        }
+    }
+    
+    return results;
+}
+
+size_t ShardedIndex::getScannedPoints() const {
+    size_t total = scanned_points_;
+    for (const auto& shard : shards_) {
+        total += shard.index->getScannedPoints();
+    }
+    return total;
+}
+
+size_t ShardedIndex::getScannedRuns() const {
+    size_t total = scanned_runs_;
+    for (const auto& shard : shards_) {
+        total += shard.index->getScannedRuns();
+    }
+    return total;
+}
+
+void ShardedIndex::resetScanStats() {
+    BaseIndex::resetScanStats();
+    for (auto& shard : shards_) {
+        shard.index->resetScanStats();
+    }
+}
+
+bool ShardedIndex::supportsConcurrentQueries() const {
+    for (const auto& shard : shards_) {
+        if (!shard.index->supportsConcurrentQueries()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+double ShardedIndex::getIndexSize() const {
+    double total = 0.0;
+    for (const auto& shard : shards_) {
+        total += shard.index->getIndexSize();
+    }
+    total += shards_.size() * 2 * dimensions_ * sizeof(double) / (1024.0 * 1024.0);
+    
+    return total;
+}
+
+std::vector<size_t> ShardedIndex::assignShards(const std::vector<DataPoint>& data) const {
+    std::vector<size_t> assignment(data.size(), 0);
+    const size_t n = shards_.size();
+    
+    if (partitioning_ == ShardPartitioning::ROUND_ROBIN || data.empty()) {
+        for (size_t i = 0; i < data.size(); ++i) {
+            assignment[i] = i % n;
+        }
+        return assignment;
+    }
+    
+    std::vector<size_t> ids(data.size());
+    for (size_t i = 0; i < ids.size(); ++i) {
+        ids[i] = i;
+    }
+    
+    if (partitioning_ == ShardPartitioning::KEY_RANGE) {
+        // Equal-count ranges of dimension 0
+        std::stable_sort(ids.begin(), ids.end(), [&](size_t a, size_t b) {
+            return data[a].getCoordinate(0) < data[b].getCoordinate(0);
+        });
+        for (size_t pos = 0; pos < ids.size(); ++pos) {
+            assignment[ids[pos]] = pos * n / ids.size();
+        }
+    } else {
+        bisect(data, ids, 0, ids.size(), 0, n, assignment);
+    }
+    
+    return assignment;
+}
+
+void ShardedIndex::bisect(const std::vector<DataPoint>& data, std::vector<size_t>& ids,
+                          size_t begin, size_t end, size_t first_shard, size_t num_shards,
+                          std::vector<size_t>& assignment) const {
+    if (num_shards == 1 || end - begin <= 1) {
+        for (size_t pos = begin; pos < end; ++pos) {
+            assignment[ids[pos]] = first_shard;
+        }
+        return;
+    }
+    
+    // Split the widest dimension so the halves get point counts
+    // proportional to their shard counts
+    size_t split_dim = 0;
+    double widest = -1.0;
+    for (size_t d = 0; d < dimensions_; ++d) {
+        double lo = std::numeric_limits<double>::max();
+        double hi = std::numeric_limits<double>::lowest();
+        for (size_t pos = begin; pos < end; ++pos) {
+            double coord = data[ids[pos]].getCoordinate(d);
+            lo = std::min(lo, coord);
+            hi = std::max(hi, coord);
+        }
+        if (hi - lo > widest) {
+            widest = hi - lo;
+            split_dim = d;
+        }
+    }
+    
+    size_t left_shards = num_shards / 2;
+    size_t mid = begin + (end - begin) * left_shards / num_shards;
+    std::nth_element(ids.begin() + begin, ids.begin() + mid, ids.begin() + end,
+                     [&](size_t a, size_t b) {
+                         return data[a].getCoordinate(split_dim) < data[b].getCoordinate(split_dim);
+                     });
+    
+    bisect(data, ids, begin, mid, first_shard, left_shards, assignment);
+    bisect(data, ids, mid, end, first_shard + left_shards, num_shards - left_shards, assignment);
+}
+
+bool ShardedIndex::intersects(const Shard& shard, const QueryRange& range) const {
+    size_t dims = std::min(dimensions_, range.getDimensions());
+    for (size_t d = 0; d < dims; ++d) {
+        if (range.getMaxBound(d) < shard.min_bounds[d] || range.getMinBound(d) > shard.max_bounds[d]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace flood
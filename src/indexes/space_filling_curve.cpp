@@ -0,0 +1,257 @@
+#include "indexes/space_filling_curve.h"
+#include <array>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define FLOOD_BMI2_DISPATCH 1
+#include <immintrin.h>
+#endif
+
+namespace flood {
+namespace sfc {
+
+namespace {
+
+const uint64_t COORD_MASK = (1ull << MORTON_BITS) - 1;
+
+// Spread the low 21 bits of v so there is one zero bit between each
+inline uint64_t spreadBits2(uint64_t v) {
+    v &= COORD_MASK;
+    v = (v | (v << 16)) & 0x0000FFFF0000FFFFull;
+    v = (v | (v << 8))  & 0x00FF00FF00FF00FFull;
+    v = (v | (v << 4))  & 0x0F0F0F0F0F0F0F0Full;
+    v = (v | (v << 2))  & 0x3333333333333333ull;
+    v = (v | (v << 1))  & 0x5555555555555555ull;
+    return v;
+}
+
+// Spread the low 21 bits of v so there are two zero bits between each
+inline uint64_t spreadBits3(uint64_t v) {
+    v &= COORD_MASK;
+    v = (v | (v << 32)) & 0x001F00000000FFFFull;
+    v = (v | (v << 16)) & 0x001F0000FF0000FFull;
+    v = (v | (v << 8))  & 0x100F00F00F00F00Full;
+    v = (v | (v << 4))  & 0x10C30C30C30C30C3ull;
+    v = (v | (v << 2))  & 0x1249249249249249ull;
+    return v;
+}
+
+#ifdef FLOOD_BMI2_DISPATCH
+__attribute__((target("bmi2")))
+uint64_t mortonEncode2DPdep(uint32_t x, uint32_t y) {
+    return _pdep_u64(x & COORD_MASK, 0x5555555555555555ull) |
+           _pdep_u64(y & COORD_MASK, 0xAAAAAAAAAAAAAAAAull);
+}
+
+__attribute__((target("bmi2")))
+uint64_t depositBitsPdep(uint64_t value, uint64_t mask) {
+    return _pdep_u64(value, mask);
+}
+
+__attribute__((target("bmi2")))
+uint64_t mortonEncode3DPdep(uint32_t x, uint32_t y, uint32_t z) {
+    return _pdep_u64(x & COORD_MASK, 0x1249249249249249ull) |
+           _pdep_u64(y & COORD_MASK, 0x2492492492492492ull) |
+           _pdep_u64(z & COORD_MASK, 0x4924924924924924ull);
+}
+#endif
+
+using Encode2DFn = uint64_t (*)(uint32_t, uint32_t);
+using Encode3DFn = uint64_t (*)(uint32_t, uint32_t, uint32_t);
+
+// Resolved once at static initialization
+#ifdef FLOOD_BMI2_DISPATCH
+const Encode2DFn encode2D_impl = cpuHasBMI2() ? mortonEncode2DPdep : mortonEncode2DMagic;
+const Encode3DFn encode3D_impl = cpuHasBMI2() ? mortonEncode3DPdep : mortonEncode3DMagic;
+#else
+const Encode2DFn encode2D_impl = mortonEncode2DMagic;
+const Encode3DFn encode3D_impl = mortonEncode3DMagic;
+#endif
+
+} // namespace
+
+bool cpuHasBMI2() {
+#ifdef FLOOD_BMI2_DISPATCH
+    // May run from a static initializer, so make sure the CPU model is set up
+    static const bool has_bmi2 = (__builtin_cpu_init(), __builtin_cpu_supports("bmi2"));
+    return has_bmi2;
+#else
+    return false;
+#endif
+}
+
+uint64_t mortonEncode2DMagic(uint32_t x, uint32_t y) {
+    return spreadBits2(x) | (spreadBits2(y) << 1);
+}
+
+uint64_t mortonEncode3DMagic(uint32_t x, uint32_t y, uint32_t z) {
+    return spreadBits3(x) | (spreadBits3(y) << 1) | (spreadBits3(z) << 2);
+}
+
+uint64_t mortonEncode2D(uint32_t x, uint32_t y) {
+    return encode2D_impl(x, y);
+}
+
+uint64_t mortonEncode3D(uint32_t x, uint32_t y, uint32_t z) {
+    return encode3D_impl(x, y, z);
+}
+
+uint64_t depositBits(uint64_t value, uint64_t mask) {
+#ifdef FLOOD_BMI2_DISPATCH
+    if (cpuHasBMI2()) {
+        return depositBitsPdep(value, mask);
+    }
+#endif
+    uint64_t result = 0;
+    while (mask) {
+        uint64_t lowest = mask & (~mask + 1);
+        if (value & 1) {
+            result |= lowest;
+        }
+        value >>= 1;
+        mask &= mask - 1;
+    }
+    return result;
+}
+
+Key128 hilbertEncode(const uint32_t* cells, size_t dims, uint32_t bits) {
+    if (dims == 0 || bits == 0) {
+        return 0;
+    }
+    
+    const uint32_t coord_mask = (bits >= 32) ? ~0u : ((1u << bits) - 1);
+    if (dims == 1) {
+        return cells[0] & coord_mask;
+    }
+    
+    // Work on a copy; stay on the stack for the usual handful of dimensions
+    uint32_t X_small[16];
+    std::vector<uint32_t> X_large;
+    uint32_t* X = X_small;
+    if (dims > 16) {
+        X_large.resize(dims);
+        X = X_large.data();
+    }
+    for (size_t i = 0; i < dims; ++i) {
+        X[i] = cells[i] & coord_mask;
+    }
+    
+    // Axes to transposed Hilbert index: undo excess work per level
+    const uint32_t M = 1u << (bits - 1);
+    for (uint32_t Q = M; Q > 1; Q >>= 1) {
+        uint32_t P = Q - 1;
+        for (size_t i = 0; i < dims; ++i) {
+            if (X[i] & Q) {
+                X[0] ^= P;  // Invert
+            } else {
+                uint32_t t = (X[0] ^ X[i]) & P;  // Exchange
+                X[0] ^= t;
+                X[i] ^= t;
+            }
+        }
+    }
+    
+    // Gray encode
+    for (size_t i = 1; i < dims; ++i) {
+        X[i] ^= X[i - 1];
+    }
+    uint32_t t = 0;
+    for (uint32_t Q = M; Q > 1; Q >>= 1) {
+        if (X[dims - 1] & Q) {
+            t ^= Q - 1;
+        }
+    }
+    for (size_t i = 0; i < dims; ++i) {
+        X[i] ^= t;
+    }
+    
+    // Interleave the transpose level by level; X[0] holds the most
+    // significant bit of each level's group
+    Key128 key = 0;
+    for (uint32_t level = bits; level-- > 0;) {
+        for (size_t i = 0; i < dims; ++i) {
+            key = (key << 1) | ((X[i] >> level) & 1);
+        }
+    }
+    return key;
+}
+
+namespace {
+
+template <typename Key>
+std::vector<size_t> radixSortImpl(std::vector<Key>& keys) {
+    constexpr size_t PASSES = sizeof(Key);
+    const size_t n = keys.size();
+    std::vector<size_t> perm(n);
+    for (size_t i = 0; i < n; ++i) {
+        perm[i] = i;
+    }
+    if (n < 2) {
+        return perm;
+    }
+    
+    // Bytes above the highest set bit of any key are all zero: skip them
+    Key any_bits = 0;
+    for (const Key& key : keys) {
+        any_bits |= key;
+    }
+    size_t passes = 0;
+    while (passes < PASSES && (any_bits >> (passes * 8)) != 0) {
+        ++passes;
+    }
+    
+    // One histogram per byte, computed in a single read of the keys
+    std::vector<std::array<size_t, 256>> histograms(passes);
+    for (auto& h : histograms) {
+        h.fill(0);
+    }
+    for (const Key& key : keys) {
+        for (size_t pass = 0; pass < passes; ++pass) {
+            ++histograms[pass][static_cast<uint8_t>(key >> (pass * 8))];
+        }
+    }
+    
+    std::vector<Key> keys_tmp(n);
+    std::vector<size_t> perm_tmp(n);
+    
+    for (size_t pass = 0; pass < passes; ++pass) {
+        auto& hist = histograms[pass];
+        
+        // Skip passes where every key has the same digit
+        uint8_t digit = static_cast<uint8_t>(keys[0] >> (pass * 8));
+        if (hist[digit] == n) {
+            continue;
+        }
+        
+        // Exclusive prefix sum gives the output offset of each bucket
+        size_t offset = 0;
+        for (auto& count : hist) {
+            size_t c = count;
+            count = offset;
+            offset += c;
+        }
+        
+        for (size_t i = 0; i < n; ++i) {
+            size_t pos = hist[static_cast<uint8_t>(keys[i] >> (pass * 8))]++;
+            keys_tmp[pos] = keys[i];
+            perm_tmp[pos] = perm[i];
+        }
+        
+        keys.swap(keys_tmp);
+        perm.swap(perm_tmp);
+    }
+    
+    return perm;
+}
+
+} // namespace
+
+std::vector<size_t> radixSortKeys(std::vector<uint64_t>& keys) {
+    return radixSortImpl(keys);
+}
+
+std::vector<size_t> radixSortKeys(std::vector<Key128>& keys) {
+    return radixSortImpl(keys);
+}
+
+} // namespace sfc
+} // namespace flood
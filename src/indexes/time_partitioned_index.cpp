@@ -0,0 +1,353 @@
+#include "indexes/time_partitioned_index.h"
+#include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+
+namespace flood {
+
+namespace {
+
+// Bucket numbers are clamped here, so unbounded query times stay finite
+constexpr double MAX_BUCKET = 4611686018427387904.0;  // 2^62
+
+} // namespace
+
+TimePartitionedIndex::TimePartitionedIndex(IndexFactory factory, double bucket_width,
+                                           size_t time_dim, size_t num_threads)
+    : factory_(std::move(factory)), bucket_width_(bucket_width), time_dim_(time_dim),
+      dimensions_(0), retention_(0.0), newest_time_(std::numeric_limits<double>::lowest()),
+      last_buckets_queried_(0), pool_(std::max<size_t>(1, num_threads)) {
+    if (!factory_) {
+        throw std::invalid_argument("TimePartitionedIndex needs an index factory");
+    }
+    name_ = factory_()->getName() + " by time";
+}
+
+void TimePartitionedIndex::build(const std::vector<DataPoint>& data) {
+    Timer timer;
+    
+    // In-flight builds of the old buckets finish on the pool and are discarded
+    buckets_.clear();
+    data_size_ = 0;
+    newest_time_ = std::numeric_limits<double>::lowest();
+    dimensions_ = data.empty() ? 0 : data[0].getDimensions();
+    if (!data.empty() && time_dim_ >= dimensions_) {
+        throw std::invalid_argument("Time dimension " + std::to_string(time_dim_) +
+                                    " is out of range for " + std::to_string(dimensions_) + "-d data");
+    }
+    
+    if (bucket_width_ <= 0.0 && !data.empty()) {
+        double lo = std::numeric_limits<double>::max();
+        double hi = std::numeric_limits<double>::lowest();
+        for (const auto& point : data) {
+            lo = std::min(lo, point.getCoordinate(time_dim_));
+            hi = std::max(hi, point.getCoordinate(time_dim_));
+        }
+        bucket_width_ = hi > lo ? (hi - lo) / DEFAULT_BUCKETS : 1.0;
+    }
+    
+    for (const auto& point : data) {
+        double time = point.getCoordinate(time_dim_);
+        newest_time_ = std::max(newest_time_, time);
+        addPoint(buckets_[bucketOf(time)], point);
+    }
+    data_size_ = data.size();
+    
+    // Every bucket is built now; indexes are created up front so the
+    // factory is only called from this thread
+    std::vector<Bucket*> targets;
+    std::vector<std::shared_ptr<BaseIndex>> indexes;
+    for (auto& entry : buckets_) {
+        targets.push_back(&entry.second);
+        indexes.push_back(makeIndex());
+    }
+    pool_.parallelFor(targets.size(), [&](size_t b) {
+        indexes[b]->build(targets[b]->open);
+        std::vector<DataPoint>().swap(targets[b]->open);
+    });
+    for (size_t b = 0; b < targets.size(); ++b) {
+        targets[b]->index = indexes[b];
+        targets[b]->is_sealed = true;
+    }
+    
+    build_time_ms_ = timer.elapsed();
+    
+    std::cout << getName() << " index built: " << data.size() << " points, "
+              << buckets_.size() << " buckets of width " << bucket_width_ << ", "
+              << build_time_ms_ << " ms" << std::endl;
+}
+
+void TimePartitionedIndex::insert(const std::vector<DataPoint>& points) {
+    if (points.empty()) {
+        return;
+    }
+    if (bucket_width_ <= 0.0) {
+        throw std::logic_error("TimePartitionedIndex needs a bucket width (or a build()) before insert()");
+    }
+    // Checked up front, so a bad point leaves the index unchanged
+    const size_t dims = dimensions_ == 0 ? points[0].getDimensions() : dimensions_;
+    for (const auto& point : points) {
+        if (point.getDimensions() < dims || time_dim_ >= point.getDimensions()) {
+            throw std::invalid_argument("Cannot insert a " + std::to_string(point.getDimensions()) +
+                                        "-d point into a " + std::to_string(dims) +
+                                        "-d index with time dimension " + std::to_string(time_dim_));
+        }
+    }
+    dimensions_ = dims;
+    collectBuilds(false);
+    
+    for (const auto& point : points) {
+        double time = point.getCoordinate(time_dim_);
+        if (retention_ > 0.0 && time < newest_time_ - retention_) {
+            continue;  // Already expired
+        }
+        newest_time_ = std::max(newest_time_, time);
+        addPoint(buckets_[bucketOf(time)], point);
+        ++data_size_;
+    }
+    
+    // Everything behind the newest bucket is complete; sealed buckets
+    // with many late points are rebuilt with them
+    if (!buckets_.empty()) {
+        auto newest = std::prev(buckets_.end());
+        for (auto it = buckets_.begin(); it != buckets_.end(); ++it) {
+            Bucket& bucket = it->second;
+            if (!bucket.is_sealed && it != newest) {
+                seal(bucket);
+            } else if (bucket.late.size() > std::max(MIN_LATE_POINTS, bucket.size / 4)) {
+                reseal(bucket);
+            }
+        }
+    }
+    
+    if (retention_ > 0.0) {
+        expireBefore(newest_time_ - retention_);
+    }
+}
+
+void TimePartitionedIndex::flush() {
+    for (auto& entry : buckets_) {
+        if (!entry.second.is_sealed) {
+            seal(entry.second);
+        }
+    }
+}
+
+void TimePartitionedIndex::waitForBuilds() {
+    collectBuilds(true);
+}
+
+size_t TimePartitionedIndex::expireBefore(double time) {
+    size_t dropped = 0;
+    while (!buckets_.empty()) {
+        auto oldest = buckets_.begin();
+        if ((oldest->first + 1) * bucket_width_ > time) {
+            break;
+        }
+        data_size_ -= oldest->second.size;
+        buckets_.erase(oldest);
+        ++dropped;
+    }
+    return dropped;
+}
+
+void TimePartitionedIndex::setRetention(double window) {
+    retention_ = window;
+    if (retention_ > 0.0 && !buckets_.empty()) {
+        expireBefore(newest_time_ - retention_);
+    }
+}
+
+void TimePartitionedIndex::dropCaches() {
+    for (auto& entry : buckets_) {
+        if (entry.second.index) {
+            entry.second.index->dropCaches();
+        }
+    }
+}
+
+size_t TimePartitionedIndex::getPendingBuilds() const {
+    size_t pending = 0;
+    for (const auto& entry : buckets_) {
+        if (entry.second.building.valid()) {
+            ++pending;
+        }
+    }
+    return pending;
+}
+
+std::vector<DataPoint> TimePartitionedIndex::query(const QueryRange& range) {
+    collectBuilds(false);
+    
+    std::vector<DataPoint> results;
+    last_buckets_queried_ = 0;
+    
+    // Prune buckets by the query's time bound
+    auto first = buckets_.begin();
+    auto last = buckets_.end();
+    if (range.getDimensions() > time_dim_) {
+        if (range.getMinBound(time_dim_) > range.getMaxBound(time_dim_)) {
+            return results;
+        }
+        first = buckets_.lower_bound(bucketOf(range.getMinBound(time_dim_)));
+        last = buckets_.upper_bound(bucketOf(range.getMaxBound(time_dim_)));
+    }
+    
+    for (auto it = first; it != last; ++it) {
+        Bucket& bucket = it->second;
+        if (bucket.size == 0 || !intersects(bucket, range)) {
+            continue;
+        }
+        ++last_buckets_queried_;
+        
+        if (bucket.index) {
+            std::vector<DataPoint> part = bucket.index->query(range);
+            results.insert(results.end(), std::make_move_iterator(part.begin()),
+                           std::make_move_iterator(part.end()));
+            scanned_points_ += bucket.index->getScannedPoints();
+            scanned_runs_ += bucket.index->getScannedRuns();
+            bucket.index->resetScanStats();
+        } else if (bucket.sealed) {
+            scanPoints(*bucket.sealed, range, results);
+        }
+        scanPoints(bucket.open, range, results);
+        scanPoints(bucket.late, range, results);
+    }
+    
+    return results;
+}
+
+double TimePartitionedIndex::getIndexSize() const {
+    size_t point_bytes = dimensions_ * sizeof(double) + sizeof(uint64_t);
+    double total = 0.0;
+    for (const auto& entry : buckets_) {
+        const Bucket& bucket = entry.second;
+        if (bucket.index) {
+            total += bucket.index->getIndexSize();
+        }
+        size_t unindexed = bucket.open.size() + bucket.late.size() +
+                           (bucket.index || !bucket.sealed ? 0 : bucket.sealed->size());
+        total += (unindexed * point_bytes + 2 * dimensions_ * sizeof(double)) / (1024.0 * 1024.0);
+    }
+    
+    return total;
+}
+
+int64_t TimePartitionedIndex::bucketOf(double time) const {
+    double bucket = std::floor(time / bucket_width_);
+    bucket = std::min(std::max(bucket, -MAX_BUCKET), MAX_BUCKET);
+    return static_cast<int64_t>(bucket);
+}
+
+std::shared_ptr<BaseIndex> TimePartitionedIndex::makeIndex() const {
+    std::shared_ptr<BaseIndex> index = factory_();
+    index->setCoordinateStorage(coordinate_encoding_, exact_recheck_);
+    return index;
+}
+
+void TimePartitionedIndex::addPoint(Bucket& bucket, const DataPoint& point) {
+    if (bucket.size == 0) {
+        bucket.min_bounds.assign(dimensions_, std::numeric_limits<double>::max());
+        bucket.max_bounds.assign(dimensions_, std::numeric_limits<double>::lowest());
+    }
+    for (size_t d = 0; d < dimensions_; ++d) {
+        double coord = point.getCoordinate(d);
+        bucket.min_bounds[d] = std::min(bucket.min_bounds[d], coord);
+        bucket.max_bounds[d] = std::max(bucket.max_bounds[d], coord);
+    }
+    ++bucket.size;
+    
+    if (bucket.is_sealed) {
+        bucket.late.push_back(point);
+    } else {
+        bucket.open.push_back(point);
+    }
+}
+
+void TimePartitionedIndex::seal(Bucket& bucket) {
+    bucket.is_sealed = true;
+    if (bucket.open.empty()) {
+        return;
+    }
+    
+    // The worker only sees the snapshot and its own index, so queries keep
+    // scanning the snapshot while the build runs
+    auto points = std::make_shared<const std::vector<DataPoint>>(std::move(bucket.open));
+    std::vector<DataPoint>().swap(bucket.open);
+    std::shared_ptr<BaseIndex> index = makeIndex();
+    bucket.sealed = points;
+    bucket.building = pool_.submit([index, points]() {
+        index->build(*points);
+        return index;
+    });
+}
+
+void TimePartitionedIndex::reseal(Bucket& bucket) {
+    if (bucket.building.valid()) {
+        return;  // Retried once the running build is installed
+    }
+    
+    std::vector<DataPoint> points;
+    if (bucket.index) {
+        points = bucket.index->query(QueryRange(bucket.min_bounds, bucket.max_bounds));
+    } else if (bucket.sealed) {
+        points = *bucket.sealed;
+    }
+    points.insert(points.end(), std::make_move_iterator(bucket.late.begin()),
+                  std::make_move_iterator(bucket.late.end()));
+    std::vector<DataPoint>().swap(bucket.late);
+    
+    // Queries scan the merged snapshot until the new index is installed
+    auto snapshot = std::make_shared<const std::vector<DataPoint>>(std::move(points));
+    std::shared_ptr<BaseIndex> index = makeIndex();
+    bucket.index.reset();
+    bucket.sealed = snapshot;
+    bucket.building = pool_.submit([index, snapshot]() {
+        index->build(*snapshot);
+        return index;
+    });
+}
+
+void TimePartitionedIndex::collectBuilds(bool wait) {
+    for (auto& entry : buckets_) {
+        Bucket& bucket = entry.second;
+        if (!bucket.building.valid()) {
+            continue;
+        }
+        if (!wait && bucket.building.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+            continue;
+        }
+        bucket.index = bucket.building.get();
+        bucket.sealed.reset();
+    }
+}
+
+bool TimePartitionedIndex::intersects(const Bucket& bucket, const QueryRange& range) const {
+    size_t dims = std::min(dimensions_, range.getDimensions());
+    for (size_t d = 0; d < dims; ++d) {
+        if (range.getMaxBound(d) < bucket.min_bounds[d] || range.getMinBound(d) > bucket.max_bounds[d]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void TimePartitionedIndex::scanPoints(const std::vector<DataPoint>& points, const QueryRange& range,
+                                      std::vector<DataPoint>& results) {
+    if (points.empty()) {
+        return;
+    }
+    ++scanned_runs_;
+    scanned_points_ += points.size();
+    for (const auto& point : points) {
+        if (range.contains(point)) {
+            results.push_back(point);
+        }
+    }
+}
+
+} // namespace flood
@@ -0,0 +1,426 @@
+#include "indexes/tsunami_index.h"
+#include <iostream>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+namespace flood {
+
+namespace {
+
+// Query-density histogram resolution used to choose grid tree splits
+constexpr size_t SKEW_BINS = 16;
+
+// |Pearson correlation| needed before a dimension pair gets a mapping
+constexpr double MAPPING_CORRELATION = 0.9;
+
+// Points sampled to estimate correlations in a region
+constexpr size_t MAPPING_SAMPLE_SIZE = 10000;
+
+} // namespace
+
+TsunamiIndex::TsunamiIndex(size_t min_region_size, size_t max_depth, double skew_threshold)
+    : min_region_size_(std::max<size_t>(1, min_region_size)), max_depth_(max_depth),
+      skew_threshold_(skew_threshold), dimensions_(0) {}
+
+void TsunamiIndex::train(const std::vector<QueryRange>& training_queries) {
+    training_queries_ = training_queries;
+}
+
+void TsunamiIndex::build(const std::vector<DataPoint>& data) {
+    Timer timer;
+    
+    nodes_.clear();
+    regions_.clear();
+    
+    if (data.empty()) {
+        data_size_ = 0;
+        build_time_ms_ = timer.elapsed();
+        return;
+    }
+    
+    dimensions_ = data[0].getDimensions();
+    
+    std::vector<size_t> ids(data.size());
+    std::iota(ids.begin(), ids.end(), 0);
+    std::vector<size_t> query_ids(training_queries_.size());
+    std::iota(query_ids.begin(), query_ids.end(), 0);
+    
+    nodes_.emplace_back();
+    buildNode(data, ids, query_ids, 0, 0);
+    
+    data_size_ = data.size();
+    build_time_ms_ = timer.elapsed();
+    
+    std::cout << "Tsunami index built: " << data.size() << " points, "
+              << regions_.size() << " regions, " << getNumMappings() << " mappings, "
+              << build_time_ms_ << " ms" << std::endl;
+}
+
+std::vector<DataPoint> TsunamiIndex::query(const QueryRange& range) {
+    std::vector<DataPoint> results;
+    
+    if (nodes_.empty()) {
+        return results;
+    }
+    
+    const size_t query_dims = range.getDimensions();
+    std::vector<double> q_min, q_max;
+    std::vector<size_t> stack = {0};
+    
+    while (!stack.empty()) {
+        const GridNode& node = nodes_[stack.back()];
+        stack.pop_back();
+        
+        if (!node.is_leaf) {
+            // Children overlapping the query along the split dimension
+            size_t first = 0;
+            size_t last = node.splits.size();
+            if (node.split_dim < query_dims) {
+                const auto& s = node.splits;
+                first = std::upper_bound(s.begin(), s.end(), range.getMinBound(node.split_dim)) - s.begin();
+                last = std::upper_bound(s.begin(), s.end(), range.getMaxBound(node.split_dim)) - s.begin();
+            }
+            for (size_t c = first; c <= last; ++c) {
+                stack.push_back(node.first_child + c);
+            }
+            continue;
+        }
+        
+        Region& region = regions_[node.region];
+        if (region.size == 0 || !applyMappings(region, range, q_min, q_max)) {
+            continue;
+        }
+        
+        auto partial = region.index->query(QueryRange(q_min, q_max));
+        results.insert(results.end(), std::make_move_iterator(partial.begin()),
+                       std::make_move_iterator(partial.end()));
+    }
+    
+    return results;
+}
+
+size_t TsunamiIndex::getScannedPoints() const {
+    size_t total = scanned_points_;
+    for (const auto& region : regions_) {
+        if (region.index) {
+            total += region.index->getScannedPoints();
+        }
+    }
+    return total;
+}
+
+size_t TsunamiIndex::getScannedRuns() const {
+    size_t total = scanned_runs_;
+    for (const auto& region : regions_) {
+        if (region.index) {
+            total += region.index->getScannedRuns();
+        }
+    }
+    return total;
+}
+
+void TsunamiIndex::resetScanStats() {
+    BaseIndex::resetScanStats();
+    for (auto& region : regions_) {
+        if (region.index) {
+            region.index->resetScanStats();
+        }
+    }
+}
+
+double TsunamiIndex::getIndexSize() const {
+    // Per-region Flood layouts + grid tree + mappings
+    double total = 0.0;
+    size_t meta_bytes = nodes_.size() * sizeof(GridNode);
+    for (const auto& node : nodes_) {
+        meta_bytes += node.splits.size() * sizeof(double);
+    }
+    for (const auto& region : regions_) {
+        if (region.index) {
+            total += region.index->getIndexSize();
+        }
+        meta_bytes += sizeof(Region) + 2 * dimensions_ * sizeof(double)
+                    + region.mappings.size() * sizeof(FunctionalMapping);
+    }
+    
+    return total + meta_bytes / (1024.0 * 1024.0);
+}
+
+size_t TsunamiIndex::getNumMappings() const {
+    size_t total = 0;
+    for (const auto& region : regions_) {
+        total += region.mappings.size();
+    }
+    return total;
+}
+
+void TsunamiIndex::buildNode(const std::vector<DataPoint>& data, std::vector<size_t>& ids,
+                             const std::vector<size_t>& query_ids, size_t node_idx, size_t depth) {
+    size_t split_dim = 0;
+    std::vector<double> splits;
+    
+    bool split = depth < max_depth_ && ids.size() >= 2 * min_region_size_ && !query_ids.empty()
+                 && chooseSplit(data, ids, query_ids, split_dim, splits);
+    
+    if (!split) {
+        nodes_[node_idx].region = regions_.size();
+        regions_.emplace_back();
+        buildRegion(data, ids, regions_.back());
+        return;
+    }
+    
+    // Route points and queries to the children
+    const size_t fanout = splits.size() + 1;
+    std::vector<std::vector<size_t>> child_ids(fanout);
+    for (size_t id : ids) {
+        double v = data[id].getCoordinate(split_dim);
+        child_ids[std::upper_bound(splits.begin(), splits.end(), v) - splits.begin()].push_back(id);
+    }
+    std::vector<size_t>().swap(ids);
+    
+    const size_t first = nodes_.size();
+    nodes_[node_idx].is_leaf = false;
+    nodes_[node_idx].split_dim = split_dim;
+    nodes_[node_idx].first_child = first;
+    nodes_[node_idx].splits = splits;
+    nodes_.resize(first + fanout);
+    
+    for (size_t c = 0; c < fanout; ++c) {
+        // Child c holds [splits[c - 1], splits[c])
+        double lower = (c == 0) ? -std::numeric_limits<double>::infinity() : splits[c - 1];
+        double upper = (c == fanout - 1) ? std::numeric_limits<double>::infinity() : splits[c];
+        
+        std::vector<size_t> child_queries;
+        for (size_t q : query_ids) {
+            const QueryRange& range = training_queries_[q];
+            if (split_dim >= range.getDimensions() ||
+                (range.getMaxBound(split_dim) >= lower && range.getMinBound(split_dim) < upper)) {
+                child_queries.push_back(q);
+            }
+        }
+        
+        buildNode(data, child_ids[c], child_queries, first + c, depth + 1);
+    }
+}
+
+bool TsunamiIndex::chooseSplit(const std::vector<DataPoint>& data, const std::vector<size_t>& ids,
+                               const std::vector<size_t>& query_ids,
+                               size_t& split_dim, std::vector<double>& splits) const {
+    double best_skew = -1.0;
+    std::vector<double> best_counts;
+    double best_lo = 0.0, best_width = 0.0;
+    
+    for (size_t dim = 0; dim < dimensions_; ++dim) {
+        double lo = std::numeric_limits<double>::max();
+        double hi = std::numeric_limits<double>::lowest();
+        for (size_t id : ids) {
+            double v = data[id].getCoordinate(dim);
+            lo = std::min(lo, v);
+            hi = std::max(hi, v);
+        }
+        if (!(hi > lo)) {
+            continue;
+        }
+        
+        // How many queries touch each equal-width slice of the node
+        double width = (hi - lo) / SKEW_BINS;
+        std::vector<double> counts(SKEW_BINS, 0.0);
+        for (size_t q : query_ids) {
+            const QueryRange& range = training_queries_[q];
+            size_t b0 = 0, b1 = SKEW_BINS - 1;
+            if (dim < range.getDimensions()) {
+                double q_lo = std::max(range.getMinBound(dim), lo);
+                double q_hi = std::min(range.getMaxBound(dim), hi);
+                if (q_lo > q_hi) {
+                    continue;
+                }
+                b0 = std::min(SKEW_BINS - 1, static_cast<size_t>((q_lo - lo) / width));
+                b1 = std::min(SKEW_BINS - 1, static_cast<size_t>((q_hi - lo) / width));
+            }
+            for (size_t b = b0; b <= b1; ++b) {
+                counts[b] += 1.0;
+            }
+        }
+        
+        // Skew: total variation distance from a uniform spread (0 = uniform)
+        double total = std::accumulate(counts.begin(), counts.end(), 0.0);
+        if (total == 0.0) {
+            continue;
+        }
+        double skew = 0.0;
+        for (double c : counts) {
+            skew += std::abs(c / total - 1.0 / SKEW_BINS);
+        }
+        skew *= 0.5;
+        
+        if (skew > best_skew) {
+            best_skew = skew;
+            split_dim = dim;
+            best_counts = counts;
+            best_lo = lo;
+            best_width = width;
+        }
+    }
+    
+    if (best_skew < skew_threshold_) {
+        return false;
+    }
+    
+    // Cut wherever query density has changed by 2x since the last cut
+    splits.clear();
+    double run_density = best_counts[0];
+    for (size_t b = 1; b < SKEW_BINS; ++b) {
+        double ratio = (best_counts[b] + 1.0) / (run_density + 1.0);
+        if (ratio >= 2.0 || ratio <= 0.5) {
+            splits.push_back(best_lo + b * best_width);
+            run_density = best_counts[b];
+        }
+    }
+    
+    return !splits.empty();
+}
+
+void TsunamiIndex::buildRegion(const std::vector<DataPoint>& data, const std::vector<size_t>& ids,
+                               Region& region) const {
+    region.size = ids.size();
+    region.min_bounds.assign(dimensions_, std::numeric_limits<double>::max());
+    region.max_bounds.assign(dimensions_, std::numeric_limits<double>::lowest());
+    region.index = std::make_unique<FloodIndex>();
+    region.index->setVerbose(false);
+    region.index->setCoordinateStorage(coordinate_encoding_, exact_recheck_);
+    
+    if (ids.empty()) {
+        return;
+    }
+    
+    std::vector<DataPoint> region_data;
+    region_data.reserve(ids.size());
+    for (size_t id : ids) {
+        for (size_t i = 0; i < dimensions_; ++i) {
+            double coord = data[id].getCoordinate(i);
+            region.min_bounds[i] = std::min(region.min_bounds[i], coord);
+            region.max_bounds[i] = std::max(region.max_bounds[i], coord);
+        }
+        region_data.push_back(data[id]);
+    }
+    
+    fitMappings(data, ids, region);
+    region.index->build(region_data);
+}
+
+void TsunamiIndex::fitMappings(const std::vector<DataPoint>& data, const std::vector<size_t>& ids,
+                               Region& region) const {
+    const size_t d = dimensions_;
+    if (d < 2 || ids.size() < 2) {
+        return;
+    }
+    
+    // Means and covariances over a strided sample
+    const size_t stride = std::max<size_t>(1, ids.size() / MAPPING_SAMPLE_SIZE);
+    std::vector<double> mean(d, 0.0);
+    std::vector<double> cov(d * d, 0.0);
+    size_t count = 0;
+    for (size_t pos = 0; pos < ids.size(); pos += stride, ++count) {
+        for (size_t i = 0; i < d; ++i) {
+            mean[i] += data[ids[pos]].getCoordinate(i);
+        }
+    }
+    for (size_t i = 0; i < d; ++i) {
+        mean[i] /= count;
+    }
+    for (size_t pos = 0; pos < ids.size(); pos += stride) {
+        const DataPoint& p = data[ids[pos]];
+        for (size_t i = 0; i < d; ++i) {
+            double di = p.getCoordinate(i) - mean[i];
+            for (size_t j = i; j < d; ++j) {
+                cov[i * d + j] += di * (p.getCoordinate(j) - mean[j]);
+            }
+        }
+    }
+    
+    // Each dimension is mapped from the dimension it correlates best with
+    for (size_t y = 0; y < d; ++y) {
+        size_t best_x = y;
+        double best_corr = 0.0;
+        for (size_t x = 0; x < d; ++x) {
+            double var_x = cov[x * d + x];
+            double var_y = cov[y * d + y];
+            if (x == y || var_x <= 0.0 || var_y <= 0.0) {
+                continue;
+            }
+            double corr = std::abs(cov[std::min(x, y) * d + std::max(x, y)]) / std::sqrt(var_x * var_y);
+            if (corr > best_corr) {
+                best_corr = corr;
+                best_x = x;
+            }
+        }
+        if (best_x == y || best_corr < MAPPING_CORRELATION) {
+            continue;
+        }
+        
+        FunctionalMapping mapping;
+        mapping.dependent_dim = y;
+        mapping.source_dim = best_x;
+        mapping.slope = cov[std::min(best_x, y) * d + std::max(best_x, y)] / cov[best_x * d + best_x];
+        mapping.intercept = mean[y] - mapping.slope * mean[best_x];
+        if (!std::isfinite(mapping.slope) || !std::isfinite(mapping.intercept) ||
+            std::abs(mapping.slope) < 1e-12) {
+            continue;
+        }
+        
+        // Residual bounds must hold for every point, not just the sample
+        mapping.min_residual = std::numeric_limits<double>::max();
+        mapping.max_residual = std::numeric_limits<double>::lowest();
+        for (size_t id : ids) {
+            double residual = data[id].getCoordinate(y)
+                            - (mapping.intercept + mapping.slope * data[id].getCoordinate(best_x));
+            mapping.min_residual = std::min(mapping.min_residual, residual);
+            mapping.max_residual = std::max(mapping.max_residual, residual);
+        }
+        
+        region.mappings.push_back(mapping);
+    }
+}
+
+bool TsunamiIndex::applyMappings(const Region& region, const QueryRange& range,
+                                 std::vector<double>& q_min, std::vector<double>& q_max) const {
+    const size_t query_dims = range.getDimensions();
+    q_min.resize(query_dims);
+    q_max.resize(query_dims);
+    for (size_t i = 0; i < query_dims; ++i) {
+        q_min[i] = range.getMinBound(i);
+        q_max[i] = range.getMaxBound(i);
+        if (i < dimensions_ && (q_max[i] < region.min_bounds[i] || q_min[i] > region.max_bounds[i])) {
+            return false;  // Region lies outside the query
+        }
+    }
+    
+    for (const auto& m : region.mappings) {
+        if (m.dependent_dim >= query_dims || m.source_dim >= query_dims) {
+            continue;
+        }
+        
+        // y in [y_lo, y_hi] implies slope * x in [y_lo - a - r_max, y_hi - a - r_min]
+        double lo = (range.getMinBound(m.dependent_dim) - m.intercept - m.max_residual) / m.slope;
+        double hi = (range.getMaxBound(m.dependent_dim) - m.intercept - m.min_residual) / m.slope;
+        if (m.slope < 0.0) {
+            std::swap(lo, hi);
+        }
+        
+        // Pad for rounding so no qualifying point is cut off
+        lo -= 1e-9 * (1.0 + std::abs(lo));
+        hi += 1e-9 * (1.0 + std::abs(hi));
+        
+        q_min[m.source_dim] = std::max(q_min[m.source_dim], lo);
+        q_max[m.source_dim] = std::min(q_max[m.source_dim], hi);
+        if (q_min[m.source_dim] > q_max[m.source_dim]) {
+            return false;
+        }
+    }
+    
+    return true;
+}
+
+} // namespace flood
@@ -0,0 +1,186 @@
+#include "utils/buffer_pool.h"
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+#include <climits>
+#include <fcntl.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+namespace flood {
+
+namespace {
+
+constexpr size_t FRAME_ALIGNMENT = 4096;
+
+} // namespace
+
+BufferPool::BufferPool(int fd, uint64_t base_offset, size_t block_size, size_t num_frames)
+    : fd_(fd), base_offset_(base_offset), block_size_(block_size),
+      memory_(nullptr), frames_(std::max<size_t>(1, num_frames)), hand_(0) {
+    void* memory = nullptr;
+    size_t bytes = (frames_.size() * block_size_ + FRAME_ALIGNMENT - 1) / FRAME_ALIGNMENT * FRAME_ALIGNMENT;
+    if (::posix_memalign(&memory, FRAME_ALIGNMENT, bytes) != 0) {
+        throw std::bad_alloc();
+    }
+    memory_ = static_cast<char*>(memory);
+    block_to_frame_.reserve(frames_.size());
+}
+
+BufferPool::~BufferPool() {
+    std::free(memory_);
+}
+
+void BufferPool::pinRange(uint64_t first, size_t count, std::vector<const char*>& frames) {
+    frames.assign(count, nullptr);
+    
+    // Pin resident blocks first so loading the missing ones cannot evict them
+    std::vector<uint64_t> missing;
+    for (size_t i = 0; i < count; ++i) {
+        auto it = block_to_frame_.find(first + i);
+        if (it != block_to_frame_.end()) {
+            Frame& frame = frames_[it->second];
+            ++frame.pins;
+            frame.referenced = true;
+            frames[i] = frameData(it->second);
+            ++stats_.hits;
+        } else {
+            missing.push_back(first + i);
+        }
+    }
+    
+    // Coalesce consecutive missing blocks into one read each
+    size_t begin = 0;
+    while (begin < missing.size()) {
+        size_t end = begin + 1;
+        while (end < missing.size() && missing[end] == missing[end - 1] + 1) {
+            ++end;
+        }
+        
+        std::vector<size_t> run_frames;
+        try {
+            for (size_t i = begin; i < end; ++i) {
+                size_t frame = evictFrame();
+                frames_[frame].pins = 1;  // Reserve until the read completes
+                run_frames.push_back(frame);
+            }
+            readRun(missing[begin], run_frames);
+        } catch (...) {
+            for (size_t frame : run_frames) {
+                frames_[frame].pins = 0;
+            }
+            // Release the pins taken on this range so far
+            for (size_t i = 0; i < count; ++i) {
+                if (frames[i] != nullptr) {
+                    --frames_[(frames[i] - memory_) / block_size_].pins;
+                }
+            }
+            throw;
+        }
+        
+        for (size_t i = begin; i < end; ++i) {
+            size_t frame = run_frames[i - begin];
+            frames_[frame].block = missing[i];
+            frames_[frame].referenced = true;
+            block_to_frame_[missing[i]] = frame;
+            frames[missing[i] - first] = frameData(frame);
+        }
+        stats_.misses += end - begin;
+        begin = end;
+    }
+}
+
+void BufferPool::unpinRange(uint64_t first, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        auto it = block_to_frame_.find(first + i);
+        if (it != block_to_frame_.end() && frames_[it->second].pins > 0) {
+            --frames_[it->second].pins;
+        }
+    }
+}
+
+void BufferPool::prefetch(uint64_t first, size_t count) const {
+    if (count > 0) {
+        ::posix_fadvise(fd_, static_cast<off_t>(base_offset_ + first * block_size_),
+                        static_cast<off_t>(count * block_size_), POSIX_FADV_WILLNEED);
+    }
+}
+
+void BufferPool::clear() {
+    for (size_t i = 0; i < frames_.size(); ++i) {
+        Frame& frame = frames_[i];
+        if (frame.pins == 0 && frame.block != NO_BLOCK) {
+            block_to_frame_.erase(frame.block);
+            frame.block = NO_BLOCK;
+            frame.referenced = false;
+        }
+    }
+    ::posix_fadvise(fd_, 0, 0, POSIX_FADV_DONTNEED);
+}
+
+size_t BufferPool::evictFrame() {
+    // Two sweeps clear every reference bit, so a third finding nothing
+    // means every frame is pinned
+    for (size_t step = 0; step < 3 * frames_.size(); ++step) {
+        size_t candidate = hand_;
+        hand_ = (hand_ + 1) % frames_.size();
+        
+        Frame& frame = frames_[candidate];
+        if (frame.pins > 0) {
+            continue;
+        }
+        if (frame.referenced) {
+            frame.referenced = false;
+            continue;
+        }
+        if (frame.block != NO_BLOCK) {
+            block_to_frame_.erase(frame.block);
+            frame.block = NO_BLOCK;
+            ++stats_.evictions;
+        }
+        return candidate;
+    }
+    throw std::logic_error("BufferPool: all " + std::to_string(frames_.size()) + " frames are pinned");
+}
+
+void BufferPool::readRun(uint64_t first, const std::vector<size_t>& frames) {
+    std::vector<iovec> iov(frames.size());
+    for (size_t i = 0; i < frames.size(); ++i) {
+        iov[i].iov_base = frameData(frames[i]);
+        iov[i].iov_len = block_size_;
+    }
+    
+    // preadv may return short counts (and takes at most IOV_MAX vectors),
+    // so advance through the vector until every frame is filled
+    off_t offset = static_cast<off_t>(base_offset_ + first * block_size_);
+    size_t next = 0;
+    while (next < iov.size()) {
+        int batch = static_cast<int>(std::min<size_t>(iov.size() - next, IOV_MAX));
+        ssize_t got = ::preadv(fd_, &iov[next], batch, offset);
+        ++stats_.read_calls;
+        if (got < 0 && errno == EINTR) {
+            continue;
+        }
+        if (got <= 0) {
+            throw std::runtime_error(std::string("BufferPool: block read failed: ") +
+                                     (got < 0 ? std::strerror(errno) : "unexpected end of file"));
+        }
+        stats_.bytes_read += static_cast<size_t>(got);
+        offset += got;
+        
+        size_t remaining = static_cast<size_t>(got);
+        while (remaining > 0 && remaining >= iov[next].iov_len) {
+            remaining -= iov[next].iov_len;
+            ++next;
+        }
+        if (remaining > 0) {
+            iov[next].iov_base = static_cast<char*>(iov[next].iov_base) + remaining;
+            iov[next].iov_len -= remaining;
+        }
+    }
+}
+
+} // namespace flood
@@ -0,0 +1,69 @@
+#include "utils/cache_flusher.h"
+#include <algorithm>
+#include <fstream>
+#include <string>
+#include <unistd.h>
+
+namespace flood {
+
+CacheFlusher::CacheFlusher(size_t bytes) : round_(0) {
+    if (bytes == 0) {
+        bytes = std::max(DEFAULT_LLC_MULTIPLE * lastLevelCacheSize(), MIN_BYTES);
+    }
+    buffer_.assign(std::max(bytes, LINE_BYTES), 0);
+}
+
+void CacheFlusher::flush() {
+    // A new value every round, and a sum nobody can predict, so neither
+    // the writes nor the reads can be optimized away
+    ++round_;
+    for (size_t i = 0; i < buffer_.size(); i += LINE_BYTES) {
+        buffer_[i] = static_cast<uint8_t>(round_ + i);
+    }
+    volatile uint8_t sink = 0;
+    uint8_t sum = 0;
+    for (size_t i = 0; i < buffer_.size(); i += LINE_BYTES) {
+        sum = static_cast<uint8_t>(sum + buffer_[i]);
+    }
+    sink = sum;
+    (void)sink;
+}
+
+size_t CacheFlusher::lastLevelCacheSize() {
+    size_t largest = 0;
+#ifdef _SC_LEVEL3_CACHE_SIZE
+    for (int name : {_SC_LEVEL2_CACHE_SIZE, _SC_LEVEL3_CACHE_SIZE, _SC_LEVEL4_CACHE_SIZE}) {
+        long size = ::sysconf(name);
+        if (size > 0) {
+            largest = std::max(largest, static_cast<size_t>(size));
+        }
+    }
+#endif
+    if (largest > 0) {
+        return largest;
+    }
+    
+    // e.g. "32768K" in /sys/devices/system/cpu/cpu0/cache/index3/size
+    for (int index = 0; index < 8; ++index) {
+        std::string dir = "/sys/devices/system/cpu/cpu0/cache/index" + std::to_string(index) + "/";
+        std::ifstream type_file(dir + "type");
+        std::ifstream size_file(dir + "size");
+        std::string type;
+        std::string size;
+        if (!(type_file >> type) || !(size_file >> size) || type == "Instruction") {
+            continue;
+        }
+        try {
+            size_t used = 0;
+            size_t value = std::stoull(size, &used);
+            char unit = used < size.size() ? size[used] : ' ';
+            value <<= unit == 'K' ? 10 : unit == 'M' ? 20 : unit == 'G' ? 30 : 0;
+            largest = std::max(largest, value);
+        } catch (const std::exception&) {
+            continue;
+        }
+    }
+    return largest;
+}
+
+} // namespace flood
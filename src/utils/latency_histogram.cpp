@@ -0,0 +1,133 @@
+#include "utils/latency_histogram.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace flood {
+
+namespace {
+
+uint32_t bitLength(uint64_t value) {
+    return value == 0 ? 0 : 64 - static_cast<uint32_t>(__builtin_clzll(value));
+}
+
+} // namespace
+
+LatencyHistogram::LatencyHistogram(uint64_t highest_trackable, int significant_digits)
+    : highest_trackable_(highest_trackable), significant_digits_(significant_digits),
+      total_(0), clamped_(0), min_(UINT64_MAX), max_(0), sum_(0.0L) {
+    if (significant_digits < 1 || significant_digits > 5) {
+        throw std::invalid_argument("LatencyHistogram precision must be 1 to 5 significant digits");
+    }
+    if (highest_trackable < 2) {
+        throw std::invalid_argument("LatencyHistogram needs a highest trackable value of at least 2");
+    }
+    
+    // Enough sub-buckets per power-of-two range to resolve 1 in 10^digits
+    uint64_t largest_exact = 2;
+    for (int d = 0; d < significant_digits; ++d) {
+        largest_exact *= 10;
+    }
+    uint32_t magnitude = bitLength(largest_exact - 1);
+    sub_bucket_half_magnitude_ = magnitude - 1;
+    sub_bucket_count_ = uint64_t(1) << magnitude;
+    sub_bucket_mask_ = sub_bucket_count_ - 1;
+    
+    // Power-of-two ranges until the highest trackable value is covered
+    size_t buckets = 1;
+    uint64_t smallest_untrackable = sub_bucket_count_;
+    while (smallest_untrackable <= highest_trackable_) {
+        ++buckets;
+        if (smallest_untrackable > (UINT64_MAX >> 1)) {
+            break;
+        }
+        smallest_untrackable <<= 1;
+    }
+    counts_.assign((buckets + 1) * (sub_bucket_count_ / 2), 0);
+}
+
+size_t LatencyHistogram::countsIndex(uint64_t value) const {
+    // Range (bucket) from the highest set bit, sub-bucket from the bits below it
+    uint32_t bucket = bitLength(value | sub_bucket_mask_) - (sub_bucket_half_magnitude_ + 1);
+    uint64_t sub_bucket = value >> bucket;
+    return (static_cast<size_t>(bucket + 1) << sub_bucket_half_magnitude_) +
+           static_cast<size_t>(sub_bucket - (sub_bucket_count_ / 2));
+}
+
+uint64_t LatencyHistogram::valueAtIndex(size_t index) const {
+    const uint64_t half = sub_bucket_count_ / 2;
+    int64_t bucket = static_cast<int64_t>(index >> sub_bucket_half_magnitude_) - 1;
+    uint64_t sub_bucket = (index & (half - 1)) + half;
+    if (bucket < 0) {
+        sub_bucket -= half;
+        bucket = 0;
+    }
+    return sub_bucket << bucket;
+}
+
+uint64_t LatencyHistogram::highestEquivalentValue(uint64_t value) const {
+    uint32_t bucket = bitLength(value | sub_bucket_mask_) - (sub_bucket_half_magnitude_ + 1);
+    uint64_t lowest = (value >> bucket) << bucket;
+    return lowest + (uint64_t(1) << bucket) - 1;
+}
+
+void LatencyHistogram::record(uint64_t value) {
+    if (value > highest_trackable_) {
+        value = highest_trackable_;
+        ++clamped_;
+    }
+    ++counts_[countsIndex(value)];
+    ++total_;
+    min_ = std::min(min_, value);
+    max_ = std::max(max_, value);
+    sum_ += value;
+}
+
+void LatencyHistogram::merge(const LatencyHistogram& other) {
+    if (other.highest_trackable_ != highest_trackable_ || other.significant_digits_ != significant_digits_) {
+        throw std::invalid_argument("Cannot merge latency histograms with different settings");
+    }
+    for (size_t i = 0; i < counts_.size(); ++i) {
+        counts_[i] += other.counts_[i];
+    }
+    total_ += other.total_;
+    clamped_ += other.clamped_;
+    min_ = std::min(min_, other.min_);
+    max_ = std::max(max_, other.max_);
+    sum_ += other.sum_;
+}
+
+void LatencyHistogram::reset() {
+    std::fill(counts_.begin(), counts_.end(), 0);
+    total_ = 0;
+    clamped_ = 0;
+    min_ = UINT64_MAX;
+    max_ = 0;
+    sum_ = 0.0L;
+}
+
+double LatencyHistogram::getMean() const {
+    return total_ ? static_cast<double>(sum_ / total_) : 0.0;
+}
+
+uint64_t LatencyHistogram::valueAtPercentile(double percentile) const {
+    if (total_ == 0) {
+        return 0;
+    }
+    percentile = std::min(std::max(percentile, 0.0), 100.0);
+    uint64_t target = static_cast<uint64_t>(std::ceil(percentile / 100.0 * total_));
+    target = std::max<uint64_t>(1, std::min(target, total_));
+    
+    uint64_t seen = 0;
+    for (size_t i = 0; i < counts_.size(); ++i) {
+        seen += counts_[i];
+        if (seen >= target) {
+            // Report the top of the sub-bucket, but never beyond what was seen
+            uint64_t value = highestEquivalentValue(valueAtIndex(i));
+            return std::max(getMin(), std::min(value, max_));
+        }
+    }
+    return max_;
+}
+
+} // namespace flood
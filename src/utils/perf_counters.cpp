@@ -0,0 +1,173 @@
+#include "utils/perf_counters.h"
+#include <cstring>
+#include <cerrno>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace flood {
+
+namespace {
+
+const char* const EVENT_NAMES[NUM_PERF_EVENTS] = {
+    "Cycles", "Instructions", "L1DMisses", "LLCMisses", "BranchMisses", "DTLBMisses"
+};
+
+#ifdef __linux__
+
+struct EventSpec {
+    uint32_t type;
+    uint64_t config;
+};
+
+constexpr uint64_t cacheConfig(uint64_t cache, uint64_t op, uint64_t result) {
+    return cache | (op << 8) | (result << 16);
+}
+
+// Indexed by PerfEvent
+const EventSpec EVENT_SPECS[NUM_PERF_EVENTS] = {
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+    {PERF_TYPE_HW_CACHE, cacheConfig(PERF_COUNT_HW_CACHE_L1D, PERF_COUNT_HW_CACHE_OP_READ,
+                                      PERF_COUNT_HW_CACHE_RESULT_MISS)},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+    {PERF_TYPE_HW_CACHE, cacheConfig(PERF_COUNT_HW_CACHE_DTLB, PERF_COUNT_HW_CACHE_OP_READ,
+                                      PERF_COUNT_HW_CACHE_RESULT_MISS)},
+};
+
+// Layout of a read() with TOTAL_TIME_ENABLED | TOTAL_TIME_RUNNING
+struct ReadFormat {
+    uint64_t value;
+    uint64_t time_enabled;
+    uint64_t time_running;
+};
+
+int openEvent(const EventSpec& spec) {
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = spec.type;
+    attr.config = spec.config;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    // This thread, any CPU, no group
+    return static_cast<int>(::syscall(__NR_perf_event_open, &attr, 0, -1, -1, PERF_FLAG_FD_CLOEXEC));
+}
+
+#endif
+
+} // namespace
+
+const char* perfEventName(PerfEvent event) {
+    return EVENT_NAMES[static_cast<size_t>(event)];
+}
+
+bool PerfSample::any() const {
+    for (bool v : valid) {
+        if (v) return true;
+    }
+    return false;
+}
+
+double PerfSample::ipc() const {
+    if (!has(PerfEvent::CYCLES) || !has(PerfEvent::INSTRUCTIONS) || get(PerfEvent::CYCLES) == 0) {
+        return 0.0;
+    }
+    return static_cast<double>(get(PerfEvent::INSTRUCTIONS)) / get(PerfEvent::CYCLES);
+}
+
+PerfSample& PerfSample::operator+=(const PerfSample& other) {
+    for (size_t e = 0; e < NUM_PERF_EVENTS; ++e) {
+        counts[e] += other.counts[e];
+        valid[e] = valid[e] || other.valid[e];
+    }
+    return *this;
+}
+
+PerfCounters::PerfCounters() {
+    fds_.fill(-1);
+#ifdef __linux__
+    int first_error = 0;
+    for (size_t e = 0; e < NUM_PERF_EVENTS; ++e) {
+        fds_[e] = openEvent(EVENT_SPECS[e]);
+        if (fds_[e] < 0 && first_error == 0) {
+            first_error = errno;
+        }
+    }
+    if (!available()) {
+        reason_ = std::string("perf_event_open failed: ") + std::strerror(first_error);
+        if (first_error == EACCES || first_error == EPERM) {
+            reason_ += " (see /proc/sys/kernel/perf_event_paranoid)";
+        } else if (first_error == ENOENT || first_error == ENODEV || first_error == EOPNOTSUPP) {
+            reason_ += " (no hardware PMU exposed)";
+        }
+    }
+#else
+    reason_ = "hardware counters need Linux perf_event_open";
+#endif
+}
+
+PerfCounters::~PerfCounters() {
+#ifdef __linux__
+    for (int fd : fds_) {
+        if (fd >= 0) {
+            ::close(fd);
+        }
+    }
+#endif
+}
+
+bool PerfCounters::available() const {
+    for (int fd : fds_) {
+        if (fd >= 0) return true;
+    }
+    return false;
+}
+
+void PerfCounters::start() {
+#ifdef __linux__
+    for (int fd : fds_) {
+        if (fd >= 0) {
+            ::ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+            ::ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+#endif
+}
+
+PerfSample PerfCounters::stop() {
+    PerfSample sample;
+#ifdef __linux__
+    // Disable everything first, so reading one counter is not counted by the next
+    for (int fd : fds_) {
+        if (fd >= 0) {
+            ::ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+        }
+    }
+    for (size_t e = 0; e < NUM_PERF_EVENTS; ++e) {
+        ReadFormat data;
+        if (fds_[e] < 0 || ::read(fds_[e], &data, sizeof(data)) != static_cast<ssize_t>(sizeof(data))) {
+            continue;
+        }
+        if (data.time_running == 0) {
+            continue;  // Never scheduled on a hardware counter
+        }
+        double value = static_cast<double>(data.value);
+        if (data.time_running < data.time_enabled) {
+            value *= static_cast<double>(data.time_enabled) / data.time_running;
+        }
+        sample.counts[e] = static_cast<uint64_t>(value + 0.5);
+        sample.valid[e] = true;
+    }
+#endif
+    return sample;
+}
+
+} // namespace flood
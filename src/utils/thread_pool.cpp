@@ -0,0 +1,93 @@
+#include "utils/thread_pool.h"
+#include <atomic>
+#include <algorithm>
+
+namespace flood {
+
+ThreadPool::ThreadPool(size_t num_threads) : stopping_(false) {
+    if (num_threads == 0) {
+        size_t hw = std::thread::hardware_concurrency();
+        num_threads = hw > 1 ? hw - 1 : 0;
+    }
+    
+    workers_.reserve(num_threads);
+    for (size_t i = 0; i < num_threads; ++i) {
+        workers_.emplace_back(&ThreadPool::workerLoop, this);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    cv_.notify_all();
+    for (auto& worker : workers_) {
+        worker.join();
+    }
+}
+
+void ThreadPool::workerLoop() {
+    while (true) {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            cv_.wait(lock, [this] { return stopping_ || !tasks_.empty(); });
+            if (stopping_ && tasks_.empty()) {
+                return;
+            }
+            task = std::move(tasks_.front());
+            tasks_.pop();
+        }
+        task();
+    }
+}
+
+void ThreadPool::parallelFor(size_t n, const std::function<void(size_t)>& fn) {
+    if (n == 0) {
+        return;
+    }
+    
+    // Items are claimed dynamically, so uneven items balance out
+    std::atomic<size_t> next(0);
+    auto drain = [&]() {
+        try {
+            for (size_t i = next++; i < n; i = next++) {
+                fn(i);
+            }
+        } catch (...) {
+            next = n;  // Stop handing out items
+            throw;
+        }
+    };
+    
+    size_t helpers = std::min(workers_.size(), n - 1);
+    std::vector<std::future<void>> pending;
+    pending.reserve(helpers);
+    for (size_t h = 0; h < helpers; ++h) {
+        pending.push_back(submit(drain));
+    }
+    
+    // The caller works too, then waits for the helpers (all of them, even
+    // if one failed, since they reference this frame)
+    std::exception_ptr error;
+    try {
+        drain();
+    } catch (...) {
+        error = std::current_exception();
+    }
+    for (auto& future : pending) {
+        try {
+            future.get();
+        } catch (...) {
+            if (!error) {
+                error = std::current_exception();
+            }
+        }
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+} // namespace flood
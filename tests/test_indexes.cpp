@@ -1,7 +1,43 @@
 #include "data/data_point.h"
 #include "data/data_loader.h"
+#include "data/columnar_dataset.h"
+#include "data/csv_parser.h"
+#include "data/attribute_table.h"
+#include "data/synthetic_generator.h"
+#include "indexes/zorder_index.h"
+#include "indexes/hilbert_index.h"
+#include "indexes/grid_index.h"
+#include "indexes/quadtree_index.h"
+#include "indexes/sharded_index.h"
+#include "indexes/tsunami_index.h"
+#include "indexes/router_index.h"
+#include "indexes/time_partitioned_index.h"
+#include "indexes/flood_index.h"
+#include "indexes/flood_external_builder.h"
+#include "indexes/disk_flood_index.h"
+#include "indexes/space_filling_curve.h"
+#include "benchmark/sweep.h"
+#include "benchmark/benchmark.h"
+#include "benchmark/microbench.h"
+#include "benchmark/result_validator.h"
+#include "benchmark/load_generator.h"
+#include "utils/latency_histogram.h"
+#include "utils/perf_counters.h"
+#include "utils/cache_flusher.h"
 #include <iostream>
 #include <cassert>
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <cstdio>
+#include <stdexcept>
+#include <cstring>
+#include <cmath>
+#include <memory>
+#include <iterator>
+#include <random>
+#include <thread>
+#include <atomic>
 
 using namespace flood;
 
@@ -56,11 +92,1783 @@ void test_data_loader() {
     std::cout << "PASSED" << std::endl;
 }
 
+void test_columnar_dataset() {
+    std::cout << "Testing ColumnarDataset... ";
+    
+    std::vector<DataPoint> data;
+    for (int i = 0; i < 1000; ++i) {
+        data.emplace_back(std::vector<double>{i * 0.5, -1.0 * i, 7.0}, 1000 + i);
+    }
+    
+    std::string temp_file = "/tmp/test_dataset.fcol";
+    ColumnarDataset::write(data, temp_file);
+    assert(ColumnarDataset::isColumnarFile(temp_file));
+    
+    ColumnarDataset dataset(temp_file);
+    assert(dataset.size() == data.size());
+    assert(dataset.getDimensions() == 3);
+    assert(dataset.getMinBound(1) == -999.0 && dataset.getMaxBound(0) == 499.5);
+    
+    // Columns are page aligned and read in place
+    assert(reinterpret_cast<uintptr_t>(dataset.column(2)) % ColumnarDataset::PAGE_ALIGNMENT == 0);
+    assert(dataset.ids()[10] == 1010 && dataset.column(0)[10] == 5.0);
+    
+    auto points = dataset.toDataPoints();
+    assert(points.size() == data.size());
+    assert(points[999].getId() == 1999 && points[999].getCoordinate(1) == -999.0);
+    
+    // Files in the old row format are rejected
+    std::string row_file = "/tmp/test_dataset_rows.bin";
+    DataLoader().saveToBinary(data, row_file);
+    assert(!ColumnarDataset::isColumnarFile(row_file));
+    bool rejected = false;
+    try {
+        ColumnarDataset invalid(row_file);
+    } catch (const std::runtime_error&) {
+        rejected = true;
+    }
+    assert(rejected);
+    
+    // A dimension count whose layout size overflows to a small value
+    {
+        std::fstream file(temp_file, std::ios::in | std::ios::out | std::ios::binary);
+        uint64_t dimensions = uint64_t(1) << 60;
+        file.seekp(24);
+        file.write(reinterpret_cast<const char*>(&dimensions), sizeof(dimensions));
+    }
+    rejected = false;
+    try {
+        ColumnarDataset invalid(temp_file);
+    } catch (const std::runtime_error&) {
+        rejected = true;
+    }
+    assert(rejected);
+    
+    std::remove(temp_file.c_str());
+    std::remove(row_file.c_str());
+    
+    std::cout << "PASSED" << std::endl;
+}
+
+void test_csv_parser() {
+    std::cout << "Testing CSVParser... ";
+    
+    double value = 0.0;
+    assert(CSVParser::parseField("-73.5", "-73.5" + 5, value) && value == -73.5);
+    std::string ts = "1970-01-02 00:00:01";
+    assert(CSVParser::parseField(ts.data(), ts.data() + ts.size(), value) && value == 86401.0);
+    assert(!CSVParser::parseField("abc", "abc" + 3, value));
+    
+    // Columns picked by header name, bad and out-of-area rows dropped
+    std::string csv_file = "/tmp/test_parser.csv";
+    {
+        std::ofstream out(csv_file);
+        out << "VendorID,tpep_pickup_datetime,passenger_count,trip_distance,pickup_longitude,pickup_latitude\r\n";
+        for (int i = 0; i < 2000; ++i) {
+            double lon = -74.0 + (i % 100) * 0.001;
+            if (i % 50 == 7) lon = 0.0;  // Outside NYC
+            out << "2,2024-01-01 00:" << (10 + i % 50) << ":00," << (i % 4) << ","
+                << (i % 9) * 0.5 << "," << lon << "," << 40.7 << "\r\n";
+            if (i % 100 == 3) out << "2,not a date,1,1.0,-74.0,40.7\r\n";
+            if (i % 100 == 5) out << "\r\n";
+        }
+    }
+    
+    CSVParseOptions options = CSVParser::nycTaxiOptions();
+    options.num_threads = 1;
+    CSVParser serial(options);
+    auto expected = serial.parse(csv_file);
+    assert(serial.getStats().rows_read == 2020);
+    assert(serial.getStats().rows_malformed == 20);
+    assert(serial.getStats().rows_filtered == 40);
+    assert(expected.size() == 1960);
+    assert(expected[0].getDimensions() == 5 && expected[0].getCoordinate(0) == -74.0);
+    
+    // Tiny chunks split the file at many points; results must not change
+    options.num_threads = 4;
+    options.min_chunk_bytes = 64;
+    CSVParser parallel(options);
+    auto actual = parallel.parse(csv_file);
+    assert(actual.size() == expected.size());
+    for (size_t i = 0; i < actual.size(); ++i) {
+        assert(actual[i].getId() == i);
+        for (size_t d = 0; d < 5; ++d) {
+            assert(actual[i].getCoordinate(d) == expected[i].getCoordinate(d));
+        }
+    }
+    
+    std::remove(csv_file.c_str());
+    
+    std::cout << "PASSED" << std::endl;
+}
+
+void test_zorder_index() {
+    std::cout << "Testing ZOrderIndex... ";
+    
+    // Morton encoders must agree with the bit-by-bit definition
+    for (uint32_t v = 0; v < 5000; ++v) {
+        uint32_t x = v * 2654435761u, y = v * 40503u, z = v ^ 0x15555u;
+        uint64_t ref2 = 0, ref3 = 0;
+        for (int i = 0; i < 21; ++i) {
+            ref2 |= ((uint64_t)((x >> i) & 1) << (2 * i)) | ((uint64_t)((y >> i) & 1) << (2 * i + 1));
+            ref3 |= ((uint64_t)((x >> i) & 1) << (3 * i)) | ((uint64_t)((y >> i) & 1) << (3 * i + 1)) |
+                    ((uint64_t)((z >> i) & 1) << (3 * i + 2));
+        }
+        assert(sfc::mortonEncode2D(x, y) == ref2);
+        assert(sfc::mortonEncode3D(x, y, z) == ref3);
+        assert(sfc::mortonEncode2DMagic(x, y) == ref2);
+        assert(sfc::mortonEncode3DMagic(x, y, z) == ref3);
+    }
+    
+    // Equal budgets in 2-D use the dedicated Morton encoder, which must
+    // match the general key layout the range decomposition assumes
+    std::vector<DataPoint> plane;
+    for (int i = 0; i < 4000; ++i) {
+        plane.emplace_back(std::vector<double>{(double)((i * 7919LL) % 1000), (double)((i * 104729LL) % 1000)}, i);
+    }
+    ZOrderIndex flat(16);
+    flat.build(plane);
+    assert(flat.getKeyBits()[0] == flat.getKeyBits()[1] && flat.getKeyBits()[0] <= sfc::MORTON_BITS);
+    for (int q = 0; q < 20; ++q) {
+        double x = q * 47.0, y = q * 31.0;
+        QueryRange box({x, y}, {x + 120.0, y + 200.0});
+        size_t matches = 0;
+        for (const auto& p : plane) {
+            if (box.contains(p)) ++matches;
+        }
+        assert(flat.query(box).size() == matches);
+    }
+    
+    // Every grid location appears 3 times: duplicate keys must not be lost
+    std::vector<DataPoint> data;
+    for (int k = 0; k < 3; ++k) {
+        for (int x = 0; x < 20; ++x) {
+            for (int y = 0; y < 20; ++y) {
+                data.emplace_back(std::vector<double>{(double)x, (double)y, (double)(x + y)},
+                                  data.size());
+            }
+        }
+    }
+    
+    ZOrderIndex zorder(16);
+    zorder.build(data);
+    
+    QueryRange range({3.0, 4.0, 0.0}, {8.0, 9.0, 12.0});
+    size_t expected = 0;
+    for (const auto& p : data) {
+        if (range.contains(p)) ++expected;
+    }
+    assert(zorder.query(range).size() == expected);
+    
+    std::cout << "PASSED" << std::endl;
+}
+
+void test_hilbert_index() {
+    std::cout << "Testing HilbertIndex... ";
+    
+    // An aligned 8x8 block is one contiguous key run, visited cell by
+    // adjacent cell
+    std::vector<std::pair<uint64_t, std::pair<uint32_t, uint32_t>>> cells;
+    for (uint32_t x = 0; x < 8; ++x) {
+        for (uint32_t y = 0; y < 8; ++y) {
+            uint32_t c[2] = {x, y};
+            cells.push_back({(uint64_t)sfc::hilbertEncode(c, 2, 3), {x, y}});
+        }
+    }
+    std::sort(cells.begin(), cells.end());
+    assert(cells.back().first - cells.front().first == 63);
+    for (size_t i = 1; i < cells.size(); ++i) {
+        auto [x0, y0] = cells[i - 1].second;
+        auto [x1, y1] = cells[i].second;
+        assert(std::abs((int)x0 - (int)x1) + std::abs((int)y0 - (int)y1) == 1);
+    }
+    
+    // Query results must match a brute-force scan
+    std::vector<DataPoint> data;
+    for (int i = 0; i < 2000; ++i) {
+        data.emplace_back(std::vector<double>{(double)(i % 37), (double)(i % 53), (double)(i % 11)}, i);
+    }
+    HilbertIndex hilbert(32);
+    hilbert.build(data);
+    
+    QueryRange range({5.0, 10.0, 2.0}, {20.0, 30.0, 7.0});
+    size_t expected = 0;
+    for (const auto& p : data) {
+        if (range.contains(p)) ++expected;
+    }
+    assert(hilbert.query(range).size() == expected);
+    
+    std::cout << "PASSED" << std::endl;
+}
+
+void test_curve_index_high_dimensions() {
+    std::cout << "Testing CurveIndex with 6 dimensions... ";
+    
+    // Dimension 3 has only 6 distinct values, dimension 5 is constant
+    std::vector<DataPoint> data;
+    for (int i = 0; i < 3000; ++i) {
+        data.emplace_back(std::vector<double>{
+            (double)(i % 97), (double)((i * 7) % 89), (double)(i / 3),
+            (double)(1 + i % 6), (double)((i * 13) % 41), 5.0}, i);
+    }
+    
+    QueryRange range({10.0, 0.0, 100.0, 2.0, 5.0, 0.0},
+                     {60.0, 50.0, 800.0, 3.0, 30.0, 10.0});
+    size_t expected = 0;
+    for (const auto& p : data) {
+        if (range.contains(p)) ++expected;
+    }
+    
+    ZOrderIndex zorder;
+    zorder.build(data);
+    assert(zorder.getKeyBits().size() == 6);
+    assert(zorder.getKeyBits()[3] == 3);
+    assert(zorder.getKeyBits()[5] == 0);
+    assert(zorder.query(range).size() == expected);
+    
+    HilbertIndex hilbert(256);
+    hilbert.build(data);
+    assert(hilbert.query(range).size() == expected);
+    
+    std::cout << "PASSED" << std::endl;
+}
+
+void test_grid_index() {
+    std::cout << "Testing GridIndex... ";
+    
+    // Skewed data with heavy duplicates in dimension 1
+    std::vector<DataPoint> data;
+    for (int i = 0; i < 5000; ++i) {
+        double x = (i % 10 == 0) ? (double)(i % 1000) : (double)(i % 50);
+        data.emplace_back(std::vector<double>{x, (double)(i % 4), (double)((i * 31) % 997)}, i);
+    }
+    
+    std::vector<QueryRange> queries = {
+        QueryRange({10.0, 1.0, 100.0}, {40.0, 2.0, 600.0}),
+        QueryRange({-5.0, -1.0, -1.0}, {2000.0, 10.0, 2000.0}),
+        QueryRange({49.5, 3.0, 0.0}, {700.0, 3.0, 996.0})
+    };
+    
+    for (bool equi_depth : {true, false}) {
+        GridIndex grid(32, equi_depth);
+        grid.build(data);
+        assert(grid.getNumCells() > 1);
+        for (const auto& range : queries) {
+            size_t expected = 0;
+            for (const auto& p : data) {
+                if (range.contains(p)) ++expected;
+            }
+            assert(grid.query(range).size() == expected);
+        }
+    }
+    
+    std::cout << "PASSED" << std::endl;
+}
+
+void test_quadtree_index() {
+    std::cout << "Testing QuadtreeIndex... ";
+    
+    // Dense cluster plus sparse background, with a block of duplicates
+    std::vector<DataPoint> data;
+    for (int i = 0; i < 6000; ++i) {
+        double x, y;
+        if (i % 3 == 0) {
+            x = (i % 997) * 0.1;
+            y = (i % 991) * 0.1;
+        } else {
+            x = 50.0 + (i % 37) * 0.001;
+            y = 50.0 + (i % 41) * 0.001;
+        }
+        if (i < 200) {
+            x = y = 25.0;
+        }
+        data.emplace_back(std::vector<double>{x, y, (double)(i % 24), (double)(i % 5)}, i);
+    }
+    
+    std::vector<QueryRange> queries = {
+        QueryRange({50.0, 50.0, 0.0, 0.0}, {50.02, 50.03, 23.0, 4.0}),
+        QueryRange({10.0, 20.0, 5.0, 1.0}, {60.0, 90.0, 12.0, 3.0}),
+        QueryRange({25.0, 25.0, 0.0, 0.0}, {25.0, 25.0, 23.0, 4.0}),
+        QueryRange({-1.0, -1.0, -1.0, -1.0}, {200.0, 200.0, 30.0, 10.0})
+    };
+    
+    for (size_t split_dims : {2, 3}) {
+        QuadtreeIndex tree(16, split_dims);
+        std::string name = tree.getName();
+        assert(name == (split_dims == 2 ? "Quadtree" : "Octree"));
+        tree.build(data);
+        assert(tree.getName() == name);
+        assert(tree.getMaxDepth() > 1);
+        for (const auto& range : queries) {
+            size_t expected = 0;
+            for (const auto& p : data) {
+                if (range.contains(p)) ++expected;
+            }
+            assert(tree.query(range).size() == expected);
+        }
+    }
+    
+    std::cout << "PASSED" << std::endl;
+}
+
+void test_sharded_index() {
+    std::cout << "Testing ShardedIndex... ";
+    
+    // Thread pool runs every item exactly once
+    ThreadPool pool(3);
+    std::vector<int> hits(1000, 0);
+    pool.parallelFor(hits.size(), [&](size_t i) { hits[i]++; });
+    assert(std::count(hits.begin(), hits.end(), 1) == 1000);
+    
+    std::vector<DataPoint> data;
+    for (int i = 0; i < 4000; ++i) {
+        data.emplace_back(std::vector<double>{(double)((i * 7) % 1000), (double)(i % 100), (double)(i % 13)}, i);
+    }
+    
+    std::vector<QueryRange> queries = {
+        QueryRange({100.0, 10.0, 0.0}, {300.0, 60.0, 12.0}),
+        QueryRange({0.0, 0.0, 5.0}, {999.0, 99.0, 5.0}),
+        QueryRange({2000.0, 0.0, 0.0}, {3000.0, 99.0, 12.0})
+    };
+    
+    for (auto partitioning : {ShardPartitioning::KEY_RANGE, ShardPartitioning::SPACE,
+                              ShardPartitioning::ROUND_ROBIN}) {
+        ShardedIndex sharded([]() { return std::make_shared<GridIndex>(16); }, 5, partitioning, 2);
+        sharded.build(data);
+        assert(sharded.getNumShards() == 5);
+        for (const auto& range : queries) {
+            std::vector<uint64_t> expected, actual;
+            for (const auto& p : data) {
+                if (range.contains(p)) expected.push_back(p.getId());
+            }
+            for (const auto& p : sharded.query(range)) {
+                actual.push_back(p.getId());
+            }
+            std::sort(expected.begin(), expected.end());
+            std::sort(actual.begin(), actual.end());
+            assert(actual == expected);
+        }
+        
+        // Spatial shards are pruned by their bounding boxes
+        if (partitioning != ShardPartitioning::ROUND_ROBIN) {
+            sharded.query(QueryRange({0.0, 0.0, 0.0}, {50.0, 99.0, 12.0}));
+            assert(sharded.getLastShardsQueried() < 5);
+        }
+    }
+    
+    // Concurrent queries add up the scan counters of the shards they share
+    ShardedIndex sharded([]() { return std::make_shared<GridIndex>(16); }, 5, ShardPartitioning::SPACE, 0);
+    sharded.build(data);
+    sharded.resetScanStats();
+    for (const auto& range : queries) {
+        sharded.query(range);
+    }
+    const size_t points_once = sharded.getScannedPoints();
+    const size_t runs_once = sharded.getScannedRuns();
+    assert(points_once > 0 && runs_once > 0);
+    sharded.resetScanStats();
+    assert(sharded.getScannedPoints() == 0 && sharded.getScannedRuns() == 0);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&]() {
+            for (int iteration = 0; iteration < 25; ++iteration) {
+                for (const auto& range : queries) {
+                    sharded.query(range);
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    assert(sharded.getScannedPoints() == 100 * points_once && sharded.getScannedRuns() == 100 * runs_once);
+    
+    std::cout << "PASSED" << std::endl;
+}
+
+void test_tsunami_index() {
+    std::cout << "Testing TsunamiIndex... ";
+    
+    // Dimension 1 tracks dimension 0 closely (correlated), dimension 2 is
+    // independent
+    std::vector<DataPoint> data;
+    for (int i = 0; i < 8000; ++i) {
+        double x = (i * 37) % 1000;
+        double y = 3.0 * x + 10.0 + (i % 7);
+        data.emplace_back(std::vector<double>{x, y, (double)((i * 13) % 500)}, i);
+    }
+    
+    // Queries concentrated on the low end of dimension 0
+    std::vector<QueryRange> training;
+    for (int q = 0; q < 60; ++q) {
+        double x = (q * 3) % 100;
+        training.push_back(QueryRange({x, 0.0, 0.0}, {x + 20.0, 4000.0, 500.0}));
+    }
+    
+    std::vector<QueryRange> queries = {
+        QueryRange({10.0, 0.0, 100.0}, {40.0, 4000.0, 300.0}),
+        QueryRange({0.0, 1500.0, 0.0}, {1000.0, 1600.0, 500.0}),
+        QueryRange({500.0, 0.0, 0.0}, {900.0, 100.0, 500.0}),
+        QueryRange({-10.0, -10.0, -10.0}, {2000.0, 5000.0, 600.0})
+    };
+    
+    TsunamiIndex untrained(500);
+    untrained.build(data);
+    assert(untrained.getNumRegions() == 1);
+    
+    TsunamiIndex tsunami(500);
+    tsunami.train(training);
+    tsunami.build(data);
+    assert(tsunami.getNumRegions() > 1);
+    assert(tsunami.getNumMappings() > 0);
+    
+    for (auto* index : {&untrained, &tsunami}) {
+        for (const auto& range : queries) {
+            size_t expected = 0;
+            for (const auto& p : data) {
+                if (range.contains(p)) ++expected;
+            }
+            assert(index->query(range).size() == expected);
+        }
+    }
+    
+    std::cout << "PASSED" << std::endl;
+}
+
+void test_router_index() {
+    std::cout << "Testing RouterIndex... ";
+    
+    std::vector<DataPoint> data;
+    for (int i = 0; i < 3000; ++i) {
+        data.emplace_back(std::vector<double>{(double)((i * 17) % 300), (double)(i % 101)}, i);
+    }
+    
+    RouterIndex router({std::make_shared<GridIndex>(32), std::make_shared<QuadtreeIndex>(32, 2)});
+    router.build(data);
+    assert(!router.isCalibrated());
+    
+    // Synthetic latencies: the grid is cheap on small boxes, the
+    // quadtree on large ones
+    std::vector<QueryRange> queries;
+    std::vector<std::vector<double>> latencies(2);
+    for (int q = 0; q < 40; ++q) {
+        double w = (q % 2 == 0) ? 2.0 : 250.0;
+        queries.push_back(QueryRange({(double)q, 0.0}, {q + w, w / 3.0}));
+        latencies[0].push_back(w < 10.0 ? 0.01 : 1.0);
+        latencies[1].push_back(w < 10.0 ? 1.0 : 0.01);
+    }
+    router.calibrate(queries, latencies);
+    assert(router.isCalibrated());
+    
+    QueryRange small({5.0, 5.0}, {7.0, 6.0});
+    QueryRange large({0.0, 0.0}, {280.0, 90.0});
+    assert(router.route(small) == 0);
+    assert(router.route(large) == 1);
+    
+    // Routed queries are answered exactly and logged
+    for (const auto& range : {small, large}) {
+        size_t expected = 0;
+        for (const auto& p : data) {
+            if (range.contains(p)) ++expected;
+        }
+        assert(router.query(range).size() == expected);
+    }
+    assert(router.getRoutingLog().size() == 2);
+    assert(router.getRouteCounts()[0] == 1 && router.getRouteCounts()[1] == 1);
+    
+    auto report = router.evaluateRegret(queries);
+    assert(report.queries == queries.size());
+    assert(report.router_ms >= report.oracle_ms);
+    
+    std::cout << "PASSED" << std::endl;
+}
+
+void test_flood_external_builder() {
+    std::cout << "Testing FloodExternalBuilder... ";
+    
+    std::vector<DataPoint> data;
+    for (int i = 0; i < 20000; ++i) {
+        double x = (i * 7919) % 1000, y = (i * 104729) % 500 * 0.1;
+        data.emplace_back(std::vector<double>{x, y, (double)(i % 13)}, 5000 + i);
+    }
+    std::string dataset_file = "/tmp/test_external.fcol";
+    ColumnarDataset::write(data, dataset_file);
+    ColumnarDataset dataset(dataset_file);
+    
+    // A 64 KiB budget forces ~19 sorted runs and two merge passes
+    ExternalBuildOptions options;
+    options.memory_budget_bytes = 64 << 10;
+    options.block_size = 512;
+    std::string index_file = "/tmp/test_external.fidx";
+    FloodExternalBuilder builder(options);
+    builder.build(dataset, index_file);
+    const auto& stats = builder.getStats();
+    assert(stats.points == data.size());
+    assert(stats.runs > 15 && stats.merge_passes == 2);
+    assert(stats.peak_buffer_bytes <= options.memory_budget_bytes);
+    
+    std::ifstream in(index_file, std::ios::binary);
+    std::vector<char> bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    fidx::FileHeader header;
+    std::memcpy(&header, bytes.data(), sizeof(header));
+    assert(std::memcmp(header.magic, fidx::MAGIC, sizeof(fidx::MAGIC)) == 0);
+    assert(header.num_points == data.size() && header.dimensions == 3);
+    assert(header.record_size == fidx::recordSize(3) && header.records_per_block == 12);
+    assert(header.data_offset % header.block_size == 0);
+    assert(bytes.size() == header.directory_offset + header.num_blocks * sizeof(fidx::BlockEntry));
+    
+    std::vector<double> projection(3), min_bounds(3), max_bounds(3);
+    const char* meta = bytes.data() + sizeof(header);
+    std::memcpy(projection.data(), meta, 3 * sizeof(double));
+    std::memcpy(min_bounds.data(), meta + 3 * sizeof(double), 3 * sizeof(double));
+    std::memcpy(max_bounds.data(), meta + 6 * sizeof(double), 3 * sizeof(double));
+    
+    // Records are complete, sorted by their flattened keys and described
+    // by the directory
+    std::vector<bool> seen(data.size(), false);
+    double previous = -1.0;
+    uint64_t position = 0;
+    for (uint64_t b = 0; b < header.num_blocks; ++b) {
+        fidx::BlockEntry entry;
+        std::memcpy(&entry, bytes.data() + header.directory_offset + b * sizeof(entry), sizeof(entry));
+        assert(entry.first_record == position && entry.count > 0);
+        for (uint64_t r = 0; r < entry.count; ++r) {
+            const char* record = bytes.data() + header.data_offset + b * header.block_size + r * header.record_size;
+            double key, coords[3];
+            uint64_t id;
+            std::memcpy(&key, record, sizeof(key));
+            std::memcpy(&id, record + 8, sizeof(id));
+            std::memcpy(coords, record + 16, sizeof(coords));
+            assert(key >= previous && key >= entry.min_key && key <= entry.max_key);
+            assert(key == FloodIndex::flattenedKey(coords, projection, min_bounds, max_bounds));
+            assert(id >= 5000 && id < 5000 + data.size() && !seen[id - 5000]);
+            assert(coords[0] == data[id - 5000].getCoordinate(0));
+            seen[id - 5000] = true;
+            previous = key;
+        }
+        position += entry.count;
+    }
+    assert(position == data.size());
+    
+    // An in-memory build (one run, no merge) writes the identical file
+    options.memory_budget_bytes = 64 << 20;
+    std::string single_file = "/tmp/test_external_single.fidx";
+    FloodExternalBuilder single(options);
+    single.build(dataset, single_file);
+    assert(single.getStats().runs == 0 && single.getStats().merge_passes == 0);
+    std::ifstream in_single(single_file, std::ios::binary);
+    std::vector<char> single_bytes((std::istreambuf_iterator<char>(in_single)), std::istreambuf_iterator<char>());
+    assert(single_bytes == bytes);
+    
+    std::remove(dataset_file.c_str());
+    std::remove(index_file.c_str());
+    std::remove(single_file.c_str());
+    
+    std::cout << "PASSED" << std::endl;
+}
+
+void test_disk_flood_index() {
+    std::cout << "Testing DiskFloodIndex... ";
+    
+    std::vector<DataPoint> data;
+    for (int i = 0; i < 30000; ++i) {
+        double x = (i * 7919LL) % 1000, y = (i * 104729LL) % 997 * 0.1;
+        data.emplace_back(std::vector<double>{x, y, (double)(i % 101)}, i);
+    }
+    
+    // A pool of 16 frames holds a small fraction of the ~60 blocks a large
+    // query touches, so queries run with constant evictions
+    DiskIndexOptions options;
+    options.block_size = 1024;
+    options.buffer_pool_bytes = 16 * 1024;
+    options.readahead_blocks = 4;
+    std::string index_file = "/tmp/test_disk_flood.fidx";
+    {
+        DiskFloodIndex index(index_file, options);
+        index.build(data);
+        assert(index.getNumBlocks() == (data.size() + 24) / 25);
+        
+        std::vector<QueryRange> queries = {
+            QueryRange({100.0, 10.0, 0.0}, {300.0, 40.0, 100.0}),
+            QueryRange({0.0, 0.0, 50.0}, {999.0, 99.7, 50.0}),
+            QueryRange({500.0, 50.0, 10.0}, {520.0, 55.0, 20.0}),
+            QueryRange({2000.0, 0.0, 0.0}, {3000.0, 1.0, 1.0})
+        };
+        for (int round = 0; round < 2; ++round) {
+            for (const auto& range : queries) {
+                std::vector<uint64_t> expected, actual;
+                for (const auto& p : data) {
+                    if (range.contains(p)) expected.push_back(p.getId());
+                }
+                for (const auto& p : index.query(range)) {
+                    assert(range.contains(p));
+                    actual.push_back(p.getId());
+                }
+                std::sort(actual.begin(), actual.end());
+                assert(actual == expected);
+            }
+        }
+        const auto& stats = index.getPoolStats();
+        assert(stats.misses > 0 && stats.evictions > 0);
+        assert(stats.read_calls < stats.misses);  // Missing runs are coalesced
+        
+        // A 2-D query leaves the third dimension unbounded
+        QueryRange planar({100.0, 10.0}, {300.0, 40.0});
+        size_t planar_expected = 0;
+        for (const auto& p : data) {
+            if (p.getCoordinate(0) >= 100.0 && p.getCoordinate(0) <= 300.0 &&
+                p.getCoordinate(1) >= 10.0 && p.getCoordinate(1) <= 40.0) ++planar_expected;
+        }
+        assert(planar_expected > 0 && index.query(planar).size() == planar_expected);
+        
+        // A repeated narrow query is served from the pool
+        QueryRange narrow({500.0, 50.0, 10.0}, {501.0, 50.5, 10.5});
+        index.resetPoolStats();
+        index.query(narrow);
+        index.query(narrow);
+        assert(index.getPoolStats().hits > 0);
+        index.dropCaches();
+        index.resetPoolStats();
+        index.query(narrow);
+        assert(index.getPoolStats().hits == 0);
+        
+        // The written file can be opened by another instance
+        DiskFloodIndex reopened(index_file, options);
+        reopened.open();
+        assert(reopened.query(queries[0]).size() == index.query(queries[0]).size());
+    }
+    
+    // The building instance owns its file
+    std::ifstream removed(index_file);
+    assert(!removed.is_open());
+    
+    std::cout << "PASSED" << std::endl;
+}
+
+void test_coordinate_storage() {
+    std::cout << "Testing compact coordinate storage... ";
+    
+    // Lon/lat-like coordinates at 1e-6 resolution and second timestamps
+    std::vector<DataPoint> data;
+    for (int i = 0; i < 4000; ++i) {
+        double lon = -74.05 + ((i * 7919LL) % 100000) * 1e-6;
+        double lat = 40.70 + ((i * 104729LL) % 100000) * 1e-6;
+        double t = 1704067200.0 + (i * 37LL) % 86400;
+        data.emplace_back(std::vector<double>{lon, lat, t}, i);
+    }
+    
+    // Bounds placed exactly on data values, so ties are exercised
+    std::vector<QueryRange> queries;
+    for (int q = 0; q < 20; ++q) {
+        const DataPoint& a = data[q * 97];
+        const DataPoint& b = data[q * 97 + 1500];
+        std::vector<double> lo(3), hi(3);
+        for (size_t d = 0; d < 3; ++d) {
+            lo[d] = std::min(a.getCoordinate(d), b.getCoordinate(d));
+            hi[d] = std::max(a.getCoordinate(d), b.getCoordinate(d));
+        }
+        queries.emplace_back(lo, hi);
+    }
+    queries.emplace_back(std::vector<double>{-74.04, 40.0, 0.0}, std::vector<double>{-74.03, 41.0, 2e9});
+    
+    auto make = [](int kind) -> std::unique_ptr<BaseIndex> {
+        switch (kind) {
+            case 0: return std::make_unique<FloodIndex>();
+            case 1: return std::make_unique<ZOrderIndex>();
+            case 2: return std::make_unique<GridIndex>(16);
+            default: return std::make_unique<QuadtreeIndex>(16, 3);
+        }
+    };
+    
+    for (auto encoding : {CoordinateEncoding::FLOAT32, CoordinateEncoding::FIXED32}) {
+        for (bool recheck : {true, false}) {
+            for (int kind = 0; kind < 4; ++kind) {
+                auto index = make(kind);
+                index->setCoordinateStorage(encoding, recheck);
+                index->build(data);
+                
+                for (const auto& range : queries) {
+                    std::vector<uint64_t> expected, actual;
+                    for (const auto& p : data) {
+                        if (range.contains(p)) expected.push_back(p.getId());
+                    }
+                    for (const auto& p : index->query(range)) {
+                        actual.push_back(p.getId());
+                        if (!recheck) {
+                            // Extra hits lie within one quantization step
+                            for (size_t d = 0; d < range.getDimensions(); ++d) {
+                                double slack = d < 2 ? 1e-6 : 1.0;
+                                assert(p.getCoordinate(d) >= range.getMinBound(d) - slack);
+                                assert(p.getCoordinate(d) <= range.getMaxBound(d) + slack);
+                            }
+                        }
+                    }
+                    std::sort(actual.begin(), actual.end());
+                    if (recheck) {
+                        assert(actual == expected);
+                    } else {
+                        assert(std::includes(actual.begin(), actual.end(), expected.begin(), expected.end()));
+                    }
+                }
+            }
+        }
+    }
+    
+    // Without the exact copy (the default), points shrink from 32 to 20
+    // bytes; with it they grow to 44
+    GridIndex wide(16), narrow(16), exact(16);
+    narrow.setCoordinateStorage(CoordinateEncoding::FIXED32);
+    exact.setCoordinateStorage(CoordinateEncoding::FIXED32, true);
+    wide.build(data);
+    narrow.build(data);
+    exact.build(data);
+    assert(narrow.getIndexSize() < wide.getIndexSize() && wide.getIndexSize() < exact.getIndexSize());
+    
+    std::cout << "PASSED" << std::endl;
+}
+
+void test_attribute_projection() {
+    std::cout << "Testing attribute projection... ";
+    
+    std::vector<DataPoint> data;
+    std::vector<double> fare, tip, passengers;
+    for (int i = 0; i < 3000; ++i) {
+        data.emplace_back(std::vector<double>{(double)((i * 7919LL) % 1000), (double)((i * 31LL) % 500), (double)(i % 24)}, i);
+        fare.push_back(5.0 + i * 0.25);
+        tip.push_back(i * 0.01);
+        passengers.push_back(1 + i % 4);
+    }
+    auto attributes = std::make_shared<AttributeTable>(data);
+    attributes->addColumn("fare", fare);
+    attributes->addColumn("tip", tip);
+    attributes->addColumn("passengers", passengers);
+    
+    bool threw = false;
+    try {
+        attributes->addColumn("short", std::vector<double>(10));
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    assert(threw);
+    
+    QueryRange range({100.0, 50.0, 0.0}, {600.0, 300.0, 11.0});
+    std::vector<std::string> projection = {"tip", "fare"};
+    
+    auto make = [](int kind) -> std::unique_ptr<BaseIndex> {
+        switch (kind) {
+            case 0: return std::make_unique<FloodIndex>();
+            case 1: return std::make_unique<HilbertIndex>();
+            case 2: return std::make_unique<GridIndex>(16);
+            case 3: return std::make_unique<QuadtreeIndex>(16, 3);
+            default:
+                // Composite: joins hits back by id
+                return std::make_unique<ShardedIndex>([]() { return std::make_shared<GridIndex>(16); }, 3,
+                                                      ShardPartitioning::KEY_RANGE, 1);
+        }
+    };
+    
+    for (int kind = 0; kind < 5; ++kind) {
+        auto index = make(kind);
+        index->setCoordinateStorage(CoordinateEncoding::FIXED32, true);
+        index->setAttributes(attributes);
+        index->build(data);
+        
+        ProjectedResult result = index->queryProjected(range, projection);
+        assert(result.column_names == projection);
+        assert(result.columns.size() == 2);
+        assert(result.columns[0].size() == result.points.size());
+        assert(result.columns[1].size() == result.points.size());
+        
+        size_t expected = 0;
+        for (const auto& p : data) {
+            if (range.contains(p)) ++expected;
+        }
+        assert(result.points.size() == expected && expected > 0);
+        for (size_t k = 0; k < result.points.size(); ++k) {
+            uint64_t id = result.points[k].getId();
+            assert(result.columns[0][k] == tip[id]);
+            assert(result.columns[1][k] == fare[id]);
+        }
+        
+        threw = false;
+        try {
+            index->queryProjected(range, {"distance"});
+        } catch (const std::invalid_argument&) {
+            threw = true;
+        }
+        assert(threw);
+    }
+    
+    // Projected queries running alongside plain queries on other threads
+    // keep their columns aligned with their own points
+    QueryRange other({0.0, 0.0, 0.0}, {999.0, 499.0, 5.0});
+    for (int kind = 0; kind < 4; ++kind) {
+        auto index = make(kind);
+        index->setAttributes(attributes);
+        index->build(data);
+        assert(index->supportsConcurrentQueries());
+        size_t expected_other = index->query(other).size();
+        std::atomic<size_t> failures(0);
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 4; ++t) {
+            threads.emplace_back([&, t]() {
+                for (int iteration = 0; iteration < 50; ++iteration) {
+                    if (t % 2 == 0) {
+                        ProjectedResult result = index->queryProjected(range, projection);
+                        bool aligned = result.columns[0].size() == result.points.size();
+                        for (size_t k = 0; aligned && k < result.points.size(); ++k) {
+                            aligned = result.columns[1][k] == fare[result.points[k].getId()];
+                        }
+                        failures += aligned ? 0 : 1;
+                    } else {
+                        failures += index->query(other).size() == expected_other ? 0 : 1;
+                    }
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        assert(failures == 0);
+    }
+    
+    // Without attributes, only an empty projection is valid
+    GridIndex plain(16);
+    plain.build(data);
+    assert(plain.queryProjected(range, {}).points.size() == plain.query(range).size());
+    
+    std::cout << "PASSED" << std::endl;
+}
+
+void test_time_partitioned_index() {
+    std::cout << "Testing TimePartitionedIndex... ";
+    
+    // One point a minute, so hourly buckets hold 60 points each
+    std::vector<DataPoint> data;
+    for (int i = 0; i < 6000; ++i) {
+        data.emplace_back(std::vector<double>{(double)((i * 7919LL) % 1000), (double)((i * 31LL) % 500), i * 60.0}, i);
+    }
+    std::vector<DataPoint> live(data.begin(), data.begin() + 3000);
+    
+    TimePartitionedIndex index([]() { return std::make_shared<GridIndex>(16); }, 3600.0);
+    index.build(live);
+    assert(index.getNumBuckets() == 50);
+    
+    auto check = [&](const QueryRange& range) {
+        std::vector<uint64_t> expected, actual;
+        for (const auto& p : live) {
+            if (range.contains(p)) expected.push_back(p.getId());
+        }
+        for (const auto& p : index.query(range)) {
+            actual.push_back(p.getId());
+        }
+        std::sort(actual.begin(), actual.end());
+        assert(actual == expected);
+    };
+    
+    // A two-hour window visits at most the three buckets it overlaps
+    QueryRange recent({100.0, 50.0, 40.5 * 3600}, {800.0, 450.0, 42.5 * 3600});
+    check(recent);
+    assert(index.getLastBucketsQueried() <= 3);
+    
+    // Streaming ingestion: queries stay exact while buckets build
+    for (size_t begin = 3000; begin < data.size(); begin += 500) {
+        std::vector<DataPoint> batch(data.begin() + begin, data.begin() + begin + 500);
+        index.insert(batch);
+        live.insert(live.end(), batch.begin(), batch.end());
+        check(QueryRange({0.0, 0.0, (begin - 200) * 60.0}, {999.0, 499.0, (begin + 400) * 60.0}));
+    }
+    index.flush();
+    index.waitForBuilds();
+    assert(index.getPendingBuilds() == 0);
+    assert(index.getNumBuckets() == 100);
+    check(QueryRange({0.0, 0.0, 0.0}, {999.0, 499.0, 1e9}));
+    
+    // A late point lands in its (already built) bucket
+    DataPoint late(std::vector<double>{500.0, 250.0, 7200.0 + 30.0}, 99999);
+    index.insert({late});
+    live.push_back(late);
+    check(QueryRange({400.0, 200.0, 7200.0}, {600.0, 300.0, 10800.0}));
+    
+    // An out-of-order stream into a sealed bucket gets it rebuilt rather
+    // than growing its late buffer without bound
+    std::vector<DataPoint> stragglers;
+    for (int i = 0; i < 1100; ++i) {
+        stragglers.emplace_back(std::vector<double>{(double)((i * 37) % 1000), (double)(i % 500), 3 * 3600.0 + i % 3600},
+                                200000 + i);
+    }
+    index.insert(stragglers);
+    live.insert(live.end(), stragglers.begin(), stragglers.end());
+    assert(index.getPendingBuilds() == 1);
+    check(QueryRange({0.0, 0.0, 3 * 3600.0}, {999.0, 499.0, 4 * 3600.0 - 1}));
+    index.waitForBuilds();
+    check(QueryRange({0.0, 0.0, 2 * 3600.0}, {999.0, 499.0, 5 * 3600.0}));
+    
+    // Points without the time dimension (or too few dimensions) are rejected
+    TimePartitionedIndex fresh([]() { return std::make_shared<GridIndex>(16); }, 3600.0);
+    for (TimePartitionedIndex* target : {&fresh, &index}) {
+        bool threw = false;
+        try {
+            target->insert({DataPoint(std::vector<double>{1.0, 2.0}, 1)});
+        } catch (const std::invalid_argument&) {
+            threw = true;
+        }
+        assert(threw);
+    }
+    assert(fresh.getNumBuckets() == 0);
+    
+    // Expiry drops whole buckets
+    assert(index.expireBefore(10 * 3600.0) == 10);
+    live.erase(std::remove_if(live.begin(), live.end(),
+                              [](const DataPoint& p) { return p.getCoordinate(2) < 10 * 3600.0; }),
+               live.end());
+    check(QueryRange({0.0, 0.0, 0.0}, {999.0, 499.0, 1e9}));
+    
+    index.setRetention(5 * 3600.0);
+    assert(index.getNumBuckets() <= 6);
+    double horizon = data.back().getCoordinate(2) - 5 * 3600.0;
+    live.erase(std::remove_if(live.begin(), live.end(),
+                              [horizon](const DataPoint& p) { return p.getCoordinate(2) < std::floor(horizon / 3600.0) * 3600.0; }),
+               live.end());
+    check(QueryRange({0.0, 0.0, 0.0}, {999.0, 499.0, 1e9}));
+    check(recent);
+    
+    std::cout << "PASSED" << std::endl;
+}
+
+void test_parameter_sweep() {
+    std::cout << "Testing ParameterSweep... ";
+    
+    assert(parseSizeList("1K:100M:x10") ==
+           (std::vector<size_t>{1000, 10000, 100000, 1000000, 10000000, 100000000}));
+    assert(parseSizeList("500, 2k,1M") == (std::vector<size_t>{500, 2000, 1000000}));
+    assert(parseValueList("0.0001:0.01:x10").size() == 3);
+    
+    SweepStat stat = SweepStat::of({1.0, 2.0, 3.0}, 0.95);
+    assert(stat.mean == 2.0 && stat.stddev == 1.0);
+    assert(std::abs(stat.ci_high - (2.0 + 4.303 / std::sqrt(3.0))) < 1e-9);
+    assert(SweepStat::of({5.0}, 0.95).ci_low == 5.0);
+    
+    SweepConfig config;
+    bool threw = false;
+    try {
+        config.set("confidence", "0.8");
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    assert(threw);
+    assert(!config.recheck);
+    config.set("recheck", "true");
+    assert(config.recheck);
+    config.set("recheck", "0");
+    assert(!config.recheck);
+    
+    const std::string config_path = "test_sweep.conf";
+    const std::string output_path = "test_sweep.csv";
+    {
+        std::ofstream file(config_path);
+        file << "# small sweep\n"
+             << "sizes = 500, 1K\n"
+             << "dims = 2\n"
+             << "selectivities = 0.01\n"
+             << "queries = 20\n"
+             << "indexes = grid, flood\n"
+             << "trials = 2\n"
+             << "output = " << output_path << "\n";
+    }
+    config.loadFile(config_path);
+    assert(config.numConfigurations() == 4);
+    
+    size_t rows = ParameterSweep(config).run();
+    assert(rows == 4 * 8);
+    
+    std::ifstream csv(output_path);
+    std::string header, line;
+    std::getline(csv, header);
+    assert(header == ParameterSweep::CSV_HEADER);
+    size_t lines = 0;
+    while (std::getline(csv, line)) {
+        ++lines;
+        assert(std::count(line.begin(), line.end(), ',') == std::count(header.begin(), header.end(), ','));
+    }
+    assert(lines == rows);
+    
+    std::remove(config_path.c_str());
+    std::remove(output_path.c_str());
+    
+    std::cout << "PASSED" << std::endl;
+}
+
+void test_perf_counters() {
+    std::cout << "Testing PerfCounters... ";
+    
+    PerfCounters counters;
+    counters.start();
+    volatile double sink = 0.0;
+    for (int i = 0; i < 100000; ++i) {
+        sink = sink + i * 0.5;
+    }
+    PerfSample sample = counters.stop();
+    
+    if (counters.available()) {
+        assert(sample.any());
+        if (sample.has(PerfEvent::INSTRUCTIONS)) {
+            assert(sample.get(PerfEvent::INSTRUCTIONS) > 100000);
+        }
+    } else {
+        // Refused by the kernel: reported, not thrown
+        assert(!sample.any());
+        assert(!counters.unavailableReason().empty());
+    }
+    
+    std::vector<DataPoint> data;
+    for (int i = 0; i < 2000; ++i) {
+        data.emplace_back(std::vector<double>{(double)(i % 97), (double)(i % 89), (double)(i % 13)}, i);
+    }
+    std::vector<QueryRange> queries(10, QueryRange({10.0, 10.0, 0.0}, {40.0, 40.0, 12.0}));
+    
+    Benchmark benchmark;
+    benchmark.setVerbose(false);
+    bool enabled = benchmark.setPerfCounters(true);
+    assert(enabled == counters.available());
+    GridIndex grid(16);
+    BenchmarkResult result = benchmark.runBenchmark(&grid, data, queries, "perf");
+    assert(result.per_query_counters.size() == (enabled ? queries.size() : 0));
+    assert(enabled || !result.query_counters.any());
+    
+    std::cout << "PASSED" << (enabled ? "" : " (counters unavailable: " + counters.unavailableReason() + ")")
+              << std::endl;
+}
+
+void test_microbench() {
+    std::cout << "Testing MicroBenchmark... ";
+    
+    // The extracted normalization matches the curve index's clamping
+    assert(CurveIndex::normalizeToCell(-5.0, 0.0, 100.0, 10) == 0);
+    assert(CurveIndex::normalizeToCell(150.0, 0.0, 100.0, 10) == 1023);
+    assert(CurveIndex::normalizeToCell(50.0, 0.0, 100.0, 0) == 0);
+    assert(CurveIndex::normalizeToCell(50.0, 7.0, 7.0, 10) == 0);
+    
+    MicroConfig config;
+    config.samples = 3;
+    config.min_sample_ms = 0.5;
+    config.verbose = false;
+    MicroBenchmark bench(config);
+    bench.add("sum", 64, [](size_t repeats) {
+        for (size_t r = 0; r < repeats; ++r) {
+            for (uint64_t i = 0; i < 64; ++i) {
+                doNotOptimize(i * r);
+            }
+        }
+    });
+    bool threw = false;
+    try {
+        bench.add("sum", 1, [](size_t) {});
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    assert(threw);
+    
+    std::vector<MicroResult> results = bench.run();
+    assert(results.size() == 1);
+    const MicroResult& r = results[0];
+    assert(r.samples == 3 && r.ops_per_sample >= 64 && r.ops_per_sample % 64 == 0);
+    assert(r.min_ns > 0.0 && r.min_ns <= r.median_ns && r.ci_low_ns <= r.mean_ns && r.mean_ns <= r.ci_high_ns);
+    assert(r.opsPerSecond() > 0.0);
+    
+    // Baseline round trip
+    const std::string path = "/tmp/test_microbench.csv";
+    MicroBenchmark::saveResults(results, path);
+    std::vector<MicroResult> loaded = MicroBenchmark::loadResults(path);
+    std::remove(path.c_str());
+    assert(loaded.size() == 1 && loaded[0].name == "sum" && loaded[0].ops_per_sample == r.ops_per_sample);
+    assert(std::fabs(loaded[0].median_ns - r.median_ns) <= 1e-6 * r.median_ns);
+    
+    // Only a change beyond the threshold with disjoint intervals counts
+    MicroResult slow = r;
+    slow.median_ns = slow.mean_ns = r.median_ns * 2.0;
+    slow.ci_low_ns = r.ci_high_ns * 1.5;
+    slow.ci_high_ns = r.ci_high_ns * 3.0;
+    std::vector<MicroComparison> cmp = MicroBenchmark::compare(results, {slow}, 0.05);
+    assert(cmp.size() == 1 && cmp[0].regression && !cmp[0].improvement);
+    assert(std::fabs(cmp[0].change - 1.0) < 1e-9);
+    cmp = MicroBenchmark::compare({slow}, results, 0.05);
+    assert(cmp[0].improvement && !cmp[0].regression);
+    cmp = MicroBenchmark::compare(results, results, 0.05);
+    assert(!cmp[0].regression && !cmp[0].improvement);
+    MicroResult renamed = r;
+    renamed.name = "other";
+    cmp = MicroBenchmark::compare(results, {renamed}, 0.05);
+    assert(cmp[0].baseline_ns == 0.0 && !cmp[0].regression);
+    
+    // The index kernel suite registers every kernel and distribution
+    config.filter = "morton3d/";
+    MicroBenchmark kernels(config);
+    addIndexKernels(kernels, 256, 7);
+    assert(kernels.names().size() == 3);
+    std::vector<MicroResult> morton = kernels.run();
+    assert(morton.size() == 3 && morton[0].name == "morton3d/uniform");
+    
+    std::cout << "PASSED" << std::endl;
+}
+
+// Grid index that loses the last point of every non-empty result
+class LossyGridIndex : public GridIndex {
+public:
+    LossyGridIndex() : GridIndex(8) {}
+    std::vector<DataPoint> query(const QueryRange& range) override {
+        std::vector<DataPoint> results = GridIndex::query(range);
+        if (!results.empty()) {
+            results.pop_back();
+        }
+        return results;
+    }
+};
+
+void test_result_validator() {
+    std::cout << "Testing ResultValidator... ";
+    
+    // Larger than one scan chunk, so several chunks run in parallel
+    std::vector<DataPoint> data;
+    for (int i = 0; i < 40000; ++i) {
+        data.emplace_back(std::vector<double>{(double)(i % 211), (double)((i * 7LL) % 197), (double)(i % 31)}, i);
+    }
+    QueryRange range({10.0, 20.0, 0.0}, {60.0, 90.0, 15.0});
+    std::vector<DataPoint> truth;
+    for (const auto& p : data) {
+        if (range.contains(p)) truth.push_back(p);
+    }
+    assert(!truth.empty());
+    
+    ResultValidator validator(data, 2);
+    assert(validator.size() == data.size());
+    std::vector<uint64_t> ids = validator.expectedIds(range);
+    assert(ids.size() == truth.size());
+    assert(std::is_sorted(ids.begin(), ids.end()));
+    
+    // Order does not matter
+    std::vector<DataPoint> shuffled(truth.rbegin(), truth.rend());
+    QueryValidation v = validator.check(range, shuffled, 4);
+    assert(v.ok() && v.query == 4 && v.expected == truth.size() && v.returned == truth.size());
+    
+    // A lost point, a duplicate and a point outside the range
+    std::vector<DataPoint> wrong(truth.begin() + 1, truth.end());
+    wrong.push_back(truth[5]);
+    wrong.emplace_back(std::vector<double>{200.0, 0.0, 0.0}, 999999);
+    v = validator.check(range, wrong);
+    assert(!v.ok() && v.missing == 1 && v.extra == 2);
+    assert(v.missing_ids.size() == 1 && v.missing_ids[0] == truth[0].getId());
+    assert(v.extra_ids.size() == 2);
+    
+    // Benchmark validation: a sample of the queries, outside the timing
+    std::vector<QueryRange> queries;
+    for (int q = 0; q < 20; ++q) {
+        queries.emplace_back(std::vector<double>{q * 5.0, 10.0, 0.0}, std::vector<double>{q * 5.0 + 40.0, 120.0, 20.0});
+    }
+    Benchmark benchmark;
+    benchmark.setVerbose(false);
+    benchmark.setValidation(true, 6);
+    GridIndex grid(8);
+    BenchmarkResult result = benchmark.runBenchmark(&grid, data, queries, "validated");
+    assert(result.validated_queries == 6 && result.failed_queries == 0 && result.mismatches.empty());
+    
+    LossyGridIndex lossy;
+    benchmark.setValidation(true);
+    result = benchmark.runBenchmark(&lossy, data, queries, "validated");
+    assert(result.validated_queries == queries.size());
+    assert(result.failed_queries == queries.size() && result.mismatches.size() == queries.size());
+    assert(result.mismatches[3].query == 3 && result.mismatches[3].missing == 1 && result.mismatches[3].extra == 0);
+    
+    std::vector<std::shared_ptr<BaseIndex>> indexes = {std::make_shared<GridIndex>(8),
+                                                       std::make_shared<LossyGridIndex>()};
+    std::vector<BenchmarkResult> suite = benchmark.runSuite(indexes, data, {{"suite", queries}});
+    assert(suite.size() == 2 && suite[0].failed_queries == 0 && suite[1].failed_queries == queries.size());
+    
+    benchmark.setValidation(false);
+    result = benchmark.runBenchmark(&grid, data, queries, "unvalidated");
+    assert(result.validated_queries == 0);
+    
+    std::cout << "PASSED" << std::endl;
+}
+
+void test_load_generator() {
+    std::cout << "Testing LoadGenerator... ";
+    
+    // Histogram: 3 significant digits, exact below 2048
+    LatencyHistogram hist;
+    for (uint64_t v = 1; v <= 1000; ++v) {
+        hist.record(v);
+    }
+    assert(hist.getCount() == 1000 && hist.getMin() == 1 && hist.getMax() == 1000);
+    assert(hist.valueAtPercentile(50.0) == 500);
+    assert(hist.valueAtPercentile(99.0) == 990);
+    assert(hist.valueAtPercentile(100.0) == 1000);
+    assert(std::fabs(hist.getMean() - 500.5) < 1e-9);
+    
+    LatencyHistogram large;
+    for (uint64_t v = 1; v <= 100000; ++v) {
+        large.record(v * 1000);  // 1 us .. 100 ms
+    }
+    uint64_t p999 = large.valueAtPercentile(99.9);
+    assert(p999 >= 99900000 && p999 <= 99900000 + 99900000 / 1000);
+    
+    LatencyHistogram merged;
+    merged.merge(hist);
+    merged.merge(large);
+    assert(merged.getCount() == 101000 && merged.getMin() == 1 && merged.getMax() == 100000000);
+    
+    LatencyHistogram small(1000000, 2);
+    small.record(5000000);
+    assert(small.getClamped() == 1 && small.getMax() == 1000000);
+    bool threw = false;
+    try {
+        merged.merge(small);
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    assert(threw);
+    
+    // Open loop at a rate the index sustains easily
+    std::vector<DataPoint> data;
+    for (int i = 0; i < 5000; ++i) {
+        data.emplace_back(std::vector<double>{(double)(i % 101), (double)((i * 13LL) % 97), (double)(i % 17)}, i);
+    }
+    GridIndex grid(8);
+    grid.build(data);
+    std::vector<QueryRange> queries = {QueryRange({10.0, 10.0, 0.0}, {30.0, 30.0, 16.0}),
+                                       QueryRange({50.0, 0.0, 0.0}, {90.0, 40.0, 16.0})};
+    
+    LoadConfig config;
+    config.duration_s = 0.2;
+    config.worker_threads = 2;
+    config.arrivals = ArrivalProcess::CONSTANT;
+    LoadGenerator generator(config);
+    LoadPoint point = generator.run(grid, queries, 500.0);
+    assert(point.issued == 100);  // Constant arrivals: exactly rate x duration
+    assert(point.completed == point.issued && point.latency.getCount() == point.issued);
+    assert(!point.serialized);
+    assert(point.latency.valueAtPercentile(50.0) >= point.service.getMin());
+    assert(point.achieved_qps > 0.0);
+    
+    config.arrivals = ArrivalProcess::POISSON;
+    config.generator_threads = 2;
+    std::vector<LoadPoint> curve = LoadGenerator(config).sweep(grid, queries, {200.0, 400.0});
+    assert(curve.size() == 2 && curve[1].offered_qps == 400.0);
+    assert(curve[0].completed == curve[0].issued && curve[0].issued > 0);
+    std::string row = LoadGenerator::toCSV("Grid", config.arrivals, curve[0]);
+    assert(row.rfind("Grid,poisson,200.000,", 0) == 0);
+    assert(std::count(row.begin(), row.end(), ',') ==
+           std::count(LoadGenerator::CSV_HEADER, LoadGenerator::CSV_HEADER + std::strlen(LoadGenerator::CSV_HEADER), ','));
+    
+    assert(parseArrivalProcess("constant") == ArrivalProcess::CONSTANT);
+    threw = false;
+    try {
+        generator.run(grid, queries, 0.0);
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    assert(threw);
+    
+    std::cout << "PASSED" << std::endl;
+}
+
+void test_workload_types() {
+    std::cout << "Testing data-driven workloads... ";
+    
+    // Two tight clusters in a large, mostly empty box, with a week of
+    // pickup times starting Monday 2024-01-01 00:00
+    std::vector<DataPoint> data;
+    for (int i = 0; i < 10000; ++i) {
+        double u = std::fmod(i * 0.6180339887, 1.0);
+        double v = std::fmod(i * 0.7548776662, 1.0);
+        double t = 1704067200.0 + std::fmod(i * 0.5698402910, 1.0) * 7 * 86400;
+        double base = i % 2 ? 70.0 : 20.0;
+        data.emplace_back(std::vector<double>{base + 2 * u, 20.0 + 2 * v, t}, i);
+    }
+    data.emplace_back(std::vector<double>{0.0, 0.0, 1704067200.0}, 10000);
+    data.emplace_back(std::vector<double>{100.0, 100.0, 1704067200.0 + 7 * 86400 - 1}, 10001);
+    ResultValidator oracle(data, 1);
+    auto nonEmpty = [&oracle](const std::vector<QueryRange>& workload) {
+        return std::count_if(workload.begin(), workload.end(),
+                             [&oracle](const QueryRange& q) { return !oracle.expectedIds(q).empty(); });
+    };
+    
+    WorkloadGenerator generator(42);
+    auto mixed = generator.generateWorkload(data, WorkloadConfig(WorkloadType::MIXED, 200, 0.001));
+    auto centered = generator.generateWorkload(data, WorkloadConfig(WorkloadType::CENTERED, 200, 0.001));
+    assert(centered.size() == 200);
+    assert(nonEmpty(centered) == 200);  // Every query contains its center
+    assert(nonEmpty(mixed) < 100);      // Uniform placement mostly misses the clusters
+    
+    WorkloadConfig hotspot_config(WorkloadType::HOTSPOT, 200, 0.001);
+    hotspot_config.num_hotspots = 8;
+    hotspot_config.zipf_exponent = 2.0;
+    auto hotspot = generator.generateWorkload(data, hotspot_config);
+    assert(nonEmpty(hotspot) >= 160);
+    for (const auto& q : hotspot) {
+        assert(q.getMinBound(2) == 1704067200.0 && q.getMaxBound(2) == 1704067200.0 + 7 * 86400 - 1);
+    }
+    
+    WorkloadConfig rush_config(WorkloadType::RUSH_HOUR, 200, 0.001);
+    rush_config.temporal_range_hours = 2.0;
+    auto rush = generator.generateWorkload(data, rush_config);
+    assert(nonEmpty(rush) == 200);
+    for (const auto& q : rush) {
+        double day = std::floor(q.getMinBound(2) / 86400) * 86400;
+        double from = q.getMinBound(2) - day;
+        double to = q.getMaxBound(2) - day;
+        assert(std::fabs(to - from - 2 * 3600.0) < 1e-6);
+        assert((from >= 7 * 3600.0 && to <= 10 * 3600.0) || (from >= 16 * 3600.0 && to <= 19 * 3600.0));
+        assert(day < 1704067200.0 + 5 * 86400);  // Monday to Friday
+    }
+    
+    // Equal-count zones: each query returns about selectivity of the data
+    auto zones = generator.generateWorkload(data, WorkloadConfig(WorkloadType::ZONE, 100, 0.01));
+    for (const auto& q : zones) {
+        size_t hits = oracle.expectedIds(q).size();
+        assert(hits >= 95 && hits <= 110);
+    }
+    
+    // Trace replay, exactly as saved
+    std::string trace_file = "/tmp/test_workload_trace.txt";
+    generator.saveWorkload(centered, trace_file);
+    WorkloadConfig trace_config(WorkloadType::TRACE, 5, 0.0);
+    trace_config.trace_file = trace_file;
+    auto replayed = generator.generateWorkload(data, trace_config);
+    assert(replayed.size() == 5);
+    for (size_t i = 0; i < replayed.size(); ++i) {
+        for (size_t d = 0; d < 3; ++d) {
+            assert(replayed[i].getMinBound(d) == centered[i].getMinBound(d));
+            assert(replayed[i].getMaxBound(d) == centered[i].getMaxBound(d));
+        }
+    }
+    std::vector<DataPoint> flat = {DataPoint({1.0, 2.0}, 0)};
+    bool threw = false;
+    try {
+        generator.generateWorkload(flat, trace_config);
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    assert(threw);
+    std::remove(trace_file.c_str());
+    threw = false;
+    try {
+        generator.generateWorkload(data, trace_config);
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    assert(threw);
+    
+    assert(parseWorkloadType("rush-hour") == WorkloadType::RUSH_HOUR);
+    assert(std::string(workloadTypeName(WorkloadType::ZONE)) == "zone");
+    
+    std::cout << "PASSED" << std::endl;
+}
+
+void test_selectivity_calibration() {
+    std::cout << "Testing selectivity calibration... ";
+    
+    // 90% of the points in a tight cluster, the rest spread over the box
+    std::vector<DataPoint> data;
+    for (int i = 0; i < 20000; ++i) {
+        double u = std::fmod(i * 0.6180339887, 1.0);
+        double v = std::fmod(i * 0.7548776662, 1.0);
+        double w = std::fmod(i * 0.5698402910, 1.0);
+        if (i % 10) {
+            data.emplace_back(std::vector<double>{40.0 + 5 * u, 60.0 + 5 * v, 10.0 + 5 * w}, i);
+        } else {
+            data.emplace_back(std::vector<double>{100 * u, 100 * v, 100 * w}, i);
+        }
+    }
+    auto within = [](const std::vector<double>& achieved, double target) {
+        return std::all_of(achieved.begin(), achieved.end(),
+                           [target](double s) { return std::fabs(s - target) <= 0.1 * target; });
+    };
+    
+    // Domain-sized boxes miss the target by orders of magnitude
+    WorkloadGenerator generator(42);
+    WorkloadConfig config(WorkloadType::MIXED, 100, 0.01);
+    auto plain = generator.generateWorkload(data, config);
+    assert(generator.getAchievedSelectivities().empty());
+    auto plain_achieved = WorkloadGenerator::measureSelectivity(data, plain);
+    auto [lowest, highest] = std::minmax_element(plain_achieved.begin(), plain_achieved.end());
+    assert(*lowest < 0.002 && *highest > 0.05);
+    
+    // Calibrated on all the data
+    config.calibrate = true;
+    auto calibrated = generator.generateWorkload(data, config);
+    assert(calibrated.size() == 100);
+    assert(generator.getAchievedSelectivities() == WorkloadGenerator::measureSelectivity(data, calibrated));
+    assert(within(generator.getAchievedSelectivities(), 0.01));
+    
+    // Calibrated on a sample, then refined where the sample was off;
+    // spatial queries leave time unrestricted
+    config.type = WorkloadType::SPATIAL;
+    config.selectivity = 0.02;
+    config.calibration_sample = 1000;
+    auto spatial = generator.generateWorkload(data, config);
+    assert(within(generator.getAchievedSelectivities(), 0.02));
+    auto [earliest, latest] = std::minmax_element(data.begin(), data.end(), [](const DataPoint& a, const DataPoint& b) {
+        return a.getCoordinate(2) < b.getCoordinate(2);
+    });
+    for (const auto& q : spatial) {
+        assert(q.getMinBound(2) == earliest->getCoordinate(2) && q.getMaxBound(2) == latest->getCoordinate(2));
+    }
+    
+    bool threw = false;
+    try {
+        generator.calibrateWorkload(data, spatial, 0.0, 0.1, 1000);
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    assert(threw);
+    
+    std::cout << "PASSED" << std::endl;
+}
+
+void test_synthetic_generator() {
+    std::cout << "Testing SyntheticGenerator... ";
+    
+    // Same points whatever the thread count, and for any sub-range
+    const size_t n = SyntheticGenerator::CHUNK_POINTS + 4464;
+    SyntheticConfig config;
+    config.distribution = Distribution::CLUSTERED;
+    config.num_threads = 1;
+    auto serial = SyntheticGenerator(config).generate(n);
+    config.num_threads = 3;
+    SyntheticGenerator generator(config);
+    auto parallel = generator.generate(n);
+    assert(serial.size() == n && parallel.size() == n);
+    for (size_t i = 0; i < n; i += 997) {
+        assert(parallel[i].getId() == i);
+        for (size_t d = 0; d < 3; ++d) {
+            assert(parallel[i].getCoordinate(d) == serial[i].getCoordinate(d));
+        }
+    }
+    std::vector<std::vector<double>> columns;
+    generator.generateColumns(n - 10, n, columns);
+    assert(columns.size() == 3 && columns[2].size() == 10);
+    assert(columns[1][3] == serial[n - 7].getCoordinate(1));
+    
+    auto correlation = [](const std::vector<DataPoint>& data) {
+        double mx = 0, my = 0, sxx = 0, syy = 0, sxy = 0;
+        for (const auto& p : data) {
+            mx += p.getCoordinate(0) / data.size();
+            my += p.getCoordinate(1) / data.size();
+        }
+        for (const auto& p : data) {
+            double dx = p.getCoordinate(0) - mx, dy = p.getCoordinate(1) - my;
+            sxx += dx * dx;
+            syy += dy * dy;
+            sxy += dx * dy;
+        }
+        return sxy / std::sqrt(sxx * syy);
+    };
+    config.dimensions = 2;
+    config.distribution = Distribution::CORRELATED;
+    auto correlated = SyntheticGenerator(config).generate(20000);
+    assert(correlation(correlated) > 0.8);
+    config.distribution = Distribution::ANTI_CORRELATED;
+    auto anti = SyntheticGenerator(config).generate(20000);
+    assert(correlation(anti) < -0.8);
+    for (const auto& p : anti) {
+        assert(p.getCoordinate(0) >= 0.0 && p.getCoordinate(0) <= 100.0);
+    }
+    config.distribution = Distribution::POWER_LAW;
+    auto skewed = SyntheticGenerator(config).generate(20000);
+    size_t near_origin = std::count_if(skewed.begin(), skewed.end(),
+                                       [](const DataPoint& p) { return p.getCoordinate(0) < 12.5; });
+    assert(near_origin > 9000 && near_origin < 11000);  // 100 * 0.5^3 is the median
+    
+    // NYC-like pickups: inside the cleaning bounds, mostly in Manhattan,
+    // more at the evening peak than before dawn
+    config.distribution = Distribution::NYC_TAXI;
+    config.dimensions = 5;
+    auto pickups = SyntheticGenerator(config).generate(20000);
+    size_t manhattan = 0, evening = 0, dawn = 0;
+    for (const auto& p : pickups) {
+        assert(p.getCoordinate(0) >= -74.3 && p.getCoordinate(0) <= -73.7);
+        assert(p.getCoordinate(1) >= 40.5 && p.getCoordinate(1) <= 40.9);
+        assert(p.getCoordinate(2) >= 1704067200.0 && p.getCoordinate(2) < 1704067200.0 + 30 * 86400);
+        assert(p.getCoordinate(3) >= 1 && p.getCoordinate(3) <= 6 && p.getCoordinate(4) > 0);
+        manhattan += p.getCoordinate(0) < -73.93 && p.getCoordinate(1) > 40.70 && p.getCoordinate(1) < 40.82;
+        int hour = static_cast<int>(std::fmod(p.getCoordinate(2), 86400.0) / 3600);
+        evening += hour == 18;
+        dawn += hour == 4;
+    }
+    assert(manhattan > pickups.size() / 2);
+    assert(evening > 3 * dawn);
+    
+    // Streamed files match the materialized points
+    config.distribution = Distribution::UNIFORM;
+    config.dimensions = 3;
+    SyntheticGenerator uniform(config);
+    auto points = uniform.generate(n);
+    std::string fcol_file = "/tmp/test_synthetic.fcol";
+    std::string bin_file = "/tmp/test_synthetic.bin";
+    uniform.writeFile(n, fcol_file);
+    uniform.writeFile(n, bin_file);
+    {
+        ColumnarDataset dataset(fcol_file);
+        assert(dataset.size() == n && dataset.getDimensions() == 3);
+        for (size_t i = 0; i < n; i += 1013) {
+            assert(dataset.ids()[i] == i && dataset.column(2)[i] == points[i].getCoordinate(2));
+        }
+        assert(dataset.getMinBound(0) >= 0.0 && dataset.getMaxBound(0) <= 100.0);
+    }
+    auto rows = DataLoader().loadFromBinary(bin_file);
+    assert(rows.size() == n && rows[n - 1].getId() == n - 1);
+    assert(rows[n - 1].getCoordinate(1) == points[n - 1].getCoordinate(1));
+    
+    // An unfinished columnar file is not a dataset
+    {
+        ColumnarWriter writer(fcol_file, 10, 1);
+        uint64_t id = 0;
+        double x = 1.0;
+        writer.writeRows(0, 1, &id, {&x});
+        bool threw = false;
+        try {
+            writer.writeRows(10, 1, &id, {&x});
+        } catch (const std::out_of_range&) {
+            threw = true;
+        }
+        assert(threw);
+    }
+    assert(!ColumnarDataset::isColumnarFile(fcol_file));
+    std::remove(fcol_file.c_str());
+    std::remove(bin_file.c_str());
+    
+    bool threw = false;
+    try {
+        parseDistribution("gaussian");
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    assert(threw);
+    
+    std::cout << "PASSED" << std::endl;
+}
+
+void test_mixed_workload() {
+    std::cout << "Testing mixed read/write workloads... ";
+    
+    OperationMix mix = parseOperationMix("90/10");
+    assert(std::fabs(mix.query - 0.9) < 1e-12 && std::fabs(mix.insert - 0.1) < 1e-12 && mix.remove == 0.0);
+    assert(parseOperationMix("2/1/1").toString() == "50/25/25");
+    for (const char* bad : {"90", "abc/10", "0/0", "10/-5", "1/2/3/4"}) {
+        bool threw = false;
+        try {
+            parseOperationMix(bad);
+        } catch (const std::invalid_argument&) {
+            threw = true;
+        }
+        assert(threw);
+    }
+    
+    // Points one minute apart, shuffled
+    std::vector<DataPoint> data;
+    std::mt19937 rng(5);
+    std::uniform_real_distribution<double> coord(0.0, 100.0);
+    for (size_t i = 0; i < 4000; ++i) {
+        data.emplace_back(std::vector<double>{coord(rng), coord(rng), i * 60.0}, i);
+    }
+    std::shuffle(data.begin(), data.end(), rng);
+    
+    MixedWorkloadConfig config;
+    config.mix = parseOperationMix("50/30/20");
+    config.num_operations = 3000;
+    config.queries = WorkloadConfig(WorkloadType::SPATIAL, 0, 0.01);
+    WorkloadGenerator generator(42);
+    MixedWorkload stream = generator.generateOperationStream(data, config);
+    assert(stream.initial.size() == 2000 && stream.operations.size() == 3000);
+    for (const auto& point : stream.initial) {
+        assert(point.getCoordinate(2) < 2000 * 60.0);
+    }
+    for (size_t i = 1; i < stream.inserts.size(); ++i) {
+        assert(stream.inserts[i].getCoordinate(2) > stream.inserts[i - 1].getCoordinate(2));
+    }
+    size_t counts[3] = {0, 0, 0};
+    for (const auto& op : stream.operations) {
+        ++counts[static_cast<int>(op.type)];
+        if (op.type == OperationType::QUERY) {
+            assert(op.arg < stream.queries.size());
+        }
+    }
+    assert(counts[1] == stream.inserts.size());
+    assert(counts[0] > 1300 && counts[0] < 1700 && counts[1] > 750 && counts[2] > 450);
+    
+    // Query operations with nothing to query are rejected
+    bool rejected = false;
+    try {
+        generator.generateOperationStream({}, config);
+    } catch (const std::invalid_argument&) {
+        rejected = true;
+    }
+    assert(rejected);
+    
+    // Rebuild policy for an index without inserts; every query still exact
+    Benchmark benchmark;
+    benchmark.setVerbose(false);
+    benchmark.setValidation(true);
+    benchmark.setRebuildPolicy(200);
+    GridIndex grid(16);
+    assert(!grid.supportsInserts());
+    bool threw = false;
+    try {
+        grid.insert({data[0]});
+    } catch (const std::logic_error&) {
+        threw = true;
+    }
+    assert(threw);
+    MixedResult rebuilt = benchmark.runMixedBenchmark(&grid, stream, "rw");
+    assert(!rebuilt.native_inserts && rebuilt.mix == "50/30/20");
+    assert(rebuilt.rebuilds == (counts[1] + counts[2]) / 200 && rebuilt.rebuild_time_ms > 0.0);
+    assert(rebuilt.validated_queries == counts[0] && rebuilt.failed_queries == 0);
+    assert(rebuilt.windows.size() == Benchmark::AGING_WINDOWS);
+    assert(rebuilt.windows.back().end_operation == 3000);
+    size_t window_queries = 0, window_rebuilds = 0;
+    for (const auto& window : rebuilt.windows) {
+        window_queries += window.queries;
+        window_rebuilds += window.rebuilds;
+        assert(window.pending_updates < 200);
+    }
+    assert(window_queries == rebuilt.query_times_ms.size() && window_queries == counts[0]);
+    assert(window_rebuilds == rebuilt.rebuilds && rebuilt.insert_times_ms.size() == counts[1]);
+    
+    // Never rebuilding: the delta and tombstones keep results exact
+    benchmark.setRebuildPolicy(0);
+    MixedResult stale = benchmark.runMixedBenchmark(&grid, stream, "rw");
+    assert(stale.rebuilds == 0 && stale.failed_queries == 0);
+    assert(stale.windows.back().pending_updates == counts[1] + counts[2]);
+    
+    // An index that inserts natively only rebuilds for deletes
+    benchmark.setRebuildPolicy(200);
+    TimePartitionedIndex partitioned([]() { return std::make_shared<GridIndex>(8); }, 3600.0);
+    assert(partitioned.supportsInserts());
+    MixedResult native = benchmark.runMixedBenchmark(&partitioned, stream, "rw");
+    assert(native.native_inserts && native.rebuilds == counts[2] / 200);
+    assert(native.failed_queries == 0 && native.validated_queries == counts[0]);
+    
+    std::string csv = "/tmp/test_mixed_results.csv";
+    benchmark.saveMixedResults({rebuilt, native}, csv);
+    std::ifstream in(csv);
+    std::string line;
+    size_t lines = 0;
+    while (std::getline(in, line)) {
+        ++lines;
+    }
+    assert(lines == 1 + 2 * Benchmark::AGING_WINDOWS);
+    std::remove(csv.c_str());
+    
+    std::cout << "PASSED" << std::endl;
+}
+
+// Grid index that counts its builds
+class CountingGridIndex : public GridIndex {
+public:
+    CountingGridIndex() : GridIndex(8) {}
+    void build(const std::vector<DataPoint>& data) override {
+        ++builds;
+        GridIndex::build(data);
+    }
+    void dropCaches() override { ++drops; }
+    size_t builds = 0;
+    size_t drops = 0;
+};
+
+void test_build_once_cold_cache() {
+    std::cout << "Testing build-once suite and cold-cache runs... ";
+    
+    CacheFlusher flusher(1 << 20);
+    assert(flusher.size() == (1 << 20));
+    flusher.flush();
+    assert(CacheFlusher(0).size() >= CacheFlusher::MIN_BYTES);
+    
+    std::vector<DataPoint> data;
+    for (size_t i = 0; i < 3000; ++i) {
+        data.emplace_back(std::vector<double>{(i * 37) % 100 * 1.0, (i * 11) % 150 * 1.0, (i % 20) * 1.0}, i);
+    }
+    std::vector<QueryRange> spatial;
+    std::vector<QueryRange> temporal;
+    for (int q = 0; q < 12; ++q) {
+        spatial.emplace_back(std::vector<double>{q * 5.0, 10.0, 0.0}, std::vector<double>{q * 5.0 + 30.0, 90.0, 19.0});
+        temporal.emplace_back(std::vector<double>{0.0, 0.0, q * 1.0}, std::vector<double>{99.0, 149.0, q + 2.0});
+    }
+    
+    auto counting = std::make_shared<CountingGridIndex>();
+    auto other = std::make_shared<CountingGridIndex>();
+    Benchmark benchmark;
+    benchmark.setVerbose(false);
+    benchmark.setWarmupQueries(100);
+    benchmark.setValidation(true);
+    benchmark.setColdCache(true, 1 << 20);
+    assert(benchmark.getCacheFlusher() && benchmark.getCacheFlusher()->size() == (1 << 20));
+    auto results = benchmark.runSuite({counting, other}, data,
+                                      {{"spatial", spatial}, {"temporal", temporal}, {"again", spatial}});
+    
+    // One build per index, shared by the results of all three workloads
+    assert(counting->builds == 1 && other->builds == 1);
+    assert(results.size() == 6);
+    for (const auto& result : results) {
+        assert(result.failed_queries == 0 && result.validated_queries == 12);
+        assert(result.cold_measured && result.cold_query_times_ms.size() == 12);
+        assert(result.cold_avg_query_time_ms > 0.0 && result.cold_p99_query_time_ms >= result.cold_median_query_time_ms);
+    }
+    assert(results[0].build_time_ms == results[2].build_time_ms && results[2].build_time_ms == results[4].build_time_ms);
+    assert(results[0].workload_name == "spatial" && results[3].workload_name == "temporal");
+    assert(results[0].total_results == results[4].total_results);
+    // The index's own caches are dropped before every cold query
+    assert(counting->drops == 36 && other->drops == 36);
+    
+    // runBenchmark still builds, and cold runs are off again once disabled
+    benchmark.setColdCache(false);
+    BenchmarkResult single = benchmark.runBenchmark(counting.get(), data, spatial, "single");
+    assert(counting->builds == 2 && !single.cold_measured && single.cold_query_times_ms.empty());
+    // Same columns either way, the cold ones left empty
+    std::string warm_only = single.toCSV();
+    std::string both = results[0].toCSV();
+    assert(std::count(warm_only.begin(), warm_only.end(), ',') == std::count(both.begin(), both.end(), ','));
+    assert(counting->drops == 36);
+    
+    // Composites forward dropCaches() to their parts
+    auto part = std::make_shared<CountingGridIndex>();
+    RouterIndex router({part});
+    router.dropCaches();
+    assert(part->drops == 1);
+    
+    std::cout << "PASSED" << std::endl;
+}
+
 int run_tests() {
     try {
         test_data_point();
         test_query_range();
         test_data_loader();
+        test_columnar_dataset();
+        test_csv_parser();
+        test_zorder_index();
+        test_hilbert_index();
+        test_curve_index_high_dimensions();
+        test_grid_index();
+        test_quadtree_index();
+        test_coordinate_storage();
+        test_attribute_projection();
+        test_sharded_index();
+        test_tsunami_index();
+        test_router_index();
+        test_time_partitioned_index();
+        test_flood_external_builder();
+        test_disk_flood_index();
+        test_parameter_sweep();
+        test_perf_counters();
+        test_microbench();
+        test_result_validator();
+        test_load_generator();
+        test_workload_types();
+        test_selectivity_calibration();
+        test_synthetic_generator();
+        test_mixed_workload();
+        test_build_once_cold_cache();
         
         return 0;
     } catch (const std::exception& e) {
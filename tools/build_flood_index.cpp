@@ -0,0 +1,58 @@
+#include "data/columnar_dataset.h"
+#include "indexes/flood_external_builder.h"
+#include <iostream>
+#include <string>
+
+using namespace flood;
+
+int main(int argc, char* argv[]) {
+    std::cout << "Out-of-core Flood Index Builder" << std::endl;
+    std::cout << "===============================" << std::endl;
+    
+    if (argc < 3) {
+        std::cerr << "Usage: " << argv[0] << " <input.fcol> <output.fidx> [options]" << std::endl;
+        std::cerr << std::endl;
+        std::cerr << "Sorts a columnar dataset by Flood's flattened key with a bounded-memory" << std::endl;
+        std::cerr << "external merge sort and writes a block-structured index file" << std::endl;
+        std::cerr << "Options:" << std::endl;
+        std::cerr << "  --memory-mb N    Memory budget for sort and I/O buffers (default 256)" << std::endl;
+        std::cerr << "  --block-size N   Index block size in bytes (default 4096)" << std::endl;
+        std::cerr << "  --temp-dir DIR   Directory for sorted runs (default: next to the output)" << std::endl;
+        return 1;
+    }
+    
+    std::string input_file = argv[1];
+    std::string output_file = argv[2];
+    
+    ExternalBuildOptions options;
+    for (int i = 3; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--memory-mb" && i + 1 < argc) {
+            options.memory_budget_bytes = std::stoull(argv[++i]) << 20;
+        } else if (arg == "--block-size" && i + 1 < argc) {
+            options.block_size = std::stoull(argv[++i]);
+        } else if (arg == "--temp-dir" && i + 1 < argc) {
+            options.temp_dir = argv[++i];
+        } else {
+            std::cerr << "Unknown option: " << arg << std::endl;
+            return 1;
+        }
+    }
+    
+    std::cout << "Input: " << input_file << std::endl;
+    std::cout << "Output: " << output_file << std::endl;
+    std::cout << "Memory budget: " << (options.memory_budget_bytes >> 20) << " MB" << std::endl;
+    std::cout << std::endl;
+    
+    try {
+        ColumnarDataset dataset(input_file);
+        FloodExternalBuilder builder(options);
+        builder.build(dataset, output_file);
+        builder.getStats().print();
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+    
+    return 0;
+}
@@ -1,8 +1,13 @@
 #!/usr/bin/env python3
 """
 Generate performance comparison plots for Flood Index project
+
+    generate_plots.py                     plots build/benchmark_results.csv (run_benchmark)
+    generate_plots.py --sweep FILE.csv    plots a tidy sweep CSV (run_sweep)
+    generate_plots.py --load FILE.csv     plots latency-throughput curves (run_load)
 """
 
+import argparse
 import pandas as pd
 import matplotlib.pyplot as plt
 import numpy as np
@@ -13,8 +18,13 @@ from pathlib import Path
 plt.style.use('seaborn-v0_8-darkgrid')
 sns.set_palette("husl")
 
+parser = argparse.ArgumentParser(description="Generate Flood Index benchmark plots")
+parser.add_argument("--sweep", type=Path, help="tidy CSV written by run_sweep")
+parser.add_argument("--load", type=Path, help="latency-throughput CSV written by run_load")
+args = parser.parse_args()
+
 # Read data
-data_file = Path(__file__).parent.parent / "build" / "benchmark_results.csv"
+data_file = args.sweep or args.load or Path(__file__).parent.parent / "build" / "benchmark_results.csv"
 df = pd.read_csv(data_file)
 
 # Create output directory
@@ -25,12 +35,19 @@ print(f"Reading data from: {data_file}")
 print(f"Output directory: {output_dir}")
 print(f"\nData shape: {df.shape}")
 print(f"Indexes: {df['Index'].unique()}")
-print(f"Workloads: {df['Workload'].unique()}\n")
+if 'Workload' in df:
+    print(f"Workloads: {df['Workload'].unique()}\n")
 
 # Define colors for each index
 colors = {
     'k-d Tree': '#3498db',  # Blue
     'Z-order': '#e74c3c',   # Red
+    'Hilbert': '#9b59b6',   # Purple
+    'Grid': '#1abc9c',      # Teal
+    'Quadtree': '#e67e22',  # Orange
+    'Octree': '#d35400',    # Dark orange
+    'Tsunami': '#34495e',   # Dark blue-gray
+    'Router': '#c0392b',    # Dark red
     'R*-tree': '#2ecc71',   # Green
     'Flood': '#f39c12'      # Orange (highlight)
 }
@@ -45,7 +62,7 @@ def plot_index_size():
     size_data = df.groupby('Index')['IndexSize_MB'].first().sort_values()
     
     bars = plt.bar(range(len(size_data)), size_data.values, 
-                   color=[colors[idx] for idx in size_data.index],
+                   color=[colors.get(idx, '#7f8c8d') for idx in size_data.index],
                    edgecolor='black', linewidth=1.2, alpha=0.85)
     
     # Highlight Flood
@@ -86,7 +103,7 @@ def plot_build_time():
     build_data = df.groupby('Index')['BuildTime_ms'].mean().sort_values()
     
     bars = plt.bar(range(len(build_data)), build_data.values,
-                   color=[colors[idx] for idx in build_data.index],
+                   color=[colors.get(idx, '#7f8c8d') for idx in build_data.index],
                    edgecolor='black', linewidth=1.2, alpha=0.85)
     
     # Highlight Flood
@@ -129,7 +146,7 @@ def plot_query_time_by_workload():
         workload_data = workload_data.sort_values()
         
         bars = ax.bar(range(len(workload_data)), workload_data.values,
-                     color=[colors[idx] for idx in workload_data.index],
+                     color=[colors.get(idx, '#7f8c8d') for idx in workload_data.index],
                      edgecolor='black', linewidth=1.2, alpha=0.85)
         
         # Highlight Flood
@@ -165,7 +182,7 @@ def plot_avg_query_time_log():
     avg_query = df.groupby('Index')['AvgQueryTime_ms'].mean().sort_values()
     
     bars = plt.bar(range(len(avg_query)), avg_query.values,
-                   color=[colors[idx] for idx in avg_query.index],
+                   color=[colors.get(idx, '#7f8c8d') for idx in avg_query.index],
                    edgecolor='black', linewidth=1.2, alpha=0.85)
     
     # Highlight Flood
@@ -199,7 +216,7 @@ def plot_query_percentiles():
     ax = axes[0]
     p95_data = df.groupby('Index')['P95QueryTime_ms'].mean().sort_values()
     bars = ax.bar(range(len(p95_data)), p95_data.values,
-                  color=[colors[idx] for idx in p95_data.index],
+                  color=[colors.get(idx, '#7f8c8d') for idx in p95_data.index],
                   edgecolor='black', linewidth=1.2, alpha=0.85)
     
     flood_idx = list(p95_data.index).index('Flood')
@@ -220,7 +237,7 @@ def plot_query_percentiles():
     ax = axes[1]
     p99_data = df.groupby('Index')['P99QueryTime_ms'].mean().sort_values()
     bars = ax.bar(range(len(p99_data)), p99_data.values,
-                  color=[colors[idx] for idx in p99_data.index],
+                  color=[colors.get(idx, '#7f8c8d') for idx in p99_data.index],
                   edgecolor='black', linewidth=1.2, alpha=0.85)
     
     flood_idx = list(p99_data.index).index('Flood')
@@ -287,8 +304,8 @@ def plot_radar_chart():
         values += values[:1]
         
         ax.plot(angles, values, 'o-', linewidth=2, label=idx, 
-               color=colors[idx], markersize=8)
-        ax.fill(angles, values, alpha=0.15, color=colors[idx])
+               color=colors.get(idx, '#7f8c8d'), markersize=8)
+        ax.fill(angles, values, alpha=0.15, color=colors.get(idx, '#7f8c8d'))
     
     # Fix axis
     ax.set_xticks(angles[:-1])
@@ -307,10 +324,88 @@ def plot_radar_chart():
     print("✓ Generated: 6_radar_chart.png")
     plt.close()
 
+# =====================================================================
+# Sweep: scaling curves with confidence bands
+# =====================================================================
+def plot_sweep_metric(metric, x, ylabel, filename):
+    """One panel per workload (and selectivity), one line per index
+    configuration against x; the other swept sizes are held at their minimum"""
+    data = df[df['Metric'] == metric].copy()
+    if data.empty or data[x].nunique() < 2:
+        return
+    data['Label'] = data['Index'] + ' (' + data['Coords'] + ')'
+    for col in ['DataSize', 'Dimensions', 'NumQueries']:
+        if col != x:
+            data = data[data[col] == data[col].min()]
+    
+    panel_keys = ['Workload'] if x == 'Selectivity' else ['Workload', 'Selectivity']
+    panels = list(data.groupby(panel_keys))
+    fig, axes = plt.subplots(1, len(panels), figsize=(6 * len(panels), 5), squeeze=False)
+    for ax, (key, panel) in zip(axes[0], panels):
+        for label, series in panel.groupby('Label'):
+            series = series.sort_values(x)
+            base = series['Index'].iloc[0]
+            color = colors.get(base.split(' ')[0], None)
+            ax.plot(series[x], series['Mean'], 'o-', label=label, color=color, linewidth=2)
+            ax.fill_between(series[x], series['CI_Low'], series['CI_High'], alpha=0.2, color=color)
+        ax.set_xscale('log')
+        ax.set_yscale('log')
+        ax.set_xlabel(x, fontsize=11, fontweight='bold')
+        ax.set_ylabel(ylabel, fontsize=11, fontweight='bold')
+        title = ', '.join(str(k) for k in np.atleast_1d(key))
+        ax.set_title(title, fontsize=12, fontweight='bold')
+        ax.grid(True, which='both', alpha=0.3, linestyle='--')
+        ax.legend(fontsize=9)
+    
+    confidence = df['Confidence'].iloc[0]
+    fig.suptitle(f'{ylabel} vs {x} (bands: {confidence:.0%} CI)', fontsize=14, fontweight='bold')
+    plt.tight_layout()
+    plt.savefig(output_dir / filename, dpi=300, bbox_inches='tight')
+    print(f"✓ Generated: {filename}")
+    plt.close()
+
+def plot_sweep():
+    plot_sweep_metric('AvgQueryTime_ms', 'DataSize', 'Avg Query Time (ms)', 'sweep_query_time_vs_size.png')
+    plot_sweep_metric('BuildTime_ms', 'DataSize', 'Build Time (ms)', 'sweep_build_time_vs_size.png')
+    plot_sweep_metric('IndexSize_MB', 'DataSize', 'Index Size (MB)', 'sweep_index_size_vs_size.png')
+    plot_sweep_metric('AvgQueryTime_ms', 'Dimensions', 'Avg Query Time (ms)', 'sweep_query_time_vs_dims.png')
+    plot_sweep_metric('AvgQueryTime_ms', 'Selectivity', 'Avg Query Time (ms)', 'sweep_query_time_vs_selectivity.png')
+    plot_sweep_metric('AchievedSelectivity', 'Selectivity', 'Achieved Selectivity', 'sweep_achieved_selectivity.png')
+
+def plot_load_curve():
+    """Latency percentiles against achieved throughput, one line per index;
+    latencies are measured from each request's intended send time"""
+    percentiles = [('P50_us', 'p50', ':'), ('P99_us', 'p99', '-'), ('P999_us', 'p99.9', '--')]
+    fig, ax = plt.subplots(figsize=(10, 6))
+    for index, curve in df.groupby('Index'):
+        curve = curve.sort_values('OfferedQPS')
+        color = colors.get(index.split(' ')[0], None)
+        for column, label, style in percentiles:
+            ax.plot(curve['AchievedQPS'], curve[column] / 1000.0, style, marker='o', color=color,
+                    label=f'{index} {label}', linewidth=2)
+    ax.set_yscale('log')
+    ax.set_xlabel('Achieved Throughput (queries/s)', fontsize=12, fontweight='bold')
+    ax.set_ylabel('Latency (ms, from intended send time)', fontsize=12, fontweight='bold')
+    arrivals = ', '.join(df['Arrivals'].unique())
+    ax.set_title(f'Latency vs Throughput (open loop, {arrivals} arrivals)', fontsize=14, fontweight='bold')
+    ax.grid(True, which='both', alpha=0.3, linestyle='--')
+    ax.legend(fontsize=9, ncol=2)
+    plt.tight_layout()
+    plt.savefig(output_dir / 'load_latency_vs_throughput.png', dpi=300, bbox_inches='tight')
+    print("✓ Generated: load_latency_vs_throughput.png")
+    plt.close()
+
 # =====================================================================
 # Main execution
 # =====================================================================
 if __name__ == "__main__":
+    if args.sweep:
+        plot_sweep()
+        raise SystemExit(0)
+    if args.load:
+        plot_load_curve()
+        raise SystemExit(0)
+    
     print("\n" + "="*60)
     print("  Generating Performance Comparison Plots")
     print("="*60 + "\n")
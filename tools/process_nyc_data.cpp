@@ -1,4 +1,6 @@
 #include "data/data_loader.h"
+#include "data/columnar_dataset.h"
+#include "data/csv_parser.h"
 #include <iostream>
 
 using namespace flood;
@@ -11,7 +13,9 @@ int main(int argc, char* argv[]) {
         std::cerr << "Usage: " << argv[0] << " <input_csv> <output_binary>" << std::endl;
         std::cerr << std::endl;
         std::cerr << "Converts NYC taxi CSV data to binary format for faster loading" << std::endl;
-        std::cerr << "Expected CSV columns: pickup_longitude, pickup_latitude, ..." << std::endl;
+        std::cerr << "An output name ending in .fcol selects the memory-mappable columnar format" << std::endl;
+        std::cerr << "Expected CSV columns (by header name): pickup_longitude, pickup_latitude," << std::endl;
+        std::cerr << "  pickup_datetime (or tpep_/lpep_pickup_datetime), passenger_count, trip_distance" << std::endl;
         return 1;
     }
     
@@ -22,28 +26,44 @@ int main(int argc, char* argv[]) {
     std::cout << "Output: " << output_file << std::endl;
     std::cout << std::endl;
     
-    // Load data
+    // Load and clean data in one parallel pass
     DataLoader loader;
-    std::cout << "Loading CSV data..." << std::endl;
-    auto data = loader.loadFromCSV(input_file);
+    std::cout << "Loading and cleaning CSV data..." << std::endl;
+    CSVParser parser(CSVParser::nycTaxiOptions());
+    std::vector<DataPoint> cleaned;
+    try {
+        cleaned = parser.parse(input_file);
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+    parser.getStats().print();
     
-    if (data.empty()) {
+    if (cleaned.empty()) {
         std::cerr << "Error: No data loaded from " << input_file << std::endl;
         return 1;
     }
     
-    // Clean data
-    std::cout << "Cleaning data..." << std::endl;
-    auto cleaned = loader.cleanData(data);
-    
     // Compute statistics
     auto stats = loader.computeStats(cleaned);
     stats.print();
     std::cout << std::endl;
     
     // Save to binary
-    std::cout << "Saving to binary format..." << std::endl;
-    loader.saveToBinary(cleaned, output_file);
+    bool columnar = output_file.size() >= 5 &&
+                    output_file.compare(output_file.size() - 5, 5, ".fcol") == 0;
+    if (columnar) {
+        std::cout << "Saving to columnar format..." << std::endl;
+        try {
+            ColumnarDataset::write(cleaned, output_file);
+        } catch (const std::exception& e) {
+            std::cerr << "Error: " << e.what() << std::endl;
+            return 1;
+        }
+    } else {
+        std::cout << "Saving to binary format..." << std::endl;
+        loader.saveToBinary(cleaned, output_file);
+    }
     
     std::cout << std::endl;
     std::cout << "Done! Processed " << cleaned.size() << " data points" << std::endl;